@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures how long a single long-running loop, in a method that is only called once, runs
+// interpreted before the JIT lets it enter compiled code with on-stack replacement.
+public class HotLoopBenchmark {
+    // Iterations of the loop between two timestamps.
+    private static final int CHUNK = 1 << 16;
+    private static final int CHUNKS = 2048;
+
+    // A chunk runs at peak once it is at most this many percent slower than the fastest one.
+    private static final int PEAK_TOLERANCE_PERCENT = 10;
+
+    public void timeSingleHotLoop(int count) {
+        for (int i = 0; i < count; ++i) {
+            timestamps = new long[CHUNKS + 1];
+            sink += hotLoop(timestamps);
+        }
+    }
+
+    // Called once per iteration of `timeSingleHotLoop`, so that its hotness comes from the back
+    // edges of its loop.
+    private static int hotLoop(long[] stamps) {
+        int sum = 0;
+        stamps[0] = System.nanoTime();
+        for (int i = 0; i < CHUNK * CHUNKS; ++i) {
+            sum += (i ^ sum) >>> 3;
+            if ((i & (CHUNK - 1)) == CHUNK - 1) {
+                stamps[(i / CHUNK) + 1] = System.nanoTime();
+            }
+        }
+        return sum;
+    }
+
+    // Returns the time in nanoseconds from the start of the loop to the first chunk that ran
+    // at peak.
+    private static long timeToPeak(long[] stamps) {
+        long fastest = Long.MAX_VALUE;
+        for (int i = 1; i < stamps.length; ++i) {
+            fastest = Math.min(fastest, stamps[i] - stamps[i - 1]);
+        }
+        long limit = fastest + fastest * PEAK_TOLERANCE_PERCENT / 100;
+        for (int i = 1; i < stamps.length; ++i) {
+            if (stamps[i] - stamps[i - 1] <= limit) {
+                return stamps[i - 1] - stamps[0];
+            }
+        }
+        return stamps[stamps.length - 1] - stamps[0];
+    }
+
+    private long[] timestamps;
+    private static int sink;
+
+    public static void main(String[] args) {
+        HotLoopBenchmark benchmark = new HotLoopBenchmark();
+        benchmark.timeSingleHotLoop(1);
+        long total = benchmark.timestamps[CHUNKS] - benchmark.timestamps[0];
+        System.out.println("HotLoopBenchmark.timeToPeak: " +
+            (timeToPeak(benchmark.timestamps) / 1000) + "us of " + (total / 1000) + "us");
+    }
+}
@@ -0,0 +1,461 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Calls many small hot methods in turn. Each of them checks its arguments and throws on paths
+// which never run, so the density of their hot code decides how much of the instruction cache
+// the working set needs.
+public class HotWorkingSetBenchmark {
+    private static final int MASK = 1023;
+
+    public void timeHotWorkingSet(int count) {
+        int[] data = new int[MASK + 1];
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += step0(data, (i + 0) & MASK, sum);
+            sum += step1(data, (i + 1) & MASK, sum);
+            sum += step2(data, (i + 2) & MASK, sum);
+            sum += step3(data, (i + 3) & MASK, sum);
+            sum += step4(data, (i + 4) & MASK, sum);
+            sum += step5(data, (i + 5) & MASK, sum);
+            sum += step6(data, (i + 6) & MASK, sum);
+            sum += step7(data, (i + 7) & MASK, sum);
+            sum += step8(data, (i + 8) & MASK, sum);
+            sum += step9(data, (i + 9) & MASK, sum);
+            sum += step10(data, (i + 10) & MASK, sum);
+            sum += step11(data, (i + 11) & MASK, sum);
+            sum += step12(data, (i + 12) & MASK, sum);
+            sum += step13(data, (i + 13) & MASK, sum);
+            sum += step14(data, (i + 14) & MASK, sum);
+            sum += step15(data, (i + 15) & MASK, sum);
+            sum += step16(data, (i + 16) & MASK, sum);
+            sum += step17(data, (i + 17) & MASK, sum);
+            sum += step18(data, (i + 18) & MASK, sum);
+            sum += step19(data, (i + 19) & MASK, sum);
+            sum += step20(data, (i + 20) & MASK, sum);
+            sum += step21(data, (i + 21) & MASK, sum);
+            sum += step22(data, (i + 22) & MASK, sum);
+            sum += step23(data, (i + 23) & MASK, sum);
+            sum += step24(data, (i + 24) & MASK, sum);
+            sum += step25(data, (i + 25) & MASK, sum);
+            sum += step26(data, (i + 26) & MASK, sum);
+            sum += step27(data, (i + 27) & MASK, sum);
+            sum += step28(data, (i + 28) & MASK, sum);
+            sum += step29(data, (i + 29) & MASK, sum);
+            sum += step30(data, (i + 30) & MASK, sum);
+            sum += step31(data, (i + 31) & MASK, sum);
+        }
+        sink = sum;
+    }
+
+    private static int step0(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step0: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step0: value " + value + " at " + index);
+        }
+        int result = data[index] * 3 + (value >>> 1);
+        data[index] = result;
+        return result ^ 0;
+    }
+
+    private static int step1(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step1: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step1: value " + value + " at " + index);
+        }
+        int result = data[index] * 5 + (value >>> 2);
+        data[index] = result;
+        return result ^ 1;
+    }
+
+    private static int step2(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step2: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step2: value " + value + " at " + index);
+        }
+        int result = data[index] * 7 + (value >>> 3);
+        data[index] = result;
+        return result ^ 2;
+    }
+
+    private static int step3(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step3: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step3: value " + value + " at " + index);
+        }
+        int result = data[index] * 9 + (value >>> 4);
+        data[index] = result;
+        return result ^ 3;
+    }
+
+    private static int step4(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step4: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step4: value " + value + " at " + index);
+        }
+        int result = data[index] * 11 + (value >>> 5);
+        data[index] = result;
+        return result ^ 4;
+    }
+
+    private static int step5(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step5: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step5: value " + value + " at " + index);
+        }
+        int result = data[index] * 13 + (value >>> 6);
+        data[index] = result;
+        return result ^ 5;
+    }
+
+    private static int step6(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step6: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step6: value " + value + " at " + index);
+        }
+        int result = data[index] * 15 + (value >>> 7);
+        data[index] = result;
+        return result ^ 6;
+    }
+
+    private static int step7(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step7: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step7: value " + value + " at " + index);
+        }
+        int result = data[index] * 17 + (value >>> 1);
+        data[index] = result;
+        return result ^ 7;
+    }
+
+    private static int step8(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step8: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step8: value " + value + " at " + index);
+        }
+        int result = data[index] * 19 + (value >>> 2);
+        data[index] = result;
+        return result ^ 8;
+    }
+
+    private static int step9(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step9: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step9: value " + value + " at " + index);
+        }
+        int result = data[index] * 21 + (value >>> 3);
+        data[index] = result;
+        return result ^ 9;
+    }
+
+    private static int step10(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step10: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step10: value " + value + " at " + index);
+        }
+        int result = data[index] * 23 + (value >>> 4);
+        data[index] = result;
+        return result ^ 10;
+    }
+
+    private static int step11(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step11: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step11: value " + value + " at " + index);
+        }
+        int result = data[index] * 25 + (value >>> 5);
+        data[index] = result;
+        return result ^ 11;
+    }
+
+    private static int step12(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step12: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step12: value " + value + " at " + index);
+        }
+        int result = data[index] * 27 + (value >>> 6);
+        data[index] = result;
+        return result ^ 12;
+    }
+
+    private static int step13(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step13: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step13: value " + value + " at " + index);
+        }
+        int result = data[index] * 29 + (value >>> 7);
+        data[index] = result;
+        return result ^ 13;
+    }
+
+    private static int step14(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step14: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step14: value " + value + " at " + index);
+        }
+        int result = data[index] * 31 + (value >>> 1);
+        data[index] = result;
+        return result ^ 14;
+    }
+
+    private static int step15(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step15: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step15: value " + value + " at " + index);
+        }
+        int result = data[index] * 33 + (value >>> 2);
+        data[index] = result;
+        return result ^ 15;
+    }
+
+    private static int step16(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step16: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step16: value " + value + " at " + index);
+        }
+        int result = data[index] * 35 + (value >>> 3);
+        data[index] = result;
+        return result ^ 16;
+    }
+
+    private static int step17(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step17: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step17: value " + value + " at " + index);
+        }
+        int result = data[index] * 37 + (value >>> 4);
+        data[index] = result;
+        return result ^ 17;
+    }
+
+    private static int step18(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step18: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step18: value " + value + " at " + index);
+        }
+        int result = data[index] * 39 + (value >>> 5);
+        data[index] = result;
+        return result ^ 18;
+    }
+
+    private static int step19(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step19: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step19: value " + value + " at " + index);
+        }
+        int result = data[index] * 41 + (value >>> 6);
+        data[index] = result;
+        return result ^ 19;
+    }
+
+    private static int step20(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step20: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step20: value " + value + " at " + index);
+        }
+        int result = data[index] * 43 + (value >>> 7);
+        data[index] = result;
+        return result ^ 20;
+    }
+
+    private static int step21(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step21: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step21: value " + value + " at " + index);
+        }
+        int result = data[index] * 45 + (value >>> 1);
+        data[index] = result;
+        return result ^ 21;
+    }
+
+    private static int step22(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step22: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step22: value " + value + " at " + index);
+        }
+        int result = data[index] * 47 + (value >>> 2);
+        data[index] = result;
+        return result ^ 22;
+    }
+
+    private static int step23(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step23: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step23: value " + value + " at " + index);
+        }
+        int result = data[index] * 49 + (value >>> 3);
+        data[index] = result;
+        return result ^ 23;
+    }
+
+    private static int step24(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step24: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step24: value " + value + " at " + index);
+        }
+        int result = data[index] * 51 + (value >>> 4);
+        data[index] = result;
+        return result ^ 24;
+    }
+
+    private static int step25(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step25: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step25: value " + value + " at " + index);
+        }
+        int result = data[index] * 53 + (value >>> 5);
+        data[index] = result;
+        return result ^ 25;
+    }
+
+    private static int step26(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step26: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step26: value " + value + " at " + index);
+        }
+        int result = data[index] * 55 + (value >>> 6);
+        data[index] = result;
+        return result ^ 26;
+    }
+
+    private static int step27(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step27: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step27: value " + value + " at " + index);
+        }
+        int result = data[index] * 57 + (value >>> 7);
+        data[index] = result;
+        return result ^ 27;
+    }
+
+    private static int step28(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step28: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step28: value " + value + " at " + index);
+        }
+        int result = data[index] * 59 + (value >>> 1);
+        data[index] = result;
+        return result ^ 28;
+    }
+
+    private static int step29(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step29: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step29: value " + value + " at " + index);
+        }
+        int result = data[index] * 61 + (value >>> 2);
+        data[index] = result;
+        return result ^ 29;
+    }
+
+    private static int step30(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step30: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step30: value " + value + " at " + index);
+        }
+        int result = data[index] * 63 + (value >>> 3);
+        data[index] = result;
+        return result ^ 30;
+    }
+
+    private static int step31(int[] data, int index, int value) {
+        if (index < 0 || index >= data.length) {
+            throw new IllegalArgumentException("step31: index " + index + " out of " + data.length);
+        }
+        if (poisoned) {
+            throw new IllegalStateException("step31: value " + value + " at " + index);
+        }
+        int result = data[index] * 65 + (value >>> 4);
+        data[index] = result;
+        return result ^ 31;
+    }
+
+    // Never set, the checks on it only guard cold code.
+    private static boolean poisoned;
+    private static int sink;
+
+    public static void main(String[] args) {
+        HotWorkingSetBenchmark benchmark = new HotWorkingSetBenchmark();
+        // Warm up, so that the methods are compiled.
+        benchmark.timeHotWorkingSet(1 << 16);
+        long start = System.nanoTime();
+        benchmark.timeHotWorkingSet(1 << 22);
+        long end = System.nanoTime();
+        System.out.println(
+            "HotWorkingSetBenchmark.timeHotWorkingSet: " + ((end - start) / 1000) + "us");
+    }
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Array kernels with a loop invariant condition in their body, or with several arrays which may
+// alias. The loop optimizer vectorizes them after unswitching or with runtime alias tests; the
+// Scalar variants keep a loop variant condition and show the time of the scalar loops.
+public class LoopUnswitchingBenchmark {
+    private static final int SIZE = 4096;
+
+    private final int[] ints1 = new int[SIZE];
+    private final int[] ints2 = new int[SIZE + 1];
+    private final int[] ints3 = new int[SIZE];
+    private final int[] ints4 = new int[SIZE + 1];
+    private final float[] floats1 = new float[SIZE];
+    private final float[] floats2 = new float[SIZE];
+
+    private static long sink;
+
+    public LoopUnswitchingBenchmark() {
+        for (int i = 0; i < SIZE; ++i) {
+            ints1[i] = i * 101;
+            ints2[i] = i - SIZE / 2;
+            ints3[i] = i * 7;
+            ints4[i] = -i;
+            floats1[i] = i * 0.5f;
+            floats2[i] = SIZE - i;
+        }
+    }
+
+    private static void addOrSubInts(int[] a, int x, boolean add) {
+        for (int i = 0; i < a.length; ++i) {
+            if (add) {
+                a[i] += x;
+            } else {
+                a[i] -= x;
+            }
+        }
+    }
+
+    private static void addOrSubIntsScalar(int[] a, int x, int n) {
+        for (int i = 0; i < a.length; ++i) {
+            if (i < n) {
+                a[i] += x;
+            } else {
+                a[i] -= x;
+            }
+        }
+    }
+
+    private static void scaleOrAddFloats(float[] a, float[] b, float x, boolean scale) {
+        for (int i = 0; i < a.length; ++i) {
+            if (scale) {
+                a[i] = x * b[i];
+            } else {
+                a[i] += b[i];
+            }
+        }
+    }
+
+    private static int sumOrSumSquaresInts(int[] a, boolean squares) {
+        int sum = 0;
+        for (int i = 0; i < a.length; ++i) {
+            if (squares) {
+                sum += a[i] * a[i];
+            } else {
+                sum += a[i];
+            }
+        }
+        return sum;
+    }
+
+    private static void shiftTwoInts(int[] a, int[] b, int[] c, int[] d, int n) {
+        for (int i = 0; i < n; ++i) {
+            a[i] = b[i + 1];
+            c[i] = d[i + 1];
+        }
+    }
+
+    public void timeAddOrSubInts(int count) {
+        for (int i = 0; i < count; ++i) {
+            addOrSubInts(ints1, i, (i & 1) == 0);
+        }
+    }
+
+    public void timeAddOrSubIntsScalar(int count) {
+        for (int i = 0; i < count; ++i) {
+            addOrSubIntsScalar(ints1, i, SIZE);
+        }
+    }
+
+    public void timeScaleOrAddFloats(int count) {
+        for (int i = 0; i < count; ++i) {
+            scaleOrAddFloats(floats1, floats2, 0.5f, (i & 1) == 0);
+        }
+    }
+
+    public void timeSumOrSumSquaresInts(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink += sumOrSumSquaresInts(ints1, (i & 1) == 0);
+        }
+    }
+
+    public void timeShiftTwoInts(int count) {
+        for (int i = 0; i < count; ++i) {
+            shiftTwoInts(ints1, ints2, ints3, ints4, SIZE);
+        }
+    }
+
+    private static final int ITERATIONS = 20000;
+
+    private interface Loop {
+        void time(int count);
+    }
+
+    private static void run(String name, Loop loop) {
+        loop.time(ITERATIONS / 10);  // Warm up.
+        long start = System.nanoTime();
+        loop.time(ITERATIONS);
+        long end = System.nanoTime();
+        System.out.println("LoopUnswitchingBenchmark." + name + ": " +
+            ((end - start) / ITERATIONS) + "ns per loop");
+    }
+
+    public static void main(String[] args) {
+        LoopUnswitchingBenchmark b = new LoopUnswitchingBenchmark();
+        run("AddOrSubInts", b::timeAddOrSubInts);
+        run("AddOrSubIntsScalar", b::timeAddOrSubIntsScalar);
+        run("ScaleOrAddFloats", b::timeScaleOrAddFloats);
+        run("SumOrSumSquaresInts", b::timeSumOrSumSquaresInts);
+        run("ShiftTwoInts", b::timeShiftTwoInts);
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Loops whose branches almost always go the same way, and one whose branch is unpredictable.
+// The methods are first run on skewed data, so that baseline code records skewed profiles
+// before the JIT compiles them optimized.
+public class SkewedBranchesBenchmark {
+    private static final int SIZE = 4096;
+
+    private final int[] values = new int[SIZE];
+    private final int[] randomValues = new int[SIZE];
+
+    private static long sink;
+
+    public SkewedBranchesBenchmark() {
+        int seed = 42;
+        for (int i = 0; i < SIZE; ++i) {
+            // One value in 1024 is negative, and one in 1024 is larger than 1000.
+            if (i % 1024 == 1) {
+                values[i] = -i;
+            } else if (i % 1024 == 513) {
+                values[i] = 1000 + i;
+            } else {
+                values[i] = i % 1000;
+            }
+            seed = seed * 1103515245 + 12345;
+            randomValues[i] = (seed >>> 8) % 2000 - 1000;
+        }
+    }
+
+    // Branch almost never taken, which the select generator would turn into a select.
+    private static int sumClamped(int[] a, int max) {
+        int sum = 0;
+        for (int i = 0; i < a.length; ++i) {
+            int x = a[i];
+            sum += (x > max) ? max : x;
+        }
+        return sum;
+    }
+
+    // Unpredictable branch with a few instructions on each side.
+    private static int sumMixed(int[] a) {
+        int sum = 0;
+        for (int i = 0; i < a.length; ++i) {
+            int x = a[i];
+            int y;
+            if (x < 0) {
+                y = (x * 3) ^ 5;
+            } else {
+                y = (x >> 1) + 7;
+            }
+            sum += y;
+        }
+        return sum;
+    }
+
+    // Likely path on the true successor of the If, which the layout makes fall through.
+    private static int countInRange(int[] a, int low, int high) {
+        int count = 0;
+        for (int i = 0; i < a.length; ++i) {
+            int x = a[i];
+            if (x >= low) {
+                count += x & 1;
+            } else {
+                count -= reportOutOfRange(x, low, high);
+            }
+        }
+        return count;
+    }
+
+    // Large method called on the rare path: it should not take the inlining budget of the loop.
+    private static int reportOutOfRange(int x, int low, int high) {
+        int distance = (x < low) ? low - x : x - high;
+        String message = "Value " + x + " is " + distance + " out of [" + low + ", " + high + "]";
+        if (message.length() > 100) {
+            throw new IllegalStateException(message);
+        }
+        return message.length() & 1;
+    }
+
+    public void timeSumClamped(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink += sumClamped(values, 1000);
+        }
+    }
+
+    public void timeSumMixed(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink += sumMixed(randomValues);
+        }
+    }
+
+    public void timeCountInRange(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink += countInRange(values, 0, 1000);
+        }
+    }
+
+    private static final int ITERATIONS = 20000;
+
+    private interface Loop {
+        void time(int count);
+    }
+
+    private static void run(String name, Loop loop) {
+        loop.time(ITERATIONS / 10);  // Warm up, and profile the branches.
+        long start = System.nanoTime();
+        loop.time(ITERATIONS);
+        long end = System.nanoTime();
+        System.out.println("SkewedBranchesBenchmark." + name + ": " +
+            ((end - start) / ITERATIONS) + "ns per loop");
+    }
+
+    public static void main(String[] args) {
+        SkewedBranchesBenchmark b = new SkewedBranchesBenchmark();
+        run("SumClamped", b::timeSumClamped);
+        run("SumMixed", b::timeSumMixed);
+        run("CountInRange", b::timeCountInRange);
+    }
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Loops the loop optimizer vectorizes, one per kind of vector operation. The arrays fit in the
+// L2 cache, so that the loops measure the vector code rather than the memory bandwidth.
+public class VectorLoopsBenchmark {
+    private static final int SIZE = 4096;
+
+    private final byte[] bytes1 = new byte[SIZE];
+    private final byte[] bytes2 = new byte[SIZE];
+    private final short[] shorts1 = new short[SIZE];
+    private final short[] shorts2 = new short[SIZE];
+    private final char[] chars = new char[SIZE];
+    private final int[] ints1 = new int[SIZE];
+    private final int[] ints2 = new int[SIZE];
+    private final long[] longs = new long[SIZE];
+    private final float[] floats1 = new float[SIZE];
+    private final float[] floats2 = new float[SIZE];
+    private final double[] doubles1 = new double[SIZE];
+    private final double[] doubles2 = new double[SIZE];
+
+    private static long sink;
+
+    public VectorLoopsBenchmark() {
+        for (int i = 0; i < SIZE; ++i) {
+            bytes1[i] = (byte) (i * 7);
+            bytes2[i] = (byte) (i * 13 + 5);
+            shorts1[i] = (short) (i * 31);
+            shorts2[i] = (short) (i * 17 - 3);
+            chars[i] = (char) (i * 11);
+            ints1[i] = i * 101;
+            ints2[i] = i - SIZE / 2;
+            longs[i] = i * 1000003L;
+            floats1[i] = i * 0.5f;
+            floats2[i] = SIZE - i;
+            doubles1[i] = i * 0.25;
+            doubles2[i] = i + 1.0;
+        }
+    }
+
+    private static void addBytes(byte[] a, byte[] b) {
+        for (int i = 0; i < a.length; ++i) {
+            a[i] += b[i];
+        }
+    }
+
+    private static void averageChars(char[] a, char[] b) {
+        for (int i = 0; i < a.length; ++i) {
+            a[i] = (char) ((a[i] + b[i] + 1) >> 1);
+        }
+    }
+
+    private static void mulShorts(short[] a, short[] b) {
+        for (int i = 0; i < a.length; ++i) {
+            a[i] = (short) (a[i] * b[i]);
+        }
+    }
+
+    private static void shiftInts(int[] a, int[] b) {
+        for (int i = 0; i < a.length; ++i) {
+            a[i] = (b[i] << 3) ^ (b[i] >>> 5);
+        }
+    }
+
+    private static void minMaxInts(int[] a, int[] b) {
+        for (int i = 0; i < a.length; ++i) {
+            a[i] = Math.max(Math.min(a[i], b[i]), -b[i]);
+        }
+    }
+
+    private static void addLongs(long[] a, long x) {
+        for (int i = 0; i < a.length; ++i) {
+            a[i] += x;
+        }
+    }
+
+    private static void saxpy(float[] a, float[] b, float x) {
+        for (int i = 0; i < a.length; ++i) {
+            a[i] += x * b[i];
+        }
+    }
+
+    private static void divDoubles(double[] a, double[] b) {
+        for (int i = 0; i < a.length; ++i) {
+            a[i] = a[i] / b[i];
+        }
+    }
+
+    private static void intsToFloats(float[] a, int[] b) {
+        for (int i = 0; i < a.length; ++i) {
+            a[i] = (float) b[i];
+        }
+    }
+
+    private static int sumInts(int[] a) {
+        int sum = 0;
+        for (int i = 0; i < a.length; ++i) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    private static long sumLongs(long[] a) {
+        long sum = 0;
+        for (int i = 0; i < a.length; ++i) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    private static int sadBytes(byte[] a, byte[] b) {
+        int sad = 0;
+        for (int i = 0; i < a.length; ++i) {
+            sad += Math.abs(a[i] - b[i]);
+        }
+        return sad;
+    }
+
+    private static int dotProductShorts(short[] a, short[] b) {
+        int sum = 0;
+        for (int i = 0; i < a.length; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    public void timeAddBytes(int count) {
+        for (int i = 0; i < count; ++i) {
+            addBytes(bytes1, bytes2);
+        }
+    }
+
+    public void timeAverageChars(int count) {
+        for (int i = 0; i < count; ++i) {
+            averageChars(chars, chars);
+        }
+    }
+
+    public void timeMulShorts(int count) {
+        for (int i = 0; i < count; ++i) {
+            mulShorts(shorts1, shorts2);
+        }
+    }
+
+    public void timeShiftInts(int count) {
+        for (int i = 0; i < count; ++i) {
+            shiftInts(ints1, ints2);
+        }
+    }
+
+    public void timeMinMaxInts(int count) {
+        for (int i = 0; i < count; ++i) {
+            minMaxInts(ints1, ints2);
+        }
+    }
+
+    public void timeAddLongs(int count) {
+        for (int i = 0; i < count; ++i) {
+            addLongs(longs, i);
+        }
+    }
+
+    public void timeSaxpy(int count) {
+        for (int i = 0; i < count; ++i) {
+            saxpy(floats1, floats2, 1.0001f);
+        }
+    }
+
+    public void timeDivDoubles(int count) {
+        for (int i = 0; i < count; ++i) {
+            divDoubles(doubles1, doubles2);
+        }
+    }
+
+    public void timeIntsToFloats(int count) {
+        for (int i = 0; i < count; ++i) {
+            intsToFloats(floats1, ints2);
+        }
+    }
+
+    public void timeSumInts(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink += sumInts(ints1);
+        }
+    }
+
+    public void timeSumLongs(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink += sumLongs(longs);
+        }
+    }
+
+    public void timeSadBytes(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink += sadBytes(bytes1, bytes2);
+        }
+    }
+
+    public void timeDotProductShorts(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink += dotProductShorts(shorts1, shorts2);
+        }
+    }
+
+    private static final int ITERATIONS = 20000;
+
+    private interface Loop {
+        void time(int count);
+    }
+
+    private static void run(String name, Loop loop) {
+        loop.time(ITERATIONS / 10);  // Warm up.
+        long start = System.nanoTime();
+        loop.time(ITERATIONS);
+        long end = System.nanoTime();
+        System.out.println("VectorLoopsBenchmark." + name + ": " +
+            ((end - start) / ITERATIONS) + "ns per loop");
+    }
+
+    public static void main(String[] args) {
+        VectorLoopsBenchmark b = new VectorLoopsBenchmark();
+        run("AddBytes", b::timeAddBytes);
+        run("AverageChars", b::timeAverageChars);
+        run("MulShorts", b::timeMulShorts);
+        run("ShiftInts", b::timeShiftInts);
+        run("MinMaxInts", b::timeMinMaxInts);
+        run("AddLongs", b::timeAddLongs);
+        run("Saxpy", b::timeSaxpy);
+        run("DivDoubles", b::timeDivDoubles);
+        run("IntsToFloats", b::timeIntsToFloats);
+        run("SumInts", b::timeSumInts);
+        run("SumLongs", b::timeSumLongs);
+        run("SadBytes", b::timeSadBytes);
+        run("DotProductShorts", b::timeDotProductShorts);
+    }
+}
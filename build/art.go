@@ -76,6 +76,10 @@ func globalFlags(ctx android.LoadHookContext) ([]string, []string) {
 		cflags = append(cflags, "-DART_USE_GENERATIONAL_CC=1")
 	}
 
+	if ctx.Config().IsEnvTrue("ART_USE_MARK_COMPACT") {
+		cflags = append(cflags, "-DART_USE_MARK_COMPACT=1")
+	}
+
 	cdexLevel := ctx.Config().GetenvWithDefault("ART_DEFAULT_COMPACT_DEX_LEVEL", "fast")
 	cflags = append(cflags, "-DART_DEFAULT_COMPACT_DEX_LEVEL="+cdexLevel)
 
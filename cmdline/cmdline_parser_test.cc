@@ -480,6 +480,7 @@ TEST_F(CmdlineParserTest, TestJitOptions) {
   }
   {
     EXPECT_SINGLE_PARSE_VALUE(12345u, "-Xjitthreshold:12345", M::JITOptimizeThreshold);
+    EXPECT_SINGLE_PARSE_VALUE(123456u, "-Xjitosrthreshold:123456", M::JITOsrThreshold);
   }
 }  // TEST_F
 
@@ -525,6 +525,8 @@ static gc::CollectorType ParseCollectorType(const std::string& option) {
     return gc::kCollectorTypeCMS;
   } else if (option == "SS") {
     return gc::kCollectorTypeSS;
+  } else if (option == "MC") {
+    return gc::kCollectorTypeMC;
   } else if (option == "CC") {
     return gc::kCollectorTypeCC;
   } else {
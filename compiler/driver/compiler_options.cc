@@ -43,6 +43,8 @@ CompilerOptions::CompilerOptions()
       large_method_threshold_(kDefaultLargeMethodThreshold),
       num_dex_methods_threshold_(kDefaultNumDexMethodsThreshold),
       inline_max_code_units_(kUnsetInlineMaxCodeUnits),
+      pass_time_budget_ms_(0u),
+      exhaust_pass_time_budget_for_testing_(false),
       instruction_set_(kRuntimeISA == InstructionSet::kArm ? InstructionSet::kThumb2 : kRuntimeISA),
       instruction_set_features_(nullptr),
       no_inline_from_(),
@@ -78,6 +80,7 @@ CompilerOptions::CompilerOptions()
       crash_on_linkage_violation_(false),
       deduplicate_code_(true),
       count_hotness_in_compiled_code_(false),
+      enable_partial_lse_(false),
       resolve_startup_const_strings_(false),
       initialize_app_image_classes_(false),
       check_profiled_methods_(ProfileMethodsCheck::kNone),
@@ -123,8 +126,11 @@ bool CompilerOptions::ParseRegisterAllocationStrategy(const std::string& option,
     register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLinearScan;
   } else if (option == "graph-color") {
     register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorGraphColor;
+  } else if (option == "loop-split") {
+    register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLoopSplit;
   } else {
-    *error_msg = "Unrecognized register allocation strategy. Try linear-scan, or graph-color.";
+    *error_msg = "Unrecognized register allocation strategy. "
+                 "Try linear-scan, graph-color, or loop-split.";
     return false;
   }
   return true;
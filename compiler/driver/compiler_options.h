@@ -149,6 +149,16 @@ class CompilerOptions final {
     inline_max_code_units_ = units;
   }
 
+  // The compile time an optimization pass may take on a method, or 0 for no limit.
+  size_t GetPassTimeBudgetMs() const {
+    return pass_time_budget_ms_;
+  }
+
+  // Whether every method goes over the pass time budget with its first pass, for testing.
+  bool IsPassTimeBudgetExhaustedForTesting() const {
+    return exhaust_pass_time_budget_for_testing_;
+  }
+
   double GetTopKProfileThreshold() const {
     return top_k_profile_threshold_;
   }
@@ -358,6 +368,10 @@ class CompilerOptions final {
     return count_hotness_in_compiled_code_;
   }
 
+  bool IsPartialLSEEnabled() const {
+    return enable_partial_lse_;
+  }
+
   bool ResolveStartupConstStrings() const {
     return resolve_startup_const_strings_;
   }
@@ -392,6 +406,8 @@ class CompilerOptions final {
   size_t large_method_threshold_;
   size_t num_dex_methods_threshold_;
   size_t inline_max_code_units_;
+  size_t pass_time_budget_ms_;
+  bool exhaust_pass_time_budget_for_testing_;
 
   InstructionSet instruction_set_;
   std::unique_ptr<const InstructionSetFeatures> instruction_set_features_;
@@ -467,6 +483,9 @@ class CompilerOptions final {
   // won't be atomic for performance reasons, so we accept races, just like in interpreter.
   bool count_hotness_in_compiled_code_;
 
+  // Whether load-store elimination also removes allocations which only escape on some paths.
+  bool enable_partial_lse_;
+
   // Whether we eagerly resolve all of the const strings that are loaded from startup methods in the
   // profile.
   bool resolve_startup_const_strings_;
@@ -60,6 +60,10 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   map.AssignIfExists(Base::LargeMethodMaxThreshold, &options->large_method_threshold_);
   map.AssignIfExists(Base::NumDexMethodsThreshold, &options->num_dex_methods_threshold_);
   map.AssignIfExists(Base::InlineMaxCodeUnitsThreshold, &options->inline_max_code_units_);
+  map.AssignIfExists(Base::PassTimeBudgetMs, &options->pass_time_budget_ms_);
+  if (map.Exists(Base::ExhaustPassTimeBudgetForTesting)) {
+    options->exhaust_pass_time_budget_for_testing_ = true;
+  }
   map.AssignIfExists(Base::GenerateDebugInfo, &options->generate_debug_info_);
   map.AssignIfExists(Base::GenerateMiniDebugInfo, &options->generate_mini_debug_info_);
   map.AssignIfExists(Base::GenerateBuildID, &options->generate_build_id_);
@@ -91,6 +95,9 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   if (map.Exists(Base::CountHotnessInCompiledCode)) {
     options->count_hotness_in_compiled_code_ = true;
   }
+  if (map.Exists(Base::EnablePartialLSE)) {
+    options->enable_partial_lse_ = true;
+  }
   map.AssignIfExists(Base::ResolveStartupConstStrings, &options->resolve_startup_const_strings_);
   map.AssignIfExists(Base::InitializeAppImageClasses, &options->initialize_app_image_classes_);
   if (map.Exists(Base::CheckProfiledMethods)) {
@@ -148,6 +155,18 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
                     "A zero value will disable inlining. Honored only by Optimizing. Has priority\n"
                     "over the --compiler-filter option. Intended for development/experimental use.")
           .IntoKey(Map::InlineMaxCodeUnitsThreshold)
+      .Define("--pass-time-budget-ms=_")
+          .template WithType<unsigned int>()
+          .WithHelp("the compile time in milliseconds an optimization pass may take on a method.\n"
+                    "Once a pass takes longer, the remaining optimization passes are skipped for\n"
+                    "the method, except those the code generators rely on. This bounds the\n"
+                    "compile time of huge methods. Zero, the default, disables the budget.\n"
+                    "Honored only by Optimizing.")
+          .IntoKey(Map::PassTimeBudgetMs)
+      .Define("--exhaust-pass-time-budget-for-testing")
+          .WithHelp("treat the first optimization pass run on each method as having gone over\n"
+                    "the pass time budget. Used for testing.")
+          .IntoKey(Map::ExhaustPassTimeBudgetForTesting)
 
       .Define({"--generate-debug-info", "-g", "--no-generate-debug-info"})
           .WithValues({true, true, false})
@@ -178,6 +197,11 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
       .Define({"--count-hotness-in-compiled-code"})
           .IntoKey(Map::CountHotnessInCompiledCode)
 
+      .Define({"--enable-partial-lse"})
+          .WithHelp("Let load-store elimination remove the allocations which only escape on\n"
+                    "some paths, materializing them where they escape.")
+          .IntoKey(Map::EnablePartialLSE)
+
       .Define({"--check-profiled-methods=_"})
           .template WithType<ProfileMethodsCheck>()
           .WithValueMap({{"log", ProfileMethodsCheck::kLog},
@@ -21,7 +21,10 @@
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "induction_var_range.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
 #include "nodes.h"
+#include "runtime.h"
 #include "side_effects_analysis.h"
 
 namespace art {
@@ -490,6 +493,16 @@ class MonotonicValueRange : public ValueRange {
   DISALLOW_COPY_AND_ASSIGN(MonotonicValueRange);
 };
 
+// Returns whether code previously JIT-compiled for the method of `graph` deoptimized
+// because of a failed dynamic bce of the given `kind`.
+static bool HasFailedSpeculation(HGraph* graph, DeoptimizationKind kind) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr || graph->GetArtMethod() == nullptr) {
+    return false;
+  }
+  return jit->GetCodeCache()->HasFailedSpeculation(graph->GetArtMethod(), dex::kDexNoIndex, kind);
+}
+
 class BCEVisitor : public HGraphVisitor {
  public:
   // The least number of bounds checks that should be eliminated by triggering
@@ -525,6 +538,16 @@ class BCEVisitor : public HGraphVisitor {
                          allocator_.Adapter(kArenaAllocBoundsCheckElimination)),
         finite_loop_(allocator_.Adapter(kArenaAllocBoundsCheckElimination)),
         has_dom_based_dynamic_bce_(false),
+        // We should never deoptimize from an osr method, otherwise we might wrongly optimize
+        // code dominated by the deoptimization. We also do not deoptimize again if the compiled
+        // code of the method already deoptimized because of dynamic bce.
+        allow_dynamic_loop_bce_(
+            !graph->IsCompilingOsr() &&
+            !HasFailedSpeculation(graph, DeoptimizationKind::kLoopBoundsBCE) &&
+            !HasFailedSpeculation(graph, DeoptimizationKind::kLoopNullBCE)),
+        allow_dynamic_block_bce_(
+            !graph->IsCompilingOsr() &&
+            !HasFailedSpeculation(graph, DeoptimizationKind::kBlockBCE)),
         initial_block_size_(graph->GetBlocks().size()),
         side_effects_(side_effects),
         induction_range_(induction_analysis),
@@ -548,9 +571,7 @@ class BCEVisitor : public HGraphVisitor {
       instruction->Accept(this);
       instruction = next_;
     }
-    // We should never deoptimize from an osr method, otherwise we might wrongly optimize
-    // code dominated by the deoptimization.
-    if (!GetGraph()->IsCompilingOsr()) {
+    if (allow_dynamic_block_bce_) {
       AddComparesWithDeoptimization(block);
     }
   }
@@ -1668,9 +1689,7 @@ class BCEVisitor : public HGraphVisitor {
       if (loop->IsIrreducible()) {
         return false;
       }
-      // We should never deoptimize from an osr method, otherwise we might wrongly optimize
-      // code dominated by the deoptimization.
-      if (GetGraph()->IsCompilingOsr()) {
+      if (!allow_dynamic_loop_bce_) {
         return false;
       }
       // A try boundary preheader is hard to handle.
@@ -2036,6 +2055,10 @@ class BCEVisitor : public HGraphVisitor {
   // Flag that denotes whether dominator-based dynamic elimination has occurred.
   bool has_dom_based_dynamic_bce_;
 
+  // Whether we can deoptimize for loop-based and dominator-based dynamic bce.
+  const bool allow_dynamic_loop_bce_;
+  const bool allow_dynamic_block_bce_;
+
   // Initial number of blocks.
   uint32_t initial_block_size_;
 
@@ -39,6 +39,7 @@
 #include "base/leb128.h"
 #include "class_linker.h"
 #include "class_root-inl.h"
+#include "code_generator_utils.h"
 #include "compiled_method.h"
 #include "dex/bytecode_utils.h"
 #include "dex/code_item_accessors-inl.h"
@@ -47,6 +48,7 @@
 #include "gc/space/image_space.h"
 #include "intern_table.h"
 #include "intrinsics.h"
+#include "jit/profiling_info.h"
 #include "mirror/array-inl.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/object_reference.h"
@@ -309,6 +311,19 @@ bool CodeGenerator::GoesToNextBlock(HBasicBlock* current, HBasicBlock* next) con
   return GetNextBlockToEmit() == FirstNonEmptyBlock(next);
 }
 
+BranchCache* CodeGenerator::GetBranchCacheToUpdate(HIf* if_instr) const {
+  ProfilingInfo* info = GetGraph()->GetProfilingInfo();
+  if (!GetGraph()->IsCompilingBaseline() || info == nullptr) {
+    return nullptr;
+  }
+  // The condition must be in a register, see `PrepareForRegisterAllocation::VisitCondition`.
+  HInstruction* condition = if_instr->InputAt(0);
+  if (condition->IsConstant() || !IsBooleanValueOrMaterializedCondition(condition)) {
+    return nullptr;
+  }
+  return info->GetBranchCache(if_instr->GetDexPc());
+}
+
 HBasicBlock* CodeGenerator::GetNextBlockToEmit() const {
   for (size_t i = current_block_index_ + 1; i < block_order_->size(); ++i) {
     HBasicBlock* block = (*block_order_)[i];
@@ -60,6 +60,7 @@ static constexpr ReadBarrierOption kCompilerReadBarrierOption =
     kEmitCompilerReadBarrier ? kWithReadBarrier : kWithoutReadBarrier;
 
 class Assembler;
+class BranchCache;
 class CodeGenerator;
 class CompilerOptions;
 class StackMapStream;
@@ -200,6 +201,10 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   HBasicBlock* FirstNonEmptyBlock(HBasicBlock* block) const;
   bool GoesToNextBlock(HBasicBlock* current, HBasicBlock* next) const;
 
+  // Returns the branch cache baseline code updates with the value of the condition of
+  // `if_instr`, or null if the branch is not profiled.
+  BranchCache* GetBranchCacheToUpdate(HIf* if_instr) const;
+
   size_t GetStackSlotOfParameter(HParameterValue* parameter) const {
     // Note that this follows the current calling convention.
     return GetFrameSize()
@@ -3720,6 +3720,27 @@ void LocationsBuilderARM64::VisitIf(HIf* if_instr) {
 }
 
 void InstructionCodeGeneratorARM64::VisitIf(HIf* if_instr) {
+  BranchCache* cache = codegen_->GetBranchCacheToUpdate(if_instr);
+  if (cache != nullptr) {
+    // Increment the count at `FalseOffset()` + 2 * condition, unless it is saturated.
+    static_assert(BranchCache::TrueOffset().Int32Value() ==
+                      BranchCache::FalseOffset().Int32Value() + 2,
+                  "Unexpected offsets for BranchCache");
+    uint64_t address =
+        reinterpret_cast64<uint64_t>(cache) + BranchCache::FalseOffset().Int32Value();
+    Register condition = InputRegisterAt(if_instr, 0).X();
+    UseScratchRegisterScope temps(GetVIXLAssembler());
+    Register temp = temps.AcquireX();
+    Register counter = temps.AcquireW();
+    vixl::aarch64::Label done;
+    __ Mov(temp, address);
+    __ Ldrh(counter, MemOperand(temp, condition, LSL, 1));
+    __ Add(counter, counter, 1);
+    __ Tbnz(counter, 16, &done);
+    __ Strh(counter, MemOperand(temp, condition, LSL, 1));
+    __ Bind(&done);
+  }
+
   HBasicBlock* true_successor = if_instr->IfTrueSuccessor();
   HBasicBlock* false_successor = if_instr->IfFalseSuccessor();
   vixl::aarch64::Label* true_target = codegen_->GetLabelOf(true_successor);
@@ -4468,12 +4489,17 @@ void CodeGeneratorARM64::MaybeGenerateInlineCacheCheck(HInstruction* instruction
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint64_t address = reinterpret_cast64<uint64_t>(cache);
-    vixl::aarch64::Label done;
+    vixl::aarch64::Label done, miss;
     __ Mov(x8, address);
     __ Ldr(x9, MemOperand(x8, InlineCache::ClassesOffset().Int32Value()));
-    // Fast path for a monomorphic cache.
+    // Fast path for a monomorphic cache. The runtime counts the receivers of the other paths.
     __ Cmp(klass, x9);
-    __ B(eq, &done);
+    __ B(ne, &miss);
+    __ Ldr(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+    __ Add(w9, w9, 1);
+    __ Str(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+    __ B(&done);
+    __ Bind(&miss);
     InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
     __ Bind(&done);
   }
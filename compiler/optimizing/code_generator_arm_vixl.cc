@@ -2860,9 +2860,35 @@ void LocationsBuilderARMVIXL::VisitIf(HIf* if_instr) {
   if (IsBooleanValueOrMaterializedCondition(if_instr->InputAt(0))) {
     locations->SetInAt(0, Location::RequiresRegister());
   }
+  if (codegen_->GetBranchCacheToUpdate(if_instr) != nullptr) {
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorARMVIXL::VisitIf(HIf* if_instr) {
+  BranchCache* cache = codegen_->GetBranchCacheToUpdate(if_instr);
+  if (cache != nullptr) {
+    // Increment the count at `FalseOffset()` + 2 * condition, unless it is saturated.
+    static_assert(BranchCache::TrueOffset().Int32Value() ==
+                      BranchCache::FalseOffset().Int32Value() + 2,
+                  "Unexpected offsets for BranchCache");
+    uint32_t address =
+        reinterpret_cast32<uint32_t>(cache) + BranchCache::FalseOffset().Int32Value();
+    vixl32::Register condition = InputRegisterAt(if_instr, 0);
+    vixl32::Register temp = RegisterFrom(if_instr->GetLocations()->GetTemp(0));
+    UseScratchRegisterScope temps(GetVIXLAssembler());
+    vixl32::Register counter = temps.Acquire();
+    vixl32::Label done;
+    __ Mov(temp, address);
+    __ Add(temp, temp, Operand(condition, ShiftType::LSL, 1));
+    __ Ldrh(counter, MemOperand(temp));
+    __ Add(counter, counter, 1);
+    __ Tst(counter, 1 << 16);
+    __ B(ne, &done, /* is_far_target= */ false);
+    __ Strh(counter, MemOperand(temp));
+    __ Bind(&done);
+  }
+
   HBasicBlock* true_successor = if_instr->IfTrueSuccessor();
   HBasicBlock* false_successor = if_instr->IfFalseSuccessor();
   vixl32::Label* true_target = codegen_->GoesToNextBlock(if_instr->GetBlock(), true_successor) ?
@@ -3518,14 +3544,19 @@ void CodeGeneratorARMVIXL::MaybeGenerateInlineCacheCheck(HInstruction* instructi
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint32_t address = reinterpret_cast32<uint32_t>(cache);
-    vixl32::Label done;
+    vixl32::Label done, miss;
     UseScratchRegisterScope temps(GetVIXLAssembler());
     temps.Exclude(ip);
     __ Mov(r4, address);
     __ Ldr(ip, MemOperand(r4, InlineCache::ClassesOffset().Int32Value()));
-    // Fast path for a monomorphic cache.
+    // Fast path for a monomorphic cache. The runtime counts the receivers of the other paths.
     __ Cmp(klass, ip);
-    __ B(eq, &done, /* is_far_target= */ false);
+    __ B(ne, &miss, /* is_far_target= */ false);
+    __ Ldr(ip, MemOperand(r4, InlineCache::CountsOffset().Int32Value()));
+    __ Add(ip, ip, 1);
+    __ Str(ip, MemOperand(r4, InlineCache::CountsOffset().Int32Value()));
+    __ B(&done);
+    __ Bind(&miss);
     InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
     __ Bind(&done);
   }
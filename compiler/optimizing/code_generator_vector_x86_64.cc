@@ -25,6 +25,12 @@ namespace x86_64 {
 // NOLINT on __ macro to suppress wrong warning/fix (misc-macro-parentheses) from clang-tidy.
 #define __ down_cast<X86_64Assembler*>(GetAssembler())->  // NOLINT
 
+// Returns whether the operation works on the full 256-bit YMM registers, which the loop
+// optimizer only vectorizes for when the CPU supports AVX2.
+static bool IsYmmOperation(HVecOperation* instruction) {
+  return instruction->GetVectorNumberOfBytes() == 32u;
+}
+
 void LocationsBuilderX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
   HInstruction* input = instruction->InputAt(0);
@@ -65,6 +71,50 @@ void InstructionCodeGeneratorX86_64::VisitVecReplicateScalar(HVecReplicateScalar
     return;
   }
 
+  if (IsYmmOperation(instruction)) {
+    // Broadcast from the lower half, the VEX encoded broadcasts fill all of the YMM register.
+    YmmRegister ymm_dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastb(ymm_dst, dst);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastw(ymm_dst, dst);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastd(ymm_dst, dst);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ true);
+        __ vpbroadcastq(ymm_dst, dst);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastss(ymm_dst, dst);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastsd(ymm_dst, dst);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
+
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -143,18 +193,19 @@ void InstructionCodeGeneratorX86_64::VisitVecExtractScalar(HVecExtractScalar* in
     case DataType::Type::kInt16:  // TODO: up to here, and?
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
       UNREACHABLE();
+    // The scalar is in the lowest lane, whatever the vector size.
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmOperation(instruction) ? 8u : 4u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ false);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmOperation(instruction) ? 4u : 2u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ true);
       break;
     case DataType::Type::kFloat32:
     case DataType::Type::kFloat64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 4u);
+      DCHECK_LE(instruction->GetVectorLength(), 8u);
       DCHECK(locations->InAt(0).Equals(locations->Out()));  // no code required
       break;
     default:
@@ -187,8 +238,9 @@ static void CreateVecUnOpLocations(ArenaAllocator* allocator, HVecUnaryOperation
 
 void LocationsBuilderX86_64::VisitVecReduce(HVecReduce* instruction) {
   CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
-  // Long reduction or min/max require a temporary.
+  // Long reduction, the reduction of a YMM register or min/max require a temporary.
   if (instruction->GetPackedType() == DataType::Type::kInt64 ||
+      IsYmmOperation(instruction) ||
       instruction->GetReductionKind() == HVecReduce::kMin ||
       instruction->GetReductionKind() == HVecReduce::kMax) {
     instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
@@ -199,6 +251,31 @@ void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmOperation(instruction)) {
+    // Add the upper half to the lower half and reduce the resulting XMM register below.
+    DCHECK_EQ(instruction->GetReductionKind(), HVecReduce::kSum);
+    XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+    __ vextracti128(tmp, locations->InAt(0).AsFpuRegister<YmmRegister>(), Immediate(1));
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpaddd(dst, src, tmp);
+        __ phaddd(dst, dst);
+        __ phaddd(dst, dst);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpaddq(dst, src, tmp);
+        __ movaps(tmp, dst);
+        __ punpckhqdq(tmp, tmp);
+        __ paddq(dst, tmp);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32:
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -248,6 +325,12 @@ void InstructionCodeGeneratorX86_64::VisitVecCnv(HVecCnv* instruction) {
   DataType::Type from = instruction->GetInputType();
   DataType::Type to = instruction->GetResultType();
   if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
+    if (IsYmmOperation(instruction)) {
+      DCHECK_EQ(8u, instruction->GetVectorLength());
+      __ vcvtdq2ps(locations->Out().AsFpuRegister<YmmRegister>(),
+                   locations->InAt(0).AsFpuRegister<YmmRegister>());
+      return;
+    }
     DCHECK_EQ(4u, instruction->GetVectorLength());
     __ cvtdq2ps(dst, src);
   } else {
@@ -261,6 +344,48 @@ void LocationsBuilderX86_64::VisitVecNeg(HVecNeg* instruction) {
 
 void InstructionCodeGeneratorX86_64::VisitVecNeg(HVecNeg* instruction) {
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpxor(dst, dst, dst);
+        __ vpsubb(dst, dst, src);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpxor(dst, dst, dst);
+        __ vpsubw(dst, dst, src);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpxor(dst, dst, dst);
+        __ vpsubd(dst, dst, src);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpxor(dst, dst, dst);
+        __ vpsubq(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vxorps(dst, dst, dst);
+        __ vsubps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vxorpd(dst, dst, dst);
+        __ vsubpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
@@ -312,6 +437,32 @@ void LocationsBuilderX86_64::VisitVecAbs(HVecAbs* instruction) {
 
 void InstructionCodeGeneratorX86_64::VisitVecAbs(HVecAbs* instruction) {
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpabsd(dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpcmpeqb(dst, dst, dst);  // all ones
+        __ vpsrld(dst, dst, Immediate(1));
+        __ vandps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpcmpeqb(dst, dst, dst);  // all ones
+        __ vpsrlq(dst, dst, Immediate(1));
+        __ vandpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
@@ -353,6 +504,44 @@ void LocationsBuilderX86_64::VisitVecNot(HVecNot* instruction) {
 
 void InstructionCodeGeneratorX86_64::VisitVecNot(HVecNot* instruction) {
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool: {  // special case boolean-not
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        YmmRegister tmp = locations->GetTemp(0).AsFpuRegister<YmmRegister>();
+        __ vpxor(dst, dst, dst);
+        __ vpcmpeqb(tmp, tmp, tmp);  // all ones
+        __ vpsubb(dst, dst, tmp);  // 32 x one
+        __ vpxor(dst, dst, src);
+        break;
+      }
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpcmpeqb(dst, dst, dst);  // all ones
+        __ vpxor(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpcmpeqb(dst, dst, dst);  // all ones
+        __ vxorps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpcmpeqb(dst, dst, dst);  // all ones
+        __ vxorpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
@@ -448,6 +637,43 @@ void LocationsBuilderX86_64::VisitVecAdd(HVecAdd* instruction) {
 void InstructionCodeGeneratorX86_64::VisitVecAdd(HVecAdd* instruction) {
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpaddb(dst, other_src, src);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpaddw(dst, other_src, src);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpaddd(dst, other_src, src);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpaddq(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vaddps(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vaddpd(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -491,6 +717,33 @@ void LocationsBuilderX86_64::VisitVecSaturationAdd(HVecSaturationAdd* instructio
 
 void InstructionCodeGeneratorX86_64::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpaddusb(dst, other_src, src);
+        break;
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpaddsb(dst, other_src, src);
+        break;
+      case DataType::Type::kUint16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpaddusw(dst, other_src, src);
+        break;
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpaddsw(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -523,6 +776,25 @@ void LocationsBuilderX86_64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
 
 void InstructionCodeGeneratorX86_64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpavgb(dst, other_src, src);
+        break;
+      case DataType::Type::kUint16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpavgw(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -555,6 +827,43 @@ void LocationsBuilderX86_64::VisitVecSub(HVecSub* instruction) {
 void InstructionCodeGeneratorX86_64::VisitVecSub(HVecSub* instruction) {
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpsubb(dst, other_src, src);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpsubw(dst, other_src, src);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpsubd(dst, other_src, src);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpsubq(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vsubps(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vsubpd(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -598,6 +907,33 @@ void LocationsBuilderX86_64::VisitVecSaturationSub(HVecSaturationSub* instructio
 
 void InstructionCodeGeneratorX86_64::VisitVecSaturationSub(HVecSaturationSub* instruction) {
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpsubusb(dst, other_src, src);
+        break;
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpsubsb(dst, other_src, src);
+        break;
+      case DataType::Type::kUint16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpsubusw(dst, other_src, src);
+        break;
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpsubsw(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -635,6 +971,34 @@ void LocationsBuilderX86_64::VisitVecMul(HVecMul* instruction) {
 void InstructionCodeGeneratorX86_64::VisitVecMul(HVecMul* instruction) {
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpmullw(dst, other_src, src);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpmulld(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vmulps(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vmulpd(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -674,6 +1038,25 @@ void LocationsBuilderX86_64::VisitVecDiv(HVecDiv* instruction) {
 void InstructionCodeGeneratorX86_64::VisitVecDiv(HVecDiv* instruction) {
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vdivps(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vdivpd(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -699,6 +1082,49 @@ void LocationsBuilderX86_64::VisitVecMin(HVecMin* instruction) {
 
 void InstructionCodeGeneratorX86_64::VisitVecMin(HVecMin* instruction) {
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpminub(dst, other_src, src);
+        break;
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpminsb(dst, other_src, src);
+        break;
+      case DataType::Type::kUint16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpminuw(dst, other_src, src);
+        break;
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpminsw(dst, other_src, src);
+        break;
+      case DataType::Type::kUint32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpminud(dst, other_src, src);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpminsd(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vminps(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vminpd(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -748,6 +1174,49 @@ void LocationsBuilderX86_64::VisitVecMax(HVecMax* instruction) {
 
 void InstructionCodeGeneratorX86_64::VisitVecMax(HVecMax* instruction) {
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpmaxub(dst, other_src, src);
+        break;
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpmaxsb(dst, other_src, src);
+        break;
+      case DataType::Type::kUint16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpmaxuw(dst, other_src, src);
+        break;
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpmaxsw(dst, other_src, src);
+        break;
+      case DataType::Type::kUint32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpmaxud(dst, other_src, src);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpmaxsd(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vmaxps(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vmaxpd(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -802,6 +1271,34 @@ void LocationsBuilderX86_64::VisitVecAnd(HVecAnd* instruction) {
 void InstructionCodeGeneratorX86_64::VisitVecAnd(HVecAnd* instruction) {
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpand(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vandps(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vandpd(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -843,6 +1340,34 @@ void LocationsBuilderX86_64::VisitVecAndNot(HVecAndNot* instruction) {
 void InstructionCodeGeneratorX86_64::VisitVecAndNot(HVecAndNot* instruction) {
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpandn(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vandnps(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vandnpd(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -884,6 +1409,34 @@ void LocationsBuilderX86_64::VisitVecOr(HVecOr* instruction) {
 void InstructionCodeGeneratorX86_64::VisitVecOr(HVecOr* instruction) {
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpor(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vorps(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vorpd(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -925,6 +1478,34 @@ void LocationsBuilderX86_64::VisitVecXor(HVecXor* instruction) {
 void InstructionCodeGeneratorX86_64::VisitVecXor(HVecXor* instruction) {
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    YmmRegister src = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister other_src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpxor(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vxorps(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vxorpd(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -979,6 +1560,30 @@ void LocationsBuilderX86_64::VisitVecShl(HVecShl* instruction) {
 
 void InstructionCodeGeneratorX86_64::VisitVecShl(HVecShl* instruction) {
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
+    YmmRegister src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpsllw(dst, src, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpslld(dst, src, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpsllq(dst, src, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -1008,6 +1613,26 @@ void LocationsBuilderX86_64::VisitVecShr(HVecShr* instruction) {
 
 void InstructionCodeGeneratorX86_64::VisitVecShr(HVecShr* instruction) {
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
+    YmmRegister src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpsraw(dst, src, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpsrad(dst, src, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -1033,6 +1658,30 @@ void LocationsBuilderX86_64::VisitVecUShr(HVecUShr* instruction) {
 
 void InstructionCodeGeneratorX86_64::VisitVecUShr(HVecUShr* instruction) {
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
+    YmmRegister src = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister dst = locations->Out().AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpsrlw(dst, src, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpsrld(dst, src, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpsrlq(dst, src, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
@@ -1094,7 +1743,8 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
 
   DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
 
-  // Zero out all other elements first.
+  // Zero out all other elements first. The VEX encoded xor also zeroes the upper half of
+  // the YMM register, and the scalar moves below preserve it.
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   cpu_has_avx ? __ vxorps(dst, dst, dst) : __ xorps(dst, dst);
 
@@ -1113,19 +1763,19 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmOperation(instruction) ? 8u : 4u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmOperation(instruction) ? 4u : 2u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());  // is 64-bit
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmOperation(instruction) ? 8u : 4u, instruction->GetVectorLength());
       __ movss(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmOperation(instruction) ? 4u : 2u, instruction->GetVectorLength());
       __ movsd(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     default:
@@ -1166,11 +1816,73 @@ void InstructionCodeGeneratorX86_64::VisitVecMultiplyAccumulate(HVecMultiplyAccu
 
 void LocationsBuilderX86_64::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
   CreateVecAccumLocations(GetGraph()->GetAllocator(), instruction);
+  // The sign bias of the operands requires two temporaries.
+  instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
+  instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
-  // TODO: psadbw for unsigned?
-  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  // Only signed bytes are accepted by the loop optimizer, psadbw works on unsigned bytes.
+  // Flipping the sign bit of both operands maps them to unsigned bytes with the same
+  // absolute differences.
+  DCHECK_EQ(DataType::Type::kInt8, instruction->InputAt(1)->AsVecOperation()->GetPackedType());
+  DCHECK_EQ(DataType::Type::kInt8, instruction->InputAt(2)->AsVecOperation()->GetPackedType());
+  __ movl(CpuRegister(TMP), Immediate(0x80808080));
+  if (IsYmmOperation(instruction)) {
+    YmmRegister acc = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister left = locations->InAt(1).AsFpuRegister<YmmRegister>();
+    YmmRegister right = locations->InAt(2).AsFpuRegister<YmmRegister>();
+    YmmRegister bias = locations->GetTemp(0).AsFpuRegister<YmmRegister>();
+    YmmRegister tmp = locations->GetTemp(1).AsFpuRegister<YmmRegister>();
+    __ movd(bias.AsXmmRegister(), CpuRegister(TMP), /*64-bit*/ false);
+    __ vpbroadcastd(bias, bias.AsXmmRegister());
+    __ vpxor(tmp, left, bias);
+    __ vpxor(bias, right, bias);
+    __ vpsadbw(tmp, tmp, bias);
+    switch (instruction->GetPackedType()) {
+      // The byte sums are in the low 16 bits of each quadword. Adding them to 32-bit lanes
+      // spreads the partial sums differently, but the final reduction adds all lanes.
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpaddd(acc, acc, tmp);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpaddq(acc, acc, tmp);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
+  XmmRegister acc = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister left = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister right = locations->InAt(2).AsFpuRegister<XmmRegister>();
+  XmmRegister bias = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  XmmRegister tmp = locations->GetTemp(1).AsFpuRegister<XmmRegister>();
+  __ movd(bias, CpuRegister(TMP), /*64-bit*/ false);
+  __ pshufd(bias, bias, Immediate(0));
+  __ movaps(tmp, left);
+  __ pxor(tmp, bias);
+  __ pxor(bias, right);
+  __ psadbw(tmp, bias);
+  switch (instruction->GetPackedType()) {
+    // See above, the final reduction adds all lanes.
+    case DataType::Type::kInt32:
+      DCHECK_EQ(4u, instruction->GetVectorLength());
+      __ paddd(acc, tmp);
+      break;
+    case DataType::Type::kInt64:
+      DCHECK_EQ(2u, instruction->GetVectorLength());
+      __ paddq(acc, tmp);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
 }
 
 void LocationsBuilderX86_64::VisitVecDotProd(HVecDotProd* instruction) {
@@ -1185,6 +1897,17 @@ void LocationsBuilderX86_64::VisitVecDotProd(HVecDotProd* instruction) {
 void InstructionCodeGeneratorX86_64::VisitVecDotProd(HVecDotProd* instruction) {
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
+  if (IsYmmOperation(instruction)) {
+    DCHECK_EQ(DataType::Type::kInt32, instruction->GetPackedType());
+    DCHECK_EQ(8u, instruction->GetVectorLength());
+    YmmRegister acc = locations->InAt(0).AsFpuRegister<YmmRegister>();
+    YmmRegister tmp = locations->GetTemp(0).AsFpuRegister<YmmRegister>();
+    __ vpmaddwd(tmp,
+                locations->InAt(1).AsFpuRegister<YmmRegister>(),
+                locations->InAt(2).AsFpuRegister<YmmRegister>());
+    __ vpaddd(acc, acc, tmp);
+    return;
+  }
   XmmRegister acc = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister left = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister right = locations->InAt(2).AsFpuRegister<XmmRegister>();
@@ -1257,8 +1980,10 @@ static Address VecAddress(LocationSummary* locations, size_t size, bool is_strin
 
 void LocationsBuilderX86_64::VisitVecLoad(HVecLoad* instruction) {
   CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ true);
-  // String load requires a temporary for the compressed load.
-  if (mirror::kUseStringCompression && instruction->IsStringCharAt()) {
+  // String load requires a temporary for the compressed load, except with AVX2.
+  if (mirror::kUseStringCompression &&
+      instruction->IsStringCharAt() &&
+      !IsYmmOperation(instruction)) {
     instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
   }
 }
@@ -1267,6 +1992,10 @@ void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, instruction->IsStringCharAt());
+  if (IsYmmOperation(instruction)) {
+    GenerateYmmVecLoad(instruction, address);
+    return;
+  }
   XmmRegister reg = locations->Out().AsFpuRegister<XmmRegister>();
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
   switch (instruction->GetPackedType()) {
@@ -1318,6 +2047,55 @@ void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
   }
 }
 
+void InstructionCodeGeneratorX86_64::GenerateYmmVecLoad(HVecLoad* instruction,
+                                                        const Address& address) {
+  LocationSummary* locations = instruction->GetLocations();
+  YmmRegister reg = locations->Out().AsFpuRegister<YmmRegister>();
+  // Unaligned accesses are as fast as aligned ones when the address is aligned.
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt16:  // (short) s.charAt(.) can yield HVecLoad/Int16/StringCharAt.
+    case DataType::Type::kUint16:
+      DCHECK_EQ(16u, instruction->GetVectorLength());
+      // Special handling of compressed/uncompressed string load.
+      if (mirror::kUseStringCompression && instruction->IsStringCharAt()) {
+        NearLabel done, not_compressed;
+        // Test compression bit.
+        static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
+                      "Expecting 0=compressed, 1=uncompressed");
+        uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
+        __ testb(Address(locations->InAt(0).AsRegister<CpuRegister>(), count_offset), Immediate(1));
+        __ j(kNotZero, &not_compressed);
+        // Zero extend 16 compressed bytes into 16 chars.
+        __ vpmovzxbw(reg, VecAddress(locations, 1, instruction->IsStringCharAt()));
+        __ jmp(&done);
+        // Load 16 direct uncompressed chars.
+        __ Bind(&not_compressed);
+        __ vmovdqu(reg, address);
+        __ Bind(&done);
+        return;
+      }
+      FALLTHROUGH_INTENDED;
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ vmovdqu(reg, address);
+      break;
+    case DataType::Type::kFloat32:
+      DCHECK_EQ(8u, instruction->GetVectorLength());
+      __ vmovups(reg, address);
+      break;
+    case DataType::Type::kFloat64:
+      DCHECK_EQ(4u, instruction->GetVectorLength());
+      __ vmovupd(reg, address);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
 void LocationsBuilderX86_64::VisitVecStore(HVecStore* instruction) {
   CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ false);
 }
@@ -1326,6 +2104,33 @@ void InstructionCodeGeneratorX86_64::VisitVecStore(HVecStore* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, /*is_string_char_at*/ false);
+  if (IsYmmOperation(instruction)) {
+    // Unaligned accesses are as fast as aligned ones when the address is aligned.
+    YmmRegister reg = locations->InAt(2).AsFpuRegister<YmmRegister>();
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vmovdqu(address, reg);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vmovups(address, reg);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vmovupd(address, reg);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   XmmRegister reg = locations->InAt(2).AsFpuRegister<XmmRegister>();
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
   switch (instruction->GetPackedType()) {
@@ -2069,12 +2069,32 @@ void InstructionCodeGeneratorX86::GenerateTestAndBranch(HInstruction* instructio
 
 void LocationsBuilderX86::VisitIf(HIf* if_instr) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(if_instr);
-  if (IsBooleanValueOrMaterializedCondition(if_instr->InputAt(0))) {
+  if (codegen_->GetBranchCacheToUpdate(if_instr) != nullptr) {
+    // The condition indexes the counts of the branch cache.
+    locations->SetInAt(0, Location::RequiresRegister());
+  } else if (IsBooleanValueOrMaterializedCondition(if_instr->InputAt(0))) {
     locations->SetInAt(0, Location::Any());
   }
 }
 
 void InstructionCodeGeneratorX86::VisitIf(HIf* if_instr) {
+  BranchCache* cache = codegen_->GetBranchCacheToUpdate(if_instr);
+  if (cache != nullptr) {
+    // Increment the count at `FalseOffset()` + 2 * condition, unless it is saturated.
+    static_assert(BranchCache::TrueOffset().Int32Value() ==
+                      BranchCache::FalseOffset().Int32Value() + 2,
+                  "Unexpected offsets for BranchCache");
+    uint32_t address =
+        reinterpret_cast32<uint32_t>(cache) + BranchCache::FalseOffset().Int32Value();
+    Register condition = if_instr->GetLocations()->InAt(0).AsRegister<Register>();
+    Address counter(condition, TIMES_2, address);
+    NearLabel done;
+    __ cmpw(counter, Immediate(-1));
+    __ j(kEqual, &done);
+    __ addw(counter, Immediate(1));
+    __ Bind(&done);
+  }
+
   HBasicBlock* true_successor = if_instr->IfTrueSuccessor();
   HBasicBlock* false_successor = if_instr->IfFalseSuccessor();
   Label* true_target = codegen_->GoesToNextBlock(if_instr->GetBlock(), true_successor) ?
@@ -2678,11 +2698,14 @@ void CodeGeneratorX86::MaybeGenerateInlineCacheCheck(HInstruction* instruction,
       CHECK_EQ(EBP, instruction->GetLocations()->GetTemp(temp_index).AsRegister<Register>());
     }
     Register temp = EBP;
-    NearLabel done;
+    NearLabel done, miss;
     __ movl(temp, Immediate(address));
-    // Fast path for a monomorphic cache.
+    // Fast path for a monomorphic cache. The runtime counts the receivers of the other paths.
     __ cmpl(klass, Address(temp, InlineCache::ClassesOffset().Int32Value()));
-    __ j(kEqual, &done);
+    __ j(kNotEqual, &miss);
+    __ addl(Address(temp, InlineCache::CountsOffset().Int32Value()), Immediate(1));
+    __ jmp(&done);
+    __ Bind(&miss);
     GenerateInvokeRuntime(GetThreadOffset<kX86PointerSize>(kQuickUpdateInlineCache).Int32Value());
     __ Bind(&done);
   }
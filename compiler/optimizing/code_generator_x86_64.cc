@@ -164,6 +164,10 @@ class SuspendCheckSlowPathX86_64 : public SlowPathCode {
     CodeGeneratorX86_64* x86_64_codegen = down_cast<CodeGeneratorX86_64*>(codegen);
     __ Bind(GetEntryLabel());
     SaveLiveRegisters(codegen, locations);  // Only saves full width XMM for SIMD.
+    if (x86_64_codegen->UsesYmmRegisters()) {
+      // Avoid the AVX to SSE transition penalty in the runtime, all YMM registers are saved.
+      __ vzeroupper();
+    }
     x86_64_codegen->InvokeRuntime(kQuickTestSuspend, instruction_, instruction_->GetDexPc(), this);
     CheckEntrypointTypes<kQuickTestSuspend, void, void>();
     RestoreLiveRegisters(codegen, locations);  // Only restores full width XMM for SIMD.
@@ -1451,7 +1455,9 @@ size_t CodeGeneratorX86_64::RestoreCoreRegister(size_t stack_index, uint32_t reg
 }
 
 size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (UsesYmmRegisters()) {
+    __ vmovups(Address(CpuRegister(RSP), stack_index), YmmRegister(reg_id));
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
   } else {
     __ movsd(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
@@ -1460,7 +1466,9 @@ size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32
 }
 
 size_t CodeGeneratorX86_64::RestoreFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (UsesYmmRegisters()) {
+    __ vmovups(YmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
   } else {
     __ movsd(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
@@ -1732,6 +1740,10 @@ void CodeGeneratorX86_64::GenerateFrameExit() {
       }
     }
   }
+  if (UsesYmmRegisters()) {
+    // Avoid the AVX to SSE transition penalty in the caller. The return value is preserved.
+    __ vzeroupper();
+  }
   __ ret();
   __ cfi().RestoreState();
   __ cfi().DefCFAOffset(GetFrameSize());
@@ -2131,12 +2143,33 @@ void InstructionCodeGeneratorX86_64::GenerateTestAndBranch(HInstruction* instruc
 
 void LocationsBuilderX86_64::VisitIf(HIf* if_instr) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(if_instr);
-  if (IsBooleanValueOrMaterializedCondition(if_instr->InputAt(0))) {
+  if (codegen_->GetBranchCacheToUpdate(if_instr) != nullptr) {
+    // The condition indexes the counts of the branch cache.
+    locations->SetInAt(0, Location::RequiresRegister());
+  } else if (IsBooleanValueOrMaterializedCondition(if_instr->InputAt(0))) {
     locations->SetInAt(0, Location::Any());
   }
 }
 
 void InstructionCodeGeneratorX86_64::VisitIf(HIf* if_instr) {
+  BranchCache* cache = codegen_->GetBranchCacheToUpdate(if_instr);
+  if (cache != nullptr) {
+    // Increment the count at `FalseOffset()` + 2 * condition, unless it is saturated.
+    static_assert(BranchCache::TrueOffset().Int32Value() ==
+                      BranchCache::FalseOffset().Int32Value() + 2,
+                  "Unexpected offsets for BranchCache");
+    uint64_t address =
+        reinterpret_cast64<uint64_t>(cache) + BranchCache::FalseOffset().Int32Value();
+    CpuRegister condition = if_instr->GetLocations()->InAt(0).AsRegister<CpuRegister>();
+    Address counter(CpuRegister(TMP), condition, TIMES_2, 0);
+    NearLabel done;
+    __ movq(CpuRegister(TMP), Immediate(address));
+    __ cmpw(counter, Immediate(-1));
+    __ j(kEqual, &done);
+    __ addw(counter, Immediate(1));
+    __ Bind(&done);
+  }
+
   HBasicBlock* true_successor = if_instr->IfTrueSuccessor();
   HBasicBlock* false_successor = if_instr->IfFalseSuccessor();
   Label* true_target = codegen_->GoesToNextBlock(if_instr->GetBlock(), true_successor) ?
@@ -2922,11 +2955,14 @@ void CodeGeneratorX86_64::MaybeGenerateInlineCacheCheck(HInstruction* instructio
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint64_t address = reinterpret_cast64<uint64_t>(cache);
-    NearLabel done;
+    NearLabel done, miss;
     __ movq(CpuRegister(TMP), Immediate(address));
-    // Fast path for a monomorphic cache.
+    // Fast path for a monomorphic cache. The runtime counts the receivers of the other paths.
     __ cmpl(Address(CpuRegister(TMP), InlineCache::ClassesOffset().Int32Value()), klass);
-    __ j(kEqual, &done);
+    __ j(kNotEqual, &miss);
+    __ addl(Address(CpuRegister(TMP), InlineCache::CountsOffset().Int32Value()), Immediate(1));
+    __ jmp(&done);
+    __ Bind(&miss);
     GenerateInvokeRuntime(
         GetThreadOffset<kX86_64PointerSize>(kQuickUpdateInlineCache).Int32Value());
     __ Bind(&done);
@@ -6085,15 +6121,20 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     }
   } else if (source.IsSIMDStackSlot()) {
     if (destination.IsFpuRegister()) {
-      __ movups(destination.AsFpuRegister<XmmRegister>(),
-                Address(CpuRegister(RSP), source.GetStackIndex()));
+      if (codegen_->UsesYmmRegisters()) {
+        __ vmovups(destination.AsFpuRegister<YmmRegister>(),
+                   Address(CpuRegister(RSP), source.GetStackIndex()));
+      } else {
+        __ movups(destination.AsFpuRegister<XmmRegister>(),
+                  Address(CpuRegister(RSP), source.GetStackIndex()));
+      }
     } else {
       DCHECK(destination.IsSIMDStackSlot());
-      size_t high = kX86_64WordSize;
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex()));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex()), CpuRegister(TMP));
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + high));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + high), CpuRegister(TMP));
+      size_t size = codegen_->GetSIMDRegisterWidth();
+      for (size_t offset = 0; offset != size; offset += kX86_64WordSize) {
+        __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + offset));
+        __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + offset), CpuRegister(TMP));
+      }
     }
   } else if (source.IsConstant()) {
     HConstant* constant = source.GetConstant();
@@ -6141,13 +6182,21 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     }
   } else if (source.IsFpuRegister()) {
     if (destination.IsFpuRegister()) {
-      __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      if (codegen_->UsesYmmRegisters()) {
+        __ vmovaps(destination.AsFpuRegister<YmmRegister>(), source.AsFpuRegister<YmmRegister>());
+      } else {
+        __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      }
     } else if (destination.IsStackSlot()) {
       __ movss(Address(CpuRegister(RSP), destination.GetStackIndex()),
                source.AsFpuRegister<XmmRegister>());
     } else if (destination.IsDoubleStackSlot()) {
       __ movsd(Address(CpuRegister(RSP), destination.GetStackIndex()),
                source.AsFpuRegister<XmmRegister>());
+    } else if (codegen_->UsesYmmRegisters()) {
+      DCHECK(destination.IsSIMDStackSlot());
+      __ vmovups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                 source.AsFpuRegister<YmmRegister>());
     } else {
        DCHECK(destination.IsSIMDStackSlot());
       __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
@@ -6195,6 +6244,15 @@ void ParallelMoveResolverX86_64::Exchange128(XmmRegister reg, int mem) {
   __ addq(CpuRegister(RSP), Immediate(extra_slot));
 }
 
+void ParallelMoveResolverX86_64::Exchange256(YmmRegister reg, int mem) {
+  size_t extra_slot = 4 * kX86_64WordSize;
+  __ subq(CpuRegister(RSP), Immediate(extra_slot));
+  __ vmovups(Address(CpuRegister(RSP), 0), reg);
+  ExchangeMemory64(0, mem + extra_slot, 4);
+  __ vmovups(reg, Address(CpuRegister(RSP), 0));
+  __ addq(CpuRegister(RSP), Immediate(extra_slot));
+}
+
 void ParallelMoveResolverX86_64::ExchangeMemory32(int mem1, int mem2) {
   ScratchRegisterScope ensure_scratch(
       this, TMP, RAX, codegen_->GetNumberOfCoreRegisters());
@@ -6247,6 +6305,14 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
     Exchange64(destination.AsRegister<CpuRegister>(), source.GetStackIndex());
   } else if (source.IsDoubleStackSlot() && destination.IsDoubleStackSlot()) {
     ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 1);
+  } else if (source.IsFpuRegister() && destination.IsFpuRegister() &&
+             codegen_->UsesYmmRegisters()) {
+    // Swap the full YMM registers without a scratch register.
+    YmmRegister source_reg = source.AsFpuRegister<YmmRegister>();
+    YmmRegister destination_reg = destination.AsFpuRegister<YmmRegister>();
+    __ vxorps(source_reg, source_reg, destination_reg);
+    __ vxorps(destination_reg, destination_reg, source_reg);
+    __ vxorps(source_reg, source_reg, destination_reg);
   } else if (source.IsFpuRegister() && destination.IsFpuRegister()) {
     __ movd(CpuRegister(TMP), source.AsFpuRegister<XmmRegister>());
     __ movaps(source.AsFpuRegister<XmmRegister>(), destination.AsFpuRegister<XmmRegister>());
@@ -6260,11 +6326,21 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
   } else if (source.IsDoubleStackSlot() && destination.IsFpuRegister()) {
     Exchange64(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
   } else if (source.IsSIMDStackSlot() && destination.IsSIMDStackSlot()) {
-    ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 2);
+    ExchangeMemory64(destination.GetStackIndex(),
+                     source.GetStackIndex(),
+                     static_cast<int>(codegen_->GetSIMDRegisterWidth() / kX86_64WordSize));
   } else if (source.IsFpuRegister() && destination.IsSIMDStackSlot()) {
-    Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    if (codegen_->UsesYmmRegisters()) {
+      Exchange256(source.AsFpuRegister<YmmRegister>(), destination.GetStackIndex());
+    } else {
+      Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    }
   } else if (destination.IsFpuRegister() && source.IsSIMDStackSlot()) {
-    Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    if (codegen_->UsesYmmRegisters()) {
+      Exchange256(destination.AsFpuRegister<YmmRegister>(), source.GetStackIndex());
+    } else {
+      Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    }
   } else {
     LOG(FATAL) << "Unimplemented swap between " << source << " and " << destination;
   }
@@ -168,6 +168,7 @@ class ParallelMoveResolverX86_64 : public ParallelMoveResolverWithSwap {
   void Exchange64(CpuRegister reg, int mem);
   void Exchange64(XmmRegister reg, int mem);
   void Exchange128(XmmRegister reg, int mem);
+  void Exchange256(YmmRegister reg, int mem);
   void ExchangeMemory32(int mem1, int mem2);
   void ExchangeMemory64(int mem1, int mem2, int num_of_qwords);
 
@@ -280,6 +281,7 @@ class InstructionCodeGeneratorX86_64 : public InstructionCodeGenerator {
   void GenerateMinMaxFP(LocationSummary* locations, bool is_min, DataType::Type type);
   void GenerateMinMax(HBinaryOperation* minmax, bool is_min);
   void GenerateMethodEntryExitHook(HInstruction* instruction);
+  void GenerateYmmVecLoad(HVecLoad* instruction, const Address& address);
 
   // Generate a heap reference load using one register `out`:
   //
@@ -388,7 +390,14 @@ class CodeGeneratorX86_64 : public CodeGenerator {
   }
 
   size_t GetSIMDRegisterWidth() const override {
-    return 2 * kX86_64WordSize;
+    // Vectorize with the 256-bit YMM registers when the CPU supports AVX2.
+    return GetInstructionSetFeatures().HasAVX2() ? 4 * kX86_64WordSize : 2 * kX86_64WordSize;
+  }
+
+  // Returns whether the SIMD code of the graph uses the YMM registers. The upper halves of
+  // the FP registers must then be preserved by moves, swaps and slow path spills.
+  bool UsesYmmRegisters() const {
+    return GetGraph()->HasSIMD() && GetSIMDRegisterWidth() == 4 * kX86_64WordSize;
   }
 
   HGraphVisitor* GetLocationBuilder() override {
@@ -590,6 +590,13 @@ class HGraphVisualizerPrinter : public HGraphDelegateVisitor {
     StartAttributeStream("target") << namer_.GetName(instruction->GetBlock()->GetSingleSuccessor());
   }
 
+  void VisitIf(HIf* instruction) override {
+    if (instruction->GetTrueCount() != 0u || instruction->GetFalseCount() != 0u) {
+      StartAttributeStream("true_count") << instruction->GetTrueCount();
+      StartAttributeStream("false_count") << instruction->GetFalseCount();
+    }
+  }
+
   void VisitDeoptimize(HDeoptimize* deoptimize) override {
     StartAttributeStream("kind") << deoptimize->GetKind();
   }
@@ -16,6 +16,8 @@
 
 #include "inliner.h"
 
+#include <numeric>
+
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/logging.h"
@@ -72,6 +74,13 @@ static constexpr size_t kMaximumNumberOfPolymorphicRecursiveCalls = 0;
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
+// A receiver type which accounts for at least this percentage of the calls of a polymorphic or
+// megamorphic call site is inlined on its own, keeping the virtual call for the other types.
+static constexpr uint64_t kDominantReceiverPercentage = 90;
+
+// The minimum number of counted calls of a call site for its dominant receiver to be trusted.
+static constexpr uint64_t kMinimumDominantReceiverCalls = 100;
+
 // We check for line numbers to make sure the DepthString implementation
 // aligns the output nicely.
 #define LOG_INTERNAL(msg) \
@@ -107,6 +116,20 @@ std::string HInliner::DepthString(int line) const {
   return value;
 }
 
+// Returns whether the branch profiles show `block` was never executed: it is dominated by the
+// only successor of a branch never taken.
+static bool IsNeverExecuted(const HBasicBlock* block) {
+  for (; block != nullptr; block = block->GetDominator()) {
+    if (block->GetPredecessors().size() == 1u) {
+      HInstruction* last = block->GetSinglePredecessor()->GetLastInstruction();
+      if (last->IsIf() && last->AsIf()->IsNeverTaken(block)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 static size_t CountNumberOfInstructions(HGraph* graph) {
   size_t number_of_instructions = 0;
   for (HBasicBlock* block : graph->GetReversePostOrderSkipEntryBlock()) {
@@ -340,6 +363,49 @@ HInliner::InlineCacheType HInliner::GetInlineCacheType(
   }
 }
 
+int32_t HInliner::FindDominantReceiver(
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    const InlineCacheCounts& counts) {
+  InlineCacheType inline_cache_type = GetInlineCacheType(classes);
+  if (inline_cache_type != kInlineCachePolymorphic &&
+      inline_cache_type != kInlineCacheMegamorphic) {
+    return -1;
+  }
+  uint8_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
+  uint64_t total_calls =
+      std::accumulate(counts.begin(), counts.begin() + number_of_types, UINT64_C(0));
+  if (total_calls < kMinimumDominantReceiverCalls) {
+    return -1;
+  }
+  // The last count of a megamorphic inline cache also includes the types which did not fit.
+  size_t number_of_candidates =
+      (inline_cache_type == kInlineCacheMegamorphic) ? number_of_types - 1u : number_of_types;
+  for (size_t i = 0; i != number_of_candidates; ++i) {
+    if (counts[i] * UINT64_C(100) >= total_calls * kDominantReceiverPercentage) {
+      return static_cast<int32_t>(i);
+    }
+  }
+  return -1;
+}
+
+void HInliner::SortByDecreasingCount(
+    /*inout*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*inout*/InlineCacheCounts* counts) {
+  uint8_t number_of_types = InlineCache::kIndividualCacheSize - classes->RemainingSlots();
+  // Stable insertion sort, so that the order of the inline cache is kept without counts.
+  for (size_t i = 1; i < number_of_types; ++i) {
+    ObjPtr<mirror::Object> klass = classes->GetReference(i);
+    uint32_t count = (*counts)[i];
+    size_t j = i;
+    for (; j != 0u && (*counts)[j - 1u] < count; --j) {
+      classes->SetReference(j, classes->GetReference(j - 1u));
+      (*counts)[j] = (*counts)[j - 1u];
+    }
+    classes->SetReference(j, klass);
+    (*counts)[j] = count;
+  }
+}
+
 static inline ObjPtr<mirror::Class> GetMonomorphicType(
     const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -506,6 +572,12 @@ bool HInliner::TryInline(HInvoke* invoke_instruction, /*inout*/ bool* did_set_al
 }
 
 bool HInliner::TryInlineFromCHA(HInvoke* invoke_instruction) {
+  if (HasFailedSpeculation(invoke_instruction, DeoptimizationKind::kCHA)) {
+    LOG_FAIL_NO_STAT() << "Not using CHA for call to "
+                       << invoke_instruction->GetMethodReference().PrettyMethod()
+                       << " as it previously deoptimized";
+    return false;
+  }
   ArtMethod* method = FindMethodFromCHA(invoke_instruction->GetResolvedMethod());
   if (method == nullptr) {
     return false;
@@ -529,7 +601,19 @@ bool HInliner::TryInlineFromCHA(HInvoke* invoke_instruction) {
   return true;
 }
 
-bool HInliner::UseOnlyPolymorphicInliningWithNoDeopt() {
+bool HInliner::HasFailedSpeculation(HInvoke* invoke_instruction, DeoptimizationKind kind) {
+  if (!codegen_->GetCompilerOptions().IsJitCompiler()) {
+    return false;
+  }
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return false;
+  }
+  return jit->GetCodeCache()->HasFailedSpeculation(
+      graph_->GetArtMethod(), invoke_instruction->GetDexPc(), kind);
+}
+
+bool HInliner::UseOnlyPolymorphicInliningWithNoDeopt(HInvoke* invoke_instruction) {
   // If we are compiling AOT or OSR, pretend the call using inline caches is polymorphic and
   // do not generate a deopt.
   //
@@ -554,7 +638,14 @@ bool HInliner::UseOnlyPolymorphicInliningWithNoDeopt() {
   //
   // For OSR:
   //     We may come from the interpreter and it may have seen different receiver types.
-  return Runtime::Current()->IsAotCompiler() || outermost_graph_->IsCompilingOsr();
+  //
+  // For JIT code that previously deoptimized on a type guard of this call:
+  //     The inline cache did not capture all the receiver types, and deoptimizing again would
+  //     throw the recompiled code away for the same reason.
+  return Runtime::Current()->IsAotCompiler() ||
+         outermost_graph_->IsCompilingOsr() ||
+         HasFailedSpeculation(invoke_instruction, DeoptimizationKind::kJitInlineCache) ||
+         HasFailedSpeculation(invoke_instruction, DeoptimizationKind::kAotInlineCache);
 }
 bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -563,12 +654,13 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
   }
 
   StackHandleScope<InlineCache::kIndividualCacheSize> classes(Thread::Current());
+  InlineCacheCounts counts;
   // The Zygote JIT compiles based on a profile, so we shouldn't use runtime inline caches
   // for it.
   InlineCacheType inline_cache_type =
       (Runtime::Current()->IsAotCompiler() || Runtime::Current()->IsZygote())
-          ? GetInlineCacheAOT(invoke_instruction, &classes)
-          : GetInlineCacheJIT(invoke_instruction, &classes);
+          ? GetInlineCacheAOT(invoke_instruction, &classes, &counts)
+          : GetInlineCacheJIT(invoke_instruction, &classes, &counts);
 
   switch (inline_cache_type) {
     case kInlineCacheNoData: {
@@ -588,8 +680,8 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
     case kInlineCacheMonomorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kMonomorphicCall);
-      if (UseOnlyPolymorphicInliningWithNoDeopt()) {
-        return TryInlinePolymorphicCall(invoke_instruction, classes);
+      if (UseOnlyPolymorphicInliningWithNoDeopt(invoke_instruction)) {
+        return TryInlinePolymorphicCall(invoke_instruction, classes, counts);
       } else {
         return TryInlineMonomorphicCall(invoke_instruction, classes);
       }
@@ -597,15 +689,24 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
     case kInlineCachePolymorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kPolymorphicCall);
-      return TryInlinePolymorphicCall(invoke_instruction, classes);
+      // Guard for the most frequent receiver types first.
+      SortByDecreasingCount(&classes, &counts);
+      return TryInlinePolymorphicCall(invoke_instruction, classes, counts);
     }
 
     case kInlineCacheMegamorphic: {
+      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
+      // The receiver types may still be dominated by one of them.
+      int32_t dominant_index = FindDominantReceiver(classes, counts);
+      if (dominant_index != -1 &&
+          TryInlineDominantReceiverCall(invoke_instruction,
+                                        classes.GetReference(dominant_index)->AsClass())) {
+        return true;
+      }
       LOG_FAIL_NO_STAT()
           << "Interface or virtual call to "
           << invoke_instruction->GetMethodReference().PrettyMethod()
           << " is megamorphic and not inlined";
-      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
       return false;
     }
 
@@ -622,8 +723,10 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
 HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     HInvoke* invoke_instruction,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/InlineCacheCounts* counts) {
   DCHECK(codegen_->GetCompilerOptions().IsJitCompiler());
+  counts->fill(0u);
 
   ArtMethod* caller = graph_->GetArtMethod();
   // Under JIT, we should always know the caller.
@@ -635,15 +738,18 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
 
   Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(
       *profiling_info->GetInlineCache(invoke_instruction->GetDexPc()),
-      classes);
+      classes,
+      counts);
   return GetInlineCacheType(*classes);
 }
 
 HInliner::InlineCacheType HInliner::GetInlineCacheAOT(
     HInvoke* invoke_instruction,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/InlineCacheCounts* counts) {
   DCHECK_EQ(classes->NumberOfReferences(), InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->RemainingSlots(), InlineCache::kIndividualCacheSize);
+  counts->fill(0u);
 
   const ProfileCompilationInfo* pci = codegen_->GetCompilerOptions().GetProfileCompilationInfo();
   if (pci == nullptr) {
@@ -688,6 +794,8 @@ HInliner::InlineCacheType HInliner::GetInlineCacheAOT(
       return kInlineCacheMissingTypes;
     }
     DCHECK_NE(classes->RemainingSlots(), 0u);
+    (*counts)[InlineCache::kIndividualCacheSize - classes->RemainingSlots()] =
+        dex_pc_data.GetClassCount(type_index);
     classes->NewHandle(clazz);
   }
 
@@ -925,7 +1033,8 @@ static void MaybeReplaceAndRemove(HInstruction* new_instruction, HInstruction* o
 
 bool HInliner::TryInlinePolymorphicCall(
     HInvoke* invoke_instruction,
-    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    const InlineCacheCounts& counts) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
@@ -933,6 +1042,15 @@ bool HInliner::TryInlinePolymorphicCall(
     return true;
   }
 
+  // If one receiver type accounts for almost all the calls, only inline it. Guarding for the
+  // other types would grow the code for little benefit.
+  int32_t dominant_index = FindDominantReceiver(classes, counts);
+  if (dominant_index != -1 &&
+      TryInlineDominantReceiverCall(invoke_instruction,
+                                    classes.GetReference(dominant_index)->AsClass())) {
+    return true;
+  }
+
   ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
   PointerSize pointer_size = class_linker->GetImagePointerSize();
 
@@ -963,7 +1081,7 @@ bool HInliner::TryInlinePolymorphicCall(
     // In monomorphic cases when UseOnlyPolymorphicInliningWithNoDeopt() is true, we call
     // `TryInlinePolymorphicCall` even though we are monomorphic.
     const bool actually_monomorphic = number_of_types == 1;
-    DCHECK_IMPLIES(actually_monomorphic, UseOnlyPolymorphicInliningWithNoDeopt());
+    DCHECK_IMPLIES(actually_monomorphic, UseOnlyPolymorphicInliningWithNoDeopt(invoke_instruction));
 
     // We only want to limit recursive polymorphic cases, not monomorphic ones.
     const bool too_many_polymorphic_recursive_calls =
@@ -993,7 +1111,7 @@ bool HInliner::TryInlinePolymorphicCall(
 
       // If we have inlined all targets before, and this receiver is the last seen,
       // we deoptimize instead of keeping the original invoke instruction.
-      bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
+      bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt(invoke_instruction) &&
           all_targets_inlined &&
           (i + 1 == number_of_types);
 
@@ -1031,6 +1149,73 @@ bool HInliner::TryInlinePolymorphicCall(
   return true;
 }
 
+bool HInliner::TryInlineDominantReceiverCall(HInvoke* invoke_instruction,
+                                             ObjPtr<mirror::Class> dominant_class) {
+  DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
+      << invoke_instruction->DebugName();
+
+  dex::TypeIndex class_index = FindClassIndexIn(dominant_class, caller_compilation_unit_);
+  if (!class_index.IsValid()) {
+    LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedDexCacheInaccessibleToCaller)
+        << "Call to " << ArtMethod::PrettyMethod(invoke_instruction->GetResolvedMethod())
+        << " from inline cache is not inlined because its dominant class is not"
+        << " accessible to the caller";
+    return false;
+  }
+
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+  PointerSize pointer_size = class_linker->GetImagePointerSize();
+  Handle<mirror::Class> handle = graph_->GetHandleCache()->NewHandle(dominant_class);
+  ArtMethod* method = ResolveMethodFromInlineCache(handle, invoke_instruction, pointer_size);
+  if (method == nullptr) {
+    // Bogus AOT profile, bail.
+    DCHECK(Runtime::Current()->IsAotCompiler());
+    return false;
+  }
+
+  if (CountRecursiveCallsOf(method) > kMaximumNumberOfPolymorphicRecursiveCalls) {
+    LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedPolymorphicRecursiveBudget)
+        << "Method " << method->PrettyMethod()
+        << " is not inlined because it has reached its polymorphic recursive call budget.";
+    return false;
+  }
+
+  LOG_NOTE() << "Try inline dominant receiver call to " << method->PrettyMethod();
+  HInstruction* receiver = invoke_instruction->InputAt(0);
+  HInstruction* cursor = invoke_instruction->GetPrevious();
+  HBasicBlock* bb_cursor = invoke_instruction->GetBlock();
+  HInstruction* return_replacement = nullptr;
+  if (!TryBuildAndInline(invoke_instruction,
+                         method,
+                         ReferenceTypeInfo::Create(handle, /* is_exact= */ true),
+                         &return_replacement)) {
+    return false;
+  }
+
+  LOG_SUCCESS() << "Call to " << invoke_instruction->GetMethodReference().PrettyMethod()
+                << " has inlined " << ArtMethod::PrettyMethod(method)
+                << " for its dominant receiver type";
+
+  HInstruction* compare = AddTypeGuard(receiver,
+                                       cursor,
+                                       bb_cursor,
+                                       class_index,
+                                       handle,
+                                       invoke_instruction,
+                                       /* with_deoptimization= */ false);
+  CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
+
+  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedDominantReceiverCall);
+
+  // Run type propagation to get the guard typed.
+  ReferenceTypePropagation rtp_fixup(graph_,
+                                     outer_compilation_unit_.GetClassLoader(),
+                                     outer_compilation_unit_.GetDexCache(),
+                                     /* is_first_run= */ false);
+  rtp_fixup.Run();
+  return true;
+}
+
 void HInliner::CreateDiamondPatternForPolymorphicInline(HInstruction* compare,
                                                         HInstruction* return_replacement,
                                                         HInstruction* invoke_instruction) {
@@ -1197,7 +1382,8 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
   bb_cursor->InsertInstructionAfter(compare, class_table_get);
 
-  if (outermost_graph_->IsCompilingOsr()) {
+  if (outermost_graph_->IsCompilingOsr() ||
+      HasFailedSpeculation(invoke_instruction, DeoptimizationKind::kJitSameTarget)) {
     CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
   } else {
     HDeoptimize* deoptimize = new (graph_->GetAllocator()) HDeoptimize(
@@ -1875,6 +2061,12 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
   bool needs_bss_check = false;
   const bool can_encode_in_stack_map = CanEncodeInlinedMethodInStackMap(
       *outer_compilation_unit_.GetDexFile(), resolved_method, codegen_, &needs_bss_check);
+  // Keep the budget for the code that runs: on a path never executed, only inline small
+  // methods, which are not larger than the call.
+  const bool never_executed = IsNeverExecuted(target_block);
+  const size_t budget = never_executed
+      ? std::min(inlining_budget_, kMaximumNumberOfInstructionsForSmallMethod)
+      : inlining_budget_;
   size_t number_of_instructions = 0;
   // Skip the entry block, it does not contain instructions that prevent inlining.
   for (HBasicBlock* block : callee_graph->GetReversePostOrderSkipEntryBlock()) {
@@ -1901,11 +2093,17 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
     for (HInstructionIterator instr_it(block->GetInstructions());
          !instr_it.Done();
          instr_it.Advance()) {
-      if (++number_of_instructions > inlining_budget_) {
-        LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedInstructionBudget)
-            << "Method " << resolved_method->PrettyMethod()
-            << " is not inlined because the outer method has reached"
-            << " its instruction budget limit.";
+      if (++number_of_instructions > budget) {
+        if (never_executed && number_of_instructions <= inlining_budget_) {
+          LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedNeverExecuted)
+              << "Method " << resolved_method->PrettyMethod()
+              << " is not inlined because the profile shows the call is never executed.";
+        } else {
+          LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedInstructionBudget)
+              << "Method " << resolved_method->PrettyMethod()
+              << " is not inlined because the outer method has reached"
+              << " its instruction budget limit.";
+        }
         return false;
       }
       HInstruction* current = instr_it.Current();
@@ -17,6 +17,8 @@
 #ifndef ART_COMPILER_OPTIMIZING_INLINER_H_
 #define ART_COMPILER_OPTIMIZING_INLINER_H_
 
+#include <array>
+
 #include "dex/dex_file_types.h"
 #include "dex/invoke_type.h"
 #include "jit/profiling_info.h"
@@ -70,6 +72,8 @@ class HInliner : public HOptimization {
     kInlineCacheMissingTypes = 5
   };
 
+  using InlineCacheCounts = std::array<uint32_t, InlineCache::kIndividualCacheSize>;
+
   // We set `did_set_always_throws` as true if we analyzed `invoke_instruction` and it always
   // throws.
   bool TryInline(HInvoke* invoke_instruction, /*inout*/ bool* did_set_always_throws);
@@ -175,9 +179,11 @@ class HInliner : public HOptimization {
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
   // invoke info was found in the profile info.
+  // `counts` receives how many times each of the `classes` was seen, or zeros if unknown.
   InlineCacheType GetInlineCacheJIT(
       HInvoke* invoke_instruction,
-      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+      /*out*/InlineCacheCounts* counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try getting the inline cache from AOT offline profile.
@@ -185,7 +191,22 @@ class HInliner : public HOptimization {
   // invoke info was found in the profile info.
   InlineCacheType GetInlineCacheAOT(
       HInvoke* invoke_instruction,
-      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+      /*out*/InlineCacheCounts* counts)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Returns the index in `classes` of the receiver type which accounts for most of the calls
+  // according to `counts`, or -1 if there is no such type. For megamorphic inline caches, the
+  // last count includes the types which did not fit in the cache, so its type is never dominant.
+  static int32_t FindDominantReceiver(
+      const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+      const InlineCacheCounts& counts)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Reorder `classes` and `counts` so that the most frequent receiver types come first.
+  static void SortByDecreasingCount(
+      /*inout*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+      /*inout*/InlineCacheCounts* counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Compute the inline cache type.
@@ -201,9 +222,11 @@ class HInliner : public HOptimization {
                                 const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Try to inline targets of a polymorphic call.
+  // Try to inline targets of a polymorphic call. `counts` are the number of times each of the
+  // `classes` was seen, which are used to only inline the dominant receiver type if there is one.
   bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
-                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
+                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+                                const InlineCacheCounts& counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool TryInlinePolymorphicCallToSameTarget(
@@ -211,8 +234,25 @@ class HInliner : public HOptimization {
       const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Try to inline the target of a polymorphic or megamorphic call for its dominant receiver
+  // type. If successful, the code in the graph will look like:
+  // if (receiver.getClass() == dominant_class) {
+  //   ... // inlined code
+  // } else {
+  //   ... // original invoke
+  // }
+  // Unlike the polymorphic inlining of all the types, there is no deoptimization for the other
+  // receiver types, as they are known to occur.
+  bool TryInlineDominantReceiverCall(HInvoke* invoke_instruction,
+                                     ObjPtr<mirror::Class> dominant_class)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Returns whether or not we should use only polymorphic inlining with no deoptimizations.
-  bool UseOnlyPolymorphicInliningWithNoDeopt();
+  bool UseOnlyPolymorphicInliningWithNoDeopt(HInvoke* invoke_instruction);
+
+  // Returns whether JIT code of the method being compiled previously deoptimized at
+  // `invoke_instruction` because of a speculation of the given `kind`.
+  bool HasFailedSpeculation(HInvoke* invoke_instruction, DeoptimizationKind kind);
 
   // Try CHA-based devirtualization to change virtual method calls into
   // direct calls.
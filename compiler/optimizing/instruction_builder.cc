@@ -33,6 +33,7 @@
 #include "intrinsics.h"
 #include "intrinsics_utils.h"
 #include "jit/jit.h"
+#include "jit/profiling_info.h"
 #include "mirror/dex_cache.h"
 #include "oat_file.h"
 #include "optimizing_compiler_stats.h"
@@ -111,6 +112,7 @@ HInstructionBuilder::HInstructionBuilder(HGraph* graph,
       latest_result_(nullptr),
       current_this_parameter_(nullptr),
       loop_headers_(local_allocator->Adapter(kArenaAllocGraphBuilder)),
+      profile_branch_caches_(nullptr),
       class_cache_(std::less<dex::TypeIndex>(), local_allocator->Adapter(kArenaAllocGraphBuilder)) {
   loop_headers_.reserve(kDefaultNumberOfLoops);
 }
@@ -364,6 +366,17 @@ bool HInstructionBuilder::Build() {
     native_debug_info_locations = FindNativeDebugInfoLocations();
   }
 
+  // Without a JIT `ProfilingInfo`, take the branch counts from the profile, if any.
+  const ProfileCompilationInfo* pci = (code_generator_ != nullptr)
+      ? code_generator_->GetCompilerOptions().GetProfileCompilationInfo()
+      : nullptr;
+  if (pci != nullptr && graph_->GetProfilingInfo() == nullptr && !graph_->IsCompilingBaseline()) {
+    ProfileCompilationInfo::MethodHotness hotness = pci->GetMethodHotness(
+        MethodReference(dex_compilation_unit_->GetDexFile(),
+                        dex_compilation_unit_->GetDexMethodIndex()));
+    profile_branch_caches_ = hotness.GetBranchCacheMap();
+  }
+
   for (HBasicBlock* block : graph_->GetReversePostOrder()) {
     current_block_ = block;
     uint32_t block_dex_pc = current_block_->GetDexPc();
@@ -646,23 +659,43 @@ void HInstructionBuilder::InitializeParameters() {
   }
 }
 
+void HInstructionBuilder::BuildIf(HCondition* comparison, uint32_t dex_pc) {
+  AppendInstruction(comparison);
+  HIf* if_instruction = new (allocator_) HIf(comparison, dex_pc);
+  ProfilingInfo* info = graph_->GetProfilingInfo();
+  if (info != nullptr && !graph_->IsCompilingBaseline()) {
+    BranchCache* cache = info->GetBranchCache(dex_pc);
+    if (cache != nullptr) {
+      // The true successor is the branch target, see `HBasicBlockBuilder`.
+      if_instruction->SetProfileCounts(cache->GetTrueCount(), cache->GetFalseCount());
+    }
+  } else if (profile_branch_caches_ != nullptr) {
+    auto it = profile_branch_caches_->find(dex_pc);
+    if (it != profile_branch_caches_->end()) {
+      // Merged profiles can count past the 16 bits of the runtime counts. Only the ratio matters,
+      // so scale the counts down.
+      const ProfileCompilationInfo::BranchCounts& counts = it->second;
+      uint32_t scale =
+          std::max(counts.true_count, counts.false_count) / std::numeric_limits<uint16_t>::max() +
+          1u;
+      if_instruction->SetProfileCounts(counts.true_count / scale, counts.false_count / scale);
+    }
+  }
+  AppendInstruction(if_instruction);
+  current_block_ = nullptr;
+}
+
 template<typename T>
 void HInstructionBuilder::If_22t(const Instruction& instruction, uint32_t dex_pc) {
   HInstruction* first = LoadLocal(instruction.VRegA(), DataType::Type::kInt32);
   HInstruction* second = LoadLocal(instruction.VRegB(), DataType::Type::kInt32);
-  T* comparison = new (allocator_) T(first, second, dex_pc);
-  AppendInstruction(comparison);
-  AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
-  current_block_ = nullptr;
+  BuildIf(new (allocator_) T(first, second, dex_pc), dex_pc);
 }
 
 template<typename T>
 void HInstructionBuilder::If_21t(const Instruction& instruction, uint32_t dex_pc) {
   HInstruction* value = LoadLocal(instruction.VRegA(), DataType::Type::kInt32);
-  T* comparison = new (allocator_) T(value, graph_->GetIntConstant(0, dex_pc), dex_pc);
-  AppendInstruction(comparison);
-  AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
-  current_block_ = nullptr;
+  BuildIf(new (allocator_) T(value, graph_->GetIntConstant(0, dex_pc), dex_pc), dex_pc);
 }
 
 template<typename T>
@@ -26,6 +26,7 @@
 #include "dex/dex_file_types.h"
 #include "handle.h"
 #include "nodes.h"
+#include "profile/profile_compilation_info.h"
 
 namespace art {
 
@@ -118,6 +119,9 @@ class HInstructionBuilder : public ValueObject {
   template<typename T> void If_21t(const Instruction& instruction, uint32_t dex_pc);
   template<typename T> void If_22t(const Instruction& instruction, uint32_t dex_pc);
 
+  // Appends the HIf of the conditional branch at `dex_pc`, with the branch profile if any.
+  void BuildIf(HCondition* comparison, uint32_t dex_pc);
+
   void Conversion_12x(const Instruction& instruction,
                       DataType::Type input_type,
                       DataType::Type result_type,
@@ -334,6 +338,10 @@ class HInstructionBuilder : public ValueObject {
 
   ScopedArenaVector<HBasicBlock*> loop_headers_;
 
+  // The branch counts of the method in the AOT profile, used when there is no JIT
+  // `ProfilingInfo`. Null if the profile has none. Valid only after Build() starts.
+  const ProfileCompilationInfo::BranchCacheMap* profile_branch_caches_;
+
   // Cached resolved types for the current compilation unit's DexFile.
   // Handle<>s reference entries in the `graph_->GetHandleCache()`.
   ScopedArenaSafeMap<dex::TypeIndex, Handle<mirror::Class>> class_cache_;
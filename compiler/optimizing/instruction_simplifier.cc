@@ -77,6 +77,7 @@ class InstructionSimplifierVisitor : public HGraphDelegateVisitor {
   void VisitEqual(HEqual* equal) override;
   void VisitNotEqual(HNotEqual* equal) override;
   void VisitBooleanNot(HBooleanNot* bool_not) override;
+  void VisitInstanceFieldGet(HInstanceFieldGet* instruction) override;
   void VisitInstanceFieldSet(HInstanceFieldSet* equal) override;
   void VisitStaticFieldSet(HStaticFieldSet* equal) override;
   void VisitArraySet(HArraySet* equal) override;
@@ -744,6 +745,36 @@ void InstructionSimplifierVisitor::VisitInstanceFieldSet(HInstanceFieldSet* inst
   }
 }
 
+void InstructionSimplifierVisitor::VisitInstanceFieldGet(HInstanceFieldGet* instruction) {
+  // Unbox a value boxed in this method, `Integer.valueOf(x).intValue()` is `x`. Whether the
+  // boxed value comes from the `IntegerCache` or is a new `Integer`, its final `value` field
+  // holds `x`. Once the unboxed value is replaced, the intrinsic (which has no side effects) is
+  // usually dead, which removes the allocation on the uncached path.
+  HInstruction* receiver = instruction->InputAt(0);
+  if (receiver->IsNullCheck()) {
+    receiver = receiver->InputAt(0);
+  }
+  if (!receiver->IsInvokeStaticOrDirect() ||
+      receiver->AsInvoke()->GetIntrinsic() != Intrinsics::kIntegerValueOf ||
+      instruction->GetFieldType() != DataType::Type::kInt32 ||
+      instruction->IsVolatile()) {
+    return;
+  }
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    ArtField* field = instruction->GetFieldInfo().GetField();
+    ArtMethod* value_of = receiver->AsInvoke()->GetResolvedMethod();
+    if (field == nullptr || field->GetDeclaringClass() != value_of->GetDeclaringClass()) {
+      return;
+    }
+    // `value` is the only instance field of `Integer`.
+    DCHECK_EQ(std::string(field->GetName()), "value");
+  }
+  instruction->ReplaceWith(receiver->InputAt(0));
+  instruction->GetBlock()->RemoveInstruction(instruction);
+  RecordSimplification();
+}
+
 void InstructionSimplifierVisitor::VisitStaticFieldSet(HStaticFieldSet* instruction) {
   if ((instruction->GetValue()->GetType() == DataType::Type::kReference)
       && CanEnsureNotNullAt(instruction->GetValue(), instruction)) {
@@ -1113,6 +1144,7 @@ void InstructionSimplifierVisitor::VisitIf(HIf* instruction) {
     // Swap successors if input is negated.
     instruction->ReplaceInput(condition->InputAt(0), 0);
     instruction->GetBlock()->SwapSuccessors();
+    instruction->SetProfileCounts(instruction->GetFalseCount(), instruction->GetTrueCount());
     RecordSimplification();
   }
 }
@@ -390,6 +390,62 @@ TEST_F(InstructionSimplifierTest, SimplifyPredicatedFieldGetNoNull) {
   EXPECT_INS_EQ(ifget->InputAt(0), obj_phi);
 }
 
+// // ENTRY
+// if (!param) {
+//   // LEFT, mostly taken
+// } else {
+//   // RIGHT
+// }
+// return
+// => if (param) { RIGHT } else { LEFT, mostly taken }
+TEST_F(InstructionSimplifierTest, SimplifyIfBooleanNotSwapsProfileCounts) {
+  ScopedObjectAccess soa(Thread::Current());
+  VariableSizedHandleScope vshs(soa.Self());
+  CreateGraph(&vshs);
+  AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                 "exit",
+                                                 {{"entry", "left"},
+                                                  {"entry", "right"},
+                                                  {"left", "breturn"},
+                                                  {"right", "breturn"},
+                                                  {"breturn", "exit"}}));
+#define GET_BLOCK(name) HBasicBlock* name = blks.Get(#name)
+  GET_BLOCK(entry);
+  GET_BLOCK(exit);
+  GET_BLOCK(left);
+  GET_BLOCK(right);
+  GET_BLOCK(breturn);
+#undef GET_BLOCK
+
+  HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+  HInstruction* not_value = new (GetAllocator()) HBooleanNot(bool_value);
+  HIf* if_inst = new (GetAllocator()) HIf(not_value);
+  if_inst->SetProfileCounts(/* true_count= */ 1000u, /* false_count= */ 10u);
+  entry->AddInstruction(not_value);
+  entry->AddInstruction(if_inst);
+
+  left->AddInstruction(new (GetAllocator()) HGoto());
+  right->AddInstruction(new (GetAllocator()) HGoto());
+  breturn->AddInstruction(new (GetAllocator()) HReturnVoid());
+
+  SetupExit(exit);
+
+  graph_->ClearDominanceInformation();
+  graph_->BuildDominatorTree();
+  ASSERT_EQ(if_inst->IfTrueSuccessor(), left);
+  ASSERT_EQ(if_inst->GetLikelySuccessor(), left);
+  InstructionSimplifier simp(graph_, /*codegen=*/nullptr);
+  simp.Run();
+
+  // The successors are swapped, and the counts with them.
+  EXPECT_INS_EQ(if_inst->InputAt(0), bool_value);
+  EXPECT_EQ(if_inst->IfTrueSuccessor(), right);
+  EXPECT_EQ(if_inst->IfFalseSuccessor(), left);
+  EXPECT_EQ(if_inst->GetTrueCount(), 10u);
+  EXPECT_EQ(if_inst->GetFalseCount(), 1000u);
+  EXPECT_EQ(if_inst->GetLikelySuccessor(), left);
+}
+
 // // ENTRY
 // obj = new Obj();
 // // Make sure this graph isn't broken
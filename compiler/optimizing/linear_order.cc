@@ -16,6 +16,8 @@
 
 #include "linear_order.h"
 
+#include <array>
+
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 
@@ -54,6 +56,53 @@ static void AddToListForLinearization(ScopedArenaVector<HBasicBlock*>* worklist,
   worklist->insert(insert_pos.base(), block);
 }
 
+// Returns the successors of `block` in the order they should be added to the worklist. The
+// last one added is processed first, and emitted right after `block` if it is ready.
+static std::array<HBasicBlock*, 2> GetIfSuccessorsForLinearization(HBasicBlock* block) {
+  HIf* if_instruction = block->GetLastInstruction()->AsIf();
+  HBasicBlock* true_successor = if_instruction->IfTrueSuccessor();
+  HBasicBlock* false_successor = if_instruction->IfFalseSuccessor();
+  // The false successor follows by default. Let the profiled likely successor follow instead,
+  // so that the hot path falls through rather than jumps.
+  if (if_instruction->GetLikelySuccessor() == true_successor) {
+    return {false_successor, true_successor};
+  }
+  return {true_successor, false_successor};
+}
+
+// Returns whether the code of `block` is never executed but for throwing an exception.
+static bool AlwaysThrows(HBasicBlock* block) {
+  if (block->GetLastInstruction()->IsThrow()) {
+    return true;
+  }
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    if (it.Current()->AlwaysThrows()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Helper method to find the cold blocks, which only lead to throwing an exception. They are not
+// part of any loop, as they do not reach a back edge.
+static void FindColdBlocks(const HGraph* graph, ScopedArenaVector<bool>* is_cold) {
+  for (HBasicBlock* block : graph->GetPostOrder()) {
+    if (block->IsEntryBlock() || block->IsExitBlock() || block->GetSuccessors().empty()) {
+      continue;
+    }
+    // Successors are visited first, except for loop headers which are not cold either.
+    bool throws = AlwaysThrows(block);
+    bool all_successors_cold = true;
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      if (!(*is_cold)[successor->GetBlockId()] && !(throws && successor->IsExitBlock())) {
+        all_successors_cold = false;
+        break;
+      }
+    }
+    (*is_cold)[block->GetBlockId()] = all_successors_cold;
+  }
+}
+
 // Helper method to validate linear order.
 static bool IsLinearOrderWellFormed(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order) {
   for (HBasicBlock* header : graph->GetBlocks()) {
@@ -87,7 +136,10 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
   // - Blocks in a loop are consecutive,
-  // - Back-edge is the last block before loop exits.
+  // - Back-edge is the last block before loop exits,
+  // - Cold blocks are after all the other blocks but the exit block, so that the code
+  //   executed keeps dense, next to the slow paths emitted at the end of the method,
+  // - The profiled likely successor of an If is next after it, when it can be.
   //
   // (1): Record the number of forward predecessors for each block. This is to
   //      ensure the resulting order is reverse post order. We could use the
@@ -108,23 +160,39 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   //      iterate over the successors. When all non-back edge predecessors of a
   //      successor block are visited, the successor block is added in the worklist
   //      following an order that satisfies the requirements to build our linear graph.
+  //      Cold blocks go to a separate worklist, which is only processed once the
+  //      other one is empty. Their successors are cold or the exit block, so they do
+  //      not hold back any other block.
+  ScopedArenaVector<bool> is_cold(graph->GetBlocks().size(),
+                                  false,
+                                  allocator.Adapter(kArenaAllocLinearOrder));
+  FindColdBlocks(graph, &is_cold);
   ScopedArenaVector<HBasicBlock*> worklist(allocator.Adapter(kArenaAllocLinearOrder));
+  ScopedArenaVector<HBasicBlock*> cold_worklist(allocator.Adapter(kArenaAllocLinearOrder));
   worklist.push_back(graph->GetEntryBlock());
   size_t num_added = 0u;
   do {
-    HBasicBlock* current = worklist.back();
-    worklist.pop_back();
+    ScopedArenaVector<HBasicBlock*>* current_worklist =
+        worklist.empty() ? &cold_worklist : &worklist;
+    HBasicBlock* current = current_worklist->back();
+    current_worklist->pop_back();
     linear_order[num_added] = current;
     ++num_added;
-    for (HBasicBlock* successor : current->GetSuccessors()) {
+    std::array<HBasicBlock*, 2> if_successors;
+    ArrayRef<HBasicBlock* const> successors(current->GetSuccessors());
+    if (current->EndsWithIf()) {
+      if_successors = GetIfSuccessorsForLinearization(current);
+      successors = ArrayRef<HBasicBlock* const>(if_successors);
+    }
+    for (HBasicBlock* successor : successors) {
       int block_id = successor->GetBlockId();
       size_t number_of_remaining_predecessors = forward_predecessors[block_id];
       if (number_of_remaining_predecessors == 1) {
-        AddToListForLinearization(&worklist, successor);
+        AddToListForLinearization(is_cold[block_id] ? &cold_worklist : &worklist, successor);
       }
       forward_predecessors[block_id] = number_of_remaining_predecessors - 1;
     }
-  } while (!worklist.empty());
+  } while (!worklist.empty() || !cold_worklist.empty());
   DCHECK_EQ(num_added, linear_order.size());
 
   DCHECK(graph->HasIrreducibleLoops() || IsLinearOrderWellFormed(graph, linear_order));
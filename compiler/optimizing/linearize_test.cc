@@ -244,4 +244,59 @@ TEST_F(LinearizeTest, CFG7) {
   TestCode(data, blocks);
 }
 
+TEST_F(LinearizeTest, ColdBlocksLast) {
+  // The block throwing the exception comes first in the reverse post order, but only
+  // leads to the exit block, so it is linearized after the block returning.
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_EQ, 3,
+    Instruction::THROW,
+    Instruction::RETURN_VOID);
+
+  HGraph* graph = CreateCFG(data);
+  std::unique_ptr<CompilerOptions> compiler_options =
+      CommonCompilerTest::CreateCompilerOptions(kRuntimeISA, "default");
+  std::unique_ptr<CodeGenerator> codegen = CodeGenerator::Create(graph, *compiler_options);
+  SsaLivenessAnalysis liveness(graph, codegen.get(), GetScopedAllocator());
+  liveness.Analyze();
+
+  const ArenaVector<HBasicBlock*>& linear_order = graph->GetLinearOrder();
+  ASSERT_GE(linear_order.size(), 3u);
+  EXPECT_TRUE(linear_order[linear_order.size() - 1u]->IsExitBlock());
+  EXPECT_TRUE(linear_order[linear_order.size() - 2u]->GetLastInstruction()->IsThrow());
+  EXPECT_TRUE(linear_order[linear_order.size() - 3u]->GetLastInstruction()->IsReturnVoid());
+}
+
+TEST_F(LinearizeTest, LikelySuccessorFollowsIf) {
+  // The false successor of the If follows it by default. The profile shows the true successor
+  // is likely, so it follows the If instead.
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_EQ, 3,
+    Instruction::RETURN_VOID,
+    Instruction::RETURN_VOID);
+
+  HGraph* graph = CreateCFG(data);
+  HIf* if_instruction = nullptr;
+  for (HBasicBlock* block : graph->GetReversePostOrder()) {
+    if (block->EndsWithIf()) {
+      if_instruction = block->GetLastInstruction()->AsIf();
+    }
+  }
+  ASSERT_TRUE(if_instruction != nullptr);
+  if_instruction->SetProfileCounts(/* true_count= */ 1000u, /* false_count= */ 10u);
+  ASSERT_EQ(if_instruction->GetLikelySuccessor(), if_instruction->IfTrueSuccessor());
+
+  std::unique_ptr<CompilerOptions> compiler_options =
+      CommonCompilerTest::CreateCompilerOptions(kRuntimeISA, "default");
+  std::unique_ptr<CodeGenerator> codegen = CodeGenerator::Create(graph, *compiler_options);
+  SsaLivenessAnalysis liveness(graph, codegen.get(), GetScopedAllocator());
+  liveness.Analyze();
+
+  const ArenaVector<HBasicBlock*>& linear_order = graph->GetLinearOrder();
+  size_t if_index = IndexOfElement(linear_order, if_instruction->GetBlock());
+  ASSERT_LT(if_index + 1u, linear_order.size());
+  EXPECT_EQ(linear_order[if_index + 1u], if_instruction->IfTrueSuccessor());
+}
+
 }  // namespace art
@@ -25,20 +25,22 @@ class SideEffectsAnalysis;
 
 class LoadStoreElimination : public HOptimization {
  public:
-  // Whether or not we should attempt partial Load-store-elimination which
-  // requires additional blocks and predicated instructions.
-  static constexpr bool kEnablePartialLSE = false;
-
   // Controls whether to enable VLOG(compiler) logs explaining the transforms taking place.
   static constexpr bool kVerboseLoggingMode = false;
 
+  // `enable_partial_lse` enables partial Load-store-elimination, which requires additional
+  // blocks and predicated instructions. Partial LSE keeps allocations which escape only on
+  // some paths virtual on the others and materializes them on the edges where they escape.
+  // It is off unless the --enable-partial-lse compiler option is passed.
   LoadStoreElimination(HGraph* graph,
                        OptimizingCompilerStats* stats,
-                       const char* name = kLoadStoreEliminationPassName)
-      : HOptimization(graph, name, stats) {}
+                       const char* name = kLoadStoreEliminationPassName,
+                       bool enable_partial_lse = false)
+      : HOptimization(graph, name, stats),
+        enable_partial_lse_(enable_partial_lse) {}
 
   bool Run() override {
-    return Run(kEnablePartialLSE);
+    return Run(enable_partial_lse_);
   }
 
   // Exposed for testing.
@@ -47,6 +49,8 @@ class LoadStoreElimination : public HOptimization {
   static constexpr const char* kLoadStoreEliminationPassName = "load_store_elimination";
 
  private:
+  const bool enable_partial_lse_;
+
   DISALLOW_COPY_AND_ASSIGN(LoadStoreElimination);
 };
 
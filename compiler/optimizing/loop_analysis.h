@@ -169,6 +169,15 @@ class ArchNoOptsLoopHelper : public ArenaObject<kArenaAllocOptimization> {
     return false;
   }
 
+  // Returns whether it is beneficial to unswitch the loop on a loop invariant condition, that is
+  // to duplicate the loop and to remove the condition from both copies.
+  //
+  // Returns 'false' by default, should be overridden by particular target loop helper.
+  virtual bool IsLoopUnswitchingBeneficial(
+      LoopAnalysisInfo* analysis_info ATTRIBUTE_UNUSED) const {
+    return false;
+  }
+
   // Returns optimal SIMD unrolling factor for the loop.
   //
   // Returns kNoUnrollingFactor by default, should be overridden by particular target loop helper.
@@ -436,6 +436,59 @@ static void PeelByCount(HLoopInformation* loop_info,
   }
 }
 
+// Finds an `if` of the loop body which tests a loop invariant condition and which branches to
+// two single blocks meeting again in the loop, i.e. the diamond (or the triangle, after critical
+// edge splitting) of an `if (invariant) { .. } else { .. }` statement. Other conditions either
+// exit the loop, which is handled by peeling, or guard more complex control flow.
+static HIf* FindUnswitchableIf(HLoopInformation* loop_info) {
+  HBasicBlock* header = loop_info->GetHeader();
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    HIf* hif = block->GetLastInstruction()->AsIf();
+    if (block == header || hif == nullptr) {
+      continue;
+    }
+    HInstruction* cond = hif->InputAt(0);
+    if (cond->IsConstant() || loop_info->Contains(*cond->GetBlock())) {
+      continue;
+    }
+    HBasicBlock* true_succ = hif->IfTrueSuccessor();
+    HBasicBlock* false_succ = hif->IfFalseSuccessor();
+    if (true_succ->GetPredecessors().size() != 1u ||
+        false_succ->GetPredecessors().size() != 1u ||
+        true_succ->GetSuccessors().size() != 1u ||
+        false_succ->GetSuccessors().size() != 1u) {
+      continue;
+    }
+    // The arms must be the only way into `meet`: with another predecessor, e.g. an earlier
+    // `continue`, removing an arm does not make the other one the dominator of `meet`.
+    HBasicBlock* meet = true_succ->GetSingleSuccessor();
+    if (meet == false_succ->GetSingleSuccessor() &&
+        meet != header &&
+        meet->GetPredecessors().size() == 2u &&
+        meet->GetDominator() == block &&
+        loop_info->Contains(*true_succ) &&
+        loop_info->Contains(*false_succ)) {
+      return hif;
+    }
+  }
+  return nullptr;
+}
+
+// Removes the arm of an `if` found by FindUnswitchableIf() which is not taken for the given
+// `value` of its condition. The `if` is replaced with a goto to the other arm.
+static void RemoveUntakenArm(HIf* hif, bool value) {
+  HBasicBlock* block = hif->GetBlock();
+  HBasicBlock* taken = value ? hif->IfTrueSuccessor() : hif->IfFalseSuccessor();
+  HBasicBlock* untaken = value ? hif->IfFalseSuccessor() : hif->IfTrueSuccessor();
+  HBasicBlock* meet = taken->GetSingleSuccessor();
+  untaken->DisconnectAndDelete();
+  // The arms meet again, so `meet` is now only reached through the taken arm.
+  block->RemoveDominatedBlock(meet);
+  taken->AddDominatedBlock(meet);
+  meet->SetDominator(taken);
+}
+
 // Returns the narrower type out of instructions a and b types.
 static DataType::Type GetNarrowerType(HInstruction* a, HInstruction* b) {
   DataType::Type type = a->GetType();
@@ -478,8 +531,9 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       vector_refs_(nullptr),
       vector_static_peeling_factor_(0),
       vector_dynamic_peeling_candidate_(nullptr),
-      vector_runtime_test_a_(nullptr),
-      vector_runtime_test_b_(nullptr),
+      vector_runtime_test_a_(),
+      vector_runtime_test_b_(),
+      vector_num_runtime_tests_(0),
       vector_map_(nullptr),
       vector_permanent_map_(nullptr),
       vector_mode_(kSequential),
@@ -824,7 +878,23 @@ bool HLoopOptimization::TryOptimizeInnerLoopFinite(LoopNode* node) {
 }
 
 bool HLoopOptimization::OptimizeInnerLoop(LoopNode* node) {
-  return TryOptimizeInnerLoopFinite(node) || TryPeelingAndUnrolling(node);
+  if (TryOptimizeInnerLoopFinite(node)) {
+    return true;
+  }
+  if (TryUnswitching(node)) {
+    // The loop lost its invariant condition, simplify it and try again. Its copy follows `node`
+    // in the loop hierarchy and is simplified and optimized next.
+    do {
+      simplified_ = false;
+      SimplifyInduction(node);
+      SimplifyBlocks(node);
+    } while (simplified_);
+    if (!TryOptimizeInnerLoopFinite(node)) {
+      TryPeelingAndUnrolling(node);
+    }
+    return true;
+  }
+  return TryPeelingAndUnrolling(node);
 }
 
 //
@@ -955,6 +1025,69 @@ bool HLoopOptimization::TryPeelingAndUnrolling(LoopNode* node) {
          TryUnrollingForBranchPenaltyReduction(&analysis_info);
 }
 
+//
+// Loop unswitching.
+//
+
+bool HLoopOptimization::TryUnswitching(LoopNode* node) {
+  HLoopInformation* loop_info = node->loop_info;
+  int64_t trip_count = 0;
+  if (!induction_range_.IsFinite(loop_info, &trip_count)) {
+    return false;
+  }
+  HIf* hif = FindUnswitchableIf(loop_info);
+  if (hif == nullptr) {
+    return false;
+  }
+
+  LoopAnalysisInfo analysis_info(loop_info);
+  LoopAnalysis::CalculateLoopBasicProperties(
+      loop_info, &analysis_info, LoopAnalysis::GetLoopTripCount(loop_info, &induction_range_));
+  if (analysis_info.HasInstructionsPreventingScalarOpts() ||
+      !arch_loop_helper_->IsLoopUnswitchingBeneficial(&analysis_info) ||
+      !LoopClonerHelper::IsLoopClonable(loop_info)) {
+    return false;
+  }
+
+  // Version the loop. The preheader is left with a goto to both copies, the original loop
+  // first, which we replace with the test of the invariant condition.
+  //
+  //   if (invariant) {           <- preheader
+  //     loop { .. then .. }      <- original loop
+  //   } else {
+  //     loop { .. else .. }      <- copy
+  //   }
+  HBasicBlock* preheader = loop_info->GetPreHeader();
+  HInstruction* cond = hif->InputAt(0);
+  LoopClonerSimpleHelper helper(loop_info, &induction_range_);
+  helper.DoVersioning();
+  DCHECK_EQ(preheader->GetSuccessors().size(), 2u);
+  DCHECK(preheader->GetLastInstruction()->IsGoto());
+  preheader->ReplaceAndRemoveInstructionWith(preheader->GetLastInstruction(),
+                                             new (global_allocator_) HIf(cond, hif->GetDexPc()));
+
+  HBasicBlock* copy_header = helper.GetBasicBlockMap()->Get(loop_info->GetHeader());
+  HLoopInformation* copy_loop_info = copy_header->GetLoopInformation();
+  HIf* copy_hif = helper.GetInstructionMap()->Get(hif)->AsIf();
+  RemoveUntakenArm(hif, /*value=*/ true);
+  RemoveUntakenArm(copy_hif, /*value=*/ false);
+
+  // Add the copy to the loop hierarchy and recompute the induction information of both loops.
+  LoopNode* copy_node = new (loop_allocator_) LoopNode(copy_loop_info);
+  copy_node->outer = node->outer;
+  copy_node->previous = node;
+  copy_node->next = node->next;
+  if (node->next != nullptr) {
+    node->next->previous = copy_node;
+  }
+  node->next = copy_node;
+  induction_range_.ReVisit(loop_info);
+  induction_range_.ReVisit(copy_loop_info);
+
+  MaybeRecordStat(stats_, MethodCompilationStat::kLoopUnswitched);
+  return true;
+}
+
 //
 // Loop vectorization. The implementation is based on the book by Aart J.C. Bik:
 // "The Software Vectorization Handbook. Applying Multimedia Extensions for Maximum Performance."
@@ -967,8 +1100,7 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
   vector_refs_->clear();
   vector_static_peeling_factor_ = 0;
   vector_dynamic_peeling_candidate_ = nullptr;
-  vector_runtime_test_a_ =
-  vector_runtime_test_b_ = nullptr;
+  vector_num_runtime_tests_ = 0;
 
   // Phis in the loop-body prevent vectorization.
   if (!block->GetPhis().IsEmpty()) {
@@ -1027,16 +1159,14 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
           // Found a[i+x] vs. b[i+y]. Accept if x == y (at worst loop-independent data dependence).
           // Conservatively assume a potential loop-carried data dependence otherwise, avoided by
           // generating an explicit a != b disambiguation runtime test on the two references.
-          if (x != y) {
-            // To avoid excessive overhead, we only accept one a != b test.
-            if (vector_runtime_test_a_ == nullptr) {
-              // First test found.
-              vector_runtime_test_a_ = a;
-              vector_runtime_test_b_ = b;
-            } else if ((vector_runtime_test_a_ != a || vector_runtime_test_b_ != b) &&
-                       (vector_runtime_test_a_ != b || vector_runtime_test_b_ != a)) {
-              return false;  // second test would be needed
+          if (x != y && !HasRuntimeTest(a, b)) {
+            // To avoid excessive overhead, we only accept a few a != b tests.
+            if (vector_num_runtime_tests_ == kMaxNumberOfRuntimeTests) {
+              return false;  // one more test would be needed
             }
+            vector_runtime_test_a_[vector_num_runtime_tests_] = a;
+            vector_runtime_test_b_[vector_num_runtime_tests_] = b;
+            ++vector_num_runtime_tests_;
           }
         }
       }
@@ -1053,7 +1183,7 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
       uint32_t vote = (offset == 0)
           ? 0
           : ((desired_alignment - offset) >> DataType::SizeShift(i->type));
-      DCHECK_LT(vote, 16u);
+      DCHECK_LT(vote, desired_alignment);
       ++peeling_votes[vote];
     } else if (BaseAlignment() >= desired_alignment &&
                num_same_alignment > max_num_same_alignment) {
@@ -1170,12 +1300,13 @@ void HLoopOptimization::Vectorize(LoopNode* node,
   }
   vector_index_ = graph_->GetConstant(induc_type, 0);
 
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests, which leave all iterations to the cleanup loop
+  // when any two references may alias:
   // vtc = a != b ? vtc : 0;
-  if (vector_runtime_test_a_ != nullptr) {
+  for (size_t i = 0; i < vector_num_runtime_tests_; ++i) {
     HInstruction* rt = Insert(
         preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
+        new (global_allocator_) HNotEqual(vector_runtime_test_a_[i], vector_runtime_test_b_[i]));
     vtc = Insert(preheader,
                  new (global_allocator_)
                  HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
@@ -1218,7 +1349,7 @@ void HLoopOptimization::Vectorize(LoopNode* node,
   // for ( ; i < stc; i += 1)
   //    <loop-body>
   if (needs_cleanup) {
-    DCHECK_IMPLIES(IsInPredicatedVectorizationMode(), vector_runtime_test_a_ != nullptr);
+    DCHECK_IMPLIES(IsInPredicatedVectorizationMode(), vector_num_runtime_tests_ != 0u);
     vector_mode_ = kSequential;
     GenerateNewLoop(node,
                     block,
@@ -1721,12 +1852,14 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
       }
     case InstructionSet::kX86:
     case InstructionSet::kX86_64:
-      // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD).
+      // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD). The x86-64 code
+      // generator also supports the 256-bit SIMD of AVX2 devices, see GetSIMDRegisterWidth().
       if (features->AsX86InstructionSetFeatures()->HasSSE4_1()) {
+        size_t vector_length = simd_register_size_ / DataType::Size(type);
+        DCHECK_EQ(simd_register_size_ % DataType::Size(type), 0u);
         switch (type) {
           case DataType::Type::kBool:
           case DataType::Type::kUint8:
-          case DataType::Type::kInt8:
             *restrictions |= kNoMul |
                              kNoDiv |
                              kNoShift |
@@ -1735,7 +1868,20 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoUnroundedHAdd |
                              kNoSAD |
                              kNoDotProd;
-            return TrySetVectorLength(type, 16);
+            return TrySetVectorLength(type, vector_length);
+          case DataType::Type::kInt8:
+            // Only the x86-64 code generator implements SAD, with psadbw.
+            *restrictions |= kNoMul |
+                             kNoDiv |
+                             kNoShift |
+                             kNoAbs |
+                             kNoSignedHAdd |
+                             kNoUnroundedHAdd |
+                             kNoDotProd;
+            if (compiler_options_->GetInstructionSet() == InstructionSet::kX86) {
+              *restrictions |= kNoSAD;
+            }
+            return TrySetVectorLength(type, vector_length);
           case DataType::Type::kUint16:
             *restrictions |= kNoDiv |
                              kNoAbs |
@@ -1743,26 +1889,26 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoUnroundedHAdd |
                              kNoSAD |
                              kNoDotProd;
-            return TrySetVectorLength(type, 8);
+            return TrySetVectorLength(type, vector_length);
           case DataType::Type::kInt16:
             *restrictions |= kNoDiv |
                              kNoAbs |
                              kNoSignedHAdd |
                              kNoUnroundedHAdd |
                              kNoSAD;
-            return TrySetVectorLength(type, 8);
+            return TrySetVectorLength(type, vector_length);
           case DataType::Type::kInt32:
             *restrictions |= kNoDiv | kNoSAD;
-            return TrySetVectorLength(type, 4);
+            return TrySetVectorLength(type, vector_length);
           case DataType::Type::kInt64:
             *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD;
-            return TrySetVectorLength(type, 2);
+            return TrySetVectorLength(type, vector_length);
           case DataType::Type::kFloat32:
             *restrictions |= kNoReduction;
-            return TrySetVectorLength(type, 4);
+            return TrySetVectorLength(type, vector_length);
           case DataType::Type::kFloat64:
             *restrictions |= kNoReduction;
-            return TrySetVectorLength(type, 2);
+            return TrySetVectorLength(type, vector_length);
           default:
             break;
         }  // switch type
@@ -2372,6 +2518,16 @@ uint32_t HLoopOptimization::MaxNumberPeeled() {
   return vector_static_peeling_factor_;  // known exactly
 }
 
+bool HLoopOptimization::HasRuntimeTest(HInstruction* a, HInstruction* b) const {
+  for (size_t i = 0; i < vector_num_runtime_tests_; ++i) {
+    if ((vector_runtime_test_a_[i] == a && vector_runtime_test_b_[i] == b) ||
+        (vector_runtime_test_a_[i] == b && vector_runtime_test_b_[i] == a)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool HLoopOptimization::IsVectorizationProfitable(int64_t trip_count) {
   // Current heuristic: non-empty body with sufficient number of iterations (if known).
   // TODO: refine by looking at e.g. operation count, alignment, etc.
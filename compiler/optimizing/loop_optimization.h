@@ -182,6 +182,12 @@ class HLoopOptimization : public HOptimization {
   // Tries to apply scalar loop peeling and unrolling.
   bool TryPeelingAndUnrolling(LoopNode* node);
 
+  // Tries to unswitch the loop on a loop invariant condition: the loop is versioned, the
+  // condition is tested once before the two copies and removed from both of them. This mostly
+  // enables vectorization of loops with an invariant `if` in their body. The copy is added to
+  // the loop hierarchy right after `node`. Returns whether transformation happened.
+  bool TryUnswitching(LoopNode* node);
+
   //
   // Vectorization analysis and synthesis.
   //
@@ -258,6 +264,7 @@ class HLoopOptimization : public HOptimization {
                             const ArrayReference* peeling_candidate);
   uint32_t MaxNumberPeeled();
   bool IsVectorizationProfitable(int64_t trip_count);
+  bool HasRuntimeTest(HInstruction* a, HInstruction* b) const;
 
   //
   // Helpers.
@@ -338,9 +345,12 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b, all of which must pass for the vector loop
+  // to run. Each test is a couple of instructions in the preheader, so there are only a few.
+  static constexpr size_t kMaxNumberOfRuntimeTests = 4;
+  HInstruction* vector_runtime_test_a_[kMaxNumberOfRuntimeTests];
+  HInstruction* vector_runtime_test_b_[kMaxNumberOfRuntimeTests];
+  size_t vector_num_runtime_tests_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
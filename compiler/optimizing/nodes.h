@@ -3460,7 +3460,9 @@ class HDoubleConstant final : public HConstant {
 class HIf final : public HExpression<1> {
  public:
   explicit HIf(HInstruction* input, uint32_t dex_pc = kNoDexPc)
-      : HExpression(kIf, SideEffects::None(), dex_pc) {
+      : HExpression(kIf, SideEffects::None(), dex_pc),
+        true_count_(0u),
+        false_count_(0u) {
     SetRawInputAt(0, input);
   }
 
@@ -3475,10 +3477,60 @@ class HIf final : public HExpression<1> {
     return GetBlock()->GetSuccessors()[1];
   }
 
+  // The number of times each successor was taken, from the branch profile of the method.
+  // Both counts are zero when the branch was not profiled.
+  void SetProfileCounts(uint16_t true_count, uint16_t false_count) {
+    true_count_ = true_count;
+    false_count_ = false_count;
+  }
+
+  uint16_t GetTrueCount() const { return true_count_; }
+  uint16_t GetFalseCount() const { return false_count_; }
+
+  // Returns whether the branch was executed often enough for its profile to be trusted.
+  bool HasReliableProfile() const {
+    return static_cast<uint32_t>(true_count_) + false_count_ >= kMinimumProfiledCount;
+  }
+
+  // Returns the successor taken at least 90% of the time, or null if there is none or the
+  // profile is not reliable.
+  HBasicBlock* GetLikelySuccessor() const {
+    if (!HasReliableProfile()) {
+      return nullptr;
+    }
+    uint32_t total = static_cast<uint32_t>(true_count_) + false_count_;
+    if (true_count_ * 10u >= total * 9u) {
+      return IfTrueSuccessor();
+    } else if (false_count_ * 10u >= total * 9u) {
+      return IfFalseSuccessor();
+    }
+    return nullptr;
+  }
+
+  // Returns whether the profile shows the branch to `successor` was never taken.
+  bool IsNeverTaken(const HBasicBlock* successor) const {
+    DCHECK(successor == IfTrueSuccessor() || successor == IfFalseSuccessor());
+    return HasReliableProfile() &&
+           (successor == IfTrueSuccessor() ? true_count_ : false_count_) == 0u;
+  }
+
+  // Returns whether the profile shows each successor taken at least a quarter of the time,
+  // which a branch predictor cannot guess well.
+  bool IsUnpredictable() const {
+    uint32_t total = static_cast<uint32_t>(true_count_) + false_count_;
+    return HasReliableProfile() && std::min(true_count_, false_count_) * 4u >= total;
+  }
+
   DECLARE_INSTRUCTION(If);
 
  protected:
   DEFAULT_COPY_CONSTRUCTOR(If);
+
+ private:
+  static constexpr uint32_t kMinimumProfiledCount = 100u;
+
+  uint16_t true_count_;
+  uint16_t false_count_;
 };
 
 
@@ -4977,7 +5029,9 @@ class HInvokeStaticOrDirect final : public HInvoke {
   }
 
   bool CanBeNull() const override {
-    return GetType() == DataType::Type::kReference && !IsStringInit();
+    return GetType() == DataType::Type::kReference &&
+           !IsStringInit() &&
+           GetIntrinsic() != Intrinsics::kIntegerValueOf;
   }
 
   MethodLoadKind GetMethodLoadKind() const { return dispatch_info_.method_load_kind; }
@@ -265,7 +265,8 @@ ArenaVector<HOptimization*> ConstructOptimizations(
         opt = new (allocator) ConstructorFenceRedundancyElimination(graph, stats, pass_name);
         break;
       case OptimizationPass::kLoadStoreElimination:
-        opt = new (allocator) LoadStoreElimination(graph, stats, pass_name);
+        opt = new (allocator) LoadStoreElimination(
+            graph, stats, pass_name, codegen->GetCompilerOptions().IsPartialLSEEnabled());
         break;
       case OptimizationPass::kScheduling:
         opt = new (allocator) HInstructionScheduling(
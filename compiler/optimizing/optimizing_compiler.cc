@@ -30,6 +30,7 @@
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "builder.h"
 #include "code_generator.h"
@@ -103,19 +104,23 @@ class PassObserver : public ValueObject {
   PassObserver(HGraph* graph,
                CodeGenerator* codegen,
                std::ostream* visualizer_output,
-               const CompilerOptions& compiler_options)
+               const CompilerOptions& compiler_options,
+               OptimizingCompilerStats* stats)
       : graph_(graph),
         last_seen_graph_size_(0),
         cached_method_name_(),
         timing_logger_enabled_(compiler_options.GetDumpPassTimings()),
         timing_logger_(timing_logger_enabled_ ? GetMethodName() : "", true, true),
+        stats_(stats),
+        pass_start_ns_(0u),
         disasm_info_(graph->GetAllocator()),
         visualizer_oss_(),
         visualizer_output_(visualizer_output),
         visualizer_enabled_(!compiler_options.GetDumpCfgFileName().empty()),
         visualizer_(&visualizer_oss_, graph, codegen),
         codegen_(codegen),
-        graph_in_bad_state_(false) {
+        graph_in_bad_state_(false),
+        over_pass_time_budget_(false) {
     if (timing_logger_enabled_ || visualizer_enabled_) {
       if (!IsVerboseMethod(compiler_options, GetMethodName())) {
         timing_logger_enabled_ = visualizer_enabled_ = false;
@@ -147,6 +152,9 @@ class PassObserver : public ValueObject {
 
   void SetGraphInBadState() { graph_in_bad_state_ = true; }
 
+  bool IsOverPassTimeBudget() const { return over_pass_time_budget_; }
+  void SetOverPassTimeBudget() { over_pass_time_budget_ = true; }
+
   const char* GetMethodName() {
     // PrettyMethod() is expensive, so we delay calling it until we actually have to.
     if (cached_method_name_.empty()) {
@@ -166,6 +174,9 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.StartTiming(pass_name);
     }
+    if (stats_ != nullptr) {
+      pass_start_ns_ = NanoTime();
+    }
   }
 
   void FlushVisualizer() {
@@ -180,6 +191,9 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.EndTiming();
     }
+    if (stats_ != nullptr) {
+      stats_->RecordPassTime(pass_name, NanoTime() - pass_start_ns_);
+    }
     if (visualizer_enabled_) {
       visualizer_.DumpGraph(pass_name, /* is_after_pass= */ true, graph_in_bad_state_);
       FlushVisualizer();
@@ -226,6 +240,10 @@ class PassObserver : public ValueObject {
   bool timing_logger_enabled_;
   TimingLogger timing_logger_;
 
+  // Compile time per pass, summed over all methods in `--dump-stats`.
+  OptimizingCompilerStats* const stats_;
+  uint64_t pass_start_ns_;
+
   DisassemblyInformation disasm_info_;
 
   std::ostringstream visualizer_oss_;
@@ -238,6 +256,11 @@ class PassObserver : public ValueObject {
   // expected to validate.
   bool graph_in_bad_state_;
 
+  // Set once a pass of this method took longer than `--pass-time-budget-ms`. Kept here
+  // rather than per pass list so that the later lists, including the architecture-specific
+  // one, skip their passes as well.
+  bool over_pass_time_budget_;
+
   friend PassScope;
 
   DISALLOW_COPY_AND_ASSIGN(PassObserver);
@@ -266,6 +289,25 @@ class PassScope : public ValueObject {
   PassObserver* const pass_observer_;
 };
 
+// Returns whether `pass` must run even after a pass went over the pass time budget: the code
+// generators rely on it, or it is an analysis other passes may rely on.
+static bool IgnoresPassTimeBudget(OptimizationPass pass) {
+  switch (pass) {
+    case OptimizationPass::kAggressiveInstructionSimplifier:
+    case OptimizationPass::kInductionVarAnalysis:
+    case OptimizationPass::kSideEffectsAnalysis:
+#ifdef ART_ENABLE_CODEGEN_arm
+    case OptimizationPass::kCriticalNativeAbiFixupArm:
+#endif
+#ifdef ART_ENABLE_CODEGEN_x86
+    case OptimizationPass::kPcRelativeFixupsX86:
+#endif
+      return true;
+    default:
+      return false;
+  }
+}
+
 class OptimizingCompiler final : public Compiler {
  public:
   explicit OptimizingCompiler(const CompilerOptions& compiler_options,
@@ -324,12 +366,28 @@ class OptimizingCompiler final : public Compiler {
     // the most recent occurrence of that pass, skipped or executed.
     std::bitset<static_cast<size_t>(OptimizationPass::kLast) + 1u> pass_changes;
     pass_changes[static_cast<size_t>(OptimizationPass::kNone)] = true;
+    // Once a pass has taken longer than the pass time budget, the method is too large for
+    // the remaining passes to fit in theirs: skip them like passes whose dependence did not
+    // change anything, except those which must run.
+    const uint64_t budget_ns = MsToNs(GetCompilerOptions().GetPassTimeBudgetMs());
+    const bool budget_exhausted = GetCompilerOptions().IsPassTimeBudgetExhaustedForTesting();
     bool change = false;
     for (size_t i = 0; i < length; ++i) {
-      if (pass_changes[static_cast<size_t>(definitions[i].depends_on)]) {
+      bool skip =
+          pass_observer->IsOverPassTimeBudget() && !IgnoresPassTimeBudget(definitions[i].pass);
+      if (skip) {
+        VLOG(compiler) << "Skipping pass over time budget: " << optimizations[i]->GetPassName();
+        MaybeRecordStat(compilation_stats_.get(),
+                        MethodCompilationStat::kSkippedPassOverTimeBudget);
+      }
+      if (!skip && pass_changes[static_cast<size_t>(definitions[i].depends_on)]) {
         // Execute the pass and record whether it changed anything.
         PassScope scope(optimizations[i]->GetPassName(), pass_observer);
+        uint64_t start_ns = (budget_ns != 0u) ? NanoTime() : 0u;
         bool pass_change = optimizations[i]->Run();
+        if (budget_exhausted || (budget_ns != 0u && NanoTime() - start_ns > budget_ns)) {
+          pass_observer->SetOverPassTimeBudget();
+        }
         pass_changes[static_cast<size_t>(definitions[i].pass)] = pass_change;
         if (pass_change) {
           change = true;
@@ -558,6 +616,9 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
         OptDef(OptimizationPass::kInstructionSimplifierX86_64),
         OptDef(OptimizationPass::kSideEffectsAnalysis),
         OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
+        // Schedule before the memory operand generation, which places instructions
+        // right before their use.
+        OptDef(OptimizationPass::kScheduling),
         OptDef(OptimizationPass::kX86MemoryOperandGeneration)
       };
       return RunOptimizations(graph,
@@ -596,6 +657,7 @@ static void AllocateRegisters(HGraph* graph,
     std::unique_ptr<RegisterAllocator> register_allocator =
         RegisterAllocator::Create(&local_allocator, codegen, liveness, strategy);
     register_allocator->AllocateRegisters();
+    register_allocator->RecordSpillsAndFillsInLoops(stats);
   }
 }
 
@@ -835,7 +897,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
-                             compiler_options);
+                             compiler_options,
+                             compilation_stats_.get());
 
   {
     VLOG(compiler) << "Building " << pass_observer.GetMethodName();
@@ -958,7 +1021,8 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
-                             compiler_options);
+                             compiler_options,
+                             compilation_stats_.get());
 
   {
     VLOG(compiler) << "Building intrinsic graph " << pass_observer.GetMethodName();
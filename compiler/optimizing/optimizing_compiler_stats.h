@@ -19,6 +19,7 @@
 
 #include <atomic>
 #include <iomanip>
+#include <map>
 #include <string>
 #include <type_traits>
 
@@ -26,6 +27,9 @@
 
 #include "base/atomic.h"
 #include "base/globals.h"
+#include "base/mutex.h"
+#include "base/time_utils.h"
+#include "thread-current-inl.h"
 
 namespace art {
 
@@ -63,6 +67,7 @@ enum class MethodCompilationStat {
   kNotCompiledPhiEquivalentInOsr,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
+  kInlinedDominantReceiverCall,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
@@ -71,7 +76,9 @@ enum class MethodCompilationStat {
   kLoopInvariantMoved,
   kLoopVectorized,
   kLoopVectorizedIdiom,
+  kLoopUnswitched,
   kSelectGenerated,
+  kBiasedBranchNotSelected,
   kRemovedInstanceOf,
   kInlinedInvokeVirtualOrInterface,
   kInlinedLastInvokeVirtualOrInterface,
@@ -105,6 +112,7 @@ enum class MethodCompilationStat {
   kNotInlinedUnresolved,
   kNotInlinedPolymorphic,
   kNotInlinedCustom,
+  kNotInlinedNeverExecuted,
   kTryInline,
   kConstructorFenceGeneratedNew,
   kConstructorFenceGeneratedFinal,
@@ -122,6 +130,9 @@ enum class MethodCompilationStat {
   kPredicatedLoadAdded,
   kPredicatedStoreAdded,
   kDevirtualized,
+  kSpillInLoop,
+  kFillInLoop,
+  kSkippedPassOverTimeBudget,
   kLastStat
 };
 std::ostream& operator<<(std::ostream& os, MethodCompilationStat rhs);
@@ -145,7 +156,16 @@ class OptimizingCompilerStats {
     return compile_stats_[stat_index];
   }
 
-  void Log() const {
+  // Add `time_ns` to the compile time spent in the pass `pass_name`, over all methods.
+  void RecordPassTime(const std::string& pass_name, uint64_t time_ns, uint32_t runs = 1)
+      REQUIRES(!pass_times_lock_) {
+    MutexLock mu(Thread::Current(), pass_times_lock_);
+    PassTime& pass_time = pass_times_[pass_name];
+    pass_time.time_ns += time_ns;
+    pass_time.runs += runs;
+  }
+
+  void Log() const REQUIRES(!pass_times_lock_) {
     uint32_t compiled_intrinsics = GetStat(MethodCompilationStat::kCompiledIntrinsic);
     uint32_t compiled_native_stubs = GetStat(MethodCompilationStat::kCompiledNativeStub);
     uint32_t bytecode_attempts =
@@ -173,26 +193,53 @@ class OptimizingCompilerStats {
         }
       }
     }
+
+    MutexLock mu(Thread::Current(), pass_times_lock_);
+    for (const auto& entry : pass_times_) {
+      LOG(INFO) << "PassTime#" << entry.first << ": " << PrettyDuration(entry.second.time_ns)
+          << " in " << entry.second.runs << " runs";
+    }
   }
 
-  void AddTo(OptimizingCompilerStats* other_stats) {
+  void AddTo(OptimizingCompilerStats* other_stats) REQUIRES(!pass_times_lock_) {
     for (size_t i = 0; i != arraysize(compile_stats_); ++i) {
       uint32_t count = compile_stats_[i];
       if (count != 0) {
         other_stats->RecordStat(static_cast<MethodCompilationStat>(i), count);
       }
     }
+    // Copy the times out first, `other_stats` takes its own lock at the same level.
+    std::map<std::string, PassTime> pass_times;
+    {
+      MutexLock mu(Thread::Current(), pass_times_lock_);
+      pass_times = pass_times_;
+    }
+    for (const auto& entry : pass_times) {
+      other_stats->RecordPassTime(entry.first, entry.second.time_ns, entry.second.runs);
+    }
   }
 
-  void Reset() {
+  void Reset() REQUIRES(!pass_times_lock_) {
     for (std::atomic<uint32_t>& stat : compile_stats_) {
       stat = 0u;
     }
+    MutexLock mu(Thread::Current(), pass_times_lock_);
+    pass_times_.clear();
   }
 
  private:
+  struct PassTime {
+    uint64_t time_ns = 0u;
+    uint32_t runs = 0u;
+  };
+
   std::atomic<uint32_t> compile_stats_[static_cast<size_t>(MethodCompilationStat::kLastStat)];
 
+  // Compile time per pass name. Compiler threads share the stats, but only take this lock
+  // to update or dump the times, and no other lock while holding it.
+  mutable Mutex pass_times_lock_{"pass times lock", kGenericBottomLock};
+  std::map<std::string, PassTime> pass_times_ GUARDED_BY(pass_times_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(OptimizingCompilerStats);
 };
 
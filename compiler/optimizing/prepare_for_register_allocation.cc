@@ -180,6 +180,13 @@ bool PrepareForRegisterAllocation::CanEmitConditionAt(HCondition* condition,
     return false;
   }
 
+  if (user->IsIf() &&
+      GetGraph()->IsCompilingBaseline() &&
+      GetGraph()->GetProfilingInfo() != nullptr) {
+    // Baseline code counts the outcomes of the branch with the value of the condition.
+    return false;
+  }
+
   if (user->IsIf() || user->IsDeoptimize()) {
     return true;
   }
@@ -23,8 +23,10 @@
 #include "base/scoped_arena_containers.h"
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
+#include "optimizing_compiler_stats.h"
 #include "register_allocator_graph_color.h"
 #include "register_allocator_linear_scan.h"
+#include "register_allocator_loop_split.h"
 #include "ssa_liveness_analysis.h"
 
 namespace art {
@@ -47,6 +49,9 @@ std::unique_ptr<RegisterAllocator> RegisterAllocator::Create(ScopedArenaAllocato
     case kRegisterAllocatorGraphColor:
       return std::unique_ptr<RegisterAllocator>(
           new (allocator) RegisterAllocatorGraphColor(allocator, codegen, analysis));
+    case kRegisterAllocatorLoopSplit:
+      return std::unique_ptr<RegisterAllocator>(
+          new (allocator) RegisterAllocatorLoopSplit(allocator, codegen, analysis));
     default:
       LOG(FATAL) << "Invalid register allocation strategy: " << strategy;
       UNREACHABLE();
@@ -68,6 +73,40 @@ RegisterAllocator::~RegisterAllocator() {
   }
 }
 
+static bool IsStackSlotKind(Location location) {
+  return location.IsStackSlot() || location.IsDoubleStackSlot() || location.IsSIMDStackSlot();
+}
+
+void RegisterAllocator::RecordSpillsAndFillsInLoops(OptimizingCompilerStats* stats) const {
+  if (stats == nullptr) {
+    return;
+  }
+  uint32_t spills = 0u;
+  uint32_t fills = 0u;
+  for (HBasicBlock* block : codegen_->GetGraph()->GetLinearOrder()) {
+    if (!block->IsInLoop()) {
+      continue;
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HParallelMove* move = it.Current()->AsParallelMove();
+      if (move == nullptr) {
+        continue;
+      }
+      for (size_t i = 0, e = move->NumMoves(); i != e; ++i) {
+        MoveOperands* operands = move->MoveOperandsAt(i);
+        if (operands->GetSource().IsRegisterKind() && IsStackSlotKind(operands->GetDestination())) {
+          ++spills;
+        } else if (IsStackSlotKind(operands->GetSource()) &&
+                   operands->GetDestination().IsRegisterKind()) {
+          ++fills;
+        }
+      }
+    }
+  }
+  MaybeRecordStat(stats, MethodCompilationStat::kSpillInLoop, spills);
+  MaybeRecordStat(stats, MethodCompilationStat::kFillInLoop, fills);
+}
+
 class AllRangesIterator : public ValueObject {
  public:
   explicit AllRangesIterator(LiveInterval* interval)
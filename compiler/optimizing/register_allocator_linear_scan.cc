@@ -198,6 +198,7 @@ void RegisterAllocatorLinearScan::AllocateRegistersInternal() {
       inactive_.push_back(fixed);
     }
   }
+  PrepareLinearScan();
   LinearScan();
 
   inactive_.clear();
@@ -218,6 +219,7 @@ void RegisterAllocatorLinearScan::AllocateRegistersInternal() {
       inactive_.push_back(fixed);
     }
   }
+  PrepareLinearScan();
   LinearScan();
 }
 
@@ -602,7 +604,7 @@ void RegisterAllocatorLinearScan::LinearScan() {
     }
 
     // (4) Try to find an available register.
-    bool success = TryAllocateFreeReg(current);
+    bool success = !IsSpillPreferred(current) && TryAllocateFreeReg(current);
 
     // (5) If no register could be found, we need to spill.
     if (!success) {
@@ -729,7 +731,7 @@ bool RegisterAllocatorLinearScan::TryAllocateFreeReg(LiveInterval* current) {
     }
   } else {
     DCHECK(!current->IsHighInterval());
-    int hint = current->FindFirstRegisterHint(free_until, liveness_);
+    int hint = FindRegisterHint(current, free_until);
     if ((hint != kNoRegister)
         // For simplicity, if the hint we are getting for a pair cannot be used,
         // we are just going to allocate a new pair.
@@ -772,6 +774,11 @@ bool RegisterAllocatorLinearScan::TryAllocateFreeReg(LiveInterval* current) {
   return true;
 }
 
+int RegisterAllocatorLinearScan::FindRegisterHint(LiveInterval* interval,
+                                                  size_t* free_until) const {
+  return interval->FindFirstRegisterHint(free_until, liveness_);
+}
+
 bool RegisterAllocatorLinearScan::IsBlocked(int reg) const {
   return processing_core_registers_
       ? blocked_core_registers_[reg]
@@ -63,11 +63,21 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
         + catch_phi_spill_slots_;
   }
 
- private:
-  // Main methods of the allocator.
-  void LinearScan();
-  bool TryAllocateFreeReg(LiveInterval* interval);
-  bool AllocateBlockedReg(LiveInterval* interval);
+ protected:
+  // Called before the linear scan of each register kind, once `GetUnhandledIntervals()`
+  // holds all the intervals of that kind. Strategies may split intervals beforehand.
+  virtual void PrepareLinearScan() {}
+
+  // Returns whether `interval` should go to the stack without trying to find it a free
+  // register. Only used for intervals without register uses.
+  virtual bool IsSpillPreferred(LiveInterval* interval ATTRIBUTE_UNUSED) const { return false; }
+
+  // Returns the register `interval` should get if it is free, or kNoRegister.
+  virtual int FindRegisterHint(LiveInterval* interval, size_t* free_until) const;
+
+  ScopedArenaVector<LiveInterval*>* GetUnhandledIntervals() const { return unhandled_; }
+  bool IsProcessingCoreRegisters() const { return processing_core_registers_; }
+  size_t GetNumberOfRegisters() const { return number_of_registers_; }
 
   // Add `interval` in the given sorted list.
   static void AddSorted(ScopedArenaVector<LiveInterval*>* array, LiveInterval* interval);
@@ -75,6 +85,12 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
   // Returns whether `reg` is blocked by the code generator.
   bool IsBlocked(int reg) const;
 
+ private:
+  // Main methods of the allocator.
+  void LinearScan();
+  bool TryAllocateFreeReg(LiveInterval* interval);
+  bool AllocateBlockedReg(LiveInterval* interval);
+
   // Update the interval for the register in `location` to cover [start, end).
   void BlockRegister(Location location, size_t start, size_t end);
   void BlockRegisters(size_t start, size_t end, bool caller_save_only = false);
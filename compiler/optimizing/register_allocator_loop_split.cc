@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "register_allocator_loop_split.h"
+
+#include "base/bit_vector-inl.h"
+#include "code_generator.h"
+#include "ssa_liveness_analysis.h"
+
+namespace art {
+
+RegisterAllocatorLoopSplit::RegisterAllocatorLoopSplit(ScopedArenaAllocator* allocator,
+                                                       CodeGenerator* codegen,
+                                                       const SsaLivenessAnalysis& liveness)
+    : RegisterAllocatorLinearScan(allocator, codegen, liveness),
+      spill_preferred_(allocator->Adapter(kArenaAllocRegisterAllocator)) {}
+
+RegisterAllocatorLoopSplit::~RegisterAllocatorLoopSplit() {}
+
+bool RegisterAllocatorLoopSplit::IsUnderRegisterPressure(HLoopInformation* loop_info) const {
+  size_t number_of_available_registers = 0;
+  for (size_t reg = 0, e = GetNumberOfRegisters(); reg != e; ++reg) {
+    if (!IsBlocked(reg)) {
+      ++number_of_available_registers;
+    }
+  }
+
+  // Count the values live at the boundaries of each block of the loop. This misses the values
+  // which only live inside a block, but these rarely make the difference.
+  bool processing_core_registers = IsProcessingCoreRegisters();
+  auto count_live_values = [&](const BitVector* live) {
+    size_t count = 0;
+    for (uint32_t index : live->Indexes()) {
+      HInstruction* instruction = liveness_.GetInstructionFromSsaIndex(index);
+      if (DataType::IsFloatingPointType(instruction->GetType()) != processing_core_registers) {
+        ++count;
+      }
+    }
+    return count;
+  };
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    if (count_live_values(liveness_.GetLiveInSet(*block)) >= number_of_available_registers ||
+        count_live_values(liveness_.GetLiveOutSet(*block)) >= number_of_available_registers) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void RegisterAllocatorLoopSplit::SplitAroundLoops(LiveInterval* interval,
+                                                  ArrayRef<const HLoopInformation* const> loops) {
+  ScopedArenaVector<LiveInterval*>* unhandled = GetUnhandledIntervals();
+  LiveInterval* current = interval;
+  // Loops are sorted by start position, so outer loops come before their inner loops.
+  for (const HLoopInformation* loop_info : loops) {
+    size_t start = loop_info->GetHeader()->GetLifetimeStart();
+    size_t end = loop_info->GetLifetimeEnd();
+    if (start <= current->GetStart()) {
+      // Defined in the loop, or in an outer loop `current` has already been split around.
+      continue;
+    }
+    if (current->IsDeadAt(start)) {
+      return;
+    }
+    if (!current->CoversSlow(start)) {
+      continue;
+    }
+    // Synthesized back edge uses and phi inputs at the back edge also count: they would need
+    // the value in a register at the end of every iteration.
+    size_t next_use = current->FirstUseAfter(start);
+    if (next_use != kNoLifetime && next_use <= end) {
+      continue;
+    }
+
+    // The value lives across the whole loop, see `SsaLivenessAnalysis::ComputeLiveRanges`.
+    // Moving to the stack at the loop entry is free as values are spilled at their definition.
+    LiveInterval* in_loop = Split(current, start);
+    DCHECK_NE(in_loop, current);
+    AddSorted(unhandled, in_loop);
+    spill_preferred_.insert(in_loop);
+    if (in_loop->IsDeadAt(end)) {
+      return;
+    }
+    current = Split(in_loop, end);
+    DCHECK_NE(current, in_loop);
+    AddSorted(unhandled, current);
+  }
+}
+
+void RegisterAllocatorLoopSplit::PrepareLinearScan() {
+  HGraph* graph = codegen_->GetGraph();
+  if (!graph->HasLoops() || graph->HasIrreducibleLoops()) {
+    return;
+  }
+
+  ScopedArenaVector<const HLoopInformation*> loops(
+      allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (HBasicBlock* block : graph->GetLinearOrder()) {
+    if (block->IsLoopHeader() && IsUnderRegisterPressure(block->GetLoopInformation())) {
+      loops.push_back(block->GetLoopInformation());
+    }
+  }
+  if (loops.empty()) {
+    return;
+  }
+
+  // Splitting adds intervals to the unhandled list, so walk a copy of it.
+  ScopedArenaVector<LiveInterval*>* unhandled = GetUnhandledIntervals();
+  ScopedArenaVector<LiveInterval*> intervals(unhandled->begin(),
+                                             unhandled->end(),
+                                             allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (LiveInterval* interval : intervals) {
+    // High intervals are split along with their low interval.
+    if (interval->IsHighInterval() || interval->IsTemp() || interval->HasRegister()) {
+      continue;
+    }
+    SplitAroundLoops(interval, ArrayRef<const HLoopInformation* const>(loops));
+  }
+}
+
+bool RegisterAllocatorLoopSplit::IsSpillPreferred(LiveInterval* interval) const {
+  return !spill_preferred_.empty() && spill_preferred_.find(interval) != spill_preferred_.end();
+}
+
+int RegisterAllocatorLoopSplit::FindRegisterHint(LiveInterval* interval,
+                                                 size_t* free_until) const {
+  int hint = RegisterAllocatorLinearScan::FindRegisterHint(interval, free_until);
+  if (hint != kNoRegister || !interval->IsSplit()) {
+    return hint;
+  }
+
+  // Coalesce `interval` with the sibling it was split from. With the same register on both
+  // sides, the resolver does not need a parallel move between them.
+  LiveInterval* previous = interval->GetParent();
+  while (previous->GetNextSibling() != interval) {
+    previous = previous->GetNextSibling();
+  }
+  if (previous->HasRegister() &&
+      free_until[previous->GetRegister()] >= interval->FirstRegisterUse()) {
+    return previous->GetRegister();
+  }
+  return kNoRegister;
+}
+
+}  // namespace art
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_LOOP_SPLIT_H_
+#define ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_LOOP_SPLIT_H_
+
+#include "base/macros.h"
+#include "base/scoped_arena_containers.h"
+#include "register_allocator_linear_scan.h"
+
+namespace art {
+
+class CodeGenerator;
+class HLoopInformation;
+class LiveInterval;
+class SsaLivenessAnalysis;
+
+/**
+ * A linear scan register allocator which keeps spill code out of loops.
+ *
+ * The linear scan spills the interval whose next use is the furthest, at the position where it
+ * runs out of registers. For a value live across a loop but not used in it, that position is
+ * often in the loop body: the value is then in a register at the loop header and on the stack at
+ * the back edge, and gets reloaded on every iteration. Before the scan, this allocator splits
+ * such intervals at the boundaries of the loops which have more live values than registers, and
+ * leaves the part covering the loop on the stack. The value is stored once at its definition and
+ * reloaded once after the loop.
+ *
+ * Split siblings also prefer the register of the sibling they were split from, so that the
+ * parallel moves connecting them are not needed.
+ */
+class RegisterAllocatorLoopSplit : public RegisterAllocatorLinearScan {
+ public:
+  RegisterAllocatorLoopSplit(ScopedArenaAllocator* allocator,
+                             CodeGenerator* codegen,
+                             const SsaLivenessAnalysis& analysis);
+  ~RegisterAllocatorLoopSplit() override;
+
+ protected:
+  void PrepareLinearScan() override;
+  bool IsSpillPreferred(LiveInterval* interval) const override;
+  int FindRegisterHint(LiveInterval* interval, size_t* free_until) const override;
+
+ private:
+  // Returns whether more values of the register kind being allocated are live in `loop_info`
+  // than there are registers to hold them.
+  bool IsUnderRegisterPressure(HLoopInformation* loop_info) const;
+
+  // Split `interval` around the loops it lives across without using it.
+  void SplitAroundLoops(LiveInterval* interval, ArrayRef<const HLoopInformation* const> loops);
+
+  // Intervals which cover a loop without any use in it, and go to the stack.
+  ScopedArenaHashSet<LiveInterval*> spill_preferred_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegisterAllocatorLoopSplit);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_LOOP_SPLIT_H_
@@ -26,6 +26,7 @@
 #include "dex/dex_instruction.h"
 #include "driver/compiler_options.h"
 #include "nodes.h"
+#include "optimizing_compiler_stats.h"
 #include "optimizing_unit_test.h"
 #include "register_allocator_linear_scan.h"
 #include "ssa_liveness_analysis.h"
@@ -85,6 +86,9 @@ TEST_F(RegisterAllocatorTest, test_name##_LinearScan) {\
 }\
 TEST_F(RegisterAllocatorTest, test_name##_GraphColor) {\
   test_name(Strategy::kRegisterAllocatorGraphColor);\
+}\
+TEST_F(RegisterAllocatorTest, test_name##_LoopSplit) {\
+  test_name(Strategy::kRegisterAllocatorLoopSplit);\
 }
 
 bool RegisterAllocatorTest::Check(const std::vector<uint16_t>& data, Strategy strategy) {
@@ -941,4 +945,90 @@ TEST_F(RegisterAllocatorTest, SpillInactive) {
   ASSERT_TRUE(ValidateIntervals(intervals, codegen));
 }
 
+TEST_F(RegisterAllocatorTest, SplitAroundLoopUnderPressure) {
+  /*
+   * Test the following snippet, with more values live across the loop than the 7 core
+   * registers of x86:
+   *  int v0 = 1;
+   *  int v1 = v0 + 1;
+   *  ...
+   *  int v11 = v10 + 1;
+   *  for (int i = 0; i < 100; ++i) {}
+   *  return v1 + v2 + ... + v11;
+   *
+   * The values are not used in the loop, so they should be split around it and stay on
+   * the stack for the whole loop, with no spill or fill in the loop.
+   */
+  const std::vector<uint16_t> data = N_REGISTERS_CODE_ITEM(14,
+    Instruction::CONST_4 | 0 << 8 | 1 << 12,
+    Instruction::ADD_INT_LIT8 | 1 << 8, 0 | 1 << 8,
+    Instruction::ADD_INT_LIT8 | 2 << 8, 1 | 1 << 8,
+    Instruction::ADD_INT_LIT8 | 3 << 8, 2 | 1 << 8,
+    Instruction::ADD_INT_LIT8 | 4 << 8, 3 | 1 << 8,
+    Instruction::ADD_INT_LIT8 | 5 << 8, 4 | 1 << 8,
+    Instruction::ADD_INT_LIT8 | 6 << 8, 5 | 1 << 8,
+    Instruction::ADD_INT_LIT8 | 7 << 8, 6 | 1 << 8,
+    Instruction::ADD_INT_LIT8 | 8 << 8, 7 | 1 << 8,
+    Instruction::ADD_INT_LIT8 | 9 << 8, 8 | 1 << 8,
+    Instruction::ADD_INT_LIT8 | 10 << 8, 9 | 1 << 8,
+    Instruction::ADD_INT_LIT8 | 11 << 8, 10 | 1 << 8,
+    Instruction::CONST_4 | 12 << 8 | 0 << 12,
+    Instruction::CONST_16 | 13 << 8, 100,
+    Instruction::IF_GE | 12 << 8 | 13 << 12, 5,
+    Instruction::ADD_INT_LIT8 | 12 << 8, 12 | 1 << 8,
+    Instruction::GOTO | 0xFC00,
+    Instruction::ADD_INT_2ADDR | 1 << 8 | 2 << 12,
+    Instruction::ADD_INT_2ADDR | 1 << 8 | 3 << 12,
+    Instruction::ADD_INT_2ADDR | 1 << 8 | 4 << 12,
+    Instruction::ADD_INT_2ADDR | 1 << 8 | 5 << 12,
+    Instruction::ADD_INT_2ADDR | 1 << 8 | 6 << 12,
+    Instruction::ADD_INT_2ADDR | 1 << 8 | 7 << 12,
+    Instruction::ADD_INT_2ADDR | 1 << 8 | 8 << 12,
+    Instruction::ADD_INT_2ADDR | 1 << 8 | 9 << 12,
+    Instruction::ADD_INT_2ADDR | 1 << 8 | 10 << 12,
+    Instruction::ADD_INT_2ADDR | 1 << 8 | 11 << 12,
+    Instruction::RETURN | 1 << 8);
+
+  HGraph* graph = CreateCFG(data);
+  ASSERT_TRUE(graph != nullptr);
+  x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
+  SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
+  liveness.Analyze();
+  std::unique_ptr<RegisterAllocator> register_allocator = RegisterAllocator::Create(
+      GetScopedAllocator(), &codegen, liveness, Strategy::kRegisterAllocatorLoopSplit);
+  register_allocator->AllocateRegisters();
+  ASSERT_TRUE(register_allocator->Validate(false));
+
+  HBasicBlock* header = nullptr;
+  for (HBasicBlock* block : graph->GetLinearOrder()) {
+    if (block->IsLoopHeader()) {
+      header = block;
+    }
+  }
+  ASSERT_TRUE(header != nullptr);
+  size_t loop_start = header->GetLifetimeStart();
+
+  // Each value goes to the stack at the loop header.
+  size_t number_of_values = 0u;
+  for (HBasicBlock* block : graph->GetLinearOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (!instruction->IsAdd() || instruction->GetLifetimePosition() >= loop_start) {
+        continue;
+      }
+      ++number_of_values;
+      LiveInterval* in_loop = instruction->GetLiveInterval()->GetSiblingAt(loop_start);
+      ASSERT_TRUE(in_loop != nullptr);
+      EXPECT_TRUE(in_loop->IsSplit());
+      EXPECT_FALSE(in_loop->HasRegister());
+    }
+  }
+  EXPECT_EQ(11u, number_of_values);
+
+  OptimizingCompilerStats stats;
+  register_allocator->RecordSpillsAndFillsInLoops(&stats);
+  EXPECT_EQ(0u, stats.GetStat(MethodCompilationStat::kSpillInLoop));
+  EXPECT_EQ(0u, stats.GetStat(MethodCompilationStat::kFillInLoop));
+}
+
 }  // namespace art
@@ -23,6 +23,10 @@ namespace art {
 
 static constexpr size_t kMaxInstructionsInBranch = 1u;
 
+// The number of instructions allowed in each branch of an If whose profile shows both branches
+// are often taken. Computing both values then costs less than the branch mispredictions.
+static constexpr size_t kMaxInstructionsInUnpredictableBranch = 3u;
+
 HSelectGenerator::HSelectGenerator(HGraph* graph,
                                    OptimizingCompilerStats* stats,
                                    const char* name)
@@ -30,9 +34,9 @@ HSelectGenerator::HSelectGenerator(HGraph* graph,
 }
 
 // Returns true if `block` has only one predecessor, ends with a Goto
-// or a Return and contains at most `kMaxInstructionsInBranch` other
+// or a Return and contains at most `max_instructions` other
 // movable instruction with no side-effects.
-static bool IsSimpleBlock(HBasicBlock* block) {
+static bool IsSimpleBlock(HBasicBlock* block, size_t max_instructions) {
   if (block->GetPredecessors().size() != 1u) {
     return false;
   }
@@ -51,7 +55,7 @@ static bool IsSimpleBlock(HBasicBlock* block) {
         // Count one HCondition and HSelect in the same block as a single instruction.
         // This enables finding nested selects.
         continue;
-      } else if (++num_instructions > kMaxInstructionsInBranch) {
+      } else if (++num_instructions > max_instructions) {
         return false;  // bail as soon as we exceed number of allowed instructions
       }
     } else {
@@ -108,11 +112,21 @@ bool HSelectGenerator::Run() {
     HBasicBlock* false_block = if_instruction->IfFalseSuccessor();
     DCHECK_NE(true_block, false_block);
 
-    if (!IsSimpleBlock(true_block) ||
-        !IsSimpleBlock(false_block) ||
+    size_t max_instructions = if_instruction->IsUnpredictable()
+        ? kMaxInstructionsInUnpredictableBranch
+        : kMaxInstructionsInBranch;
+    if (!IsSimpleBlock(true_block, max_instructions) ||
+        !IsSimpleBlock(false_block, max_instructions) ||
         !BlocksMergeTogether(true_block, false_block)) {
       continue;
     }
+
+    // Keep a branch the profile shows is almost always taken the same way. It is predicted
+    // well, and costs less than waiting for the condition and both values.
+    if (if_instruction->GetLikelySuccessor() != nullptr) {
+      MaybeRecordStat(stats_, MethodCompilationStat::kBiasedBranchNotSelected);
+      continue;
+    }
     HBasicBlock* merge_block = true_block->GetSingleSuccessor();
 
     // If the branches are not empty, move instructions in front of the If.
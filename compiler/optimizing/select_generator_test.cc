@@ -19,6 +19,7 @@
 #include "base/arena_allocator.h"
 #include "builder.h"
 #include "nodes.h"
+#include "optimizing_compiler_stats.h"
 #include "optimizing_unit_test.h"
 #include "side_effects_analysis.h"
 
@@ -34,7 +35,12 @@ class SelectGeneratorTest : public OptimizingUnitTest {
                                                       DataType::Type::kInt32));
   }
 
-  void ConstructBasicGraphForSelect(HInstruction* instr) {
+  HIf* ConstructBasicGraphForSelect(HInstruction* instr) {
+    return ConstructBasicGraphForSelect({instr});
+  }
+
+  // The last of `instrs` is the value selected when the condition is true.
+  HIf* ConstructBasicGraphForSelect(std::initializer_list<HInstruction*> instrs) {
     HBasicBlock* if_block = AddNewBlock();
     HBasicBlock* then_block = AddNewBlock();
     HBasicBlock* else_block = AddNewBlock();
@@ -53,26 +59,34 @@ class SelectGeneratorTest : public OptimizingUnitTest {
     entry_block_->AddInstruction(bool_param);
     HIntConstant* const1 =  graph_->GetIntConstant(1);
 
-    if_block->AddInstruction(new (GetAllocator()) HIf(bool_param));
+    HIf* if_instruction = new (GetAllocator()) HIf(bool_param);
+    if_block->AddInstruction(if_instruction);
 
-    then_block->AddInstruction(instr);
+    for (HInstruction* instr : instrs) {
+      then_block->AddInstruction(instr);
+    }
     then_block->AddInstruction(new (GetAllocator()) HGoto());
 
     else_block->AddInstruction(new (GetAllocator()) HGoto());
 
     HPhi* phi = new (GetAllocator()) HPhi(GetAllocator(), 0, 0, DataType::Type::kInt32);
     return_block_->AddPhi(phi);
-    phi->AddInput(instr);
+    phi->AddInput(*(instrs.end() - 1));
     phi->AddInput(const1);
+    return if_instruction;
   }
 
-  bool CheckGraphAndTrySelectGenerator() {
+  bool CheckGraphAndTrySelectGenerator(OptimizingCompilerStats* stats = nullptr) {
     graph_->BuildDominatorTree();
     EXPECT_TRUE(CheckGraph());
 
     SideEffectsAnalysis side_effects(graph_);
     side_effects.Run();
-    return HSelectGenerator(graph_, /*handles*/ nullptr, /*stats*/ nullptr).Run();
+    return HSelectGenerator(graph_, stats).Run();
+  }
+
+  HAdd* MakeAdd(HInstruction* lhs, HInstruction* rhs) {
+    return new (GetAllocator()) HAdd(DataType::Type::kInt32, lhs, rhs, 0);
   }
 };
 
@@ -99,4 +113,44 @@ TEST_F(SelectGeneratorTest, testAdd) {
   EXPECT_TRUE(CheckGraphAndTrySelectGenerator());
 }
 
+// Test that SelectGenerator keeps a branch the profile shows is almost always taken.
+TEST_F(SelectGeneratorTest, testBiasedBranch) {
+  InitGraphAndParameters();
+  HIf* if_instruction = ConstructBasicGraphForSelect(MakeAdd(parameters_[0], parameters_[0]));
+  if_instruction->SetProfileCounts(/* true_count= */ 10u, /* false_count= */ 1000u);
+  OptimizingCompilerStats stats;
+  EXPECT_FALSE(CheckGraphAndTrySelectGenerator(&stats));
+  EXPECT_EQ(1u, stats.GetStat(MethodCompilationStat::kBiasedBranchNotSelected));
+}
+
+// Test that SelectGenerator selects a branch too rarely executed for its profile to be trusted.
+TEST_F(SelectGeneratorTest, testBiasedBranchUnreliableProfile) {
+  InitGraphAndParameters();
+  HIf* if_instruction = ConstructBasicGraphForSelect(MakeAdd(parameters_[0], parameters_[0]));
+  if_instruction->SetProfileCounts(/* true_count= */ 0u, /* false_count= */ 10u);
+  EXPECT_TRUE(CheckGraphAndTrySelectGenerator());
+}
+
+// Test that SelectGenerator allows more instructions per branch only for unpredictable branches.
+TEST_F(SelectGeneratorTest, testUnpredictableBranch) {
+  InitGraphAndParameters();
+  HAdd* add1 = MakeAdd(parameters_[0], parameters_[0]);
+  HAdd* add2 = MakeAdd(add1, parameters_[0]);
+  HAdd* add3 = MakeAdd(add2, parameters_[0]);
+  HIf* if_instruction = ConstructBasicGraphForSelect({add1, add2, add3});
+  if_instruction->SetProfileCounts(/* true_count= */ 400u, /* false_count= */ 600u);
+  EXPECT_TRUE(CheckGraphAndTrySelectGenerator());
+}
+
+TEST_F(SelectGeneratorTest, testNotUnpredictableBranch) {
+  InitGraphAndParameters();
+  HAdd* add1 = MakeAdd(parameters_[0], parameters_[0]);
+  HAdd* add2 = MakeAdd(add1, parameters_[0]);
+  HAdd* add3 = MakeAdd(add2, parameters_[0]);
+  HIf* if_instruction = ConstructBasicGraphForSelect({add1, add2, add3});
+  // Taken a fifth of the time: neither biased enough to keep nor unpredictable.
+  if_instruction->SetProfileCounts(/* true_count= */ 200u, /* false_count= */ 800u);
+  EXPECT_FALSE(CheckGraphAndTrySelectGenerator());
+}
+
 }  // namespace art
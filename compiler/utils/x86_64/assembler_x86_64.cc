@@ -32,6 +32,10 @@ std::ostream& operator<<(std::ostream& os, const XmmRegister& reg) {
   return os << reg.AsFloatRegister();
 }
 
+std::ostream& operator<<(std::ostream& os, const YmmRegister& reg) {
+  return os << reg.AsFloatRegister();
+}
+
 std::ostream& operator<<(std::ostream& os, const X87Register& reg) {
   return os << "ST" << static_cast<int>(reg);
 }
@@ -1021,6 +1025,596 @@ void X86_64Assembler::vfmadd213sd(XmmRegister acc, XmmRegister left, XmmRegister
   EmitUint8(0xA9);
   EmitXmmRegisterOperand(acc.LowBits(), right);
 }
+void X86_64Assembler::vmovaps(YmmRegister dst, YmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x28, dst.AsFloatRegister(),
+                              ManagedRegister::NoRegister().AsX86_64(), src.AsFloatRegister());
+}
+
+void X86_64Assembler::vmovups(YmmRegister dst, const Address& src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256MemoryOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x10, dst.AsFloatRegister(), src);
+}
+
+void X86_64Assembler::vmovups(const Address& dst, YmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256MemoryOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x11, src.AsFloatRegister(), dst);
+}
+
+void X86_64Assembler::vmovupd(YmmRegister dst, const Address& src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256MemoryOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x10, dst.AsFloatRegister(), src);
+}
+
+void X86_64Assembler::vmovupd(const Address& dst, YmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256MemoryOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x11, src.AsFloatRegister(), dst);
+}
+
+void X86_64Assembler::vmovdqu(YmmRegister dst, const Address& src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256MemoryOperation(SET_VEX_PP_F3, SET_VEX_M_0F, 0x6F, dst.AsFloatRegister(), src);
+}
+
+void X86_64Assembler::vmovdqu(const Address& dst, YmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256MemoryOperation(SET_VEX_PP_F3, SET_VEX_M_0F, 0x7F, src.AsFloatRegister(), dst);
+}
+
+void X86_64Assembler::vpaddb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xFC, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xFD, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xFE, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddq(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xD4, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xF8, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xF9, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xFA, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubq(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xFB, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmullw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xD5, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmulld(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x40, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddusb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xDC, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xEC, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddusw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xDD, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xED, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubusb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xD8, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xE8, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubusw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xD9, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xE9, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpavgb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xE0, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpavgw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xE3, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x38, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x3C, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xEA, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xEE, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminsd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x39, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxsd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x3D, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminub(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xDA, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxub(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xDE, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminuw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x3A, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxuw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x3E, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminud(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x3B, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxud(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x3F, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpand(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xDB, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpandn(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xDF, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpor(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xEB, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpxor(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xEF, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpcmpeqb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x74, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaddwd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xF5, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsadbw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0xF6, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vaddps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x58, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vaddpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x58, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vsubps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x5C, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vsubpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x5C, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vmulps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x59, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vmulpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x59, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vdivps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x5E, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vdivpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x5E, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vminps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x5D, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vminpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x5D, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vmaxps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x5F, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vmaxpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x5F, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vandps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x54, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vandpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x54, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vandnps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x55, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vandnpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x55, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vorps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x56, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vorpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x56, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vxorps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x57, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vxorpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x57, dst.AsFloatRegister(),
+                              X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+                              src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpabsd(YmmRegister dst, YmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x1E, dst.AsFloatRegister(),
+                              ManagedRegister::NoRegister().AsX86_64(), src.AsFloatRegister());
+}
+
+void X86_64Assembler::vcvtdq2ps(YmmRegister dst, YmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_NONE, SET_VEX_M_0F, 0x5B, dst.AsFloatRegister(),
+                              ManagedRegister::NoRegister().AsX86_64(), src.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsllw(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x71, /*reg=*/ 6,
+                              X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister()),
+                              src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpslld(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x72, /*reg=*/ 6,
+                              X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister()),
+                              src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsllq(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x73, /*reg=*/ 6,
+                              X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister()),
+                              src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsraw(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x71, /*reg=*/ 4,
+                              X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister()),
+                              src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrad(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x72, /*reg=*/ 4,
+                              X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister()),
+                              src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrlw(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x71, /*reg=*/ 2,
+                              X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister()),
+                              src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrld(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x72, /*reg=*/ 2,
+                              X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister()),
+                              src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrlq(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F, 0x73, /*reg=*/ 2,
+                              X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister()),
+                              src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpbroadcastb(YmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x78, dst.AsFloatRegister(),
+                              ManagedRegister::NoRegister().AsX86_64(), src.AsFloatRegister());
+}
+
+void X86_64Assembler::vpbroadcastw(YmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x79, dst.AsFloatRegister(),
+                              ManagedRegister::NoRegister().AsX86_64(), src.AsFloatRegister());
+}
+
+void X86_64Assembler::vpbroadcastd(YmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x58, dst.AsFloatRegister(),
+                              ManagedRegister::NoRegister().AsX86_64(), src.AsFloatRegister());
+}
+
+void X86_64Assembler::vpbroadcastq(YmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x59, dst.AsFloatRegister(),
+                              ManagedRegister::NoRegister().AsX86_64(), src.AsFloatRegister());
+}
+
+void X86_64Assembler::vbroadcastss(YmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x18, dst.AsFloatRegister(),
+                              ManagedRegister::NoRegister().AsX86_64(), src.AsFloatRegister());
+}
+
+void X86_64Assembler::vbroadcastsd(YmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x19, dst.AsFloatRegister(),
+                              ManagedRegister::NoRegister().AsX86_64(), src.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmovzxbw(YmmRegister dst, const Address& src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256MemoryOperation(SET_VEX_PP_66, SET_VEX_M_0F_38, 0x30, dst.AsFloatRegister(), src);
+}
+
+void X86_64Assembler::vextracti128(XmmRegister dst, YmmRegister src, const Immediate& imm) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(imm.is_uint8());
+  EmitVex256RegisterOperation(SET_VEX_PP_66, SET_VEX_M_0F_3A, 0x39, src.AsFloatRegister(),
+                              ManagedRegister::NoRegister().AsX86_64(), dst.AsFloatRegister());
+  EmitUint8(imm.value());
+}
+
+void X86_64Assembler::vzeroupper() {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0xC5);
+  EmitUint8(0xF8);
+  EmitUint8(0x77);
+}
+
 void X86_64Assembler::flds(const Address& src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0xD9);
@@ -5784,5 +6378,66 @@ uint8_t X86_64Assembler::EmitVexPrefixByteTwo(bool W,
   return vex_prefix;
 }
 
+void X86_64Assembler::EmitVexPrefix(bool R,
+                                    bool X,
+                                    bool B,
+                                    bool W,
+                                    int SET_VEX_M,
+                                    X86_64ManagedRegister vvvv,
+                                    int SET_VEX_L,
+                                    int SET_VEX_PP) {
+  // The 2-byte form only encodes VEX.R, so it requires the 0F opcode map and VEX.W = 0.
+  bool is_twobyte_form = !X && !B && !W && SET_VEX_M == SET_VEX_M_0F;
+  EmitUint8(EmitVexPrefixByteZero(is_twobyte_form));
+  if (is_twobyte_form) {
+    EmitUint8(EmitVexPrefixByteOne(R, vvvv, SET_VEX_L, SET_VEX_PP));
+  } else {
+    EmitUint8(EmitVexPrefixByteOne(R, X, B, SET_VEX_M));
+    if (vvvv.IsNoRegister()) {
+      EmitUint8(EmitVexPrefixByteTwo(W, SET_VEX_L, SET_VEX_PP));
+    } else {
+      EmitUint8(EmitVexPrefixByteTwo(W, vvvv, SET_VEX_L, SET_VEX_PP));
+    }
+  }
+}
+
+void X86_64Assembler::EmitVex256RegisterOperation(int SET_VEX_PP,
+                                                  int SET_VEX_M,
+                                                  uint8_t opcode,
+                                                  int reg,
+                                                  X86_64ManagedRegister vvvv,
+                                                  int rm) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(/*R=*/ reg > 7,
+                /*X=*/ false,
+                /*B=*/ rm > 7,
+                /*W=*/ false,
+                SET_VEX_M,
+                vvvv,
+                SET_VEX_L_256,
+                SET_VEX_PP);
+  EmitUint8(opcode);
+  EmitRegisterOperand(reg & 7, rm & 7);
+}
+
+void X86_64Assembler::EmitVex256MemoryOperation(int SET_VEX_PP,
+                                                int SET_VEX_M,
+                                                uint8_t opcode,
+                                                int reg,
+                                                const Address& address) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  uint8_t rex = address.rex();
+  EmitVexPrefix(/*R=*/ reg > 7,
+                /*X=*/ (rex & GET_REX_X) != 0,
+                /*B=*/ (rex & GET_REX_B) != 0,
+                /*W=*/ false,
+                SET_VEX_M,
+                ManagedRegister::NoRegister().AsX86_64(),
+                SET_VEX_L_256,
+                SET_VEX_PP);
+  EmitUint8(opcode);
+  EmitOperand(reg & 7, address);
+}
+
 }  // namespace x86_64
 }  // namespace art
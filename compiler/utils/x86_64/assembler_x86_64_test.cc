@@ -2134,6 +2134,115 @@ TEST_F(AssemblerX86_64Test, Psrldq) {
             "psrldq $2, %xmm15\n", "psrldqi");
 }
 
+// The assembler test driver only knows of the XMM registers, so the 256-bit operations are tested
+// with register triples covering the 2-byte and 3-byte VEX prefixes.
+static constexpr int kYmmTestRegisters[][3] = {
+    {0, 1, 2}, {7, 6, 5}, {8, 3, 4}, {2, 9, 6}, {5, 4, 10}, {15, 14, 13}};
+
+using YmmTernaryOperation = void (x86_64::X86_64Assembler::*)(x86_64::YmmRegister,
+                                                              x86_64::YmmRegister,
+                                                              x86_64::YmmRegister);
+
+static std::string RepeatYYY(x86_64::X86_64Assembler* assembler,
+                             YmmTernaryOperation f,
+                             const char* name) {
+  std::ostringstream str;
+  for (const int* regs : kYmmTestRegisters) {
+    (assembler->*f)(x86_64::YmmRegister(regs[0]),
+                    x86_64::YmmRegister(regs[1]),
+                    x86_64::YmmRegister(regs[2]));
+    str << name << " %ymm" << regs[2] << ", %ymm" << regs[1] << ", %ymm" << regs[0] << "\n";
+  }
+  return str.str();
+}
+
+TEST_F(AssemblerX86_64AVXTest, YmmIntegerArithmetic) {
+  x86_64::X86_64Assembler* assembler = GetAssembler();
+  std::string expected;
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpaddb, "vpaddb");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpaddd, "vpaddd");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpsubq, "vpsubq");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpmullw, "vpmullw");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpmulld, "vpmulld");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpaddusb, "vpaddusb");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpsubsw, "vpsubsw");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpavgw, "vpavgw");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpminsb, "vpminsb");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpmaxud, "vpmaxud");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpandn, "vpandn");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpxor, "vpxor");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpcmpeqb, "vpcmpeqb");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpmaddwd, "vpmaddwd");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vpsadbw, "vpsadbw");
+  DriverStr(expected, "ymm_integer_arithmetic");
+}
+
+TEST_F(AssemblerX86_64AVXTest, YmmFloatingPointArithmetic) {
+  x86_64::X86_64Assembler* assembler = GetAssembler();
+  std::string expected;
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vaddps, "vaddps");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vsubpd, "vsubpd");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vmulps, "vmulps");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vdivpd, "vdivpd");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vminps, "vminps");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vmaxpd, "vmaxpd");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vandnps, "vandnps");
+  expected += RepeatYYY(assembler, &x86_64::X86_64Assembler::vxorpd, "vxorpd");
+  DriverStr(expected, "ymm_fp_arithmetic");
+}
+
+TEST_F(AssemblerX86_64AVXTest, YmmMoves) {
+  x86_64::X86_64Assembler* assembler = GetAssembler();
+  x86_64::CpuRegister base(x86_64::RDI);
+  x86_64::CpuRegister index(x86_64::R9);
+  assembler->vmovaps(x86_64::YmmRegister(x86_64::XMM1), x86_64::YmmRegister(x86_64::XMM12));
+  assembler->vmovaps(x86_64::YmmRegister(x86_64::XMM11), x86_64::YmmRegister(x86_64::XMM2));
+  assembler->vmovdqu(x86_64::YmmRegister(x86_64::XMM3),
+                     x86_64::Address(base, index, x86_64::TIMES_4, 16));
+  assembler->vmovdqu(x86_64::Address(base, 32), x86_64::YmmRegister(x86_64::XMM10));
+  assembler->vmovups(x86_64::YmmRegister(x86_64::XMM8),
+                     x86_64::Address(x86_64::CpuRegister(x86_64::RSP), 64));
+  assembler->vmovupd(x86_64::Address(x86_64::CpuRegister(x86_64::R13), 8),
+                     x86_64::YmmRegister(x86_64::XMM0));
+  assembler->vpmovzxbw(x86_64::YmmRegister(x86_64::XMM9),
+                       x86_64::Address(base, index, x86_64::TIMES_2, 12));
+  assembler->vzeroupper();
+  DriverStr("vmovaps %ymm12, %ymm1\n"
+            "vmovaps %ymm2, %ymm11\n"
+            "vmovdqu 0x10(%rdi,%r9,4), %ymm3\n"
+            "vmovdqu %ymm10, 0x20(%rdi)\n"
+            "vmovups 0x40(%rsp), %ymm8\n"
+            "vmovupd %ymm0, 0x8(%r13)\n"
+            "vpmovzxbw 0xc(%rdi,%r9,2), %ymm9\n"
+            "vzeroupper\n", "ymm_moves");
+}
+
+TEST_F(AssemblerX86_64AVXTest, YmmShiftsAndShuffles) {
+  x86_64::X86_64Assembler* assembler = GetAssembler();
+  assembler->vpsllw(x86_64::YmmRegister(x86_64::XMM0), x86_64::YmmRegister(x86_64::XMM9),
+                    x86_64::Immediate(15));
+  assembler->vpsrad(x86_64::YmmRegister(x86_64::XMM10), x86_64::YmmRegister(x86_64::XMM1),
+                    x86_64::Immediate(3));
+  assembler->vpsrlq(x86_64::YmmRegister(x86_64::XMM14), x86_64::YmmRegister(x86_64::XMM15),
+                    x86_64::Immediate(63));
+  assembler->vpbroadcastb(x86_64::YmmRegister(x86_64::XMM2), x86_64::XmmRegister(x86_64::XMM3));
+  assembler->vpbroadcastd(x86_64::YmmRegister(x86_64::XMM11), x86_64::XmmRegister(x86_64::XMM4));
+  assembler->vbroadcastsd(x86_64::YmmRegister(x86_64::XMM5), x86_64::XmmRegister(x86_64::XMM12));
+  assembler->vextracti128(x86_64::XmmRegister(x86_64::XMM6), x86_64::YmmRegister(x86_64::XMM13),
+                          x86_64::Immediate(1));
+  assembler->vpabsd(x86_64::YmmRegister(x86_64::XMM7), x86_64::YmmRegister(x86_64::XMM8));
+  assembler->vcvtdq2ps(x86_64::YmmRegister(x86_64::XMM9), x86_64::YmmRegister(x86_64::XMM0));
+  DriverStr("vpsllw $15, %ymm9, %ymm0\n"
+            "vpsrad $3, %ymm1, %ymm10\n"
+            "vpsrlq $63, %ymm15, %ymm14\n"
+            "vpbroadcastb %xmm3, %ymm2\n"
+            "vpbroadcastd %xmm4, %ymm11\n"
+            "vbroadcastsd %xmm12, %ymm5\n"
+            "vextracti128 $1, %ymm13, %xmm6\n"
+            "vpabsd %ymm8, %ymm7\n"
+            "vcvtdq2ps %ymm0, %ymm9\n", "ymm_shifts_and_shuffles");
+}
+
 std::string x87_fn(AssemblerX86_64Test::Base* assembler_test ATTRIBUTE_UNUSED,
                    x86_64::X86_64Assembler* assembler) {
   std::ostringstream str;
@@ -1774,6 +1774,27 @@ TEST_F(Dex2oatTest, StderrLoggerOutput) {
   EXPECT_NE(std::string::npos, output_.find("dex2oat took"));
 }
 
+TEST_F(Dex2oatTest, PassTimeBudget) {
+  const std::string odex_location = GetOdexDir() + "/Dex2OatPassTimeBudget.odex";
+  std::string error_msg;
+  // No pass of the small test methods takes a millisecond, force the first pass of each method
+  // over the budget so that the passes after it get skipped and counted in --dump-stats.
+  int status = GenerateOdexForTestWithStatus(
+      { GetTestDexFileName("ManyMethods") },
+      odex_location,
+      CompilerFilter::kSpeed,
+      &error_msg,
+      { "--pass-time-budget-ms=1",
+        "--exhaust-pass-time-budget-for-testing",
+        "--dump-stats",
+        // Pass -Xuse-stderr-logger have dex2oat output in output_ on target.
+        "--runtime-arg",
+        "-Xuse-stderr-logger" });
+  ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << error_msg << "\n" << output_;
+  EXPECT_NE(std::string::npos, output_.find("SkippedPassOverTimeBudget")) << output_;
+  EXPECT_NE(std::string::npos, output_.find("PassTime#")) << output_;
+}
+
 TEST_F(Dex2oatTest, VerifyCompilationReason) {
   std::string dex_location = GetScratchDir() + "/Dex2OatCompilationReason.jar";
   std::string odex_location = GetOdexDir() + "/Dex2OatCompilationReason.odex";
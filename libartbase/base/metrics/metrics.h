@@ -50,12 +50,21 @@
   METRIC(FullGcTracingThroughputAvg, MetricsAverage)                    \
   METRIC(JitMethodCompileTotalTime, MetricsCounter)                     \
   METRIC(JitMethodCompileCount, MetricsCounter)                         \
+  METRIC(JitCompileQueueDepthAvg, MetricsAverage)                       \
+  METRIC(JitCompileQueueTimeAvg, MetricsAverage)                        \
+  METRIC(JitDeoptimizationCount, MetricsCounter)                        \
+  METRIC(JitDeoptimizationRecompileCount, MetricsCounter)               \
+  METRIC(RssTargetCompactionCount, MetricsCounter)                      \
+  METRIC(RssTargetTrimCount, MetricsCounter)                            \
+  METRIC(RssTargetNoActionCount, MetricsCounter)                        \
+  METRIC(LargeObjectSpaceFragmentedBytesAvg, MetricsAverage)            \
   METRIC(YoungGcCollectionTime, MetricsHistogram, 15, 0, 60'000)        \
   METRIC(FullGcCollectionTime, MetricsHistogram, 15, 0, 60'000)         \
   METRIC(YoungGcThroughput, MetricsHistogram, 15, 0, 10'000)            \
   METRIC(FullGcThroughput, MetricsHistogram, 15, 0, 10'000)             \
   METRIC(YoungGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)     \
-  METRIC(FullGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)
+  METRIC(FullGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)      \
+  METRIC(JitCompileQueueTime, MetricsHistogram, 15, 0, 10'000)
 
 // A lot of the metrics implementation code is generated by passing one-off macros into ART_COUNTERS
 // and ART_HISTOGRAMS. This means metrics.h and metrics.cc are very #define-heavy, which can be
@@ -27,6 +27,7 @@
 #include <climits>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <random>
 #include <string>
@@ -222,8 +223,14 @@ enum class ProfileCompilationInfo::FileSectionType : uint32_t {
   // an optional reserved section not implemented on client yet.
   kAggregationCounts = 4,
 
+  // How many times the runtime saw each class of the inline caches of the methods section.
+  kInlineCacheCounts = 5,
+
+  // How many times each conditional branch of the hot methods was taken and not taken.
+  kBranchCounts = 6,
+
   // The number of known sections.
-  kNumberOfSections = 5
+  kNumberOfSections = 7
 };
 
 class ProfileCompilationInfo::FileSectionInfo {
@@ -594,6 +601,7 @@ void ProfileCompilationInfo::DexPcData::AddClass(const dex::TypeIndex& type_idx)
   if (classes.size() + 1 >= ProfileCompilationInfo::kIndividualInlineCacheSize) {
     is_megamorphic = true;
     classes.clear();
+    class_counts.clear();
     return;
   }
 
@@ -601,6 +609,40 @@ void ProfileCompilationInfo::DexPcData::AddClass(const dex::TypeIndex& type_idx)
   classes.emplace_hint(lb, type_idx);
 }
 
+void ProfileCompilationInfo::DexPcData::AddClassCount(const dex::TypeIndex& type_idx,
+                                                      uint32_t count) {
+  if (count == 0u || classes.find(type_idx) == classes.end()) {
+    // Also covers megamorphic and missing types inline caches, which have no classes.
+    return;
+  }
+  // As in AddClass(), look up the type before emplacing it to avoid leaking arena memory.
+  auto lb = class_counts.lower_bound(type_idx);
+  if (lb != class_counts.end() && lb->first == type_idx) {
+    // Saturate rather than overflow, only the relative frequencies matter.
+    lb->second = (count > std::numeric_limits<uint32_t>::max() - lb->second)
+        ? std::numeric_limits<uint32_t>::max()
+        : lb->second + count;
+  } else {
+    class_counts.PutBefore(lb, type_idx, count);
+  }
+}
+
+void ProfileCompilationInfo::BranchCounts::Add(uint32_t other_false_count,
+                                               uint32_t other_true_count) {
+  auto saturating_add = [](uint32_t lhs, uint32_t rhs) {
+    return (rhs > std::numeric_limits<uint32_t>::max() - lhs)
+        ? std::numeric_limits<uint32_t>::max()
+        : lhs + rhs;
+  };
+  false_count = saturating_add(false_count, other_false_count);
+  true_count = saturating_add(true_count, other_true_count);
+}
+
+uint32_t ProfileCompilationInfo::DexPcData::GetClassCount(const dex::TypeIndex& type_idx) const {
+  auto it = class_counts.find(type_idx);
+  return it != class_counts.end() ? it->second : 0u;
+}
+
 // Transform the actual dex location into a key used to index the dex file in the profile.
 // See ProfileCompilationInfo#GetProfileDexFileBaseKey as well.
 std::string ProfileCompilationInfo::GetProfileDexFileAugmentedKey(
@@ -879,6 +921,8 @@ static bool WriteBuffer(int fd, const void* buffer, size_t byte_count) {
  *   Classes - optional, zipped
  *   Methods - optional, zipped
  *   AggregationCounts - optional, zipped, server-side
+ *   InlineCacheCounts - optional, zipped
+ *   BranchCounts - optional, zipped
  *
  * DexFiles:
  *    number_of_dex_files
@@ -917,6 +961,31 @@ static bool WriteBuffer(int fd, const void* buffer, size_t byte_count) {
  *    type_index_diff[dex_map_size]
  * where `M` stands for special encodings indicating missing types (kIsMissingTypesEncoding)
  * or memamorphic call (kIsMegamorphicEncoding) which both imply `dex_map_size == 0`.
+ *
+ * InlineCacheCounts contains records for any number of dex files, each consisting of:
+ *    profile_index  // Index of the dex file in DexFiles section.
+ *    following_data_size  // For easy skipping of remaining data when dex file is filtered out.
+ *    method_counts_encoding[]  // Until the size indicated by `following_data_size`.
+ * where the `method_counts_encoding` is
+ *    method_index_diff
+ *    number_of_inline_caches
+ *    inline_cache_counts_encoding[number_of_inline_caches]
+ * and the `inline_cache_counts_encoding` is
+ *    dex_pc
+ *    number_of_counts
+ *    (type_index_diff,count)[number_of_counts]
+ * Only the inline caches with counts are recorded. The counts refer to the classes of the same
+ * inline cache in the Methods section and older versions of ART ignore them.
+ *
+ * BranchCounts contains records for any number of dex files, each consisting of:
+ *    profile_index  // Index of the dex file in DexFiles section.
+ *    following_data_size  // For easy skipping of remaining data when dex file is filtered out.
+ *    method_branch_counts_encoding[]  // Until the size indicated by `following_data_size`.
+ * where the `method_branch_counts_encoding` is
+ *    method_index_diff
+ *    number_of_branches
+ *    (dex_pc,false_count,true_count)[number_of_branches]
+ * Only hot methods have branch counts. Older versions of ART ignore them.
  **/
 bool ProfileCompilationInfo::Save(int fd) {
   uint64_t start = NanoTime();
@@ -936,6 +1005,8 @@ bool ProfileCompilationInfo::Save(int fd) {
   uint64_t dex_files_section_size = sizeof(ProfileIndexType);  // Number of dex files.
   uint64_t classes_section_size = 0u;
   uint64_t methods_section_size = 0u;
+  uint64_t inline_cache_counts_section_size = 0u;
+  uint64_t branch_counts_section_size = 0u;
   DCHECK_LE(info_.size(), MaxProfileIndex());
   for (const std::unique_ptr<DexFileData>& dex_data : info_) {
     if (dex_data->profile_key.size() > kMaxDexFileKeyLength) {
@@ -948,13 +1019,17 @@ bool ProfileCompilationInfo::Save(int fd) {
         sizeof(uint16_t) + dex_data->profile_key.size();
     classes_section_size += dex_data->ClassesDataSize();
     methods_section_size += dex_data->MethodsDataSize();
+    inline_cache_counts_section_size += dex_data->InlineCacheCountsDataSize();
+    branch_counts_section_size += dex_data->BranchCountsDataSize();
   }
 
   const uint32_t file_section_count =
       /* dex files */ 1u +
       /* extra descriptors */ (extra_descriptors_section_size != 0u ? 1u : 0u) +
       /* classes */ (classes_section_size != 0u ? 1u : 0u) +
-      /* methods */ (methods_section_size != 0u ? 1u : 0u);
+      /* methods */ (methods_section_size != 0u ? 1u : 0u) +
+      /* inline cache counts */ (inline_cache_counts_section_size != 0u ? 1u : 0u) +
+      /* branch counts */ (branch_counts_section_size != 0u ? 1u : 0u);
   uint64_t header_and_infos_size =
       sizeof(FileHeader) + file_section_count * sizeof(FileSectionInfo);
 
@@ -965,7 +1040,9 @@ bool ProfileCompilationInfo::Save(int fd) {
       dex_files_section_size +
       extra_descriptors_section_size +
       classes_section_size +
-      methods_section_size;
+      methods_section_size +
+      inline_cache_counts_section_size +
+      branch_counts_section_size;
   VLOG(profiler) << "Required capacity: " << total_uncompressed_size << " bytes.";
   if (total_uncompressed_size > GetSizeErrorThresholdBytes()) {
     LOG(WARNING) << "Profile data size exceeds "
@@ -1064,6 +1141,37 @@ bool ProfileCompilationInfo::Save(int fd) {
     add_section_info(FileSectionType::kMethods, buffer.Size(), methods_section_size);
   }
 
+  // Write the inline cache counts section.
+  if (inline_cache_counts_section_size != 0u) {
+    SafeBuffer buffer(inline_cache_counts_section_size);
+    for (const std::unique_ptr<DexFileData>& dex_data : info_) {
+      dex_data->WriteInlineCacheCounts(buffer);
+    }
+    if (!buffer.Deflate()) {
+      return false;
+    }
+    if (!WriteBuffer(fd, buffer.Get(), buffer.Size())) {
+      return false;
+    }
+    add_section_info(
+        FileSectionType::kInlineCacheCounts, buffer.Size(), inline_cache_counts_section_size);
+  }
+
+  // Write the branch counts section.
+  if (branch_counts_section_size != 0u) {
+    SafeBuffer buffer(branch_counts_section_size);
+    for (const std::unique_ptr<DexFileData>& dex_data : info_) {
+      dex_data->WriteBranchCounts(buffer);
+    }
+    if (!buffer.Deflate()) {
+      return false;
+    }
+    if (!WriteBuffer(fd, buffer.Get(), buffer.Size())) {
+      return false;
+    }
+    add_section_info(FileSectionType::kBranchCounts, buffer.Size(), branch_counts_section_size);
+  }
+
   if (file_offset > GetSizeWarningThresholdBytes()) {
     LOG(WARNING) << "Profile data size exceeds "
         << GetSizeWarningThresholdBytes()
@@ -1260,21 +1368,36 @@ bool ProfileCompilationInfo::AddMethod(const ProfileMethodInfo& pmi,
       FindOrAddDexPc(inline_cache, cache.dex_pc)->SetIsMegamorphic();
       continue;
     }
-    for (const TypeReference& class_ref : cache.classes) {
+    for (size_t i = 0; i != cache.classes.size(); ++i) {
       DexPcData* dex_pc_data = FindOrAddDexPc(inline_cache, cache.dex_pc);
       if (dex_pc_data->is_missing_types || dex_pc_data->is_megamorphic) {
         // Don't bother adding classes if we are missing types or already megamorphic.
         break;
       }
-      dex::TypeIndex type_index = FindOrCreateTypeIndex(*pmi.ref.dex_file, class_ref);
+      dex::TypeIndex type_index = FindOrCreateTypeIndex(*pmi.ref.dex_file, cache.classes[i]);
       if (type_index.IsValid()) {
         dex_pc_data->AddClass(type_index);
+        if (i < cache.class_counts.size()) {
+          dex_pc_data->AddClassCount(type_index, cache.class_counts[i]);
+        }
       } else {
         // Could not create artificial type index.
         dex_pc_data->SetIsMissingTypes();
       }
     }
   }
+
+  // Add branch counts.
+  if (!pmi.branch_caches.empty()) {
+    BranchCacheMap* branch_caches = data->FindOrAddBranchCaches(pmi.ref.index);
+    DCHECK(branch_caches != nullptr);
+    for (const ProfileMethodInfo::ProfileBranchCache& cache : pmi.branch_caches) {
+      if (cache.false_count == 0u && cache.true_count == 0u) {
+        continue;  // The branch was not executed.
+      }
+      branch_caches->FindOrAdd(cache.dex_pc)->second.Add(cache.false_count, cache.true_count);
+    }
+  }
   return true;
 }
 
@@ -1676,6 +1799,77 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::ReadMethodsSec
   return ProfileLoadStatus::kSuccess;
 }
 
+ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::ReadBranchCountsSection(
+    ProfileSource& source,
+    const FileSectionInfo& section_info,
+    const dchecked_vector<ProfileIndexType>& dex_profile_index_remap,
+    /*out*/ std::string* error) {
+  DCHECK(section_info.GetType() == FileSectionType::kBranchCounts);
+  SafeBuffer buffer;
+  ProfileLoadStatus status = ReadSectionData(source, section_info, &buffer, error);
+  if (status != ProfileLoadStatus::kSuccess) {
+    return status;
+  }
+
+  while (buffer.GetAvailableBytes() != 0u) {
+    ProfileIndexType profile_index;
+    if (!buffer.ReadUintAndAdvance(&profile_index)) {
+      *error = "Error profile index in branch counts section.";
+      return ProfileLoadStatus::kBadData;
+    }
+    if (profile_index >= dex_profile_index_remap.size()) {
+      *error = "Invalid profile index in branch counts section.";
+      return ProfileLoadStatus::kBadData;
+    }
+    profile_index = dex_profile_index_remap[profile_index];
+    if (profile_index == MaxProfileIndex()) {
+      status = DexFileData::SkipBranchCounts(buffer, error);
+    } else {
+      status = info_[profile_index]->ReadBranchCounts(buffer, error);
+    }
+    if (status != ProfileLoadStatus::kSuccess) {
+      return status;
+    }
+  }
+  return ProfileLoadStatus::kSuccess;
+}
+
+ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::ReadInlineCacheCountsSection(
+    ProfileSource& source,
+    const FileSectionInfo& section_info,
+    const dchecked_vector<ProfileIndexType>& dex_profile_index_remap,
+    const dchecked_vector<ExtraDescriptorIndex>& extra_descriptors_remap,
+    /*out*/ std::string* error) {
+  DCHECK(section_info.GetType() == FileSectionType::kInlineCacheCounts);
+  SafeBuffer buffer;
+  ProfileLoadStatus status = ReadSectionData(source, section_info, &buffer, error);
+  if (status != ProfileLoadStatus::kSuccess) {
+    return status;
+  }
+
+  while (buffer.GetAvailableBytes() != 0u) {
+    ProfileIndexType profile_index;
+    if (!buffer.ReadUintAndAdvance(&profile_index)) {
+      *error = "Error profile index in inline cache counts section.";
+      return ProfileLoadStatus::kBadData;
+    }
+    if (profile_index >= dex_profile_index_remap.size()) {
+      *error = "Invalid profile index in inline cache counts section.";
+      return ProfileLoadStatus::kBadData;
+    }
+    profile_index = dex_profile_index_remap[profile_index];
+    if (profile_index == MaxProfileIndex()) {
+      status = DexFileData::SkipInlineCacheCounts(buffer, error);
+    } else {
+      status = info_[profile_index]->ReadInlineCacheCounts(buffer, extra_descriptors_remap, error);
+    }
+    if (status != ProfileLoadStatus::kSuccess) {
+      return status;
+    }
+  }
+  return ProfileLoadStatus::kSuccess;
+}
+
 // TODO(calin): fail fast if the dex checksums don't match.
 ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
     int32_t fd,
@@ -1771,6 +1965,7 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
 
   // Process all other sections.
   dchecked_vector<ExtraDescriptorIndex> extra_descriptors_remap;
+  const FileSectionInfo* inline_cache_counts_section_info = nullptr;
   for (uint32_t i = 1u; i != section_count; ++i) {
     const FileSectionInfo& section_info = section_infos[i];
     DCHECK(status == ProfileLoadStatus::kSuccess);
@@ -1800,6 +1995,16 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
       case FileSectionType::kAggregationCounts:
         // This section is only used on server side.
         break;
+      case FileSectionType::kInlineCacheCounts:
+        // Process it after the methods section, which may come later.
+        inline_cache_counts_section_info = &section_info;
+        break;
+      case FileSectionType::kBranchCounts:
+        // Skip if all dex files were filtered out.
+        if (!info_.empty()) {
+          status = ReadBranchCountsSection(*source, section_info, dex_profile_index_remap, error);
+        }
+        break;
       default:
         // Unknown section. Skip it. New versions of ART are allowed
         // to add sections that shall be ignored by old versions.
@@ -1811,6 +2016,19 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
     }
   }
 
+  // Skip if all dex files were filtered out.
+  if (inline_cache_counts_section_info != nullptr && !info_.empty()) {
+    status = ReadInlineCacheCountsSection(*source,
+                                          *inline_cache_counts_section_info,
+                                          dex_profile_index_remap,
+                                          extra_descriptors_remap,
+                                          error);
+    if (status != ProfileLoadStatus::kSuccess) {
+      DCHECK(!error->empty());
+      return status;
+    }
+  }
+
   return ProfileLoadStatus::kSuccess;
 }
 
@@ -1921,7 +2139,8 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
         } else if (other_ic_it.second.is_megamorphic) {
           dex_pc_data->SetIsMegamorphic();
         } else {
-          for (dex::TypeIndex type_index : other_class_set) {
+          for (dex::TypeIndex other_type_index : other_class_set) {
+            dex::TypeIndex type_index = other_type_index;
             if (type_index.index_ >= num_type_ids) {
               ExtraDescriptorIndex new_extra_descriptor_index =
                   extra_descriptors_remap[type_index.index_ - num_type_ids];
@@ -1932,11 +2151,25 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
               type_index = dex::TypeIndex(num_type_ids + new_extra_descriptor_index);
             }
             dex_pc_data->AddClass(type_index);
+            dex_pc_data->AddClassCount(type_index,
+                                       other_ic_it.second.GetClassCount(other_type_index));
           }
         }
       }
     }
 
+    // Merge the branch counts.
+    for (const auto& [other_method_index, other_branch_caches] : other_dex_data->branch_map) {
+      BranchCacheMap* branch_caches = dex_data->FindOrAddBranchCaches(other_method_index);
+      if (branch_caches == nullptr) {
+        return false;
+      }
+      for (const auto& [dex_pc, other_counts] : other_branch_caches) {
+        branch_caches->FindOrAdd(dex_pc)->second.Add(other_counts.false_count,
+                                                     other_counts.true_count);
+      }
+    }
+
     // Merge the method bitmaps.
     dex_data->MergeBitmap(*other_dex_data);
   }
@@ -2256,6 +2489,17 @@ ProfileCompilationInfo::DexFileData::FindOrAddHotMethod(uint16_t method_index) {
       InlineCacheMap(std::less<uint16_t>(), allocator_->Adapter(kArenaAllocProfile)))->second);
 }
 
+ProfileCompilationInfo::BranchCacheMap*
+ProfileCompilationInfo::DexFileData::FindOrAddBranchCaches(uint16_t method_index) {
+  if (method_index >= num_method_ids) {
+    LOG(ERROR) << "Invalid method index " << method_index << ". num_method_ids=" << num_method_ids;
+    return nullptr;
+  }
+  return &(branch_map.FindOrAdd(
+      method_index,
+      BranchCacheMap(std::less<uint16_t>(), allocator_->Adapter(kArenaAllocProfile)))->second);
+}
+
 // Mark a method as executed at least once.
 bool ProfileCompilationInfo::DexFileData::AddMethod(MethodHotness::Flag flags, size_t index) {
   if (index >= num_method_ids || index > kMaxSupportedMethodIndex) {
@@ -2299,6 +2543,10 @@ ProfileCompilationInfo::MethodHotness ProfileCompilationInfo::DexFileData::GetHo
   if (it != method_map.end()) {
     ret.SetInlineCacheMap(&it->second);
     ret.AddFlag(MethodHotness::kFlagHot);
+    auto branch_it = branch_map.find(dex_method_index);
+    if (branch_it != branch_map.end()) {
+      ret.SetBranchCacheMap(&branch_it->second);
+    }
   }
   return ret;
 }
@@ -2827,6 +3075,371 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::DexFileData::S
   return ProfileLoadStatus::kSuccess;
 }
 
+uint32_t ProfileCompilationInfo::DexFileData::InlineCacheCountsDataSize() const {
+  size_t num_methods = 0u;
+  size_t num_dex_pc_entries = 0u;
+  size_t num_count_entries = 0u;
+  for (const auto& method_entry : method_map) {
+    bool has_counts = false;
+    for (const auto& inline_cache_entry : method_entry.second) {
+      const DexPcData& dex_pc_data = inline_cache_entry.second;
+      if (!dex_pc_data.class_counts.empty()) {
+        has_counts = true;
+        ++num_dex_pc_entries;
+        num_count_entries += dex_pc_data.class_counts.size();
+      }
+    }
+    if (has_counts) {
+      ++num_methods;
+    }
+  }
+  if (num_methods == 0u) {
+    return 0u;
+  }
+
+  constexpr size_t kPerMethodSize =
+      sizeof(uint16_t) +  // Method index diff.
+      sizeof(uint16_t);   // Number of inline caches with counts.
+  constexpr size_t kPerDexPcEntrySize =
+      sizeof(uint16_t) +  // Dex PC.
+      sizeof(uint8_t);    // Number of counts.
+  constexpr size_t kPerCountEntrySize =
+      sizeof(uint16_t) +  // Type index diff.
+      sizeof(uint32_t);   // Count.
+
+  return sizeof(ProfileIndexType) +                 // Which dex file.
+         sizeof(uint32_t) +                         // Total size of following data.
+         num_methods * kPerMethodSize +             // Data for methods.
+         num_dex_pc_entries * kPerDexPcEntrySize +  // Data for dex pc entries.
+         num_count_entries * kPerCountEntrySize;    // Data for count entries.
+}
+
+void ProfileCompilationInfo::DexFileData::WriteInlineCacheCounts(SafeBuffer& buffer) const {
+  uint32_t counts_data_size = InlineCacheCountsDataSize();
+  if (counts_data_size == 0u) {
+    return;  // No data to write.
+  }
+  DCHECK_GE(buffer.GetAvailableBytes(), counts_data_size);
+  uint32_t expected_available_bytes_at_end = buffer.GetAvailableBytes() - counts_data_size;
+
+  // Write the profile index.
+  buffer.WriteUintAndAdvance(profile_index);
+  // Write the total size of the following data (without the profile index
+  // and the total size itself) for easy skipping when the dex file is filtered out.
+  uint32_t following_data_size = counts_data_size - sizeof(ProfileIndexType) - sizeof(uint32_t);
+  buffer.WriteUintAndAdvance(following_data_size);
+
+  uint16_t last_method_index = 0;
+  for (const auto& method_entry : method_map) {
+    const InlineCacheMap& inline_cache_map = method_entry.second;
+    size_t num_dex_pcs_with_counts = std::count_if(
+        inline_cache_map.begin(),
+        inline_cache_map.end(),
+        [](const auto& entry) { return !entry.second.class_counts.empty(); });
+    if (num_dex_pcs_with_counts == 0u) {
+      continue;
+    }
+    uint16_t method_index = method_entry.first;
+    DCHECK_GE(method_index, last_method_index);
+    uint16_t diff_with_last_method_index = method_index - last_method_index;
+    last_method_index = method_index;
+    buffer.WriteUintAndAdvance(diff_with_last_method_index);
+    buffer.WriteUintAndAdvance(dchecked_integral_cast<uint16_t>(num_dex_pcs_with_counts));
+
+    for (const auto& inline_cache_entry : inline_cache_map) {
+      const DexPcData& dex_pc_data = inline_cache_entry.second;
+      if (dex_pc_data.class_counts.empty()) {
+        continue;
+      }
+      DCHECK_LT(dex_pc_data.class_counts.size(), kIndividualInlineCacheSize);
+      buffer.WriteUintAndAdvance(inline_cache_entry.first);
+      buffer.WriteUintAndAdvance(dchecked_integral_cast<uint8_t>(dex_pc_data.class_counts.size()));
+      // Store the difference between the type indexes for better compression.
+      uint16_t last_type_index = 0u;
+      for (const auto& [type_index, count] : dex_pc_data.class_counts) {
+        DCHECK_GE(type_index.index_, last_type_index);
+        uint16_t diff_with_last_type_index = type_index.index_ - last_type_index;
+        last_type_index = type_index.index_;
+        buffer.WriteUintAndAdvance(diff_with_last_type_index);
+        buffer.WriteUintAndAdvance(count);
+      }
+    }
+  }
+
+  // Check if we've written the right number of bytes.
+  DCHECK_EQ(buffer.GetAvailableBytes(), expected_available_bytes_at_end);
+}
+
+ProfileCompilationInfo::ProfileLoadStatus
+ProfileCompilationInfo::DexFileData::ReadInlineCacheCounts(
+    SafeBuffer& buffer,
+    const dchecked_vector<ExtraDescriptorIndex>& extra_descriptors_remap,
+    std::string* error) {
+  uint32_t following_data_size;
+  if (!buffer.ReadUintAndAdvance(&following_data_size)) {
+    *error = "Error reading inline cache counts data size.";
+    return ProfileLoadStatus::kBadData;
+  }
+  if (following_data_size > buffer.GetAvailableBytes()) {
+    *error = "Inline cache counts data size exceeds available data size.";
+    return ProfileLoadStatus::kBadData;
+  }
+  uint32_t expected_available_bytes_at_end = buffer.GetAvailableBytes() - following_data_size;
+
+  uint32_t num_valid_method_indexes =
+      std::min<uint32_t>(kMaxSupportedMethodIndex + 1u, num_method_ids);
+  uint16_t num_valid_type_indexes = dchecked_integral_cast<uint16_t>(
+      std::min<size_t>(num_type_ids + extra_descriptors_remap.size(), DexFile::kDexNoIndex16));
+  uint16_t method_index = 0;
+  bool first_diff = true;
+  while (buffer.GetAvailableBytes() > expected_available_bytes_at_end) {
+    uint16_t diff_with_last_method_index;
+    if (!buffer.ReadUintAndAdvance(&diff_with_last_method_index)) {
+      *error = "Error reading inline cache counts method index diff.";
+      return ProfileLoadStatus::kBadData;
+    }
+    if (diff_with_last_method_index == 0u && !first_diff) {
+      *error = "Duplicate inline cache counts method index.";
+      return ProfileLoadStatus::kBadData;
+    }
+    first_diff = false;
+    if (diff_with_last_method_index >= num_valid_method_indexes - method_index) {
+      *error = "Invalid inline cache counts method index.";
+      return ProfileLoadStatus::kBadData;
+    }
+    method_index += diff_with_last_method_index;
+    // The counts only apply to inline caches which exist, do not create new ones.
+    auto method_it = method_map.find(method_index);
+    InlineCacheMap* inline_cache = (method_it != method_map.end()) ? &method_it->second : nullptr;
+
+    uint16_t num_dex_pcs;
+    if (!buffer.ReadUintAndAdvance(&num_dex_pcs)) {
+      *error = "Error reading number of inline cache counts.";
+      return ProfileLoadStatus::kBadData;
+    }
+    for (uint16_t dex_pc_index = 0; dex_pc_index != num_dex_pcs; ++dex_pc_index) {
+      uint16_t dex_pc;
+      if (!buffer.ReadUintAndAdvance(&dex_pc)) {
+        *error = "Error reading inline cache counts dex pc.";
+        return ProfileLoadStatus::kBadData;
+      }
+      DexPcData* dex_pc_data = nullptr;
+      if (inline_cache != nullptr) {
+        auto dex_pc_it = inline_cache->find(dex_pc);
+        if (dex_pc_it != inline_cache->end()) {
+          dex_pc_data = &dex_pc_it->second;
+        }
+      }
+      uint8_t num_counts;
+      if (!buffer.ReadUintAndAdvance(&num_counts)) {
+        *error = "Error reading inline cache counts size.";
+        return ProfileLoadStatus::kBadData;
+      }
+      if (num_counts == 0u || num_counts >= kIndividualInlineCacheSize) {
+        *error = "Invalid inline cache counts size.";
+        return ProfileLoadStatus::kBadData;
+      }
+      uint16_t type_index = 0u;
+      for (size_t i = 0; i != num_counts; ++i) {
+        uint16_t type_index_diff;
+        uint32_t count;
+        if (!buffer.ReadUintAndAdvance(&type_index_diff) || !buffer.ReadUintAndAdvance(&count)) {
+          *error = "Error reading inline cache count.";
+          return ProfileLoadStatus::kBadData;
+        }
+        if (type_index_diff == 0u && i != 0u) {
+          *error = "Duplicate inline cache count type index.";
+          return ProfileLoadStatus::kBadData;
+        }
+        if (type_index_diff >= num_valid_type_indexes - type_index) {
+          *error = "Invalid inline cache count type index.";
+          return ProfileLoadStatus::kBadData;
+        }
+        type_index += type_index_diff;
+        if (dex_pc_data == nullptr) {
+          continue;
+        }
+        if (type_index >= num_type_ids) {
+          ExtraDescriptorIndex new_extra_descriptor_index =
+              extra_descriptors_remap[type_index - num_type_ids];
+          if (new_extra_descriptor_index >= DexFile::kDexNoIndex16 - num_type_ids) {
+            *error = "Remapped inline cache count type index out of range.";
+            return ProfileLoadStatus::kMergeError;
+          }
+          dex_pc_data->AddClassCount(dex::TypeIndex(num_type_ids + new_extra_descriptor_index),
+                                     count);
+        } else {
+          dex_pc_data->AddClassCount(dex::TypeIndex(type_index), count);
+        }
+      }
+    }
+  }
+
+  if (buffer.GetAvailableBytes() != expected_available_bytes_at_end) {
+    *error = "Inline cache counts data did not end at expected position.";
+    return ProfileLoadStatus::kBadData;
+  }
+
+  return ProfileLoadStatus::kSuccess;
+}
+
+ProfileCompilationInfo::ProfileLoadStatus
+ProfileCompilationInfo::DexFileData::SkipInlineCacheCounts(SafeBuffer& buffer,
+                                                           std::string* error) {
+  uint32_t following_data_size;
+  if (!buffer.ReadUintAndAdvance(&following_data_size)) {
+    *error = "Error reading inline cache counts data size to skip.";
+    return ProfileLoadStatus::kBadData;
+  }
+  if (following_data_size > buffer.GetAvailableBytes()) {
+    *error = "Inline cache counts data size to skip exceeds remaining data.";
+    return ProfileLoadStatus::kBadData;
+  }
+  buffer.Advance(following_data_size);
+  return ProfileLoadStatus::kSuccess;
+}
+
+uint32_t ProfileCompilationInfo::DexFileData::BranchCountsDataSize() const {
+  size_t num_methods = 0u;
+  size_t num_branches = 0u;
+  for (const auto& method_entry : branch_map) {
+    if (!method_entry.second.empty()) {
+      ++num_methods;
+      num_branches += method_entry.second.size();
+    }
+  }
+  if (num_methods == 0u) {
+    return 0u;
+  }
+
+  constexpr size_t kPerMethodSize =
+      sizeof(uint16_t) +  // Method index diff.
+      sizeof(uint16_t);   // Number of branches.
+  constexpr size_t kPerBranchSize =
+      sizeof(uint16_t) +  // Dex PC.
+      sizeof(uint32_t) +  // False count.
+      sizeof(uint32_t);   // True count.
+
+  return sizeof(ProfileIndexType) +        // Which dex file.
+         sizeof(uint32_t) +                // Total size of following data.
+         num_methods * kPerMethodSize +    // Data for methods.
+         num_branches * kPerBranchSize;    // Data for branches.
+}
+
+void ProfileCompilationInfo::DexFileData::WriteBranchCounts(SafeBuffer& buffer) const {
+  uint32_t counts_data_size = BranchCountsDataSize();
+  if (counts_data_size == 0u) {
+    return;  // No data to write.
+  }
+  DCHECK_GE(buffer.GetAvailableBytes(), counts_data_size);
+  uint32_t expected_available_bytes_at_end = buffer.GetAvailableBytes() - counts_data_size;
+
+  // Write the profile index.
+  buffer.WriteUintAndAdvance(profile_index);
+  // Write the total size of the following data (without the profile index
+  // and the total size itself) for easy skipping when the dex file is filtered out.
+  uint32_t following_data_size = counts_data_size - sizeof(ProfileIndexType) - sizeof(uint32_t);
+  buffer.WriteUintAndAdvance(following_data_size);
+
+  uint16_t last_method_index = 0;
+  for (const auto& [method_index, branch_caches] : branch_map) {
+    if (branch_caches.empty()) {
+      continue;
+    }
+    DCHECK_GE(method_index, last_method_index);
+    uint16_t diff_with_last_method_index = method_index - last_method_index;
+    last_method_index = method_index;
+    buffer.WriteUintAndAdvance(diff_with_last_method_index);
+    buffer.WriteUintAndAdvance(dchecked_integral_cast<uint16_t>(branch_caches.size()));
+    for (const auto& [dex_pc, counts] : branch_caches) {
+      buffer.WriteUintAndAdvance(dex_pc);
+      buffer.WriteUintAndAdvance(counts.false_count);
+      buffer.WriteUintAndAdvance(counts.true_count);
+    }
+  }
+
+  // Check if we've written the right number of bytes.
+  DCHECK_EQ(buffer.GetAvailableBytes(), expected_available_bytes_at_end);
+}
+
+ProfileCompilationInfo::ProfileLoadStatus
+ProfileCompilationInfo::DexFileData::ReadBranchCounts(SafeBuffer& buffer, std::string* error) {
+  uint32_t following_data_size;
+  if (!buffer.ReadUintAndAdvance(&following_data_size)) {
+    *error = "Error reading branch counts data size.";
+    return ProfileLoadStatus::kBadData;
+  }
+  if (following_data_size > buffer.GetAvailableBytes()) {
+    *error = "Branch counts data size exceeds available data size.";
+    return ProfileLoadStatus::kBadData;
+  }
+  uint32_t expected_available_bytes_at_end = buffer.GetAvailableBytes() - following_data_size;
+
+  uint32_t num_valid_method_indexes =
+      std::min<uint32_t>(kMaxSupportedMethodIndex + 1u, num_method_ids);
+  uint16_t method_index = 0;
+  bool first_diff = true;
+  while (buffer.GetAvailableBytes() > expected_available_bytes_at_end) {
+    uint16_t diff_with_last_method_index;
+    if (!buffer.ReadUintAndAdvance(&diff_with_last_method_index)) {
+      *error = "Error reading branch counts method index diff.";
+      return ProfileLoadStatus::kBadData;
+    }
+    if (diff_with_last_method_index == 0u && !first_diff) {
+      *error = "Duplicate branch counts method index.";
+      return ProfileLoadStatus::kBadData;
+    }
+    first_diff = false;
+    if (diff_with_last_method_index >= num_valid_method_indexes - method_index) {
+      *error = "Invalid branch counts method index.";
+      return ProfileLoadStatus::kBadData;
+    }
+    method_index += diff_with_last_method_index;
+    BranchCacheMap* branch_caches = FindOrAddBranchCaches(method_index);
+    DCHECK(branch_caches != nullptr);
+
+    uint16_t num_branches;
+    if (!buffer.ReadUintAndAdvance(&num_branches)) {
+      *error = "Error reading number of branch counts.";
+      return ProfileLoadStatus::kBadData;
+    }
+    for (uint16_t i = 0; i != num_branches; ++i) {
+      uint16_t dex_pc;
+      uint32_t false_count;
+      uint32_t true_count;
+      if (!buffer.ReadUintAndAdvance(&dex_pc) ||
+          !buffer.ReadUintAndAdvance(&false_count) ||
+          !buffer.ReadUintAndAdvance(&true_count)) {
+        *error = "Error reading branch counts.";
+        return ProfileLoadStatus::kBadData;
+      }
+      branch_caches->FindOrAdd(dex_pc)->second.Add(false_count, true_count);
+    }
+  }
+
+  if (buffer.GetAvailableBytes() != expected_available_bytes_at_end) {
+    *error = "Branch counts data did not end at expected position.";
+    return ProfileLoadStatus::kBadData;
+  }
+
+  return ProfileLoadStatus::kSuccess;
+}
+
+ProfileCompilationInfo::ProfileLoadStatus
+ProfileCompilationInfo::DexFileData::SkipBranchCounts(SafeBuffer& buffer, std::string* error) {
+  uint32_t following_data_size;
+  if (!buffer.ReadUintAndAdvance(&following_data_size)) {
+    *error = "Error reading branch counts data size to skip.";
+    return ProfileLoadStatus::kBadData;
+  }
+  if (following_data_size > buffer.GetAvailableBytes()) {
+    *error = "Branch counts data size to skip exceeds remaining data.";
+    return ProfileLoadStatus::kBadData;
+  }
+  buffer.Advance(following_data_size);
+  return ProfileLoadStatus::kSuccess;
+}
+
 void ProfileCompilationInfo::DexFileData::WriteClassSet(
     SafeBuffer& buffer,
     const ArenaSet<dex::TypeIndex>& class_set) {
@@ -50,11 +50,15 @@ struct ProfileMethodInfo {
                        bool missing_types,
                        const std::vector<TypeReference>& profile_classes,
                        // Only used by profman for creating profiles from text
-                       bool megamorphic = false)
+                       bool megamorphic = false,
+                       const std::vector<uint32_t>& counts = {})
         : dex_pc(pc),
           is_missing_types(missing_types),
           classes(profile_classes),
-          is_megamorphic(megamorphic) {}
+          is_megamorphic(megamorphic),
+          class_counts(counts) {
+      DCHECK(class_counts.empty() || class_counts.size() == classes.size());
+    }
 
     const uint32_t dex_pc;
     const bool is_missing_types;
@@ -63,16 +67,34 @@ struct ProfileMethodInfo {
     // by the profman. See `ProfileCompilationInfo::FindOrCreateTypeIndex()`.
     const std::vector<TypeReference> classes;
     const bool is_megamorphic;
+    // How many times each of the `classes` was seen, or empty if unknown.
+    const std::vector<uint32_t> class_counts;
+  };
+
+  struct ProfileBranchCache {
+    ProfileBranchCache(uint32_t pc, uint32_t not_taken, uint32_t taken)
+        : dex_pc(pc),
+          false_count(not_taken),
+          true_count(taken) {}
+
+    const uint32_t dex_pc;
+    // How many times the conditional branch was not taken, and taken.
+    const uint32_t false_count;
+    const uint32_t true_count;
   };
 
   explicit ProfileMethodInfo(MethodReference reference) : ref(reference) {}
 
-  ProfileMethodInfo(MethodReference reference, const std::vector<ProfileInlineCache>& caches)
+  ProfileMethodInfo(MethodReference reference,
+                    const std::vector<ProfileInlineCache>& caches,
+                    const std::vector<ProfileBranchCache>& branches = {})
       : ref(reference),
-        inline_caches(caches) {}
+        inline_caches(caches),
+        branch_caches(branches) {}
 
   MethodReference ref;
   std::vector<ProfileInlineCache> inline_caches;
+  std::vector<ProfileBranchCache> branch_caches;
 };
 
 class FlattenProfileData;
@@ -138,22 +160,30 @@ class ProfileCompilationInfo {
     explicit DexPcData(const ArenaAllocatorAdapter<void>& allocator)
         : is_missing_types(false),
           is_megamorphic(false),
-          classes(std::less<dex::TypeIndex>(), allocator) {}
+          classes(std::less<dex::TypeIndex>(), allocator),
+          class_counts(std::less<dex::TypeIndex>(), allocator) {}
     void AddClass(const dex::TypeIndex& type_idx);
+    // Adds `count` to the number of times the receiver was `type_idx`, which must already be
+    // one of the `classes`.
+    void AddClassCount(const dex::TypeIndex& type_idx, uint32_t count);
+    uint32_t GetClassCount(const dex::TypeIndex& type_idx) const;
     void SetIsMegamorphic() {
       if (is_missing_types) return;
       is_megamorphic = true;
       classes.clear();
+      class_counts.clear();
     }
     void SetIsMissingTypes() {
       is_megamorphic = false;
       is_missing_types = true;
       classes.clear();
+      class_counts.clear();
     }
     bool operator==(const DexPcData& other) const {
       return is_megamorphic == other.is_megamorphic &&
           is_missing_types == other.is_missing_types &&
-          classes == other.classes;
+          classes == other.classes &&
+          class_counts == other.class_counts;
     }
 
     // Not all runtime types can be encoded in the profile. For example if the receiver
@@ -162,6 +192,9 @@ class ProfileCompilationInfo {
     bool is_missing_types;
     bool is_megamorphic;
     ArenaSet<dex::TypeIndex> classes;
+    // How many times the runtime saw each of the `classes` as receiver. Classes without a count
+    // were not counted, for example because the profile was written by an older runtime.
+    ArenaSafeMap<dex::TypeIndex, uint32_t> class_counts;
   };
 
   // The inline cache map: DexPc -> DexPcData.
@@ -170,6 +203,25 @@ class ProfileCompilationInfo {
   // Maps a method dex index to its inline cache.
   using MethodMap = ArenaSafeMap<uint16_t, InlineCacheMap>;
 
+  // The outcomes of a conditional branch.
+  struct BranchCounts {
+    bool operator==(const BranchCounts& other) const {
+      return false_count == other.false_count && true_count == other.true_count;
+    }
+
+    // Adds the counts of `other`. The counts saturate, only their ratio matters.
+    void Add(uint32_t other_false_count, uint32_t other_true_count);
+
+    uint32_t false_count = 0u;
+    uint32_t true_count = 0u;
+  };
+
+  // The branch cache map: DexPc -> BranchCounts.
+  using BranchCacheMap = ArenaSafeMap<uint16_t, BranchCounts>;
+
+  // Maps a method dex index to its branch caches.
+  using BranchMethodMap = ArenaSafeMap<uint16_t, BranchCacheMap>;
+
   // Profile method hotness information for a single method. Also includes a pointer to the inline
   // cache map.
   class MethodHotness {
@@ -244,14 +296,24 @@ class ProfileCompilationInfo {
       return inline_cache_map_;
     }
 
+    // Returns the branch counts of the method, or null if none were recorded.
+    const BranchCacheMap* GetBranchCacheMap() const {
+      return branch_cache_map_;
+    }
+
    private:
     const InlineCacheMap* inline_cache_map_ = nullptr;
+    const BranchCacheMap* branch_cache_map_ = nullptr;
     uint32_t flags_ = 0;
 
     void SetInlineCacheMap(const InlineCacheMap* info) {
       inline_cache_map_ = info;
     }
 
+    void SetBranchCacheMap(const BranchCacheMap* info) {
+      branch_cache_map_ = info;
+    }
+
     friend class ProfileCompilationInfo;
   };
 
@@ -775,6 +837,7 @@ class ProfileCompilationInfo {
           profile_index(index),
           checksum(location_checksum),
           method_map(std::less<uint16_t>(), allocator->Adapter(kArenaAllocProfile)),
+          branch_map(std::less<uint16_t>(), allocator->Adapter(kArenaAllocProfile)),
           class_set(std::less<dex::TypeIndex>(), allocator->Adapter(kArenaAllocProfile)),
           num_type_ids(num_types),
           num_method_ids(num_methods),
@@ -806,6 +869,7 @@ class ProfileCompilationInfo {
       return checksum == other.checksum &&
           num_method_ids == other.num_method_ids &&
           method_map == other.method_map &&
+          branch_map == other.branch_map &&
           class_set == other.class_set &&
           BitMemoryRegion::Equals(method_bitmap, other.method_bitmap);
     }
@@ -873,6 +937,19 @@ class ProfileCompilationInfo {
         std::string* error);
     static ProfileLoadStatus SkipMethods(SafeBuffer& buffer, std::string* error);
 
+    uint32_t InlineCacheCountsDataSize() const;
+    void WriteInlineCacheCounts(SafeBuffer& buffer) const;
+    ProfileLoadStatus ReadInlineCacheCounts(
+        SafeBuffer& buffer,
+        const dchecked_vector<ExtraDescriptorIndex>& extra_descriptors_remap,
+        std::string* error);
+    static ProfileLoadStatus SkipInlineCacheCounts(SafeBuffer& buffer, std::string* error);
+
+    uint32_t BranchCountsDataSize() const;
+    void WriteBranchCounts(SafeBuffer& buffer) const;
+    ProfileLoadStatus ReadBranchCounts(SafeBuffer& buffer, std::string* error);
+    static ProfileLoadStatus SkipBranchCounts(SafeBuffer& buffer, std::string* error);
+
     // The allocator used to allocate new inline cache maps.
     ArenaAllocator* const allocator_;
     // The profile key this data belongs to.
@@ -883,12 +960,17 @@ class ProfileCompilationInfo {
     uint32_t checksum;
     // The methods' profile information.
     MethodMap method_map;
+    // The branch counts of the hot methods.
+    BranchMethodMap branch_map;
     // The classes which have been profiled. Note that these don't necessarily include
     // all the classes that can be found in the inline caches reference.
     ArenaSet<dex::TypeIndex> class_set;
     // Find the inline caches of the the given method index. Add an empty entry if
     // no previous data is found.
     InlineCacheMap* FindOrAddHotMethod(uint16_t method_index);
+    // Find the branch caches of the given method index. Add an empty entry if
+    // no previous data is found.
+    BranchCacheMap* FindOrAddBranchCaches(uint16_t method_index);
     // Num type ids.
     uint32_t num_type_ids;
     // Num method ids.
@@ -1013,6 +1095,21 @@ class ProfileCompilationInfo {
       const dchecked_vector<ExtraDescriptorIndex>& extra_descriptors_remap,
       /*out*/ std::string* error);
 
+  // The inline cache counts apply to the inline caches read from the methods section, so this
+  // must be called after reading it.
+  ProfileLoadStatus ReadInlineCacheCountsSection(
+      ProfileSource& source,
+      const FileSectionInfo& section_info,
+      const dchecked_vector<ProfileIndexType>& dex_profile_index_remap,
+      const dchecked_vector<ExtraDescriptorIndex>& extra_descriptors_remap,
+      /*out*/ std::string* error);
+
+  ProfileLoadStatus ReadBranchCountsSection(
+      ProfileSource& source,
+      const FileSectionInfo& section_info,
+      const dchecked_vector<ProfileIndexType>& dex_profile_index_remap,
+      /*out*/ std::string* error);
+
   // Entry point for profile loading functionality.
   ProfileLoadStatus LoadInternal(
       int32_t fd,
@@ -678,6 +678,122 @@ TEST_F(ProfileCompilationInfoTest, InlineCacheAcrossDexFiles) {
   ASSERT_STREQ(kDex1Class, info.GetTypeDescriptor(dex2, type_index));
 }
 
+TEST_F(ProfileCompilationInfoTest, InlineCacheCounts) {
+  ScratchFile profile;
+
+  // The second class is in another dex file, so it is recorded with an extra descriptor.
+  std::vector<TypeReference> types = {
+      TypeReference(dex1, dex::TypeIndex(0)),
+      TypeReference(dex2, dex::TypeIndex(1))};
+  std::vector<ProfileInlineCache> inline_caches {
+      ProfileInlineCache(/*pc=*/ 1u,
+                         /*missing_types=*/ false,
+                         types,
+                         /*megamorphic=*/ false,
+                         /*counts=*/ {90u, 10u}),
+      // Counts are optional.
+      ProfileInlineCache(/*pc=*/ 2u, /*missing_types=*/ false, types)
+  };
+
+  ProfileCompilationInfo saved_info;
+  ASSERT_TRUE(AddMethod(&saved_info, dex1, /*method_idx=*/ 0, inline_caches));
+  ASSERT_TRUE(saved_info.Save(GetFd(profile)));
+  ASSERT_EQ(0, profile.GetFile()->Flush());
+
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(loaded_info.Load(GetFd(profile)));
+  ASSERT_TRUE(loaded_info.Equals(saved_info));
+
+  auto check_counts = [&](const ProfileCompilationInfo& info, uint32_t scale) {
+    Hotness hotness = GetMethod(info, dex1, /*method_idx=*/ 0);
+    ASSERT_TRUE(hotness.IsHot());
+    ASSERT_TRUE(EqualInlineCaches(inline_caches, dex1, hotness, info));
+    const ProfileCompilationInfo::InlineCacheMap* inline_cache_map = hotness.GetInlineCacheMap();
+    ASSERT_TRUE(inline_cache_map != nullptr);
+    const ProfileCompilationInfo::DexPcData& counted = inline_cache_map->Get(1u);
+    ASSERT_EQ(2u, counted.classes.size());
+    for (dex::TypeIndex type_index : counted.classes) {
+      EXPECT_EQ((type_index == dex::TypeIndex(0) ? 90u : 10u) * scale,
+                counted.GetClassCount(type_index));
+    }
+    const ProfileCompilationInfo::DexPcData& not_counted = inline_cache_map->Get(2u);
+    ASSERT_EQ(2u, not_counted.classes.size());
+    EXPECT_TRUE(not_counted.class_counts.empty());
+  };
+  check_counts(loaded_info, /*scale=*/ 1u);
+
+  // Merging adds up the counts.
+  ASSERT_TRUE(loaded_info.MergeWith(saved_info));
+  check_counts(loaded_info, /*scale=*/ 2u);
+
+  // The counts are dropped when the inline cache becomes megamorphic.
+  std::vector<ProfileInlineCache> megamorphic_inline_caches = inline_caches;
+  MakeMegamorphic(&megamorphic_inline_caches);
+  ASSERT_TRUE(AddMethod(&loaded_info, dex1, /*method_idx=*/ 0, megamorphic_inline_caches));
+  const ProfileCompilationInfo::InlineCacheMap* inline_cache_map =
+      GetMethod(loaded_info, dex1, /*method_idx=*/ 0).GetInlineCacheMap();
+  ASSERT_TRUE(inline_cache_map != nullptr);
+  EXPECT_TRUE(inline_cache_map->Get(1u).is_megamorphic);
+  EXPECT_TRUE(inline_cache_map->Get(1u).class_counts.empty());
+}
+
+TEST_F(ProfileCompilationInfoTest, BranchCounts) {
+  ScratchFile profile;
+
+  std::vector<ProfileMethodInfo::ProfileBranchCache> branch_caches {
+      ProfileMethodInfo::ProfileBranchCache(/*pc=*/ 3u, /*not_taken=*/ 5u, /*taken=*/ 95u),
+      ProfileMethodInfo::ProfileBranchCache(/*pc=*/ 7u, /*not_taken=*/ 40u, /*taken=*/ 0u),
+      // Branches which were not executed are not recorded.
+      ProfileMethodInfo::ProfileBranchCache(/*pc=*/ 9u, /*not_taken=*/ 0u, /*taken=*/ 0u)
+  };
+
+  ProfileCompilationInfo saved_info;
+  for (const DexFile* dex : {dex1, dex2}) {
+    ASSERT_TRUE(saved_info.AddMethod(
+        ProfileMethodInfo(MethodReference(dex, /*index=*/ 1), /*caches=*/ {}, branch_caches),
+        Hotness::kFlagHot));
+  }
+  // Only hot methods have branch counts.
+  ASSERT_TRUE(saved_info.AddMethod(
+      ProfileMethodInfo(MethodReference(dex1, /*index=*/ 2), /*caches=*/ {}, branch_caches),
+      Hotness::kFlagStartup));
+  ASSERT_TRUE(saved_info.Save(GetFd(profile)));
+  ASSERT_EQ(0, profile.GetFile()->Flush());
+
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(loaded_info.Load(GetFd(profile)));
+  ASSERT_TRUE(loaded_info.Equals(saved_info));
+
+  auto check_counts = [&](const ProfileCompilationInfo& info, const DexFile* dex, uint32_t scale) {
+    Hotness hotness = GetMethod(info, dex, /*method_idx=*/ 1);
+    ASSERT_TRUE(hotness.IsHot());
+    const ProfileCompilationInfo::BranchCacheMap* branch_cache_map = hotness.GetBranchCacheMap();
+    ASSERT_TRUE(branch_cache_map != nullptr);
+    ASSERT_EQ(2u, branch_cache_map->size());
+    EXPECT_EQ(5u * scale, branch_cache_map->Get(3u).false_count);
+    EXPECT_EQ(95u * scale, branch_cache_map->Get(3u).true_count);
+    EXPECT_EQ(40u * scale, branch_cache_map->Get(7u).false_count);
+    EXPECT_EQ(0u, branch_cache_map->Get(7u).true_count);
+  };
+  check_counts(loaded_info, dex1, /*scale=*/ 1u);
+  check_counts(loaded_info, dex2, /*scale=*/ 1u);
+  EXPECT_TRUE(GetMethod(loaded_info, dex1, /*method_idx=*/ 2).GetBranchCacheMap() == nullptr);
+
+  // Merging adds up the counts.
+  ASSERT_TRUE(loaded_info.MergeWith(saved_info));
+  check_counts(loaded_info, dex1, /*scale=*/ 2u);
+
+  // The branch counts of filtered out dex files are skipped.
+  ProfileCompilationInfo filtered_info;
+  ProfileCompilationInfo::ProfileLoadFilterFn filter_fn =
+      [&dex2 = dex2](const std::string& dex_location, uint32_t checksum) -> bool {
+        return dex_location == dex2->GetLocation() && checksum == dex2->GetLocationChecksum();
+      };
+  ASSERT_TRUE(filtered_info.Load(GetFd(profile), /*merge_classes=*/ true, filter_fn));
+  ASSERT_EQ(1u, filtered_info.GetNumberOfDexFiles());
+  check_counts(filtered_info, dex2, /*scale=*/ 1u);
+}
+
 // Verify that profiles behave correctly even if the methods are added in a different
 // order and with a different dex profile indices for the dex files.
 TEST_F(ProfileCompilationInfoTest, MergeInlineCacheTriggerReindex) {
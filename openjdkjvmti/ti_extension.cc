@@ -396,6 +396,41 @@ jvmtiError ExtensionUtil::GetExtensionFunctions(jvmtiEnv* env,
     return error;
   }
 
+  // Class histogram
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(HeapExtensions::SetClassHistogramEnabled),
+      "com.android.art.heap.set_class_histogram_enabled",
+      "Enables or disables the class histogram, which estimates the objects allocated and counts"
+      " the objects surviving a concurrent copying GC per class. The allocations are sampled"
+      " when threads refill their allocation buffers, so the allocation entrypoints stay"
+      " uninstrumented. Enabling it clears the counts. It is the same as the -XX:ClassHistogram"
+      " runtime option.",
+      {
+        { "enabled", JVMTI_KIND_IN, JVMTI_TYPE_JBOOLEAN, false },
+      },
+      { });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(HeapExtensions::GetClassHistogram),
+      "com.android.art.heap.get_class_histogram",
+      "Returns the class histogram in human readable form, sorted by decreasing allocated bytes."
+      " The counts of each thread are only added to the histogram when the GC runs, so the"
+      " histogram is as of the last GC. Returns JVMTI_ERROR_ABSENT_INFORMATION if the histogram"
+      " was never enabled.",
+      {
+        { "histogram", JVMTI_KIND_ALLOC_BUF, JVMTI_TYPE_CCHAR, false },
+      },
+      {
+         ERR(NULL_POINTER),
+         ERR(ABSENT_INFORMATION),
+      });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
   // These require index-ids and debuggable to function
   art::Runtime* runtime = art::Runtime::Current();
   if (runtime->GetJniIdType() == art::JniIdType::kIndices &&
@@ -17,6 +17,8 @@
 #include "ti_heap.h"
 
 #include <ios>
+#include <limits>
+#include <sstream>
 #include <unordered_map>
 
 #include "android-base/logging.h"
@@ -32,6 +34,7 @@
 #include "deopt_manager.h"
 #include "dex/primitive.h"
 #include "events-inl.h"
+#include "gc/class_histogram.h"
 #include "gc/collector_type.h"
 #include "gc/gc_cause.h"
 #include "gc/heap-visit-objects-inl.h"
@@ -1578,6 +1581,26 @@ jvmtiError HeapExtensions::GetHeapName(jvmtiEnv* env, jint heap_id, char** heap_
   }
 }
 
+jvmtiError HeapExtensions::SetClassHistogramEnabled(jvmtiEnv* env ATTRIBUTE_UNUSED,
+                                                    jboolean enabled) {
+  art::Runtime::Current()->GetHeap()->SetClassHistogramEnabled(enabled == JNI_TRUE);
+  return ERR(NONE);
+}
+
+jvmtiError HeapExtensions::GetClassHistogram(jvmtiEnv* env, char** histogram) {
+  if (histogram == nullptr) {
+    return ERR(NULL_POINTER);
+  }
+  art::gc::ClassHistogram* class_histogram =
+      art::Runtime::Current()->GetHeap()->GetClassHistogram();
+  if (class_histogram == nullptr) {
+    return ERR(ABSENT_INFORMATION);
+  }
+  std::ostringstream oss;
+  class_histogram->Dump(oss, std::numeric_limits<size_t>::max());
+  return CopyStringAndReturn(env, oss.str().c_str(), histogram);
+}
+
 jvmtiError HeapExtensions::IterateThroughHeapExt(jvmtiEnv* env,
                                                  jint heap_filter,
                                                  jclass klass,
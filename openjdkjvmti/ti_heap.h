@@ -91,6 +91,9 @@ class HeapExtensions {
 
   static jvmtiError JNICALL ChangeArraySize(jvmtiEnv* env, jobject arr, jsize new_size);
 
+  static jvmtiError JNICALL SetClassHistogramEnabled(jvmtiEnv* env, jboolean enabled);
+  static jvmtiError JNICALL GetClassHistogram(jvmtiEnv* env, char** histogram);
+
   static void ReplaceReferences(
       art::Thread* self,
       const std::unordered_map<art::ObjPtr<art::mirror::Object>,
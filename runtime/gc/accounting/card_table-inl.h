@@ -19,12 +19,16 @@
 
 #include "card_table.h"
 
+#include <algorithm>
+
 #include <android-base/logging.h>
 
 #include "base/atomic.h"
 #include "base/bit_utils.h"
 #include "base/mem_map.h"
 #include "space_bitmap.h"
+#include "thread.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
@@ -86,10 +90,12 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
     uintptr_t* word_end = reinterpret_cast<uintptr_t*>(aligned_end);
     for (uintptr_t* word_cur = reinterpret_cast<uintptr_t*>(card_cur); word_cur < word_end;
         ++word_cur) {
-      while (LIKELY(*word_cur == 0)) {
-        ++word_cur;
+      if (LIKELY(*word_cur == 0)) {
+        // Skip the run of clean cards with the vectorized search.
+        uint8_t* card = FindNonCleanCard(reinterpret_cast<uint8_t*>(word_cur), aligned_end);
+        word_cur = reinterpret_cast<uintptr_t*>(AlignDown(card, sizeof(uintptr_t)));
         if (UNLIKELY(word_cur >= word_end)) {
-          goto exit_for;
+          break;
         }
       }
 
@@ -111,7 +117,6 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
         start += kCardSize;
       }
     }
-    exit_for:
 
     // Handle any unaligned cards at the end.
     card_cur = reinterpret_cast<uint8_t*>(word_end);
@@ -182,8 +187,17 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
     uint8_t new_bytes[sizeof(uintptr_t)];
   };
 
-  // TODO: Parallelize.
   while (word_cur < word_end) {
+    static_assert(kCardClean == 0);
+    if (*word_cur == 0) {
+      // Skip the run of clean cards with the vectorized search.
+      uint8_t* card = FindNonCleanCard(reinterpret_cast<uint8_t*>(word_cur),
+                                       reinterpret_cast<uint8_t*>(word_end));
+      word_cur = reinterpret_cast<uintptr_t*>(AlignDown(card, sizeof(uintptr_t)));
+      if (word_cur >= word_end) {
+        break;
+      }
+    }
     while (true) {
       expected_word = *word_cur;
       static_assert(kCardClean == 0);
@@ -209,6 +223,67 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
   }
 }
 
+template <typename ChunkVisitor>
+inline void CardTable::VisitChunksParallel(ThreadPool* thread_pool,
+                                           uint8_t* scan_begin,
+                                           uint8_t* scan_end,
+                                           const ChunkVisitor& chunk_visitor) {
+  DCHECK_ALIGNED(scan_begin, kCardSize);
+  Thread* const self = Thread::Current();
+  size_t num_chunks = 0;
+  for (uint8_t* chunk_begin = scan_begin; chunk_begin < scan_end; ++num_chunks) {
+    uint8_t* chunk_end =
+        chunk_begin + std::min(kParallelChunkSize, static_cast<size_t>(scan_end - chunk_begin));
+    // No thread safety analysis since the calling thread holds the locks on behalf of the workers
+    // while they run.
+    thread_pool->AddTask(self, new FunctionTask(
+        [&chunk_visitor, chunk_begin, chunk_end](Thread*) NO_THREAD_SAFETY_ANALYSIS {
+          chunk_visitor(chunk_begin, chunk_end);
+        }));
+    chunk_begin = chunk_end;
+  }
+  if (num_chunks == 0) {
+    return;
+  }
+  thread_pool->SetMaxActiveWorkers(std::min(num_chunks, thread_pool->GetThreadCount() + 1) - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  thread_pool->StopWorkers(self);
+}
+
+template <typename Visitor, typename ModifiedVisitor>
+inline void CardTable::ModifyCardsAtomicParallel(ThreadPool* thread_pool,
+                                                 uint8_t* scan_begin,
+                                                 uint8_t* scan_end,
+                                                 const Visitor& visitor,
+                                                 const ModifiedVisitor& modified) {
+  VisitChunksParallel(thread_pool,
+                      scan_begin,
+                      scan_end,
+                      [&](uint8_t* chunk_begin, uint8_t* chunk_end) {
+                        ModifyCardsAtomic(chunk_begin, chunk_end, visitor, modified);
+                      });
+}
+
+template <bool kClearCard, typename Visitor>
+inline size_t CardTable::ScanParallel(ThreadPool* thread_pool,
+                                      ContinuousSpaceBitmap* bitmap,
+                                      uint8_t* scan_begin,
+                                      uint8_t* scan_end,
+                                      const Visitor& visitor,
+                                      const uint8_t minimum_age) {
+  Atomic<size_t> cards_scanned(0u);
+  VisitChunksParallel(
+      thread_pool,
+      scan_begin,
+      scan_end,
+      [&](uint8_t* chunk_begin, uint8_t* chunk_end) NO_THREAD_SAFETY_ANALYSIS {
+        size_t count = Scan<kClearCard>(bitmap, chunk_begin, chunk_end, visitor, minimum_age);
+        cards_scanned.fetch_add(count, std::memory_order_relaxed);
+      });
+  return cards_scanned.load(std::memory_order_relaxed);
+}
+
 inline void* CardTable::AddrFromCard(const uint8_t *card_addr) const {
   DCHECK(IsValidCard(card_addr))
     << " card_addr: " << reinterpret_cast<const void*>(card_addr)
@@ -18,6 +18,13 @@
 
 #include <sys/mman.h>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "base/bit_utils.h"
 #include "base/mem_map.h"
 #include "base/systrace.h"
 #include "base/utils.h"
@@ -132,6 +139,119 @@ void CardTable::CheckAddrIsInCardTable(const uint8_t* addr) const {
       << " addr: " << reinterpret_cast<const void*>(addr);
 }
 
+uint8_t* CardTable::FindNonCleanCardScalar(uint8_t* card_begin, uint8_t* card_end) {
+  static_assert(kCardClean == 0, "kCardClean must be 0");
+  uint8_t* card_cur = card_begin;
+  // Handle any unaligned cards at the start.
+  while (!IsAligned<sizeof(uintptr_t)>(card_cur) && card_cur < card_end) {
+    if (*card_cur != kCardClean) {
+      return card_cur;
+    }
+    ++card_cur;
+  }
+  uint8_t* aligned_end = AlignDown(card_end, sizeof(uintptr_t));
+  while (card_cur < aligned_end && *reinterpret_cast<uintptr_t*>(card_cur) == 0u) {
+    card_cur += sizeof(uintptr_t);
+  }
+  // Find the card in the non-clean word, or handle the unaligned cards at the end.
+  while (card_cur < card_end && *card_cur == kCardClean) {
+    ++card_cur;
+  }
+  return card_cur;
+}
+
+// The vectorized searches test blocks of 64 cards, aligned to 64 bytes so that the loads never
+// cross a cache line, and leave the cards before the first block, after the last one, and the
+// search for the exact card within a non-clean block to FindNonCleanCardScalar.
+static constexpr size_t kCardBlockSize = 64;
+
+#if defined(__SSE2__)
+
+static uint8_t* FindNonCleanCardSse2(uint8_t* card_begin, uint8_t* card_end) {
+  uint8_t* card_cur = AlignUp(card_begin, kCardBlockSize);
+  uint8_t* aligned_end = AlignDown(card_end, kCardBlockSize);
+  if (card_cur >= aligned_end) {
+    return CardTable::FindNonCleanCardScalar(card_begin, card_end);
+  }
+  uint8_t* card = CardTable::FindNonCleanCardScalar(card_begin, card_cur);
+  if (card != card_cur) {
+    return card;
+  }
+  const __m128i zero = _mm_setzero_si128();
+  for (; card_cur < aligned_end; card_cur += kCardBlockSize) {
+    const __m128i* block = reinterpret_cast<const __m128i*>(card_cur);
+    __m128i cards_low = _mm_or_si128(_mm_load_si128(block), _mm_load_si128(block + 1));
+    __m128i cards_high = _mm_or_si128(_mm_load_si128(block + 2), _mm_load_si128(block + 3));
+    __m128i cards = _mm_or_si128(cards_low, cards_high);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(cards, zero)) != 0xffff) {
+      break;
+    }
+  }
+  return CardTable::FindNonCleanCardScalar(card_cur, card_end);
+}
+
+__attribute__((target("avx2")))
+static uint8_t* FindNonCleanCardAvx2(uint8_t* card_begin, uint8_t* card_end) {
+  uint8_t* card_cur = AlignUp(card_begin, kCardBlockSize);
+  uint8_t* aligned_end = AlignDown(card_end, kCardBlockSize);
+  if (card_cur >= aligned_end) {
+    return CardTable::FindNonCleanCardScalar(card_begin, card_end);
+  }
+  uint8_t* card = CardTable::FindNonCleanCardScalar(card_begin, card_cur);
+  if (card != card_cur) {
+    return card;
+  }
+  for (; card_cur < aligned_end; card_cur += kCardBlockSize) {
+    const __m256i* block = reinterpret_cast<const __m256i*>(card_cur);
+    __m256i cards = _mm256_or_si256(_mm256_load_si256(block), _mm256_load_si256(block + 1));
+    if (!_mm256_testz_si256(cards, cards)) {
+      break;
+    }
+  }
+  return CardTable::FindNonCleanCardScalar(card_cur, card_end);
+}
+
+#elif defined(__aarch64__)
+
+static uint8_t* FindNonCleanCardNeon(uint8_t* card_begin, uint8_t* card_end) {
+  uint8_t* card_cur = AlignUp(card_begin, kCardBlockSize);
+  uint8_t* aligned_end = AlignDown(card_end, kCardBlockSize);
+  if (card_cur >= aligned_end) {
+    return CardTable::FindNonCleanCardScalar(card_begin, card_end);
+  }
+  uint8_t* card = CardTable::FindNonCleanCardScalar(card_begin, card_cur);
+  if (card != card_cur) {
+    return card;
+  }
+  for (; card_cur < aligned_end; card_cur += kCardBlockSize) {
+    uint8x16_t cards = vorrq_u8(vorrq_u8(vld1q_u8(card_cur), vld1q_u8(card_cur + 16)),
+                                vorrq_u8(vld1q_u8(card_cur + 32), vld1q_u8(card_cur + 48)));
+    if (vmaxvq_u8(cards) != 0u) {
+      break;
+    }
+  }
+  return CardTable::FindNonCleanCardScalar(card_cur, card_end);
+}
+
+#endif
+
+using FindNonCleanCardFunction = uint8_t* (*)(uint8_t*, uint8_t*);
+
+static FindNonCleanCardFunction SelectFindNonCleanCard() {
+#if defined(__SSE2__)
+  return __builtin_cpu_supports("avx2") ? FindNonCleanCardAvx2 : FindNonCleanCardSse2;
+#elif defined(__aarch64__)
+  return FindNonCleanCardNeon;
+#else
+  return CardTable::FindNonCleanCardScalar;
+#endif
+}
+
+uint8_t* CardTable::FindNonCleanCard(uint8_t* card_begin, uint8_t* card_end) {
+  static const FindNonCleanCardFunction find_non_clean_card = SelectFindNonCleanCard();
+  return find_non_clean_card(card_begin, card_end);
+}
+
 void CardTable::VerifyCardTable() {
   UNIMPLEMENTED(WARNING) << "Card table verification";
 }
@@ -25,6 +25,8 @@
 
 namespace art {
 
+class ThreadPool;
+
 namespace mirror {
 class Object;
 }  // namespace mirror
@@ -51,6 +53,9 @@ class CardTable {
   static constexpr uint8_t kCardClean = 0x0;
   static constexpr uint8_t kCardDirty = 0x70;
   static constexpr uint8_t kCardAged = kCardDirty - 1;
+  // Bytes of heap covered by each task of the parallel card scans. A multiple of the heap bytes
+  // covered by a word of a mod-union table card bitmap, so that tasks never share such a word.
+  static constexpr size_t kParallelChunkSize = 16 * MB;
 
   static CardTable* Create(const uint8_t* heap_begin, size_t heap_capacity);
   ~CardTable();
@@ -114,6 +119,19 @@ class CardTable {
                          const Visitor& visitor,
                          const ModifiedVisitor& modified);
 
+  // Same as ModifyCardsAtomic, but splits the range into chunks of `kParallelChunkSize` bytes
+  // which are processed by the workers of `thread_pool` and the calling thread. `scan_begin` must
+  // be card aligned and `modified` must be safe to call concurrently for cards of different
+  // chunks. The GC passes the heap thread pool, which only exists when -XX:ParallelGCThreads,
+  // -XX:ConcGCThreads or -XX:ConcurrentCopyingMarkWorkers ask for GC threads. None of them do by
+  // default, and the callers then use the serial ModifyCardsAtomic and Scan.
+  template <typename Visitor, typename ModifiedVisitor>
+  void ModifyCardsAtomicParallel(ThreadPool* thread_pool,
+                                 uint8_t* scan_begin,
+                                 uint8_t* scan_end,
+                                 const Visitor& visitor,
+                                 const ModifiedVisitor& modified);
+
   // For every dirty at least minumum age between begin and end invoke the visitor with the
   // specified argument. Returns how many cards the visitor was run on.
   template <bool kClearCard, typename Visitor>
@@ -125,6 +143,26 @@ class CardTable {
       REQUIRES(Locks::heap_bitmap_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Same as Scan, but the chunks of `kParallelChunkSize` bytes of the range are scanned by the
+  // workers of `thread_pool` and the calling thread, so the visitor must be thread safe.
+  // `scan_begin` must be card aligned.
+  template <bool kClearCard, typename Visitor>
+  size_t ScanParallel(ThreadPool* thread_pool,
+                      SpaceBitmap<kObjectAlignment>* bitmap,
+                      uint8_t* scan_begin,
+                      uint8_t* scan_end,
+                      const Visitor& visitor,
+                      const uint8_t minimum_age = kCardDirty)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Returns the first card in [card_begin, card_end) which is not clean, or `card_end` if they
+  // are all clean. Uses the widest vector unit of the CPU, AVX2 or SSE2 on x86 and NEON on arm64.
+  static uint8_t* FindNonCleanCard(uint8_t* card_begin, uint8_t* card_end);
+
+  // Word at a time version of FindNonCleanCard, used on other architectures and for testing.
+  static uint8_t* FindNonCleanCardScalar(uint8_t* card_begin, uint8_t* card_end);
+
   // Assertion used to check the given address is covered by the card table
   void CheckAddrIsInCardTable(const uint8_t* addr) const;
 
@@ -145,6 +183,14 @@ class CardTable {
  private:
   CardTable(MemMap&& mem_map, uint8_t* biased_begin, size_t offset);
 
+  // Runs chunk_visitor(chunk_begin, chunk_end) on the chunks of `kParallelChunkSize` bytes of
+  // [scan_begin, scan_end) with the workers of `thread_pool` and the calling thread.
+  template <typename ChunkVisitor>
+  static void VisitChunksParallel(ThreadPool* thread_pool,
+                                  uint8_t* scan_begin,
+                                  uint8_t* scan_end,
+                                  const ChunkVisitor& chunk_visitor);
+
   // Returns true iff the card table address is within the bounds of the card table.
   bool IsValidCard(const uint8_t* card_addr) const ALWAYS_INLINE;
 
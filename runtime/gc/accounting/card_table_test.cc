@@ -17,13 +17,18 @@
 #include "card_table-inl.h"
 
 #include <string>
+#include <utility>
 
 #include "base/atomic.h"
+#include "base/mem_map.h"
+#include "base/time_utils.h"
 #include "base/utils.h"
 #include "common_runtime_test.h"
+#include "gc/heap.h"
 #include "handle_scope-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
+#include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread_pool.h"
 
@@ -38,6 +43,16 @@ namespace accounting {
 
 class CardTableTest : public CommonRuntimeTest {
  public:
+  // The heap thread pool which runs the parallel card table operations only exists with GC
+  // threads, and there are none by default.
+  static constexpr size_t kNumParallelGCThreads = 3;
+
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair(
+        "-XX:ParallelGCThreads=" + std::to_string(kNumParallelGCThreads), nullptr));
+  }
+
   std::unique_ptr<CardTable> card_table_;
 
   void CommonSetup() {
@@ -145,6 +160,120 @@ TEST_F(CardTableTest, TestModifyCardsAtomic) {
   }
 }
 
+TEST_F(CardTableTest, TestFindNonCleanCard) {
+  CommonSetup();
+  uint8_t* card_begin = card_table_->CardFromAddr(HeapBegin());
+  uint8_t* card_end = card_table_->CardFromAddr(HeapLimit());
+  const size_t num_cards = card_end - card_begin;
+  // Try every alignment of the range around a single non-clean card, and no non-clean card.
+  for (size_t dirty_index = 0; dirty_index <= 3 * 64; ++dirty_index) {
+    if (dirty_index < 3 * 64) {
+      card_begin[dirty_index] = CardTable::kCardAged;
+    }
+    for (size_t begin_index = 0; begin_index < 64; ++begin_index) {
+      for (size_t end_index = num_cards - 64; end_index <= num_cards; ++end_index) {
+        uint8_t* range_begin = card_begin + begin_index;
+        uint8_t* range_end = card_begin + end_index;
+        uint8_t* expected = (dirty_index >= begin_index && dirty_index < 3 * 64)
+            ? card_begin + dirty_index
+            : range_end;
+        EXPECT_EQ(expected, CardTable::FindNonCleanCardScalar(range_begin, range_end));
+        EXPECT_EQ(expected, CardTable::FindNonCleanCard(range_begin, range_end));
+      }
+    }
+    if (dirty_index < 3 * 64) {
+      card_begin[dirty_index] = CardTable::kCardClean;
+    }
+  }
+}
+
+class CountModifiedVisitor {
+ public:
+  explicit CountModifiedVisitor(Atomic<size_t>* count) : count_(count) {}
+
+  void operator()(uint8_t* /*card*/, uint8_t /*expected_value*/, uint8_t /*new_value*/) const {
+    count_->fetch_add(1u, std::memory_order_relaxed);
+  }
+
+ private:
+  Atomic<size_t>* const count_;
+};
+
+TEST_F(CardTableTest, TestModifyCardsAtomicParallel) {
+  ThreadPool* thread_pool = Runtime::Current()->GetHeap()->GetThreadPool();
+  ASSERT_TRUE(thread_pool != nullptr);
+  ASSERT_EQ(kNumParallelGCThreads, thread_pool->GetThreadCount());
+  // Cover several parallel chunks.
+  uint8_t* const heap_begin = reinterpret_cast<uint8_t*>(0x2000000);
+  const size_t heap_size = 4 * CardTable::kParallelChunkSize + 3 * CardTable::kCardSize;
+  std::unique_ptr<CardTable> card_table(CardTable::Create(heap_begin, heap_size));
+  ASSERT_TRUE(card_table != nullptr);
+  size_t num_dirty_cards = 0;
+  uint8_t* const heap_end = heap_begin + heap_size;
+  for (uint8_t* addr = heap_begin; addr < heap_end; addr += 37 * CardTable::kCardSize) {
+    card_table->MarkCard(addr);
+    ++num_dirty_cards;
+  }
+  Atomic<size_t> num_modified_cards(0u);
+  card_table->ModifyCardsAtomicParallel(thread_pool,
+                                        heap_begin,
+                                        heap_end,
+                                        AgeCardVisitor(),
+                                        CountModifiedVisitor(&num_modified_cards));
+  EXPECT_EQ(num_dirty_cards, num_modified_cards.load());
+  for (uint8_t* addr = heap_begin; addr < heap_end; addr += CardTable::kCardSize) {
+    uint8_t expected = ((addr - heap_begin) / CardTable::kCardSize % 37 == 0)
+        ? CardTable::kCardAged
+        : CardTable::kCardClean;
+    ASSERT_EQ(expected, *card_table->CardFromAddr(addr));
+  }
+}
+
+// Compares the scalar and vectorized searches on the cards of a synthetic 4GB heap with a few
+// dirty cards, like the card table of a large heap during a sticky GC.
+TEST_F(CardTableTest, FindNonCleanCardBenchmark) {
+  static constexpr size_t kNumCards =
+      static_cast<size_t>(UINT64_C(4) * GB / CardTable::kCardSize);
+  static constexpr size_t kDirtyCardInterval = 4 * KB + 7;
+  std::string error_msg;
+  MemMap cards = MemMap::MapAnonymous("card table benchmark",
+                                      kNumCards,
+                                      PROT_READ | PROT_WRITE,
+                                      /*low_4gb=*/ false,
+                                      &error_msg);
+  ASSERT_TRUE(cards.IsValid()) << error_msg;
+  size_t num_dirty_cards = 0;
+  for (size_t i = kDirtyCardInterval / 2; i < kNumCards; i += kDirtyCardInterval) {
+    cards.Begin()[i] = CardTable::kCardDirty;
+    ++num_dirty_cards;
+  }
+  auto count_non_clean_cards = [&](uint8_t* (*find_non_clean_card)(uint8_t*, uint8_t*)) {
+    uint64_t start_time = NanoTime();
+    size_t count = 0;
+    uint8_t* card_end = cards.Begin() + kNumCards;
+    for (uint8_t* card = find_non_clean_card(cards.Begin(), card_end);
+         card != card_end;
+         card = find_non_clean_card(card + 1, card_end)) {
+      ++count;
+    }
+    return std::make_pair(count, NanoTime() - start_time);
+  };
+  static constexpr size_t kNumIterations = 10;
+  uint64_t scalar_time = 0;
+  uint64_t vector_time = 0;
+  for (size_t i = 0; i < kNumIterations; ++i) {
+    auto [scalar_count, scalar_duration] = count_non_clean_cards(CardTable::FindNonCleanCardScalar);
+    auto [vector_count, vector_duration] = count_non_clean_cards(CardTable::FindNonCleanCard);
+    EXPECT_EQ(num_dirty_cards, scalar_count);
+    EXPECT_EQ(num_dirty_cards, vector_count);
+    scalar_time += scalar_duration;
+    vector_time += vector_duration;
+  }
+  LOG(INFO) << "Card search of a 4GB heap: scalar "
+            << PrettyDuration(scalar_time / kNumIterations) << ", vectorized "
+            << PrettyDuration(vector_time / kNumIterations);
+}
+
 // TODO: Add test for CardTable::Scan.
 }  // namespace accounting
 }  // namespace gc
@@ -31,6 +31,7 @@
 #include "object_callbacks.h"
 #include "space_bitmap-inl.h"
 #include "thread-current-inl.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
@@ -531,8 +532,18 @@ class CardBitVisitor {
 void ModUnionTableCardCache::ProcessCards() {
   CardTable* const card_table = GetHeap()->GetCardTable();
   ModUnionAddToCardBitmapVisitor visitor(card_bitmap_.get(), card_table);
-  // Clear dirty cards in the this space and update the corresponding mod-union bits.
-  card_table->ModifyCardsAtomic(space_->Begin(), space_->End(), AgeCardVisitor(), visitor);
+  // Clear dirty cards in the this space and update the corresponding mod-union bits. The chunks
+  // of the parallel version start at multiples of kParallelChunkSize from the beginning of the
+  // card bitmap, so the workers never set bits in the same bitmap word.
+  ThreadPool* const thread_pool = GetHeap()->GetThreadPool();
+  if (thread_pool != nullptr &&
+      thread_pool->GetThreadCount() != 0u &&
+      space_->Size() > CardTable::kParallelChunkSize) {
+    card_table->ModifyCardsAtomicParallel(
+        thread_pool, space_->Begin(), space_->End(), AgeCardVisitor(), visitor);
+  } else {
+    card_table->ModifyCardsAtomic(space_->Begin(), space_->End(), AgeCardVisitor(), visitor);
+  }
 }
 
 void ModUnionTableCardCache::ClearTable() {
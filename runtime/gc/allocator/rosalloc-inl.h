@@ -58,7 +58,8 @@ inline bool RosAlloc::Run::IsFull() {
 
 inline bool RosAlloc::CanAllocFromThreadLocalRun(Thread* self, size_t size) {
   if (UNLIKELY(!IsSizeForThreadLocal(size))) {
-    return false;
+    return IsSizeForMagazine(size) &&
+        self->GetRosAllocMagazine(SizeToIndex(size) - kNumThreadLocalSizeBrackets) != nullptr;
   }
   size_t bracket_size;
   size_t idx = SizeToIndexAndBracketSize(size, &bracket_size);
@@ -79,7 +80,16 @@ inline void* RosAlloc::AllocFromThreadLocalRun(Thread* self, size_t size,
                                                size_t* bytes_allocated) {
   DCHECK(bytes_allocated != nullptr);
   if (UNLIKELY(!IsSizeForThreadLocal(size))) {
-    return nullptr;
+    if (UNLIKELY(!IsSizeForMagazine(size))) {
+      return nullptr;
+    }
+    size_t bracket_size;
+    size_t idx = SizeToIndexAndBracketSize(size, &bracket_size);
+    void* slot_addr = AllocFromMagazine(self, idx);
+    if (LIKELY(slot_addr != nullptr)) {
+      *bytes_allocated = bracket_size;
+    }
+    return slot_addr;
   }
   size_t bracket_size;
   size_t idx = SizeToIndexAndBracketSize(size, &bracket_size);
@@ -100,14 +110,31 @@ inline void* RosAlloc::AllocFromThreadLocalRun(Thread* self, size_t size,
 }
 
 inline size_t RosAlloc::MaxBytesBulkAllocatedFor(size_t size) {
-  if (UNLIKELY(!IsSizeForThreadLocal(size))) {
+  if (UNLIKELY(size > kLargeSizeThreshold)) {
     return size;
   }
   size_t bracket_size;
   size_t idx = SizeToIndexAndBracketSize(size, &bracket_size);
+  if (UNLIKELY(!IsSizeForThreadLocal(size))) {
+    // A magazine refill counts all the slots it takes.
+    return MagazineCapacity(idx) * bracket_size;
+  }
   return numOfSlots[idx] * bracket_size;
 }
 
+inline void* RosAlloc::AllocFromMagazine(Thread* self, size_t idx) {
+  DCHECK_GE(idx, kNumThreadLocalSizeBrackets);
+  const size_t magazine_idx = idx - kNumThreadLocalSizeBrackets;
+  // Only the owner thread pops from its magazine, and the magazine is only revoked while the
+  // owner is suspended or exiting, so no synchronization is needed.
+  Slot* slot = reinterpret_cast<Slot*>(self->GetRosAllocMagazine(magazine_idx));
+  if (LIKELY(slot != nullptr)) {
+    self->SetRosAllocMagazine(magazine_idx, slot->Next());
+    slot->Clear();
+  }
+  return slot;
+}
+
 inline void* RosAlloc::Run::AllocSlot() {
   Slot* slot = free_list_.Remove();
   if (kTraceRosAlloc && slot != nullptr) {
@@ -737,33 +737,115 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
     *bytes_allocated = bracket_size;
     *usable_size = bracket_size;
   } else {
-    // Use the (shared) current run.
-    MutexLock mu(self, *size_bracket_locks_[idx]);
-    slot_addr = AllocFromCurrentRunUnlocked(self, idx);
+    // Use a magazine. It is refilled from the (shared) current run in batches so that the size
+    // bracket lock is taken once per batch instead of once per allocation.
+    slot_addr = AllocFromMagazine(self, idx);
+    if (LIKELY(slot_addr != nullptr)) {
+      // The slot is already counted. Leave it as is.
+      *bytes_tl_bulk_allocated = 0;
+    } else {
+      size_t num_slots;
+      {
+        MutexLock mu(self, *size_bracket_locks_[idx]);
+        num_slots = RefillMagazine(self, idx);
+      }
+      if (UNLIKELY(num_slots == 0)) {
+        return nullptr;
+      }
+      // Account for all the slots taken for the magazine.
+      *bytes_tl_bulk_allocated = num_slots * bracket_size;
+      slot_addr = AllocFromMagazine(self, idx);
+      // Must succeed now with a refilled magazine.
+      DCHECK(slot_addr != nullptr);
+    }
     if (kTraceRosAlloc) {
-      LOG(INFO) << "RosAlloc::AllocFromRun() : 0x" << std::hex
+      LOG(INFO) << "RosAlloc::AllocFromRun() magazine : 0x" << std::hex
                 << reinterpret_cast<intptr_t>(slot_addr)
                 << "-0x" << (reinterpret_cast<intptr_t>(slot_addr) + bracket_size)
                 << "(" << std::dec << (bracket_size) << ")";
     }
-    if (LIKELY(slot_addr != nullptr)) {
-      *bytes_allocated = bracket_size;
-      *usable_size = bracket_size;
-      *bytes_tl_bulk_allocated = bracket_size;
-    }
+    *bytes_allocated = bracket_size;
+    *usable_size = bracket_size;
   }
   // Caller verifies that it is all 0.
   return slot_addr;
 }
 
+size_t RosAlloc::RefillMagazine(Thread* self, size_t idx) {
+  size_bracket_locks_[idx]->AssertHeld(self);
+  const size_t magazine_idx = idx - kNumThreadLocalSizeBrackets;
+  DCHECK(self->GetRosAllocMagazine(magazine_idx) == nullptr);
+  const size_t capacity = MagazineCapacity(idx);
+  Slot* head = nullptr;
+  Slot* tail = nullptr;
+  size_t num_slots = 0;
+  // Keep the slots in allocation order so that consecutive allocations stay close.
+  for (; num_slots < capacity; ++num_slots) {
+    Slot* slot = reinterpret_cast<Slot*>(AllocFromCurrentRunUnlocked(self, idx));
+    if (UNLIKELY(slot == nullptr)) {
+      break;
+    }
+    if (tail == nullptr) {
+      head = slot;
+    } else {
+      tail->SetNext(slot);
+    }
+    tail = slot;
+  }
+  self->SetRosAllocMagazine(magazine_idx, head);
+  return num_slots;
+}
+
+RosAlloc::Run* RosAlloc::GetRunOfSlot(void* ptr) {
+  DCHECK_LE(base_, ptr);
+  DCHECK_LT(ptr, base_ + footprint_);
+  size_t pm_idx = RoundDownToPageMapIndex(ptr);
+  // Find the beginning of the run.
+  while (page_map_[pm_idx] != kPageMapRun) {
+    DCHECK_EQ(page_map_[pm_idx], kPageMapRunPart);
+    DCHECK_GT(pm_idx, 0U);
+    --pm_idx;
+  }
+  Run* run = reinterpret_cast<Run*>(base_ + pm_idx * kPageSize);
+  DCHECK_EQ(run->magic_num_, kMagicNum);
+  return run;
+}
+
+size_t RosAlloc::RevokeMagazine(Thread* self, Thread* thread, size_t idx) {
+  const size_t magazine_idx = idx - kNumThreadLocalSizeBrackets;
+  Slot* slot = reinterpret_cast<Slot*>(thread->GetRosAllocMagazine(magazine_idx));
+  if (slot == nullptr) {
+    return 0U;
+  }
+  thread->SetRosAllocMagazine(magazine_idx, nullptr);
+  size_t num_slots = 0;
+  // Flush the whole magazine under one acquisition of the size bracket lock.
+  MutexLock mu(self, *size_bracket_locks_[idx]);
+  while (slot != nullptr) {
+    Slot* next = slot->Next();
+    slot->Clear();
+    Run* run = GetRunOfSlot(slot);
+    DCHECK_EQ(run->size_bracket_idx_, idx);
+    FreeFromRunLocked(self, slot, run);
+    ++num_slots;
+    slot = next;
+  }
+  return num_slots * bracketSizes[idx];
+}
+
 size_t RosAlloc::FreeFromRun(Thread* self, void* ptr, Run* run) {
   DCHECK_EQ(run->magic_num_, kMagicNum);
   DCHECK_LT(run, ptr);
   DCHECK_LT(ptr, run->End());
+  MutexLock brackets_mu(self, *size_bracket_locks_[run->size_bracket_idx_]);
+  return FreeFromRunLocked(self, ptr, run);
+}
+
+size_t RosAlloc::FreeFromRunLocked(Thread* self, void* ptr, Run* run) {
   const size_t idx = run->size_bracket_idx_;
   const size_t bracket_size = bracketSizes[idx];
   bool run_was_full = false;
-  MutexLock brackets_mu(self, *size_bracket_locks_[idx]);
+  size_bracket_locks_[idx]->AssertHeld(self);
   if (kIsDebugBuild) {
     run_was_full = run->IsFull();
   }
@@ -958,6 +1040,22 @@ inline void RosAlloc::Run::ZeroHeaderAndSlotHeaders() {
   }
 }
 
+void RosAlloc::Run::MarkMagazineSlotsFree(const std::unordered_set<void*>& magazine_slots,
+                                          bool* is_free) {
+  if (magazine_slots.empty()) {
+    return;
+  }
+  const size_t idx = size_bracket_idx_;
+  uint8_t* slot_base = reinterpret_cast<uint8_t*>(this) + headerSizes[idx];
+  const size_t bracket_size = IndexToBracketSize(idx);
+  for (size_t slot_idx = 0, num_slots = numOfSlots[idx]; slot_idx < num_slots; ++slot_idx) {
+    if (magazine_slots.find(slot_base + slot_idx * bracket_size) != magazine_slots.end()) {
+      CHECK(!is_free[slot_idx]) << "A slot in a magazine is also in a free list " << Dump();
+      is_free[slot_idx] = true;
+    }
+  }
+}
+
 inline void RosAlloc::Run::ZeroData() {
   const uint8_t idx = size_bracket_idx_;
   uint8_t* slot_begin = reinterpret_cast<uint8_t*>(FirstSlot());
@@ -965,7 +1063,8 @@ inline void RosAlloc::Run::ZeroData() {
 }
 
 void RosAlloc::Run::InspectAllSlots(void (*handler)(void* start, void* end, size_t used_bytes, void* callback_arg),
-                                    void* arg) {
+                                    void* arg,
+                                    const std::unordered_set<void*>& magazine_slots) {
   size_t idx = size_bracket_idx_;
   uint8_t* slot_base = reinterpret_cast<uint8_t*>(this) + headerSizes[idx];
   size_t num_slots = numOfSlots[idx];
@@ -987,6 +1086,7 @@ void RosAlloc::Run::InspectAllSlots(void (*handler)(void* start, void* end, size
       is_free[slot_idx] = true;
     }
   }
+  MarkMagazineSlotsFree(magazine_slots, is_free.get());
   for (size_t slot_idx = 0; slot_idx < num_slots; ++slot_idx) {
     uint8_t* slot_addr = slot_base + slot_idx * bracket_size;
     if (!is_free[slot_idx]) {
@@ -1400,7 +1500,17 @@ void RosAlloc::InspectAll(void (*handler)(void* start, void* end, size_t used_by
   if (handler == nullptr) {
     return;
   }
-  MutexLock mu(Thread::Current(), lock_);
+  Thread* self = Thread::Current();
+  // The mutators are suspended, see RosAllocSpace::InspectAllRosAlloc(), so the magazines do not
+  // change until the walk is done. Collect their slots before taking `lock_`, for the lock order.
+  std::unordered_set<void*> magazine_slots;
+  if (Locks::thread_list_lock_->IsExclusiveHeld(self)) {
+    CollectMagazineSlots(&magazine_slots);
+  } else {
+    MutexLock thread_list_mu(self, *Locks::thread_list_lock_);
+    CollectMagazineSlots(&magazine_slots);
+  }
+  MutexLock mu(self, lock_);
   size_t pm_end = page_map_size_;
   size_t i = 0;
   while (i < pm_end) {
@@ -1462,7 +1572,7 @@ void RosAlloc::InspectAll(void (*handler)(void* start, void* end, size_t used_by
         DCHECK_EQ(run->magic_num_, kMagicNum);
         // The dedicated full run doesn't contain any real allocations, don't visit the slots in
         // there.
-        run->InspectAllSlots(handler, arg);
+        run->InspectAllSlots(handler, arg, magazine_slots);
         size_t num_pages = numOfPages[run->size_bracket_idx_];
         if (kIsDebugBuild) {
           for (size_t j = i + 1; j < i + num_pages; ++j) {
@@ -1537,6 +1647,9 @@ size_t RosAlloc::RevokeThreadLocalRuns(Thread* thread) {
       RevokeRun(self, idx, thread_local_run);
     }
   }
+  for (size_t idx = kNumThreadLocalSizeBrackets; idx < kNumOfSizeBrackets; idx++) {
+    free_bytes += RevokeMagazine(self, thread, idx);
+  }
   return free_bytes;
 }
 
@@ -1604,6 +1717,9 @@ void RosAlloc::AssertThreadLocalRunsAreRevoked(Thread* thread) {
       Run* thread_local_run = reinterpret_cast<Run*>(thread->GetRosAllocRun(idx));
       DCHECK(thread_local_run == nullptr || thread_local_run == dedicated_full_run_);
     }
+    for (size_t i = 0; i < kNumMagazineSizeBrackets; i++) {
+      DCHECK(thread->GetRosAllocMagazine(i) == nullptr);
+    }
   }
 }
 
@@ -1851,6 +1967,8 @@ void RosAlloc::Verify() {
             thread_local_run->size_bracket_idx_ == i);
     }
   }
+  std::unordered_set<void*> magazine_slots;
+  CollectMagazineSlots(&magazine_slots);
   for (size_t i = 0; i < kNumOfSizeBrackets; i++) {
     MutexLock brackets_mu(self, *size_bracket_locks_[i]);
     Run* current_run = current_runs_[i];
@@ -1863,11 +1981,26 @@ void RosAlloc::Verify() {
   }
   // Call Verify() here for the lock order.
   for (auto& run : runs) {
-    run->Verify(self, this, is_running_on_memory_tool_);
+    run->Verify(self, this, is_running_on_memory_tool_, magazine_slots);
+  }
+}
+
+void RosAlloc::CollectMagazineSlots(std::unordered_set<void*>* magazine_slots) {
+  for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
+    for (size_t i = 0; i < kNumMagazineSizeBrackets; ++i) {
+      for (Slot* slot = reinterpret_cast<Slot*>(thread->GetRosAllocMagazine(i));
+           slot != nullptr;
+           slot = slot->Next()) {
+        CHECK(magazine_slots->insert(slot).second) << "A slot is in more than one magazine";
+      }
+    }
   }
 }
 
-void RosAlloc::Run::Verify(Thread* self, RosAlloc* rosalloc, bool running_on_memory_tool) {
+void RosAlloc::Run::Verify(Thread* self,
+                           RosAlloc* rosalloc,
+                           bool running_on_memory_tool,
+                           const std::unordered_set<void*>& magazine_slots) {
   DCHECK_EQ(magic_num_, kMagicNum) << "Bad magic number : " << Dump();
   const size_t idx = size_bracket_idx_;
   CHECK_LT(idx, kNumOfSizeBrackets) << "Out of range size bracket index : " << Dump();
@@ -1960,6 +2093,8 @@ void RosAlloc::Run::Verify(Thread* self, RosAlloc* rosalloc, bool running_on_mem
       is_free[slot_idx] = true;
     }
   }
+  // The slots cached in magazines are free, although their runs count them as in use.
+  MarkMagazineSlotsFree(magazine_slots, is_free.get());
   for (size_t slot_idx = 0; slot_idx < num_slots; ++slot_idx) {
     uint8_t* slot_addr = slot_base + slot_idx * bracket_size;
     if (running_on_memory_tool) {
@@ -20,6 +20,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <algorithm>
 #include <memory>
 #include <set>
 #include <string>
@@ -449,11 +450,18 @@ class RosAlloc {
     // Zero the run's header and the slot headers.
     void ZeroHeaderAndSlotHeaders();
     // Iterate over all the slots and apply the given function.
-    void InspectAllSlots(void (*handler)(void* start, void* end, size_t used_bytes, void* callback_arg), void* arg);
+    void InspectAllSlots(void (*handler)(void* start, void* end, size_t used_bytes, void* callback_arg),
+                         void* arg,
+                         const std::unordered_set<void*>& magazine_slots);
+    // Set the entries of `is_free` for the slots of this run which are in `magazine_slots`.
+    void MarkMagazineSlotsFree(const std::unordered_set<void*>& magazine_slots, bool* is_free);
     // Dump the run metadata for debugging.
     std::string Dump();
     // Verify for debugging.
-    void Verify(Thread* self, RosAlloc* rosalloc, bool running_on_memory_tool)
+    void Verify(Thread* self,
+                RosAlloc* rosalloc,
+                bool running_on_memory_tool,
+                const std::unordered_set<void*>& magazine_slots)
         REQUIRES(Locks::mutator_lock_)
         REQUIRES(Locks::thread_list_lock_);
 
@@ -543,6 +551,16 @@ class RosAlloc {
            (is_size_for_thread_local == (SizeToIndex(size) < kNumThreadLocalSizeBrackets)));
     return is_size_for_thread_local;
   }
+  // Returns true if the given allocation size is served from a per-thread magazine.
+  static bool IsSizeForMagazine(size_t size) {
+    return size > kMaxThreadLocalBracketSize && size <= kLargeSizeThreshold;
+  }
+  // Returns the number of slots a magazine of the given size bracket is refilled with.
+  static size_t MagazineCapacity(size_t idx) {
+    DCHECK_GE(idx, kNumThreadLocalSizeBrackets);
+    DCHECK_LT(idx, kNumOfSizeBrackets);
+    return std::max<size_t>(kMagazineBytes / bracketSizes[idx], 1U);
+  }
   // Rounds up the size up the nearest bracket size.
   static size_t RoundToBracketSize(size_t size) {
     DCHECK(size <= kLargeSizeThreshold);
@@ -667,6 +685,17 @@ class RosAlloc {
                 "Mismatch between kNumThreadLocalSizeBrackets and "
                 "kNumRosAllocThreadLocalSizeBracketsInThread");
 
+  // The size brackets that do not use thread-local runs use per-thread magazines instead. A
+  // magazine is a list of free slots taken from the shared current run in one batch.
+  // Sync this with the length of Thread::rosalloc_magazines_.
+  static constexpr size_t kNumMagazineSizeBrackets = 26;
+  static_assert(kNumMagazineSizeBrackets == kNumRosAllocMagazineSizeBracketsInThread,
+                "Mismatch between kNumMagazineSizeBrackets and "
+                "kNumRosAllocMagazineSizeBracketsInThread");
+
+  // The number of bytes a magazine is refilled with at once, rounded down to whole slots.
+  static constexpr size_t kMagazineBytes = 4 * KB;
+
   // The size of the largest bracket we use thread-local runs for.
   // This should be equal to bracketSizes[kNumThreadLocalSizeBrackets - 1].
   static constexpr size_t kMaxThreadLocalBracketSize = 128;
@@ -796,6 +825,25 @@ class RosAlloc {
   // Returns the bracket size.
   size_t FreeFromRun(Thread* self, void* ptr, Run* run)
       REQUIRES(!lock_);
+  // Same as FreeFromRun() but the caller holds the size bracket lock of the run.
+  size_t FreeFromRunLocked(Thread* self, void* ptr, Run* run)
+      REQUIRES(!lock_);
+
+  // Pops a slot off the magazine of the calling thread. Returns null if the magazine is empty.
+  ALWAYS_INLINE void* AllocFromMagazine(Thread* self, size_t idx);
+  // Refills the empty magazine of the calling thread from the current run. The caller holds the
+  // size bracket lock. Returns the number of slots put in the magazine.
+  size_t RefillMagazine(Thread* self, size_t idx) REQUIRES(!lock_);
+  // Returns the slots of a magazine of the given thread to their runs. Returns the total bytes of
+  // the returned slots.
+  size_t RevokeMagazine(Thread* self, Thread* thread, size_t idx) REQUIRES(!lock_);
+  // Adds the slots cached in the magazines of all threads to `magazine_slots`. These slots are
+  // free although their runs count them as in use.
+  void CollectMagazineSlots(std::unordered_set<void*>* magazine_slots)
+      REQUIRES(Locks::thread_list_lock_);
+  // Returns the run which contains the given slot. Reads the page map without the lock, which is
+  // safe as long as the run has a slot in use.
+  Run* GetRunOfSlot(void* ptr);
 
   // Used to allocate a new thread local run for a size bracket.
   Run* AllocRun(Thread* self, size_t idx) REQUIRES(!lock_);
@@ -856,10 +904,10 @@ class RosAlloc {
       REQUIRES(!bulk_free_lock_, !lock_);
 
   // Returns true if the given allocation request can be allocated in
-  // an existing thread local run without allocating a new run.
+  // an existing thread local run or magazine without allocating a new run.
   ALWAYS_INLINE bool CanAllocFromThreadLocalRun(Thread* self, size_t size);
   // Allocate the given allocation request in an existing thread local
-  // run without allocating a new run.
+  // run or magazine without allocating a new run.
   ALWAYS_INLINE void* AllocFromThreadLocalRun(Thread* self, size_t size, size_t* bytes_allocated);
 
   // Returns the maximum bytes that could be allocated for the given
@@ -881,9 +929,10 @@ class RosAlloc {
   // run at the end of the memory region, if any.
   bool Trim() REQUIRES(!lock_);
   // Iterates over all the memory slots and apply the given function.
+  // Takes Locks::thread_list_lock_ unless the caller already holds it.
   void InspectAll(void (*handler)(void* start, void* end, size_t used_bytes, void* callback_arg),
                   void* arg)
-      REQUIRES(!lock_);
+      REQUIRES(!lock_) NO_THREAD_SAFETY_ANALYSIS;
 
   // Release empty pages.
   size_t ReleasePages() REQUIRES(!lock_);
@@ -894,9 +943,10 @@ class RosAlloc {
   // Update the current capacity.
   void SetFootprintLimit(size_t bytes) REQUIRES(!lock_);
 
-  // Releases the thread-local runs assigned to the given thread back to the common set of runs.
-  // Returns the total bytes of free slots in the revoked thread local runs. This is to be
-  // subtracted from Heap::num_bytes_allocated_ to cancel out the ahead-of-time counting.
+  // Releases the thread-local runs assigned to the given thread back to the common set of runs,
+  // and returns the slots of its magazines to their runs.
+  // Returns the total bytes of free slots in the revoked thread local runs and magazines. This is
+  // to be subtracted from Heap::num_bytes_allocated_ to cancel out the ahead-of-time counting.
   size_t RevokeThreadLocalRuns(Thread* thread) REQUIRES(!lock_, !bulk_free_lock_);
   // Releases the thread-local runs assigned to all the threads back to the common set of runs.
   // Returns the total bytes of free slots in the revoked thread local runs. This is to be
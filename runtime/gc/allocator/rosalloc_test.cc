@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rosalloc-inl.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/mem_map.h"
+#include "base/time_utils.h"
+#include "common_runtime_test.h"
+#include "thread_pool.h"
+
+namespace art {
+namespace gc {
+namespace allocator {
+
+class RosAllocTest : public CommonRuntimeTest {
+ public:
+  static constexpr size_t kCapacity = 256 * MB;
+  static constexpr size_t kMaxNumThreads = 64;
+  static constexpr size_t kNumAllocationsPerThread = 64 * 1024;
+  static constexpr size_t kBatchSize = 256;
+
+  void AllocationThroughputTest();
+};
+
+// Allocates batches of objects across the thread-local and the magazine size brackets and frees
+// each batch with a bulk free, like a sweep would.
+class AllocThroughputTask : public Task {
+ public:
+  AllocThroughputTask(RosAlloc* rosalloc, size_t id, size_t num_allocations)
+      : rosalloc_(rosalloc), id_(id), num_allocations_(num_allocations), failed_(false) {}
+
+  void Run(Thread* self) override {
+    std::vector<void*> ptrs(RosAllocTest::kBatchSize);
+    size_t size = 16 + 8 * id_;
+    for (size_t i = 0; i < num_allocations_; i += ptrs.size()) {
+      for (size_t j = 0; j < ptrs.size(); ++j) {
+        size_t bytes_allocated, usable_size, bytes_tl_bulk_allocated;
+        ptrs[j] = rosalloc_->Alloc<true>(self,
+                                         size,
+                                         &bytes_allocated,
+                                         &usable_size,
+                                         &bytes_tl_bulk_allocated);
+        if (ptrs[j] == nullptr) {
+          failed_ = true;
+          ptrs.resize(j);
+          break;
+        }
+        reinterpret_cast<uint8_t*>(ptrs[j])[0] = 1;
+        size = (size + 136) % (RosAlloc::kLargeSizeThreshold - 8) + 8;
+      }
+      rosalloc_->BulkFree(self, ptrs.data(), ptrs.size());
+      if (failed_) {
+        break;
+      }
+    }
+    // The runs and magazines of this thread belong to rosalloc_, not to the heap.
+    rosalloc_->RevokeThreadLocalRuns(self);
+  }
+
+  void Finalize() override {
+    CHECK(!failed_) << "Allocation failed in task " << id_;
+    delete this;
+  }
+
+ private:
+  RosAlloc* const rosalloc_;
+  const size_t id_;
+  const size_t num_allocations_;
+  bool failed_;
+};
+
+void RosAllocTest::AllocationThroughputTest() {
+  Thread* self = Thread::Current();
+  std::string error_msg;
+  MemMap mem_map = MemMap::MapAnonymous("rosalloc test",
+                                        kCapacity,
+                                        PROT_READ | PROT_WRITE,
+                                        /*low_4gb=*/ false,
+                                        &error_msg);
+  ASSERT_TRUE(mem_map.IsValid()) << error_msg;
+  RosAlloc rosalloc(mem_map.Begin(),
+                    kCapacity,
+                    kCapacity,
+                    RosAlloc::kPageReleaseModeSizeAndEnd,
+                    /*running_on_memory_tool=*/ false);
+  for (size_t num_threads = 1; num_threads <= kMaxNumThreads; num_threads *= 2) {
+    ThreadPool thread_pool("RosAlloc test thread pool", num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+      thread_pool.AddTask(self, new AllocThroughputTask(&rosalloc, i, kNumAllocationsPerThread));
+    }
+    uint64_t start_time = NanoTime();
+    thread_pool.StartWorkers(self);
+    thread_pool.Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+    uint64_t duration = NanoTime() - start_time;
+    uint64_t num_allocations = num_threads * kNumAllocationsPerThread;
+    LOG(INFO) << "RosAlloc throughput with " << num_threads << " threads: "
+              << num_allocations * MsToNs(1000) / std::max<uint64_t>(duration, 1u)
+              << " allocations/s (" << PrettyDuration(duration) << ")";
+    // Everything was freed and all the magazines were flushed.
+    size_t bytes_allocated = 0;
+    rosalloc.InspectAll(RosAlloc::BytesAllocatedCallback, &bytes_allocated);
+    EXPECT_EQ(0u, bytes_allocated);
+  }
+}
+
+TEST_F(RosAllocTest, AllocationThroughput) {
+  AllocationThroughputTest();
+}
+
+// The slots a magazine is refilled with count as in use in their run, but InspectAll() must not
+// report them.
+TEST_F(RosAllocTest, InspectAllSkipsMagazineSlots) {
+  Thread* self = Thread::Current();
+  std::string error_msg;
+  MemMap mem_map = MemMap::MapAnonymous("rosalloc test",
+                                        kCapacity,
+                                        PROT_READ | PROT_WRITE,
+                                        /*low_4gb=*/ false,
+                                        &error_msg);
+  ASSERT_TRUE(mem_map.IsValid()) << error_msg;
+  RosAlloc rosalloc(mem_map.Begin(),
+                    kCapacity,
+                    kCapacity,
+                    RosAlloc::kPageReleaseModeSizeAndEnd,
+                    /*running_on_memory_tool=*/ false);
+  // Served from a magazine: above the thread-local brackets, below the large object threshold.
+  size_t size = RosAlloc::kLargeSizeThreshold / 4;
+  size_t bytes_allocated, usable_size, bytes_tl_bulk_allocated;
+  void* ptr = rosalloc.Alloc<true>(self, size, &bytes_allocated, &usable_size,
+                                   &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(ptr != nullptr);
+  // The refill took more than the one slot handed out.
+  EXPECT_GT(bytes_tl_bulk_allocated, usable_size);
+  size_t inspected_bytes = 0;
+  rosalloc.InspectAll(RosAlloc::BytesAllocatedCallback, &inspected_bytes);
+  EXPECT_EQ(usable_size, inspected_bytes);
+  rosalloc.Free(self, ptr);
+  rosalloc.RevokeThreadLocalRuns(self);
+  inspected_bytes = 0;
+  rosalloc.InspectAll(RosAlloc::BytesAllocatedCallback, &inspected_bytes);
+  EXPECT_EQ(0u, inspected_bytes);
+}
+
+}  // namespace allocator
+}  // namespace gc
+}  // namespace art
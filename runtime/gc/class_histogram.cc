@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_histogram.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include "base/utils.h"
+#include "mirror/class-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace gc {
+
+ClassHistogram::ClassHistogram() : lock_("class histogram lock", kGenericBottomLock) {}
+
+void ClassHistogram::Flush(ThreadLocalClassHistogram* table) {
+  if (table->IsEmpty()) {
+    return;
+  }
+  // Get the descriptors outside of the lock. GetDescriptor does not use read barriers, so this
+  // also works for from-space classes during a concurrent copying collection.
+  std::vector<std::pair<std::string, const ClassHistogramEntry*>> descriptors;
+  descriptors.reserve(table->entries_.size());
+  for (const auto& [klass, entry] : table->entries_) {
+    std::string temp;
+    descriptors.emplace_back(klass->GetDescriptor(&temp), &entry);
+  }
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    for (const auto& [descriptor, entry] : descriptors) {
+      ClassHistogramEntry& total = entries_[descriptor];
+      total.allocated_objects += entry->allocated_objects;
+      total.allocated_bytes += entry->allocated_bytes;
+      total.survived_objects += entry->survived_objects;
+      total.survived_bytes += entry->survived_bytes;
+    }
+  }
+  table->entries_.clear();
+}
+
+std::vector<std::pair<std::string, ClassHistogramEntry>> ClassHistogram::GetEntries() {
+  std::vector<std::pair<std::string, ClassHistogramEntry>> result;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    result.assign(entries_.begin(), entries_.end());
+  }
+  std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second.allocated_bytes > rhs.second.allocated_bytes;
+  });
+  return result;
+}
+
+void ClassHistogram::Dump(std::ostream& os, size_t max_classes) {
+  std::vector<std::pair<std::string, ClassHistogramEntry>> entries = GetEntries();
+  os << "Class histogram of " << entries.size() << " classes, as of the last GC:\n";
+  for (size_t i = 0; i < std::min(max_classes, entries.size()); ++i) {
+    const std::string& descriptor = entries[i].first;
+    const ClassHistogramEntry& entry = entries[i].second;
+    os << "  " << descriptor << ": allocated " << entry.allocated_objects << " objects/"
+       << PrettySize(entry.allocated_bytes) << ", survived " << entry.survived_objects
+       << " objects/" << PrettySize(entry.survived_bytes) << "\n";
+  }
+}
+
+void ClassHistogram::Clear() {
+  MutexLock mu(Thread::Current(), lock_);
+  entries_.clear();
+}
+
+}  // namespace gc
+}  // namespace art
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_CLASS_HISTOGRAM_H_
+#define ART_RUNTIME_GC_CLASS_HISTOGRAM_H_
+
+#include <algorithm>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+namespace gc {
+
+// Allocation and survival counts of the objects of one class.
+struct ClassHistogramEntry {
+  // Estimated from samples, see ThreadLocalClassHistogram::RecordAllocation().
+  uint64_t allocated_objects = 0u;
+  uint64_t allocated_bytes = 0u;
+  // Objects copied by the concurrent copying collector, counted once per GC they survive.
+  uint64_t survived_objects = 0u;
+  uint64_t survived_bytes = 0u;
+};
+
+// The counts of one thread since it was last flushed, keyed by class. Only the owning thread
+// updates it. The classes are not GC roots, so the heap flushes the table into the ClassHistogram
+// before they may move or be unloaded: whenever it revokes the thread-local buffers of the thread,
+// and at the end of the marking of the concurrent copying collector.
+class ThreadLocalClassHistogram {
+ public:
+  // Records an allocation of `byte_count` bytes that took `bulk_byte_count` bytes from the heap:
+  // either a single object allocated outside of the thread-local buffers, or the first object of
+  // a new thread-local buffer. The other objects of the buffer are not seen, so all the bytes of
+  // the buffer are counted as objects of the same class. The allocations that refill a buffer are
+  // a sample of the allocations weighted by size.
+  void RecordAllocation(mirror::Class* klass, size_t byte_count, size_t bulk_byte_count) {
+    ClassHistogramEntry& entry = entries_[klass];
+    entry.allocated_objects +=
+        std::max<size_t>((bulk_byte_count + byte_count / 2) / byte_count, 1u);
+    entry.allocated_bytes += bulk_byte_count;
+  }
+
+  void RecordSurvivor(mirror::Class* klass, size_t byte_count) {
+    ClassHistogramEntry& entry = entries_[klass];
+    ++entry.survived_objects;
+    entry.survived_bytes += byte_count;
+  }
+
+  bool IsEmpty() const {
+    return entries_.empty();
+  }
+
+  void Reset() {
+    entries_.clear();
+  }
+
+ private:
+  std::unordered_map<mirror::Class*, ClassHistogramEntry> entries_;
+
+  friend class ClassHistogram;
+};
+
+// The counts of all the threads, keyed by class descriptor so that they outlive class moves and
+// unloading. Classes from different class loaders with the same descriptor share an entry.
+class ClassHistogram {
+ public:
+  ClassHistogram();
+
+  // Adds the counts of `table` to the histogram and clears it. The thread owning `table` must be
+  // the current thread or suspended.
+  void Flush(ThreadLocalClassHistogram* table)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  // Returns the entries sorted by decreasing allocated bytes.
+  std::vector<std::pair<std::string, ClassHistogramEntry>> GetEntries() REQUIRES(!lock_);
+
+  // Dumps the `max_classes` classes with the most allocated bytes.
+  void Dump(std::ostream& os, size_t max_classes) REQUIRES(!lock_);
+
+  void Clear() REQUIRES(!lock_);
+
+ private:
+  Mutex lock_;
+  std::map<std::string, ClassHistogramEntry> entries_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(ClassHistogram);
+};
+
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_CLASS_HISTOGRAM_H_
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_histogram.h"
+
+#include "common_runtime_test.h"
+#include "handle_scope-inl.h"
+#include "heap.h"
+#include "mirror/array-alloc-inl.h"
+#include "mirror/array-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace gc {
+
+class ClassHistogramTest : public CommonRuntimeTest {
+ public:
+  static const ClassHistogramEntry* FindEntry(
+      const std::vector<std::pair<std::string, ClassHistogramEntry>>& entries,
+      const std::string& descriptor) {
+    for (const auto& [entry_descriptor, entry] : entries) {
+      if (entry_descriptor == descriptor) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+};
+
+TEST_F(ClassHistogramTest, CountsAllocationsAndSurvivors) {
+  static constexpr size_t kNumArrays = 1024;
+  static constexpr size_t kNumSurvivors = 10;
+  static constexpr size_t kArrayLength = 1024;
+  static constexpr size_t kLargeArrayLength = 16 * 1024;
+  static constexpr size_t kArraysSize = kNumArrays * kArrayLength * sizeof(int32_t);
+  Heap* heap = Runtime::Current()->GetHeap();
+  heap->SetClassHistogramEnabled(true);
+  ASSERT_TRUE(heap->GetClassHistogram() != nullptr);
+  Thread* self = Thread::Current();
+  {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<kNumSurvivors> hs(self);
+    for (size_t i = 0; i < kNumArrays; ++i) {
+      ObjPtr<mirror::IntArray> array = mirror::IntArray::Alloc(self, kArrayLength);
+      ASSERT_TRUE(array != nullptr);
+      if (i < kNumSurvivors) {
+        hs.NewHandle(array);
+      }
+    }
+    // The GC flushes the counts of all the threads. The explicit GC evacuates all the regions, so
+    // with the concurrent copying collector the arrays kept alive are counted as survivors.
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+    heap->FlushClassHistogram(self);
+  }
+  std::vector<std::pair<std::string, ClassHistogramEntry>> entries =
+      heap->GetClassHistogram()->GetEntries();
+  // Only the allocations that refill the thread-local buffers are sampled. Nearly all of them are
+  // arrays, but the arrays that fit in the buffer the thread had before are not counted.
+  const ClassHistogramEntry* array_entry = FindEntry(entries, "[I");
+  ASSERT_TRUE(array_entry != nullptr);
+  EXPECT_GE(array_entry->allocated_objects, kNumArrays / 2);
+  EXPECT_GE(array_entry->allocated_bytes, kArraysSize / 2);
+  if (kUseReadBarrier) {
+    EXPECT_GE(array_entry->survived_objects, kNumSurvivors);
+  }
+  // The entries are sorted by decreasing allocated bytes.
+  for (size_t i = 1; i < entries.size(); ++i) {
+    EXPECT_GE(entries[i - 1].second.allocated_bytes, entries[i].second.allocated_bytes);
+  }
+
+  // The counts remain available after the histogram is disabled.
+  heap->SetClassHistogramEnabled(false);
+  EXPECT_FALSE(heap->GetClassHistogram()->GetEntries().empty());
+
+  // Enabling the histogram again clears it, along with the counts of the threads that were not
+  // flushed yet.
+  heap->SetClassHistogramEnabled(true);
+  {
+    ScopedObjectAccess soa(self);
+    // Large objects do not fit in the thread-local buffers and are always counted.
+    ASSERT_TRUE(mirror::IntArray::Alloc(self, kLargeArrayLength) != nullptr);
+  }
+  heap->SetClassHistogramEnabled(false);
+  heap->SetClassHistogramEnabled(true);
+  {
+    ScopedObjectAccess soa(self);
+    heap->FlushClassHistogram(self);
+  }
+  EXPECT_TRUE(heap->GetClassHistogram()->GetEntries().empty());
+  heap->SetClassHistogramEnabled(false);
+}
+
+}  // namespace gc
+}  // namespace art
@@ -105,7 +105,8 @@ inline mirror::Object* ConcurrentCopying::MarkImmuneSpace(Thread* const self,
                updated_all_immune_objects_.load(std::memory_order_relaxed) ||
                gc_grays_immune_objects_);
       } else {
-        DCHECK(kGrayImmuneObject);
+        // Mark workers other than the GC-running thread don't gray immune objects either.
+        DCHECK(kGrayImmuneObject || is_parallel_marking_);
       }
     }
     if (!kGrayImmuneObject || updated_all_immune_objects_.load(std::memory_order_relaxed)) {
@@ -16,6 +16,8 @@
 
 #include "concurrent_copying.h"
 
+#include <sched.h>
+
 #include "art_field-inl.h"
 #include "barrier.h"
 #include "base/enums.h"
@@ -31,6 +33,7 @@
 #include "gc/accounting/mod_union_table-inl.h"
 #include "gc/accounting/read_barrier_table.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/class_histogram.h"
 #include "gc/gc_pause_listener.h"
 #include "gc/reference_processor.h"
 #include "gc/space/image_space.h"
@@ -42,9 +45,11 @@
 #include "mirror/object-inl.h"
 #include "mirror/object-refvisitor-inl.h"
 #include "mirror/object_reference.h"
+#include "mirror/reference.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -66,6 +71,11 @@ static constexpr size_t kReadBarrierMarkStackSize = 512 * KB;
 static constexpr size_t kSweepArrayChunkFreeSize = 1024;
 // Verify that there are no missing card marks.
 static constexpr bool kVerifyNoMissingCardMarks = kIsDebugBuild;
+// Minimum number of references on the GC mark stack for it to be processed by mark workers.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
+// Minimum number of references on the mark stack of a mark worker for it to share half of them
+// with an idle worker.
+static constexpr size_t kMinimumSharedMarkStackSize = 64;
 
 ConcurrentCopying::ConcurrentCopying(Heap* heap,
                                      bool young_gen,
@@ -82,12 +92,17 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
                                                      kDefaultGcMarkStackSize)),
       use_generational_cc_(use_generational_cc),
       young_gen_(young_gen),
+      use_survivor_regions_(false),
       rb_mark_bit_stack_(accounting::ObjectStack::Create("rb copying gc mark stack",
                                                          kReadBarrierMarkStackSize,
                                                          kReadBarrierMarkStackSize)),
       rb_mark_bit_stack_full_(false),
       mark_stack_lock_("concurrent copying mark stack lock", kMarkSweepMarkStackLock),
       thread_running_gc_(nullptr),
+      num_mark_workers_(std::max<size_t>(heap->GetConcurrentCopyingMarkWorkers(), 1u)),
+      is_parallel_marking_(false),
+      num_active_mark_workers_(0u),
+      num_idle_mark_workers_(0u),
       is_marking_(false),
       is_using_read_barrier_entrypoints_(false),
       is_active_(false),
@@ -104,6 +119,8 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       reclaimed_bytes_ratio_sum_(0.f),
       cumulative_bytes_moved_(0),
       cumulative_objects_moved_(0),
+      mark_worker_stats_(num_mark_workers_ > 1u ? num_mark_workers_ : 0u),
+      parallel_mark_count_(0),
       skipped_blocks_lock_("concurrent copying bytes blocks lock", kMarkSweepMarkStackLock),
       measure_read_barrier_slow_path_(measure_read_barrier_slow_path),
       mark_from_read_barrier_measurements_(false),
@@ -415,10 +432,13 @@ void ConcurrentCopying::InitializePhase() {
   bytes_scanned_ = 0;
   GcCause gc_cause = GetCurrentIteration()->GetGcCause();
 
+  use_survivor_regions_ =
+      use_generational_cc_ && young_gen_ && region_space_->GetTenureThreshold() > 1u;
   force_evacuate_all_ = false;
   if (!use_generational_cc_ || !young_gen_) {
     if (gc_cause == kGcCauseExplicit ||
         gc_cause == kGcCauseCollectorTransition ||
+        gc_cause == kGcCauseRssTarget ||
         GetCurrentIteration()->GetClearSoftReferences()) {
       force_evacuate_all_ = true;
     }
@@ -718,15 +738,23 @@ class ConcurrentCopying::VerifyNoMissingCardMarkVisitor {
 
   void CheckReference(mirror::Object* ref, int32_t offset = -1) const
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    if (ref != nullptr && cc_->region_space_->IsInNewlyAllocatedRegion(ref)) {
+    if (ref == nullptr) {
+      return;
+    }
+    // References from survivor regions to survivor regions need no card mark, as both are
+    // evacuated by the next young collection.
+    space::RegionSpace* const region_space = cc_->region_space_;
+    if (region_space->IsInNewlyAllocatedRegion(ref) ||
+        (region_space->IsInSurvivorRegion(ref) &&
+         !region_space->IsInSurvivorRegion(holder_.Ptr()))) {
       LOG(FATAL_WITHOUT_ABORT)
         << holder_->PrettyTypeOf() << "(" << holder_.Ptr() << ") references object "
-        << ref->PrettyTypeOf() << "(" << ref << ") in newly allocated region at offset=" << offset;
+        << ref->PrettyTypeOf() << "(" << ref << ") in nursery region at offset=" << offset;
       LOG(FATAL_WITHOUT_ABORT) << "time=" << cc_->region_space_->Time();
       constexpr const char* kIndent = "  ";
       LOG(FATAL_WITHOUT_ABORT) << cc_->DumpReferenceInfo(holder_.Ptr(), "holder_", kIndent);
       LOG(FATAL_WITHOUT_ABORT) << cc_->DumpReferenceInfo(ref, "ref", kIndent);
-      LOG(FATAL) << "Unexpected reference to newly allocated region.";
+      LOG(FATAL) << "Unexpected reference to nursery region.";
     }
   }
 
@@ -833,20 +861,39 @@ void ConcurrentCopying::GrayAllDirtyImmuneObjects() {
     } else {
       // Keep cards aged if we don't have a mod-union table since we may need to scan them in future
       // GCs. This case is for app images.
-      card_table->ModifyCardsAtomic(
-          space->Begin(),
-          space->End(),
-          [](uint8_t card) {
-            return (card != gc::accounting::CardTable::kCardClean)
-                ? gc::accounting::CardTable::kCardAged
-                : card;
-          },
-          /* card modified visitor */ VoidFunctor());
-      card_table->Scan</*kClearCard=*/ false>(space->GetMarkBitmap(),
+      auto age_card_visitor = [](uint8_t card) {
+        return (card != gc::accounting::CardTable::kCardClean)
+            ? gc::accounting::CardTable::kCardAged
+            : card;
+      };
+      // Large app images are aged and scanned in parallel. The visitor only does an atomic read
+      // barrier state update, so it is safe to run on the heap thread pool.
+      ThreadPool* const thread_pool = heap_->GetThreadPool();
+      if (thread_pool != nullptr &&
+          thread_pool->GetThreadCount() != 0u &&
+          space->Size() > accounting::CardTable::kParallelChunkSize) {
+        card_table->ModifyCardsAtomicParallel(thread_pool,
                                               space->Begin(),
                                               space->End(),
-                                              visitor,
-                                              gc::accounting::CardTable::kCardAged);
+                                              age_card_visitor,
+                                              /* card modified visitor */ VoidFunctor());
+        card_table->ScanParallel</*kClearCard=*/ false>(thread_pool,
+                                                        space->GetMarkBitmap(),
+                                                        space->Begin(),
+                                                        space->End(),
+                                                        visitor,
+                                                        gc::accounting::CardTable::kCardAged);
+      } else {
+        card_table->ModifyCardsAtomic(space->Begin(),
+                                      space->End(),
+                                      age_card_visitor,
+                                      /* card modified visitor */ VoidFunctor());
+        card_table->Scan</*kClearCard=*/ false>(space->GetMarkBitmap(),
+                                                space->Begin(),
+                                                space->End(),
+                                                visitor,
+                                                gc::accounting::CardTable::kCardAged);
+      }
     }
   }
 }
@@ -1743,6 +1790,9 @@ class ConcurrentCopying::DisableMarkingCheckpoint : public Closure {
     // Note a thread that has just started right before this checkpoint may have already this flag
     // set to false, which is ok.
     thread->SetIsGcMarkingAndUpdateEntrypoints(false);
+    // The thread does not copy objects anymore. Flush the survivors it copied and the objects it
+    // allocated while the from-space classes they refer to are still valid.
+    concurrent_copying_->GetHeap()->FlushClassHistogram(thread);
     // If thread is a running mutator, then act on behalf of the garbage collector.
     // See the code in ThreadList::RunCheckpoint.
     concurrent_copying_->GetBarrier().Pass(self);
@@ -2143,7 +2193,18 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
                                               REQUIRES_SHARED(Locks::mutator_lock_) {
                                             ProcessMarkStackRef(ref);
                                           });
+    ThreadPool* const thread_pool = heap_->GetThreadPool();
+    const size_t num_workers = (thread_pool != nullptr)
+        ? std::min(num_mark_workers_, thread_pool->GetThreadCount() + 1)
+        : 1u;
     while (!gc_mark_stack_->IsEmpty()) {
+      // Hand the stack over to the mark workers as soon as it holds enough work for them, for
+      // instance after scanning a large array.
+      if (num_workers > 1u && gc_mark_stack_->Size() >= kMinimumParallelMarkStackSize) {
+        count += gc_mark_stack_->Size();
+        ProcessMarkStackParallel(num_workers);
+        continue;
+      }
       mirror::Object* to_ref = gc_mark_stack_->PopBack();
       ProcessMarkStackRef(to_ref);
       ++count;
@@ -2224,17 +2285,7 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
       processor(to_ref);
       ++count;
     }
-    {
-      MutexLock mu(thread_running_gc_, mark_stack_lock_);
-      if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
-        // The pool has enough. Delete it.
-        delete mark_stack;
-      } else {
-        // Otherwise, put it into the pool for later reuse.
-        mark_stack->Reset();
-        pooled_mark_stacks_.push_back(mark_stack);
-      }
-    }
+    RecycleMarkStack(thread_running_gc_, mark_stack);
   }
   if (disable_weak_ref_access) {
     MutexLock mu(thread_running_gc_, mark_stack_lock_);
@@ -2244,7 +2295,202 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
   return count;
 }
 
-inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
+void ConcurrentCopying::RecycleMarkStack(Thread* const self,
+                                         accounting::ObjectStack* mark_stack) {
+  MutexLock mu(self, mark_stack_lock_);
+  if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
+    // The pool has enough. Delete it.
+    delete mark_stack;
+  } else {
+    // Otherwise, put it into the pool for later reuse.
+    mark_stack->Reset();
+    pooled_mark_stacks_.push_back(mark_stack);
+  }
+}
+
+accounting::ObjectStack* ConcurrentCopying::StealRevokedMarkStack(Thread* const self) {
+  MutexLock mu(self, mark_stack_lock_);
+  if (revoked_mark_stacks_.empty()) {
+    return nullptr;
+  }
+  accounting::ObjectStack* mark_stack = revoked_mark_stacks_.back();
+  revoked_mark_stacks_.pop_back();
+  return mark_stack;
+}
+
+inline accounting::ObjectStack* ConcurrentCopying::GetMarkWorkerStack(Thread* const self) {
+  // The GC-running thread keeps pushing onto the GC mark stack, the other mark workers onto their
+  // thread-local mark stacks (see PushOntoMarkStack).
+  return self == thread_running_gc_ ? gc_mark_stack_.get() : self->GetThreadLocalMarkStack();
+}
+
+void ConcurrentCopying::ShareMarkWork(Thread* const self, accounting::ObjectStack* mark_stack) {
+  accounting::ObjectStack* shared_mark_stack;
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    if (!pooled_mark_stacks_.empty()) {
+      shared_mark_stack = pooled_mark_stacks_.back();
+      pooled_mark_stacks_.pop_back();
+    } else {
+      shared_mark_stack = accounting::ObjectStack::Create(
+          "thread local mark stack", kMarkStackSize, kMarkStackSize);
+    }
+  }
+  DCHECK(shared_mark_stack->IsEmpty());
+  // Only the owner pops off its mark stack, no need to hold the lock while moving the references.
+  const size_t num_refs = std::min(mark_stack->Size() / 2, kMarkStackSize);
+  for (size_t i = 0; i < num_refs; ++i) {
+    shared_mark_stack->PushBack(mark_stack->PopBack());
+  }
+  MutexLock mu(self, mark_stack_lock_);
+  revoked_mark_stacks_.push_back(shared_mark_stack);
+}
+
+// Runs a mark worker on a heap thread pool thread (or on the GC-running thread, which also picks up
+// tasks while waiting for the thread pool).
+class ConcurrentCopying::MarkWorkerTask : public SelfDeletingTask {
+ public:
+  MarkWorkerTask(ConcurrentCopying* collector,
+                 size_t worker_index,
+                 std::vector<mirror::Object*>&& refs)
+      : collector_(collector), worker_index_(worker_index), refs_(std::move(refs)) {}
+
+  // No thread safety analysis since the GC-running thread holds the mutator lock on behalf of the
+  // workers while they run, as for the MarkSweep mark stack tasks.
+  void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    collector_->RunMarkWorker(self, worker_index_, refs_);
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  const size_t worker_index_;
+  const std::vector<mirror::Object*> refs_;
+};
+
+void ConcurrentCopying::RunMarkWorker(Thread* const self,
+                                      size_t worker_index,
+                                      const std::vector<mirror::Object*>& refs) {
+  DCHECK(is_parallel_marking_);
+  const uint64_t start_time = NanoTime();
+  uint64_t objects_processed = 0;
+  uint64_t bytes_scanned = 0;
+  uint64_t mark_stacks_shared = 0;
+  uint64_t mark_stacks_stolen = 0;
+  num_active_mark_workers_.fetch_add(1u, std::memory_order_seq_cst);
+  for (mirror::Object* ref : refs) {
+    bytes_scanned += ProcessMarkStackRef</*kParallel=*/true>(ref);
+    ++objects_processed;
+  }
+  while (true) {
+    // Drain the references this worker pushed itself first, giving half of them away whenever
+    // another worker ran out of work.
+    accounting::ObjectStack* own_mark_stack;
+    while ((own_mark_stack = GetMarkWorkerStack(self)) != nullptr && !own_mark_stack->IsEmpty()) {
+      if (num_idle_mark_workers_.load(std::memory_order_relaxed) != 0u &&
+          own_mark_stack->Size() >= kMinimumSharedMarkStackSize) {
+        ShareMarkWork(self, own_mark_stack);
+        ++mark_stacks_shared;
+      }
+      bytes_scanned += ProcessMarkStackRef</*kParallel=*/true>(own_mark_stack->PopBack());
+      ++objects_processed;
+    }
+    // Then steal a mark stack shared by another worker, or revoked when it became full by another
+    // worker or by a mutator.
+    accounting::ObjectStack* mark_stack = StealRevokedMarkStack(self);
+    if (mark_stack != nullptr) {
+      ++mark_stacks_stolen;
+      for (StackReference<mirror::Object>* p = mark_stack->Begin(); p != mark_stack->End(); ++p) {
+        bytes_scanned += ProcessMarkStackRef</*kParallel=*/true>(p->AsMirrorPtr());
+        ++objects_processed;
+      }
+      RecycleMarkStack(self, mark_stack);
+      continue;
+    }
+    // Out of work. Wait until another worker shares some, or until no worker is active, at which
+    // point there is nothing left to share. Stacks revoked by mutators afterwards are picked up by
+    // ProcessThreadLocalMarkStacks.
+    num_idle_mark_workers_.fetch_add(1u, std::memory_order_seq_cst);
+    num_active_mark_workers_.fetch_sub(1u, std::memory_order_seq_cst);
+    bool has_work;
+    while (true) {
+      const bool workers_done = num_active_mark_workers_.load(std::memory_order_seq_cst) == 0u;
+      {
+        MutexLock mu(self, mark_stack_lock_);
+        has_work = !revoked_mark_stacks_.empty();
+      }
+      if (has_work || workers_done) {
+        break;
+      }
+      sched_yield();
+    }
+    if (has_work) {
+      num_active_mark_workers_.fetch_add(1u, std::memory_order_seq_cst);
+    }
+    num_idle_mark_workers_.fetch_sub(1u, std::memory_order_seq_cst);
+    if (!has_work) {
+      break;
+    }
+  }
+  if (self != thread_running_gc_) {
+    accounting::ObjectStack* tl_mark_stack = self->GetThreadLocalMarkStack();
+    if (tl_mark_stack != nullptr) {
+      DCHECK(tl_mark_stack->IsEmpty());
+      self->SetThreadLocalMarkStack(nullptr);
+      RecycleMarkStack(self, tl_mark_stack);
+    }
+  }
+  MarkWorkerStats& stats = mark_worker_stats_[worker_index];
+  stats.objects_processed += objects_processed;
+  stats.bytes_scanned += bytes_scanned;
+  stats.mark_stacks_shared += mark_stacks_shared;
+  stats.mark_stacks_stolen += mark_stacks_stolen;
+  stats.duration_ns += NanoTime() - start_time;
+}
+
+void ConcurrentCopying::ProcessMarkStackParallel(size_t num_workers) {
+  TimingLogger::ScopedTiming split(__FUNCTION__, GetTimings());
+  Thread* const self = Thread::Current();
+  DCHECK_EQ(self, thread_running_gc_);
+  DCHECK_EQ(static_cast<uint32_t>(mark_stack_mode_.load(std::memory_order_relaxed)),
+            static_cast<uint32_t>(kMarkStackModeThreadLocal));
+  DCHECK_GT(num_workers, 1u);
+  DCHECK_LE(num_workers, mark_worker_stats_.size());
+  ThreadPool* const thread_pool = heap_->GetThreadPool();
+  // Split the GC mark stack up into one chunk per worker.
+  const size_t chunk_size = (gc_mark_stack_->Size() + num_workers - 1) / num_workers;
+  StackReference<mirror::Object>* it = gc_mark_stack_->Begin();
+  StackReference<mirror::Object>* const end = gc_mark_stack_->End();
+  for (size_t i = 0; i < num_workers; ++i) {
+    const size_t delta = std::min(static_cast<size_t>(end - it), chunk_size);
+    std::vector<mirror::Object*> refs;
+    refs.reserve(delta);
+    for (StackReference<mirror::Object>* chunk_end = it + delta; it != chunk_end; ++it) {
+      refs.push_back(it->AsMirrorPtr());
+    }
+    thread_pool->AddTask(self, new MarkWorkerTask(this, i, std::move(refs)));
+  }
+  gc_mark_stack_->Reset();
+  uint64_t bytes_scanned_before = 0;
+  for (const MarkWorkerStats& stats : mark_worker_stats_) {
+    bytes_scanned_before += stats.bytes_scanned;
+  }
+  is_parallel_marking_ = true;
+  thread_pool->SetMaxActiveWorkers(num_workers - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  thread_pool->StopWorkers(self);
+  is_parallel_marking_ = false;
+  DCHECK_EQ(num_active_mark_workers_.load(std::memory_order_relaxed), 0u);
+  DCHECK_EQ(num_idle_mark_workers_.load(std::memory_order_relaxed), 0u);
+  for (const MarkWorkerStats& stats : mark_worker_stats_) {
+    bytes_scanned_ += stats.bytes_scanned;
+  }
+  bytes_scanned_ -= bytes_scanned_before;
+  ++parallel_mark_count_;
+}
+
+template <bool kParallel>
+inline size_t ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   DCHECK(!region_space_->IsInFromSpace(to_ref));
   size_t obj_size = 0;
   space::RegionSpace::RegionType rtype = region_space_->GetRegionType(to_ref);
@@ -2265,8 +2511,11 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   bool perform_scan = false;
   switch (rtype) {
     case space::RegionSpace::RegionType::kRegionTypeUnevacFromSpace:
-      // Mark the bitmap only in the GC thread here so that we don't need a CAS.
-      if (!kUseBakerReadBarrier || !region_space_bitmap_->Set(to_ref)) {
+      // Mark the bitmap only in the GC thread here so that we don't need a CAS. Mark workers
+      // share the bitmap words with each other and have to use one.
+      if (!kUseBakerReadBarrier ||
+          !(kParallel ? region_space_bitmap_->AtomicTestAndSet(to_ref)
+                      : region_space_bitmap_->Set(to_ref))) {
         // It may be already marked if we accidentally pushed the same object twice due to the racy
         // bitmap read in MarkUnevacFromSpaceRegion.
         if (use_generational_cc_ && young_gen_) {
@@ -2288,7 +2537,11 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
     case space::RegionSpace::RegionType::kRegionTypeToSpace:
       if (use_generational_cc_) {
         // Copied to to-space, set the bit so that the next GC can scan objects.
-        region_space_bitmap_->Set(to_ref);
+        if (kParallel) {
+          region_space_bitmap_->AtomicTestAndSet(to_ref);
+        } else {
+          region_space_bitmap_->Set(to_ref);
+        }
       }
       perform_scan = true;
       break;
@@ -2318,13 +2571,17 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
           accounting::LargeObjectBitmap* los_bitmap =
               heap_->GetLargeObjectsSpace()->GetMarkBitmap();
           DCHECK(los_bitmap->HasAddress(to_ref));
-          // Only the GC thread could be setting the LOS bit map hence doesn't
-          // need to be atomically done.
-          perform_scan = !los_bitmap->Set(to_ref);
+          // Only the GC thread (or the mark workers) could be setting the LOS
+          // bit map hence doesn't need to be atomically done outside of
+          // parallel marking.
+          perform_scan = kParallel ? !los_bitmap->AtomicTestAndSet(to_ref)
+                                   : !los_bitmap->Set(to_ref);
         } else {
-          // Only the GC thread could be setting the non-moving space bit map
-          // hence doesn't need to be atomically done.
-          perform_scan = !mark_bitmap->Set(to_ref);
+          // Only the GC thread (or the mark workers) could be setting the
+          // non-moving space bit map hence doesn't need to be atomically done
+          // outside of parallel marking.
+          perform_scan = kParallel ? !mark_bitmap->AtomicTestAndSet(to_ref)
+                                   : !mark_bitmap->Set(to_ref);
         }
       } else {
         perform_scan = true;
@@ -2333,11 +2590,12 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   if (perform_scan) {
     obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
     if (use_generational_cc_ && young_gen_) {
-      Scan<true>(to_ref, obj_size);
+      Scan</*kNoUnEvac=*/true, kParallel>(to_ref, obj_size);
     } else {
-      Scan<false>(to_ref, obj_size);
+      Scan</*kNoUnEvac=*/false, kParallel>(to_ref, obj_size);
     }
   }
+  const size_t bytes_scanned = obj_size;
   if (kUseBakerReadBarrier) {
     DCHECK(to_ref->GetReadBarrierState() == ReadBarrier::GrayState())
         << " to_ref=" << to_ref
@@ -2376,13 +2634,17 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
 #endif
 
   if (add_to_live_bytes) {
-    // Add to the live bytes per unevacuated from-space. Note this code is always run by the
-    // GC-running thread (no synchronization required).
+    // Add to the live bytes per unevacuated from-space. Note this code is run by the
+    // GC-running thread (no synchronization required) or by the mark workers.
     DCHECK(region_space_bitmap_->Test(to_ref));
     if (obj_size == 0) {
       obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
     }
-    region_space_->AddLiveBytes(to_ref, RoundUp(obj_size, space::RegionSpace::kAlignment));
+    if (kParallel) {
+      region_space_->AtomicAddLiveBytes(to_ref, RoundUp(obj_size, space::RegionSpace::kAlignment));
+    } else {
+      region_space_->AddLiveBytes(to_ref, RoundUp(obj_size, space::RegionSpace::kAlignment));
+    }
   }
   if (ReadBarrier::kEnableToSpaceInvariantChecks) {
     CHECK(to_ref != nullptr);
@@ -2394,6 +2656,7 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
         visitor,
         visitor);
   }
+  return bytes_scanned;
 }
 
 class ConcurrentCopying::DisableWeakRefAccessCallback : public Closure {
@@ -3146,11 +3409,11 @@ void ConcurrentCopying::AssertToSpaceInvariantInNonMovingSpace(mirror::Object* o
 }
 
 // Used to scan ref fields of an object.
-template <bool kNoUnEvac>
+template <bool kNoUnEvac, bool kParallel>
 class ConcurrentCopying::RefFieldsVisitor {
  public:
   explicit RefFieldsVisitor(ConcurrentCopying* collector, Thread* const thread)
-      : collector_(collector), thread_(thread) {
+      : collector_(collector), thread_(thread), has_survivor_refs_(false) {
     // Cannot have `kNoUnEvac` when Generational CC collection is disabled.
     DCHECK_IMPLIES(kNoUnEvac, collector_->use_generational_cc_);
   }
@@ -3158,7 +3421,11 @@ class ConcurrentCopying::RefFieldsVisitor {
   void operator()(mirror::Object* obj, MemberOffset offset, bool /* is_static */)
       const ALWAYS_INLINE REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES_SHARED(Locks::heap_bitmap_lock_) {
-    collector_->Process<kNoUnEvac>(obj, offset);
+    collector_->Process<kNoUnEvac, kParallel>(thread_, obj, offset);
+    if (UNLIKELY(collector_->use_survivor_regions_)) {
+      NoteSurvivorRef(
+          obj->GetFieldObject<mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(offset));
+    }
   }
 
   void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const
@@ -3179,51 +3446,80 @@ class ConcurrentCopying::RefFieldsVisitor {
       ALWAYS_INLINE
       REQUIRES_SHARED(Locks::mutator_lock_) {
     collector_->MarkRoot</*kGrayImmuneObject=*/false>(thread_, root);
+    if (UNLIKELY(collector_->use_survivor_regions_)) {
+      NoteSurvivorRef(root->AsMirrorPtr());
+    }
+  }
+
+  // Whether the scanned object references a survivor region after being visited.
+  bool HasSurvivorRefs() const {
+    return has_survivor_refs_;
   }
 
  private:
+  void NoteSurvivorRef(mirror::Object* ref) const REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (!has_survivor_refs_ && collector_->region_space_->IsInSurvivorRegion(ref)) {
+      has_survivor_refs_ = true;
+    }
+  }
+
   ConcurrentCopying* const collector_;
   Thread* const thread_;
+  mutable bool has_survivor_refs_;
 };
 
-template <bool kNoUnEvac>
+template <bool kNoUnEvac, bool kParallel>
 inline void ConcurrentCopying::Scan(mirror::Object* to_ref, size_t obj_size) {
   // Cannot have `kNoUnEvac` when Generational CC collection is disabled.
   DCHECK_IMPLIES(kNoUnEvac, use_generational_cc_);
+  Thread* const self = kParallel ? Thread::Current() : thread_running_gc_;
   if (kDisallowReadBarrierDuringScan && !Runtime::Current()->IsActiveTransaction()) {
     // Avoid all read barriers during visit references to help performance.
     // Don't do this in transaction mode because we may read the old value of an field which may
     // trigger read barriers.
-    Thread::Current()->ModifyDebugDisallowReadBarrier(1);
+    self->ModifyDebugDisallowReadBarrier(1);
   }
-  if (obj_size == 0) {
-    obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
+  if (!kParallel) {
+    // Mark workers account for the bytes they scan themselves.
+    if (obj_size == 0) {
+      obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
+    }
+    bytes_scanned_ += obj_size;
   }
-  bytes_scanned_ += obj_size;
 
   DCHECK(!region_space_->IsInFromSpace(to_ref));
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
-  RefFieldsVisitor<kNoUnEvac> visitor(this, thread_running_gc_);
+  DCHECK_EQ(Thread::Current(), self);
+  DCHECK_IMPLIES(kParallel, is_parallel_marking_);
+  RefFieldsVisitor<kNoUnEvac, kParallel> visitor(this, self);
   // Disable the read barrier for a performance reason.
   to_ref->VisitReferences</*kVisitNativeRoots=*/true, kDefaultVerifyFlags, kWithoutReadBarrier>(
       visitor, visitor);
+  if (UNLIKELY(visitor.HasSurvivorRefs()) && !region_space_->IsInSurvivorRegion(to_ref)) {
+    // The fields were updated without a write barrier. Dirty the card so that the next young
+    // collection finds the references to the survivor regions it evacuates.
+    heap_->GetCardTable()->MarkCard(to_ref);
+  }
   if (kDisallowReadBarrierDuringScan && !Runtime::Current()->IsActiveTransaction()) {
-    thread_running_gc_->ModifyDebugDisallowReadBarrier(-1);
+    self->ModifyDebugDisallowReadBarrier(-1);
   }
 }
 
-template <bool kNoUnEvac>
-inline void ConcurrentCopying::Process(mirror::Object* obj, MemberOffset offset) {
+template <bool kNoUnEvac, bool kParallel>
+inline void ConcurrentCopying::Process(Thread* const self,
+                                       mirror::Object* obj,
+                                       MemberOffset offset) {
   // Cannot have `kNoUnEvac` when Generational CC collection is disabled.
   DCHECK_IMPLIES(kNoUnEvac, use_generational_cc_);
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
+  DCHECK_EQ(Thread::Current(), self);
+  DCHECK_IMPLIES(!kParallel, self == thread_running_gc_);
   mirror::Object* ref = obj->GetFieldObject<
       mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(offset);
-  mirror::Object* to_ref = Mark</*kGrayImmuneObject=*/false, kNoUnEvac, /*kFromGCThread=*/true>(
-      thread_running_gc_,
-      ref,
-      /*holder=*/ obj,
-      offset);
+  // Mark workers go through the thread-safe marking path, like mutators do.
+  mirror::Object* to_ref =
+      Mark</*kGrayImmuneObject=*/false, kNoUnEvac, /*kFromGCThread=*/!kParallel>(self,
+                                                                               ref,
+                                                                               /*holder=*/ obj,
+                                                                               offset);
   if (to_ref == ref) {
     return;
   }
@@ -3459,8 +3755,14 @@ mirror::Object* ConcurrentCopying::Copy(Thread* const self,
   size_t bytes_allocated = 0U;
   size_t unused_size;
   bool fall_back_to_non_moving = false;
-  mirror::Object* to_ref = region_space_->AllocNonvirtual</*kForEvac=*/ true>(
-      region_space_alloc_size, &region_space_bytes_allocated, nullptr, &unused_size);
+  mirror::Object* to_ref = use_survivor_regions_
+      ? region_space_->AllocSurvivor(region_space_->GetRegionAge(from_ref) + 1u,
+                                     region_space_alloc_size,
+                                     &region_space_bytes_allocated,
+                                     nullptr,
+                                     &unused_size)
+      : region_space_->AllocNonvirtual</*kForEvac=*/ true>(
+          region_space_alloc_size, &region_space_bytes_allocated, nullptr, &unused_size);
   bytes_allocated = region_space_bytes_allocated;
   if (LIKELY(to_ref != nullptr)) {
     DCHECK_EQ(region_space_alloc_size, region_space_bytes_allocated);
@@ -3575,6 +3877,10 @@ mirror::Object* ConcurrentCopying::Copy(Thread* const self,
         objects_moved_.fetch_add(1, std::memory_order_relaxed);
         bytes_moved_.fetch_add(bytes_allocated, std::memory_order_relaxed);
       }
+      if (UNLIKELY(heap_->IsClassHistogramEnabled())) {
+        // The from-space class stays valid until DisableMarkingCheckpoint flushes the count.
+        self->GetClassHistogram()->RecordSurvivor(klass, bytes_allocated);
+      }
 
       if (LIKELY(!fall_back_to_non_moving)) {
         DCHECK(region_space_->IsInToSpace(to_ref));
@@ -3814,6 +4120,16 @@ bool ConcurrentCopying::IsNullOrMarkedHeapReference(mirror::HeapReference<mirror
   if (to_ref == nullptr) {
     return false;
   }
+  if (UNLIKELY(use_survivor_regions_) && region_space_->IsInSurvivorRegion(to_ref)) {
+    // The reference processor only uses this method on the referent of a
+    // java.lang.ref.Reference. Dirty the card of the Reference object like a write barrier
+    // would, as the referent is not visited by Scan().
+    mirror::Object* holder = reinterpret_cast<mirror::Object*>(
+        reinterpret_cast<uint8_t*>(field) - mirror::Reference::ReferentOffset().Uint32Value());
+    if (!region_space_->IsInSurvivorRegion(holder)) {
+      heap_->GetCardTable()->MarkCard(holder);
+    }
+  }
   if (from_ref != to_ref) {
     if (do_atomic_update) {
       do {
@@ -3902,6 +4218,23 @@ void ConcurrentCopying::DumpPerformanceInfo(std::ostream& os) {
      << ")\n";
   if (!young_gen_) {
     os << "Total madvise time " << PrettyDuration(region_space_->GetMadviseTime()) << "\n";
+  } else if (region_space_->GetTenureThreshold() > 1u) {
+    os << "Tenure threshold " << region_space_->GetTenureThreshold() << " minor GCs\n";
+  }
+  if (parallel_mark_count_ > 0) {
+    os << "Parallel mark stack processing count " << parallel_mark_count_ << "\n";
+    for (size_t i = 0; i < mark_worker_stats_.size(); ++i) {
+      const MarkWorkerStats& stats = mark_worker_stats_[i];
+      os << "Mark worker " << i << ": " << stats.objects_processed << " objects, "
+         << PrettySize(stats.bytes_scanned) << " scanned, " << stats.mark_stacks_shared
+         << " mark stacks shared, " << stats.mark_stacks_stolen << " stolen in "
+         << PrettyDuration(stats.duration_ns);
+      if (stats.duration_ns > 0) {
+        os << " (" << PrettySize(stats.bytes_scanned * UINT64_C(1000000000) / stats.duration_ns)
+           << "/s)";
+      }
+      os << "\n";
+    }
   }
 }
 
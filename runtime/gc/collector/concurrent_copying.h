@@ -144,6 +144,18 @@ class ConcurrentCopying : public GarbageCollector {
   bool IsActive() const {
     return is_active_;
   }
+  // Number of threads, including the GC-running thread, that may process the mark stack.
+  size_t GetNumMarkWorkers() const {
+    return num_mark_workers_;
+  }
+  // Number of times the mark stack was processed by parallel mark workers.
+  uint64_t GetParallelMarkCount() const {
+    return parallel_mark_count_;
+  }
+  // Cumulative number of objects processed by the parallel mark worker `worker_index`.
+  uint64_t GetMarkWorkerObjectsProcessed(size_t worker_index) const {
+    return mark_worker_stats_[worker_index].objects_processed;
+  }
   Barrier& GetBarrier() {
     return *gc_barrier_;
   }
@@ -175,8 +187,10 @@ class ConcurrentCopying : public GarbageCollector {
                        MemberOffset offset)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_, !skipped_blocks_lock_, !immune_gray_stack_lock_);
-  // Scan the reference fields of object `to_ref`.
-  template <bool kNoUnEvac>
+  // Scan the reference fields of object `to_ref`. `kParallel` is true when called from a mark
+  // worker (see ProcessMarkStackParallel), in which case the scanned bytes are not added to
+  // `bytes_scanned_`.
+  template <bool kNoUnEvac, bool kParallel = false>
   void Scan(mirror::Object* to_ref, size_t obj_size = 0) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   // Scan the reference fields of object 'obj' in the dirty cards during
@@ -187,8 +201,8 @@ class ConcurrentCopying : public GarbageCollector {
   void ScanDirtyObject(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   // Process a field.
-  template <bool kNoUnEvac>
-  void Process(mirror::Object* obj, MemberOffset offset)
+  template <bool kNoUnEvac, bool kParallel = false>
+  void Process(Thread* const self, mirror::Object* obj, MemberOffset offset)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_ , !skipped_blocks_lock_, !immune_gray_stack_lock_);
   void VisitRoots(mirror::Object*** roots, size_t count, const RootInfo& info) override
@@ -209,7 +223,36 @@ class ConcurrentCopying : public GarbageCollector {
   void ProcessMarkStack() override REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   bool ProcessMarkStackOnce() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
-  void ProcessMarkStackRef(mirror::Object* to_ref) REQUIRES_SHARED(Locks::mutator_lock_)
+  // Process a reference popped off a mark stack and return the number of bytes scanned.
+  // `kParallel` is true when called from a mark worker: bitmap and live-bytes updates are then
+  // done atomically since other workers may be updating the same words.
+  template <bool kParallel = false>
+  size_t ProcessMarkStackRef(mirror::Object* to_ref) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Split the GC mark stack across the heap thread pool and process it, along with everything
+  // reachable from it, with `num_workers` mark workers (including the GC-running thread). Only
+  // used in the thread-local mark stack mode.
+  void ProcessMarkStackParallel(size_t num_workers) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Body of a mark worker. Processes `refs`, then drains the worker's own mark stack, sharing half
+  // of it whenever another worker is idle, and steals the mark stacks shared or revoked by other
+  // threads. Returns once no worker has work left.
+  void RunMarkWorker(Thread* const self,
+                     size_t worker_index,
+                     const std::vector<mirror::Object*>& refs)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // Returns the mark stack owned by mark worker `self`, or null if it has none yet.
+  accounting::ObjectStack* GetMarkWorkerStack(Thread* const self);
+  // Move the top half of `mark_stack`, owned by mark worker `self`, onto `revoked_mark_stacks_`
+  // for idle workers to steal.
+  void ShareMarkWork(Thread* const self, accounting::ObjectStack* mark_stack)
+      REQUIRES(!mark_stack_lock_);
+  // Take a mark stack shared by a mark worker, or revoked by another thread when it became full.
+  // Returns null if there is none.
+  accounting::ObjectStack* StealRevokedMarkStack(Thread* const self)
+      REQUIRES(!mark_stack_lock_);
+  // Give a processed revoked mark stack back to the pool (or delete it if the pool is full).
+  void RecycleMarkStack(Thread* const self, accounting::ObjectStack* mark_stack)
       REQUIRES(!mark_stack_lock_);
   void GrayAllDirtyImmuneObjects()
       REQUIRES(Locks::mutator_lock_)
@@ -351,6 +394,12 @@ class ConcurrentCopying : public GarbageCollector {
   // Generational "sticky", only trace through dirty objects in region space.
   const bool young_gen_;
 
+  // True if this young collection copies survivors to survivor regions instead of promoting
+  // them (see RegionSpace::GetTenureThreshold). References from tenured objects to survivor
+  // regions must then be recorded in the card table, as the next young collection only finds
+  // them by scanning dirty cards. Set in InitializePhase.
+  bool use_survivor_regions_;
+
   // If true, the GC thread is done scanning marked objects on dirty and aged
   // card (see ConcurrentCopying::CopyingPhase).
   Atomic<bool> done_scanning_;
@@ -380,6 +429,16 @@ class ConcurrentCopying : public GarbageCollector {
   std::vector<accounting::ObjectStack*> pooled_mark_stacks_
       GUARDED_BY(mark_stack_lock_);
   Thread* thread_running_gc_;
+  // Number of threads, including the GC-running thread, processing the mark stack in the
+  // thread-local mark stack mode. Parallel processing is disabled if it is 1.
+  const size_t num_mark_workers_;
+  // True while mark workers run in ProcessMarkStackParallel. Only used for debug checks.
+  bool is_parallel_marking_;
+  // Mark workers of ProcessMarkStackParallel which may still produce work, and those waiting for
+  // some. A worker shares work before it stops being active, so once none is active the shared
+  // work is all on `revoked_mark_stacks_`.
+  Atomic<size_t> num_active_mark_workers_;
+  Atomic<size_t> num_idle_mark_workers_;
   bool is_marking_;                       // True while marking is ongoing.
   // True while we might dispatch on the read barrier entrypoints.
   bool is_using_read_barrier_entrypoints_;
@@ -440,6 +499,19 @@ class ConcurrentCopying : public GarbageCollector {
   uint64_t bytes_scanned_;
   uint64_t cumulative_bytes_moved_;
   uint64_t cumulative_objects_moved_;
+  // Cumulative per-worker statistics of ProcessMarkStackParallel, indexed by mark worker. Each
+  // entry is written only by the task of its worker, and read by the GC-running thread after the
+  // workers are done.
+  struct MarkWorkerStats {
+    uint64_t objects_processed = 0;
+    uint64_t bytes_scanned = 0;
+    uint64_t mark_stacks_shared = 0;
+    uint64_t mark_stacks_stolen = 0;
+    uint64_t duration_ns = 0;
+  };
+  std::vector<MarkWorkerStats> mark_worker_stats_;
+  // Number of times ProcessMarkStackParallel ran.
+  uint64_t parallel_mark_count_;
 
   // The skipped blocks are memory blocks/chucks that were copies of
   // objects that were unused due to lost races (cas failures) at
@@ -500,7 +572,8 @@ class ConcurrentCopying : public GarbageCollector {
   template <bool kConcurrent> class GrayImmuneObjectVisitor;
   class ImmuneSpaceScanObjVisitor;
   class LostCopyVisitor;
-  template <bool kNoUnEvac> class RefFieldsVisitor;
+  class MarkWorkerTask;
+  template <bool kNoUnEvac, bool kParallel> class RefFieldsVisitor;
   class RevokeThreadLocalMarkStackCheckpoint;
   class ScopedGcGraysImmuneObjects;
   class ThreadFlipVisitor;
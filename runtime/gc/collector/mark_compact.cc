@@ -0,0 +1,685 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mark_compact.h"
+
+#include <string.h>
+
+#include <limits>
+#include <vector>
+
+#include "base/bit_utils.h"
+#include "base/logging.h"  // For VLOG.
+#include "base/mutex-inl.h"
+#include "base/timing_logger.h"
+#include "base/utils.h"
+#include "class_linker.h"
+#include "gc/accounting/atomic_stack.h"
+#include "gc/accounting/card_table.h"
+#include "gc/accounting/heap_bitmap-inl.h"
+#include "gc/accounting/mod_union_table.h"
+#include "gc/accounting/space_bitmap-inl.h"
+#include "gc/heap.h"
+#include "gc/reference_processor.h"
+#include "gc/space/bump_pointer_space.h"
+#include "gc/space/image_space.h"
+#include "gc/space/large_object_space.h"
+#include "gc/space/space-inl.h"
+#include "mirror/class-refvisitor-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object-refvisitor-inl.h"
+#include "mirror/reference-inl.h"
+#include "runtime.h"
+#include "thread-inl.h"
+#include "thread_list.h"
+
+namespace art {
+namespace gc {
+namespace collector {
+
+// Granularity of the live words bitmap, which is also the allocation granularity of the space.
+static constexpr size_t kAlignment = space::BumpPointerSpace::kAlignment;
+static_assert(kAlignment == kObjectAlignment,
+              "The live words bitmap is a ContinuousSpaceBitmap of kObjectAlignment granularity");
+// Number of words, and bytes, of the space covered by one word of the live words bitmap.
+static constexpr size_t kWordsPerChunk = kBitsPerIntPtrT;
+static constexpr size_t kChunkSize = kWordsPerChunk * kAlignment;
+
+MarkCompact::MarkCompact(Heap* heap, const std::string& name_prefix)
+    : GarbageCollector(heap,
+                       name_prefix + (name_prefix.empty() ? "" : " ") + "mark compact"),
+      mark_stack_(nullptr),
+      space_(nullptr),
+      mark_bitmap_(nullptr),
+      chunk_info_(nullptr),
+      post_compact_end_(nullptr),
+      self_(nullptr),
+      compacting_(false),
+      live_objects_in_space_(0u) {}
+
+void MarkCompact::SetSpace(space::BumpPointerSpace* space) {
+  DCHECK(space != nullptr);
+  if (space == space_) {
+    return;
+  }
+  space_ = space;
+  const size_t capacity = space->Capacity();
+  CHECK_LE(capacity, std::numeric_limits<uint32_t>::max()) << "Chunk info entries are 32-bit";
+  objects_bitmap_ = accounting::ContinuousSpaceBitmap::Create(
+      "mark compact objects bitmap", space->Begin(), capacity);
+  CHECK(objects_bitmap_.IsValid()) << "Failed to create the objects bitmap";
+  live_words_bitmap_ = accounting::ContinuousSpaceBitmap::Create(
+      "mark compact live words bitmap", space->Begin(), capacity);
+  CHECK(live_words_bitmap_.IsValid()) << "Failed to create the live words bitmap";
+  const size_t num_chunks = live_words_bitmap_.Size() / sizeof(uintptr_t);
+  std::string error_msg;
+  chunk_info_map_ = MemMap::MapAnonymous("mark compact chunk info",
+                                         RoundUp(num_chunks * sizeof(uint32_t), kPageSize),
+                                         PROT_READ | PROT_WRITE,
+                                         /*low_4gb=*/ false,
+                                         &error_msg);
+  CHECK(chunk_info_map_.IsValid()) << "Failed to allocate chunk info: " << error_msg;
+  chunk_info_ = reinterpret_cast<uint32_t*>(chunk_info_map_.Begin());
+}
+
+void MarkCompact::BindBitmaps() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  WriterMutexLock mu(self_, *Locks::heap_bitmap_lock_);
+  // Mark all of the spaces we never collect as immune.
+  for (const auto& space : GetHeap()->GetContinuousSpaces()) {
+    if (space->GetGcRetentionPolicy() == space::kGcRetentionPolicyNeverCollect ||
+        space->GetGcRetentionPolicy() == space::kGcRetentionPolicyFullCollect) {
+      immune_spaces_.AddSpace(space);
+    }
+  }
+}
+
+void MarkCompact::RunPhases() {
+  Thread* self = Thread::Current();
+  InitializePhase();
+  Locks::mutator_lock_->AssertNotHeld(self);
+  {
+    // Objects are moved without read barriers or forwarding state in the objects, so the whole
+    // collection has to happen with the mutators suspended.
+    ScopedPause pause(this);
+    GetHeap()->PreGcVerificationPaused(this);
+    GetHeap()->PrePauseRosAllocVerification(this);
+    MarkingPhase();
+    ReclaimPhase();
+  }
+  GetHeap()->PostGcVerification(this);
+  FinishPhase();
+}
+
+void MarkCompact::InitializePhase() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  CHECK(!kMovingClasses) << "Mark compact requires classes to be allocated in a non-moving space";
+  mark_stack_ = heap_->GetMarkStack();
+  DCHECK(mark_stack_ != nullptr);
+  immune_spaces_.Reset();
+  CHECK(space_ != nullptr);
+  CHECK(space_->CanMoveObjects()) << "Attempting to compact non-movable space " << *space_;
+  self_ = Thread::Current();
+  compacting_ = false;
+  post_compact_end_ = nullptr;
+  live_objects_in_space_ = 0u;
+  {
+    ReaderMutexLock mu(self_, *Locks::heap_bitmap_lock_);
+    mark_bitmap_ = heap_->GetMarkBitmap();
+  }
+}
+
+void MarkCompact::ProcessReferences(Thread* self) {
+  WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  ReferenceProcessor* rp = GetHeap()->GetReferenceProcessor();
+  rp->Setup(self, this, /*concurrent=*/false, GetCurrentIteration()->GetClearSoftReferences());
+  rp->ProcessReferences(self, GetTimings());
+}
+
+void MarkCompact::MarkingPhase() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Locks::mutator_lock_->AssertExclusiveHeld(self_);
+  // Revoke the thread local buffers so that the object counts of the space are exact and no
+  // thread keeps allocating into the range we compact.
+  RevokeAllThreadLocalBuffers();
+  BindBitmaps();
+  // Process dirty cards and add dirty cards to mod-union tables.
+  heap_->ProcessCards(GetTimings(), /*use_rem_sets=*/false, false, true);
+  // Clear the whole card table since we cannot get any additional dirty cards during the
+  // paused GC. This saves memory but only works for pause the world collectors.
+  t.NewTiming("ClearCardTable");
+  heap_->GetCardTable()->ClearCardTable();
+  // Need to do this before the checkpoint since we don't want any threads to add references to
+  // the live stack during the recursive mark.
+  if (kUseThreadLocalAllocationStack) {
+    TimingLogger::ScopedTiming t2("RevokeAllThreadLocalAllocationStacks", GetTimings());
+    heap_->RevokeAllThreadLocalAllocationStacks(self_);
+  }
+  heap_->SwapStacks();
+  {
+    WriterMutexLock mu(self_, *Locks::heap_bitmap_lock_);
+    MarkRoots();
+    // Recursively mark remaining objects.
+    MarkReachableObjects();
+  }
+  ProcessReferences(self_);
+  // Marking is complete, from now on IsMarked() returns post-compaction addresses so that the
+  // system weaks and the cleared references get updated while they are swept.
+  CalculatePostCompactAddresses();
+  {
+    ReaderMutexLock mu(self_, *Locks::heap_bitmap_lock_);
+    SweepSystemWeaks();
+    GetHeap()->GetReferenceProcessor()->UpdateRoots(this);
+  }
+  Runtime::Current()->BroadcastForNewSystemWeaks();
+  Runtime::Current()->GetClassLinker()->CleanupClassLoaders();
+  GetHeap()->RecordFreeRevoke();  // This is for the non-moving rosalloc space.
+}
+
+void MarkCompact::MarkReachableObjects() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  {
+    TimingLogger::ScopedTiming t2("MarkStackAsLive", GetTimings());
+    accounting::ObjectStack* live_stack = heap_->GetLiveStack();
+    heap_->MarkAllocStackAsLive(live_stack);
+    live_stack->Reset();
+  }
+  for (auto& space : heap_->GetContinuousSpaces()) {
+    // If the space is immune then we need to mark the references to other spaces.
+    accounting::ModUnionTable* table = heap_->FindModUnionTableFromSpace(space);
+    if (table != nullptr) {
+      TimingLogger::ScopedTiming t2(
+          space->IsZygoteSpace() ? "UpdateAndMarkZygoteModUnionTable" :
+                                   "UpdateAndMarkImageModUnionTable",
+                                   GetTimings());
+      table->UpdateAndMarkReferences(this);
+    } else if (space->IsImageSpace() && space->GetLiveBitmap() != nullptr) {
+      // App image spaces have no mod union table, scan their live bitmap as roots.
+      TimingLogger::ScopedTiming t2("VisitLiveBits", GetTimings());
+      accounting::ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
+      live_bitmap->VisitMarkedRange(reinterpret_cast<uintptr_t>(space->Begin()),
+                                    reinterpret_cast<uintptr_t>(space->End()),
+                                    [this](mirror::Object* obj)
+          REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+        ScanObject(obj);
+      });
+    }
+  }
+  // Recursively process the mark stack.
+  ProcessMarkStack();
+}
+
+void MarkCompact::ReclaimPhase() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  WriterMutexLock mu(self_, *Locks::heap_bitmap_lock_);
+  // Update the references first, the mark bitmaps tell which objects of the non-moving spaces
+  // are still live.
+  UpdateReferences();
+  // Reclaim unmarked objects.
+  Sweep(false);
+  // Swap the live and mark bitmaps for each space which we modified space. This is an
+  // optimization that enables us to not clear live bits inside of the sweep. Only swaps unbound
+  // bitmaps.
+  SwapBitmaps();
+  // Unbind the live and mark bitmaps.
+  GetHeap()->UnBindBitmaps();
+  Compact();
+}
+
+void MarkCompact::ResizeMarkStack(size_t new_size) {
+  std::vector<StackReference<mirror::Object>> temp(mark_stack_->Begin(), mark_stack_->End());
+  CHECK_LE(mark_stack_->Size(), new_size);
+  mark_stack_->Resize(new_size);
+  for (auto& obj : temp) {
+    mark_stack_->PushBack(obj.AsMirrorPtr());
+  }
+}
+
+inline void MarkCompact::MarkStackPush(mirror::Object* obj) {
+  if (UNLIKELY(mark_stack_->Size() >= mark_stack_->Capacity())) {
+    ResizeMarkStack(mark_stack_->Capacity() * 2);
+  }
+  // The object must be pushed on to the mark stack.
+  mark_stack_->PushBack(obj);
+}
+
+void MarkCompact::SetLiveWords(mirror::Object* obj, size_t size) {
+  DCHECK_ALIGNED(size, kAlignment);
+  const uintptr_t offset = reinterpret_cast<uintptr_t>(obj) - live_words_bitmap_.HeapBegin();
+  size_t bit = offset / kAlignment;
+  const size_t end_bit = bit + size / kAlignment;
+  Atomic<uintptr_t>* const words = live_words_bitmap_.Begin();
+  while (bit < end_bit) {
+    const size_t shift = bit % kWordsPerChunk;
+    const size_t num_bits = std::min(end_bit - bit, kWordsPerChunk - shift);
+    const uintptr_t mask = num_bits == kWordsPerChunk
+        ? ~static_cast<uintptr_t>(0)
+        : ((static_cast<uintptr_t>(1) << num_bits) - 1) << shift;
+    Atomic<uintptr_t>* const word = &words[bit / kWordsPerChunk];
+    // Marking is single threaded, no need for an atomic read-modify-write.
+    word->store(word->load(std::memory_order_relaxed) | mask, std::memory_order_relaxed);
+    bit += num_bits;
+  }
+}
+
+inline void MarkCompact::MarkObjectNoUpdate(mirror::Object* obj) {
+  if (obj == nullptr) {
+    return;
+  }
+  if (space_->HasAddress(obj)) {
+    if (!objects_bitmap_.Set(obj)) {
+      // This object was not previously marked.
+      SetLiveWords(obj, RoundUp(obj->SizeOf<kDefaultVerifyFlags>(), kAlignment));
+      ++live_objects_in_space_;
+      MarkStackPush(obj);
+    }
+  } else if (!immune_spaces_.IsInImmuneRegion(obj)) {
+    auto slow_path = [](const mirror::Object* ref) {
+      // Marking a large object, make sure its aligned as a consistency check.
+      CHECK_ALIGNED(ref, kPageSize);
+    };
+    if (!mark_bitmap_->Set(obj, slow_path)) {
+      // This object was not previously marked.
+      MarkStackPush(obj);
+    }
+  }
+}
+
+void MarkCompact::CalculatePostCompactAddresses() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  DCHECK(!compacting_);
+  const size_t num_chunks =
+      RoundUp(static_cast<size_t>(space_->End() - space_->Begin()), kChunkSize) / kChunkSize;
+  Atomic<uintptr_t>* const words = live_words_bitmap_.Begin();
+  uint32_t live_bytes = 0u;
+  for (size_t i = 0; i < num_chunks; ++i) {
+    chunk_info_[i] = live_bytes;
+    live_bytes += POPCOUNT(words[i].load(std::memory_order_relaxed)) * kAlignment;
+  }
+  post_compact_end_ = space_->Begin() + live_bytes;
+  DCHECK_LE(post_compact_end_, space_->End());
+  compacting_ = true;
+}
+
+inline mirror::Object* MarkCompact::PostCompactAddress(mirror::Object* obj) {
+  DCHECK(compacting_);
+  DCHECK(objects_bitmap_.Test(obj)) << "Forwarding unmarked object " << obj;
+  const uintptr_t offset = reinterpret_cast<uintptr_t>(obj) - live_words_bitmap_.HeapBegin();
+  const size_t index = accounting::ContinuousSpaceBitmap::OffsetToIndex(offset);
+  // Live words of the chunk which precede obj.
+  const uintptr_t word = live_words_bitmap_.Begin()[index].load(std::memory_order_relaxed) &
+      (accounting::ContinuousSpaceBitmap::OffsetToMask(offset) - 1);
+  return reinterpret_cast<mirror::Object*>(
+      space_->Begin() + chunk_info_[index] + POPCOUNT(word) * kAlignment);
+}
+
+inline mirror::Object* MarkCompact::GetForwardingAddress(mirror::Object* obj) {
+  return space_->HasAddress(obj) ? PostCompactAddress(obj) : obj;
+}
+
+mirror::Object* MarkCompact::MarkObject(mirror::Object* obj) {
+  if (compacting_) {
+    return obj == nullptr ? nullptr : GetForwardingAddress(obj);
+  }
+  MarkObjectNoUpdate(obj);
+  return obj;
+}
+
+void MarkCompact::MarkHeapReference(mirror::HeapReference<mirror::Object>* obj_ptr,
+                                    bool do_atomic_update ATTRIBUTE_UNUSED) {
+  mirror::Object* obj = obj_ptr->AsMirrorPtr();
+  mirror::Object* new_obj = MarkObject(obj);
+  if (new_obj != obj) {
+    // Write barrier is not necessary since it still points to the same object, just at a different
+    // address.
+    obj_ptr->Assign(new_obj);
+  }
+}
+
+void MarkCompact::VisitRoots(mirror::Object*** roots,
+                             size_t count,
+                             const RootInfo& info ATTRIBUTE_UNUSED) {
+  for (size_t i = 0; i < count; ++i) {
+    mirror::Object* obj = *roots[i];
+    mirror::Object* new_obj = MarkObject(obj);
+    if (new_obj != obj) {
+      *roots[i] = new_obj;
+    }
+  }
+}
+
+void MarkCompact::VisitRoots(mirror::CompressedReference<mirror::Object>** roots,
+                             size_t count,
+                             const RootInfo& info ATTRIBUTE_UNUSED) {
+  for (size_t i = 0; i < count; ++i) {
+    mirror::Object* obj = roots[i]->AsMirrorPtr();
+    mirror::Object* new_obj = MarkObject(obj);
+    if (new_obj != obj) {
+      roots[i]->Assign(new_obj);
+    }
+  }
+}
+
+// Marks all objects in the root set.
+void MarkCompact::MarkRoots() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Runtime::Current()->VisitRoots(this);
+}
+
+void MarkCompact::SweepSystemWeaks() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Runtime::Current()->SweepSystemWeaks(this);
+}
+
+mirror::Object* MarkCompact::IsMarked(mirror::Object* obj) {
+  if (space_->HasAddress(obj)) {
+    if (!objects_bitmap_.Test(obj)) {
+      return nullptr;
+    }
+    return compacting_ ? PostCompactAddress(obj) : obj;
+  }
+  // All immune objects are assumed marked.
+  if (immune_spaces_.IsInImmuneRegion(obj)) {
+    return obj;
+  }
+  return mark_bitmap_->Test(obj) ? obj : nullptr;
+}
+
+bool MarkCompact::IsNullOrMarkedHeapReference(mirror::HeapReference<mirror::Object>* object,
+                                              // MarkCompact does the GC in a pause. No CAS needed.
+                                              bool do_atomic_update ATTRIBUTE_UNUSED) {
+  mirror::Object* obj = object->AsMirrorPtr();
+  if (obj == nullptr) {
+    return true;
+  }
+  mirror::Object* new_obj = IsMarked(obj);
+  if (new_obj == nullptr) {
+    return false;
+  }
+  if (new_obj != obj) {
+    // Write barrier is not necessary since it still points to the same object, just at a different
+    // address.
+    object->Assign(new_obj);
+  }
+  return true;
+}
+
+// Process the "referent" field in a java.lang.ref.Reference.  If the referent has not yet been
+// marked, put it on the appropriate list in the heap for later processing.
+void MarkCompact::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
+                                         ObjPtr<mirror::Reference> reference) {
+  heap_->GetReferenceProcessor()->DelayReferenceReferent(klass, reference, this);
+}
+
+class MarkCompact::MarkObjectVisitor {
+ public:
+  explicit MarkObjectVisitor(MarkCompact* collector) : collector_(collector) {}
+
+  void operator()(ObjPtr<mirror::Object> obj,
+                  MemberOffset offset,
+                  bool /* is_static */) const ALWAYS_INLINE
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    // Object was already verified when we scanned it.
+    collector_->MarkObjectNoUpdate(
+        obj->GetFieldObject<mirror::Object, kVerifyNone, kWithoutReadBarrier>(offset));
+  }
+
+  void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    collector_->DelayReferenceReferent(klass, ref);
+  }
+
+  // TODO: Remove NO_THREAD_SAFETY_ANALYSIS when clang better understands visitors.
+  void VisitRootIfNonNull(mirror::CompressedReference<mirror::Object>* root) const
+      NO_THREAD_SAFETY_ANALYSIS {
+    if (!root->IsNull()) {
+      VisitRoot(root);
+    }
+  }
+
+  void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
+      NO_THREAD_SAFETY_ANALYSIS {
+    collector_->MarkObjectNoUpdate(root->AsMirrorPtr());
+  }
+
+ private:
+  MarkCompact* const collector_;
+};
+
+// Visit all of the references of an object and mark them.
+void MarkCompact::ScanObject(mirror::Object* obj) {
+  MarkObjectVisitor visitor(this);
+  obj->VisitReferences</*kVisitNativeRoots=*/true, kDefaultVerifyFlags, kWithoutReadBarrier>(
+      visitor, visitor);
+}
+
+// Scan anything that's on the mark stack.
+void MarkCompact::ProcessMarkStack() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  while (!mark_stack_->IsEmpty()) {
+    mirror::Object* obj = mark_stack_->PopBack();
+    ScanObject(obj);
+  }
+}
+
+class MarkCompact::UpdateObjectReferencesVisitor {
+ public:
+  explicit UpdateObjectReferencesVisitor(MarkCompact* collector) : collector_(collector) {}
+
+  void operator()(ObjPtr<mirror::Object> obj,
+                  MemberOffset offset,
+                  bool /* is_static */) const ALWAYS_INLINE
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    collector_->MarkHeapReference(obj->GetFieldObjectReferenceAddr<kVerifyNone>(offset),
+                                  /*do_atomic_update=*/ false);
+  }
+
+  void operator()(ObjPtr<mirror::Class> klass ATTRIBUTE_UNUSED,
+                  ObjPtr<mirror::Reference> ref) const
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    // The referent is either cleared or marked by now.
+    collector_->MarkHeapReference(ref->GetReferentReferenceAddr(), /*do_atomic_update=*/ false);
+  }
+
+  // TODO: Remove NO_THREAD_SAFETY_ANALYSIS when clang better understands visitors.
+  void VisitRootIfNonNull(mirror::CompressedReference<mirror::Object>* root) const
+      NO_THREAD_SAFETY_ANALYSIS {
+    if (!root->IsNull()) {
+      VisitRoot(root);
+    }
+  }
+
+  void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
+      NO_THREAD_SAFETY_ANALYSIS {
+    mirror::Object* obj = root->AsMirrorPtr();
+    mirror::Object* new_obj = collector_->GetForwardingAddress(obj);
+    if (new_obj != obj) {
+      root->Assign(new_obj);
+    }
+  }
+
+ private:
+  MarkCompact* const collector_;
+};
+
+void MarkCompact::UpdateObjectReferences(mirror::Object* obj) {
+  UpdateObjectReferencesVisitor visitor(this);
+  if (obj->IsClass<kVerifyNone>()) {
+    // Class::VisitNativeRoots() reads the ClassExt through the ext_data_ field, so visit the
+    // native roots before the field gets updated to the post-compaction address.
+    obj->AsClass<kVerifyNone>()->VisitNativeRoots<kWithoutReadBarrier>(
+        visitor, Runtime::Current()->GetClassLinker()->GetImagePointerSize());
+    obj->VisitReferences</*kVisitNativeRoots=*/false, kVerifyNone, kWithoutReadBarrier>(
+        visitor, visitor);
+  } else {
+    obj->VisitReferences</*kVisitNativeRoots=*/true, kVerifyNone, kWithoutReadBarrier>(
+        visitor, visitor);
+  }
+}
+
+void MarkCompact::UpdateReferences() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  DCHECK(compacting_);
+  // Update roots.
+  Runtime::Current()->VisitRoots(this);
+  auto update_visitor = [this](mirror::Object* obj)
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    UpdateObjectReferences(obj);
+  };
+  // Update object references in mod union tables and non-moving spaces.
+  for (const auto& space : heap_->GetContinuousSpaces()) {
+    accounting::ModUnionTable* table = heap_->FindModUnionTableFromSpace(space);
+    if (table != nullptr) {
+      TimingLogger::ScopedTiming t2(
+          space->IsZygoteSpace() ? "UpdateZygoteModUnionTableReferences" :
+                                   "UpdateImageModUnionTableReferences",
+                                   GetTimings());
+      table->UpdateAndMarkReferences(this);
+    } else if (space != space_) {
+      // Every object of an immune space is live, elsewhere only the marked objects are.
+      accounting::ContinuousSpaceBitmap* bitmap = immune_spaces_.ContainsSpace(space)
+          ? space->GetLiveBitmap()
+          : space->GetMarkBitmap();
+      if (bitmap != nullptr) {
+        TimingLogger::ScopedTiming t2("UpdateSpaceReferences", GetTimings());
+        bitmap->VisitMarkedRange(reinterpret_cast<uintptr_t>(space->Begin()),
+                                 reinterpret_cast<uintptr_t>(space->End()),
+                                 update_visitor);
+      }
+    }
+  }
+  space::LargeObjectSpace* los = heap_->GetLargeObjectsSpace();
+  if (los != nullptr) {
+    TimingLogger::ScopedTiming t2("UpdateLargeObjectReferences", GetTimings());
+    los->GetMarkBitmap()->VisitMarkedRange(reinterpret_cast<uintptr_t>(los->Begin()),
+                                           reinterpret_cast<uintptr_t>(los->End()),
+                                           update_visitor);
+  }
+  // Update the objects in the compacted space last. Nothing has moved yet, so the objects are
+  // still at their pre-compaction addresses.
+  TimingLogger::ScopedTiming t2("UpdateCompactedSpaceReferences", GetTimings());
+  objects_bitmap_.VisitMarkedRange(reinterpret_cast<uintptr_t>(space_->Begin()),
+                                   reinterpret_cast<uintptr_t>(space_->End()),
+                                   update_visitor);
+}
+
+bool MarkCompact::ShouldSweepSpace(space::ContinuousSpace* space) const {
+  return space != space_;
+}
+
+void MarkCompact::Sweep(bool swap_bitmaps) {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  DCHECK(mark_stack_->IsEmpty());
+  for (const auto& space : GetHeap()->GetContinuousSpaces()) {
+    if (space->IsContinuousMemMapAllocSpace()) {
+      space::ContinuousMemMapAllocSpace* alloc_space = space->AsContinuousMemMapAllocSpace();
+      if (!ShouldSweepSpace(alloc_space)) {
+        continue;
+      }
+      TimingLogger::ScopedTiming split(
+          alloc_space->IsZygoteSpace() ? "SweepZygoteSpace" : "SweepAllocSpace", GetTimings());
+      RecordFree(alloc_space->Sweep(swap_bitmaps));
+    }
+  }
+  SweepLargeObjects(swap_bitmaps);
+}
+
+void MarkCompact::SweepLargeObjects(bool swap_bitmaps) {
+  space::LargeObjectSpace* los = heap_->GetLargeObjectsSpace();
+  if (los != nullptr) {
+    TimingLogger::ScopedTiming split("SweepLargeObjects", GetTimings());
+    RecordFreeLOS(los->Sweep(swap_bitmaps));
+  }
+}
+
+void MarkCompact::MoveObjects() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  uint8_t* const begin = space_->Begin();
+  const size_t num_chunks =
+      RoundUp(static_cast<size_t>(space_->End() - begin), kChunkSize) / kChunkSize;
+  Atomic<uintptr_t>* const words = live_words_bitmap_.Begin();
+  // Contiguous live words are moved with a single memmove(). Since the runs are visited in address
+  // order and only ever move down, a run never overwrites live words which have not moved yet.
+  uint8_t* run_from = nullptr;
+  uint8_t* run_to = nullptr;
+  size_t run_size = 0u;
+  for (size_t i = 0; i < num_chunks; ++i) {
+    uintptr_t word = words[i].load(std::memory_order_relaxed);
+    uint8_t* const chunk_begin = begin + i * kChunkSize;
+    uint8_t* to = begin + chunk_info_[i];
+    while (word != 0u) {
+      const size_t shift = CTZ(word);
+      const uintptr_t inverted = ~(word >> shift);
+      const size_t num_bits = inverted == 0u ? kWordsPerChunk - shift : CTZ(inverted);
+      uint8_t* const from = chunk_begin + shift * kAlignment;
+      const size_t size = num_bits * kAlignment;
+      if (run_from + run_size == from) {
+        run_size += size;
+      } else {
+        if (run_size != 0u) {
+          memmove(run_to, run_from, run_size);
+        }
+        run_from = from;
+        run_to = to;
+        run_size = size;
+      }
+      to += size;
+      word = (shift + num_bits == kWordsPerChunk)
+          ? 0u
+          : word & ~(((static_cast<uintptr_t>(1) << num_bits) - 1) << shift);
+    }
+  }
+  if (run_size != 0u) {
+    memmove(run_to, run_from, run_size);
+  }
+}
+
+void MarkCompact::Compact() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  const uint64_t objects_before = space_->GetObjectsAllocated();
+  const uint64_t bytes_before = space_->GetBytesAllocated();
+  MoveObjects();
+  const uint64_t bytes_after = static_cast<uint64_t>(post_compact_end_ - space_->Begin());
+  space_->ResetAfterCompaction(post_compact_end_, live_objects_in_space_);
+  VLOG(heap) << "Compacted " << *space_ << " from " << PrettySize(bytes_before) << " to "
+             << PrettySize(bytes_after);
+  CHECK_LE(live_objects_in_space_, objects_before);
+  CHECK_LE(bytes_after, bytes_before);
+  RecordFree(ObjectBytePair(objects_before - live_objects_in_space_, bytes_before - bytes_after));
+}
+
+void MarkCompact::FinishPhase() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  CHECK(mark_stack_->IsEmpty());
+  mark_stack_->Reset();
+  // The chunk info is recomputed from scratch by the next collection, only the bitmaps need to be
+  // cleared.
+  objects_bitmap_.Clear();
+  live_words_bitmap_.Clear();
+  compacting_ = false;
+  // Clear all of the spaces' mark bitmaps.
+  WriterMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
+  heap_->ClearMarkedObjects();
+}
+
+void MarkCompact::RevokeAllThreadLocalBuffers() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  GetHeap()->RevokeAllThreadLocalBuffers();
+}
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
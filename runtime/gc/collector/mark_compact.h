@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_COLLECTOR_MARK_COMPACT_H_
+#define ART_RUNTIME_GC_COLLECTOR_MARK_COMPACT_H_
+
+#include <memory>
+#include <string>
+
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/mem_map.h"
+#include "garbage_collector.h"
+#include "gc/accounting/heap_bitmap.h"
+#include "gc/accounting/space_bitmap.h"
+#include "gc_root.h"
+#include "immune_spaces.h"
+#include "mirror/object_reference.h"
+#include "offsets.h"
+
+namespace art {
+
+class Thread;
+
+namespace mirror {
+class Class;
+class Object;
+}  // namespace mirror
+
+namespace gc {
+
+class Heap;
+
+namespace accounting {
+template <typename T> class AtomicStack;
+using ObjectStack = AtomicStack<mirror::Object>;
+}  // namespace accounting
+
+namespace space {
+class BumpPointerSpace;
+class ContinuousSpace;
+}  // namespace space
+
+namespace collector {
+
+// A stop-the-world sliding mark-compact collector. Live objects of a bump pointer space are slid
+// towards the beginning of the space in address order, so unlike the semi-space collector no
+// to-space has to be reserved. Forwarding addresses are not stored in the objects; they are
+// computed from a bitmap of live 8-byte words and a per-bitmap-word prefix sum of live bytes.
+//
+// References are updated before any object is moved, which relies on classes never being
+// allocated in the compacted space (see kMovingClasses).
+class MarkCompact final : public GarbageCollector {
+ public:
+  explicit MarkCompact(Heap* heap, const std::string& name_prefix = "");
+
+  ~MarkCompact() {}
+
+  void RunPhases() override NO_THREAD_SAFETY_ANALYSIS;
+  void InitializePhase();
+  void MarkingPhase() REQUIRES(Locks::mutator_lock_) REQUIRES(!Locks::heap_bitmap_lock_);
+  void ReclaimPhase() REQUIRES(Locks::mutator_lock_) REQUIRES(!Locks::heap_bitmap_lock_);
+  void FinishPhase() REQUIRES(Locks::mutator_lock_);
+  GcType GetGcType() const override {
+    return kGcTypePartial;
+  }
+  CollectorType GetCollectorType() const override {
+    return kCollectorTypeMC;
+  }
+
+  // Sets the space which gets compacted. The side tables are (re)created when the space changes.
+  void SetSpace(space::BumpPointerSpace* space);
+
+  mirror::Object* MarkObject(mirror::Object* obj) override
+      REQUIRES(Locks::heap_bitmap_lock_, Locks::mutator_lock_);
+
+  void MarkHeapReference(mirror::HeapReference<mirror::Object>* obj_ptr,
+                         bool do_atomic_update) override
+      REQUIRES(Locks::heap_bitmap_lock_, Locks::mutator_lock_);
+
+  void VisitRoots(mirror::Object*** roots, size_t count, const RootInfo& info) override
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
+
+  void VisitRoots(mirror::CompressedReference<mirror::Object>** roots,
+                  size_t count,
+                  const RootInfo& info) override
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
+
+  // Schedules an unmarked object for reference processing.
+  void DelayReferenceReferent(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> reference)
+      override REQUIRES_SHARED(Locks::heap_bitmap_lock_, Locks::mutator_lock_);
+
+ protected:
+  // Returns null if the object is not marked. Otherwise returns the object, or its post-compaction
+  // address once the forwarding addresses have been computed.
+  mirror::Object* IsMarked(mirror::Object* obj) override
+      REQUIRES(Locks::mutator_lock_)
+      REQUIRES_SHARED(Locks::heap_bitmap_lock_);
+
+  bool IsNullOrMarkedHeapReference(mirror::HeapReference<mirror::Object>* obj,
+                                   bool do_atomic_update) override
+      REQUIRES(Locks::mutator_lock_)
+      REQUIRES_SHARED(Locks::heap_bitmap_lock_);
+
+  // Recursively blackens objects on the mark stack.
+  void ProcessMarkStack() override
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
+
+  // Revoke all the thread-local buffers.
+  void RevokeAllThreadLocalBuffers() override;
+
+ private:
+  class MarkObjectVisitor;
+  class UpdateObjectReferencesVisitor;
+
+  // Bind the live bits to the mark bits of bitmaps for spaces that are never collected, ie
+  // the image. Mark that portion of the heap as immune.
+  void BindBitmaps() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::heap_bitmap_lock_);
+
+  void MarkRoots() REQUIRES(Locks::heap_bitmap_lock_, Locks::mutator_lock_);
+  void MarkReachableObjects() REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
+  void ProcessReferences(Thread* self) REQUIRES(Locks::mutator_lock_);
+  void SweepSystemWeaks() REQUIRES_SHARED(Locks::heap_bitmap_lock_, Locks::mutator_lock_);
+
+  // Marks obj if it is not marked yet and pushes it on the mark stack. For objects in the
+  // compacted space this also records the words the object occupies in the live words bitmap.
+  void MarkObjectNoUpdate(mirror::Object* obj)
+      REQUIRES(Locks::heap_bitmap_lock_, Locks::mutator_lock_);
+  void ScanObject(mirror::Object* obj) REQUIRES(Locks::heap_bitmap_lock_, Locks::mutator_lock_);
+  void SetLiveWords(mirror::Object* obj, size_t size);
+  void MarkStackPush(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_);
+  void ResizeMarkStack(size_t new_size) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Computes the prefix sum of live bytes for each live words bitmap word. After this the
+  // collector is in the compacting state and returns post-compaction addresses.
+  void CalculatePostCompactAddresses();
+  // Returns the address obj will be moved to. obj must be a marked object in space_.
+  mirror::Object* PostCompactAddress(mirror::Object* obj);
+  // Returns the post-compaction address of obj if it lives in space_, otherwise obj itself.
+  mirror::Object* GetForwardingAddress(mirror::Object* obj);
+
+  // Updates all the references in the roots, the immune spaces, the non-moving spaces and the
+  // compacted space to their post-compaction addresses.
+  void UpdateReferences() REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
+  void UpdateObjectReferences(mirror::Object* obj)
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
+
+  // Returns true if we should sweep the space.
+  bool ShouldSweepSpace(space::ContinuousSpace* space) const;
+
+  // Reclaims the unmarked objects of the non-moving spaces.
+  void Sweep(bool swap_bitmaps) REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  void SweepLargeObjects(bool swap_bitmaps) REQUIRES(Locks::heap_bitmap_lock_);
+
+  // Slides the live words of space_ down to their post-compaction addresses and releases the
+  // pages freed at the end of the space.
+  void Compact() REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
+  void MoveObjects() REQUIRES(Locks::mutator_lock_);
+
+  accounting::ObjectStack* mark_stack_;
+
+  // Every object inside the immune spaces is assumed to be marked.
+  ImmuneSpaces immune_spaces_;
+
+  // The space which is compacted in place.
+  space::BumpPointerSpace* space_;
+
+  // Cached mark bitmap of the non-moving spaces as an optimization.
+  accounting::HeapBitmap* mark_bitmap_;
+
+  // One bit per marked object start in space_.
+  accounting::ContinuousSpaceBitmap objects_bitmap_;
+
+  // One bit per live 8-byte word of space_.
+  accounting::ContinuousSpaceBitmap live_words_bitmap_;
+
+  // For each word of live_words_bitmap_, the number of live bytes in space_ before the heap range
+  // covered by that word. Indexed like the bitmap words.
+  MemMap chunk_info_map_;
+  uint32_t* chunk_info_;
+
+  // Where the top of space_ will be after compaction.
+  uint8_t* post_compact_end_;
+
+  Thread* self_;
+
+  // Set once the post-compaction addresses are known. From then on the marking entry points
+  // update references instead of marking.
+  bool compacting_;
+
+  size_t live_objects_in_space_;
+
+  friend class MarkCompactTest;  // For testing the compaction without running a collection.
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(MarkCompact);
+};
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_COLLECTOR_MARK_COMPACT_H_
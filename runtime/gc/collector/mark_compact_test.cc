@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mark_compact.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "class_linker-inl.h"
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "gc/space/bump_pointer_space-inl.h"
+#include "gc/space/space.h"
+#include "handle_scope-inl.h"
+#include "intern_table.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-alloc-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/string.h"
+#include "runtime_globals.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace gc {
+namespace collector {
+
+#define TEST_DISABLED_WITHOUT_MARK_COMPACT() \
+  if (!kMarkCompactSupport || kUseReadBarrier) { \
+    printf("WARNING: TEST DISABLED WITHOUT MARK COMPACT SUPPORT\n"); \
+    return; \
+  }
+
+class MarkCompactTest : public CommonRuntimeTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    if (kMarkCompactSupport && !kUseReadBarrier) {
+      options->push_back(std::make_pair("-Xgc:MC", nullptr));
+    }
+  }
+
+  static std::string StringAt(Handle<mirror::ObjectArray<mirror::Object>> array, size_t i)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    return array->Get(i)->AsString()->ToModifiedUtf8();
+  }
+
+  // Records `size` bytes at `obj` as a live object, as marking does in the compacted space.
+  static void MarkLive(MarkCompact* collector, mirror::Object* obj, size_t size) {
+    collector->objects_bitmap_.Set(obj);
+    collector->SetLiveWords(obj, size);
+    ++collector->live_objects_in_space_;
+  }
+
+  static void CalculatePostCompactAddresses(MarkCompact* collector) {
+    collector->CalculatePostCompactAddresses();
+  }
+
+  // Once the post-compaction addresses are calculated, marking returns the forwarding address.
+  static mirror::Object* PostCompactAddress(MarkCompact* collector, mirror::Object* obj)
+      NO_THREAD_SAFETY_ANALYSIS {
+    return collector->MarkObject(obj);
+  }
+
+  static void MoveObjects(MarkCompact* collector) NO_THREAD_SAFETY_ANALYSIS {
+    collector->MoveObjects();
+  }
+};
+
+// Exercise the forwarding address computation and the sliding of the live words on a standalone
+// space. This needs neither a runtime built for mark compact nor a collection, so unlike the
+// tests below it runs in every configuration.
+TEST_F(MarkCompactTest, SlidesLiveWords) {
+  static constexpr size_t kNumBlocks = 300;
+  // Blocks of a few words, and blocks spanning live words bitmap words.
+  static constexpr size_t kBlockSizes[] = { 16u, 520u, 1048u };
+  std::unique_ptr<space::BumpPointerSpace> space(
+      space::BumpPointerSpace::Create("mark compact test space", 4 * MB));
+  ASSERT_TRUE(space != nullptr);
+  MarkCompact collector(Runtime::Current()->GetHeap());
+  collector.SetSpace(space.get());
+
+  struct Block {
+    mirror::Object* address;
+    size_t size;
+    bool live;
+  };
+  std::vector<Block> blocks;
+  for (size_t i = 0; i != kNumBlocks; ++i) {
+    size_t size = kBlockSizes[i % arraysize(kBlockSizes)];
+    mirror::Object* address = space->AllocNonvirtual(size);
+    ASSERT_TRUE(address != nullptr);
+    memset(address, static_cast<uint8_t>(i), size);
+    // Runs of two live blocks separated by a dead one.
+    bool live = (i % 3u) != 0u;
+    if (live) {
+      MarkLive(&collector, address, size);
+    }
+    blocks.push_back({address, size, live});
+  }
+
+  CalculatePostCompactAddresses(&collector);
+  std::vector<mirror::Object*> new_addresses;
+  uint8_t* expected = space->Begin();
+  for (const Block& block : blocks) {
+    if (block.live) {
+      mirror::Object* new_address = PostCompactAddress(&collector, block.address);
+      EXPECT_EQ(expected, reinterpret_cast<uint8_t*>(new_address));
+      new_addresses.push_back(new_address);
+      expected += block.size;
+    }
+  }
+
+  MoveObjects(&collector);
+  size_t live_index = 0u;
+  for (size_t i = 0; i != kNumBlocks; ++i) {
+    if (!blocks[i].live) {
+      continue;
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(new_addresses[live_index++]);
+    for (size_t j = 0; j != blocks[i].size; ++j) {
+      ASSERT_EQ(static_cast<uint8_t>(i), data[j]) << "block " << i << " byte " << j;
+    }
+  }
+}
+
+// Interleave live strings with garbage and check that a collection slides the live strings
+// down, updates the references to them and frees the garbage.
+TEST_F(MarkCompactTest, SlidesLiveObjects) {
+  TEST_DISABLED_WITHOUT_MARK_COMPACT();
+  static constexpr size_t kNumLive = 512;
+  Heap* heap = Runtime::Current()->GetHeap();
+  ASSERT_EQ(kCollectorTypeMC, heap->CurrentCollectorType());
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  Handle<mirror::Class> array_class(
+      hs.NewHandle(class_linker_->FindSystemClass(self, "[Ljava/lang/Object;")));
+  ASSERT_TRUE(array_class != nullptr);
+  Handle<mirror::ObjectArray<mirror::Object>> live(hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumLive)));
+  ASSERT_TRUE(live != nullptr);
+  std::vector<uintptr_t> old_addresses;
+  for (size_t i = 0; i != kNumLive; ++i) {
+    // Garbage before each live string, so that every live string has somewhere to slide to.
+    ASSERT_TRUE(mirror::String::AllocFromModifiedUtf8(self, "garbage garbage garbage") != nullptr);
+    ObjPtr<mirror::String> string =
+        mirror::String::AllocFromModifiedUtf8(self, std::to_string(i).c_str());
+    ASSERT_TRUE(string != nullptr);
+    live->Set<false>(i, string);
+    old_addresses.push_back(reinterpret_cast<uintptr_t>(string.Ptr()));
+  }
+  space::ContinuousSpace* space =
+      heap->FindContinuousSpaceFromObject(live->Get(kNumLive - 1), /*fail_ok=*/ true);
+  ASSERT_TRUE(space != nullptr && space->IsBumpPointerSpace());
+  const size_t bytes_before = heap->GetBytesAllocated();
+
+  heap->CollectGarbage(/* clear_soft_references= */ false);
+
+  EXPECT_LT(heap->GetBytesAllocated(), bytes_before);
+  EXPECT_EQ(0u, heap->VerifyHeapReferences());
+  uintptr_t previous = 0u;
+  for (size_t i = 0; i != kNumLive; ++i) {
+    ObjPtr<mirror::Object> obj = live->Get(i);
+    ASSERT_TRUE(obj != nullptr);
+    uintptr_t address = reinterpret_cast<uintptr_t>(obj.Ptr());
+    // Sliding keeps the address order and the live strings only move down.
+    EXPECT_LT(previous, address);
+    EXPECT_LT(address, old_addresses[i]);
+    previous = address;
+    EXPECT_EQ(std::to_string(i), StringAt(live, i));
+  }
+}
+
+// A weakly interned string is a system weak: its intern table entry must point to the string's
+// post-compaction address, and an unreachable one must be swept.
+TEST_F(MarkCompactTest, UpdatesSystemWeaks) {
+  TEST_DISABLED_WITHOUT_MARK_COMPACT();
+  Heap* heap = Runtime::Current()->GetHeap();
+  InternTable* intern_table = Runtime::Current()->GetInternTable();
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  // Garbage allocated first, so that the interned string moves.
+  for (size_t i = 0; i != 128; ++i) {
+    ASSERT_TRUE(mirror::String::AllocFromModifiedUtf8(self, "garbage garbage garbage") != nullptr);
+  }
+  Handle<mirror::String> kept(hs.NewHandle(intern_table->InternWeak("MarkCompactTest kept")));
+  ASSERT_TRUE(kept != nullptr);
+  ASSERT_TRUE(intern_table->InternWeak("MarkCompactTest dropped") != nullptr);
+  const uintptr_t old_address = reinterpret_cast<uintptr_t>(kept.Get());
+
+  heap->CollectGarbage(/* clear_soft_references= */ false);
+
+  EXPECT_NE(old_address, reinterpret_cast<uintptr_t>(kept.Get()));
+  EXPECT_EQ(kept.Get(), intern_table->LookupWeak(self, kept.Get()).Ptr());
+  EXPECT_EQ(kept.Get(), intern_table->InternWeak("MarkCompactTest kept").Ptr());
+  StackHandleScope<1> hs2(self);
+  Handle<mirror::String> dropped(
+      hs2.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "MarkCompactTest dropped")));
+  ASSERT_TRUE(dropped != nullptr);
+  EXPECT_TRUE(intern_table->LookupWeak(self, dropped.Get()) == nullptr);
+}
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
@@ -64,6 +64,8 @@ enum GcCause {
   kGcCauseProfileSaver,
   // GC cause for running an empty checkpoint.
   kGcCauseRunEmptyCheckpoint,
+  // Compaction to bring the resident set size of the process back under the RSS target.
+  kGcCauseRssTarget,
 };
 
 const char* PrettyCause(GcCause cause);
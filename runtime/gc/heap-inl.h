@@ -25,6 +25,7 @@
 #include "gc/accounting/atomic_stack.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/allocation_record.h"
+#include "gc/class_histogram.h"
 #include "gc/collector/semi_space.h"
 #include "gc/space/bump_pointer_space-inl.h"
 #include "gc/space/dlmalloc_space-inl.h"
@@ -216,6 +217,12 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
         need_gc = true;
       }
       GetMetrics()->TotalBytesAllocated()->Add(bytes_tl_bulk_allocated);
+      if (UNLIKELY(IsClassHistogramEnabled())) {
+        // The allocations that fit in the thread-local buffers of the thread do not come here with
+        // the uninstrumented entrypoints. Sample the allocations that refill the buffers instead.
+        self->GetClassHistogram()->RecordAllocation(
+            klass.Ptr(), bytes_allocated, bytes_tl_bulk_allocated);
+      }
     }
   }
   if (kIsDebugBuild && Runtime::Current()->IsStarted()) {
@@ -31,6 +31,7 @@
 #include <sys/types.h>
 #include <vector>
 
+#include "android-base/file.h"
 #include "android-base/stringprintf.h"
 
 #include "allocation_listener.h"
@@ -60,7 +61,9 @@
 #include "gc/accounting/read_barrier_table.h"
 #include "gc/accounting/remembered_set.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/class_histogram.h"
 #include "gc/collector/concurrent_copying.h"
+#include "gc/collector/mark_compact.h"
 #include "gc/collector/mark_sweep.h"
 #include "gc/collector/partial_mark_sweep.h"
 #include "gc/collector/semi_space.h"
@@ -265,6 +268,7 @@ Heap::Heap(size_t initial_size,
            double target_utilization,
            double foreground_heap_growth_multiplier,
            size_t stop_for_native_allocs,
+           size_t rss_target,
            size_t capacity,
            size_t non_moving_space_capacity,
            const std::vector<std::string>& boot_class_path,
@@ -281,6 +285,7 @@ Heap::Heap(size_t initial_size,
            size_t large_object_threshold,
            size_t parallel_gc_threads,
            size_t conc_gc_threads,
+           size_t concurrent_copying_mark_workers,
            bool low_memory_mode,
            size_t long_pause_log_threshold,
            size_t long_gc_log_threshold,
@@ -297,6 +302,7 @@ Heap::Heap(size_t initial_size,
            bool measure_gc_performance,
            bool use_homogeneous_space_compaction_for_oom,
            bool use_generational_cc,
+           size_t generational_cc_tenure_threshold,
            uint64_t min_interval_homogeneous_space_compaction_by_oom,
            bool dump_region_info_before_gc,
            bool dump_region_info_after_gc)
@@ -311,6 +317,7 @@ Heap::Heap(size_t initial_size,
       pending_task_lock_(nullptr),
       parallel_gc_threads_(parallel_gc_threads),
       conc_gc_threads_(conc_gc_threads),
+      concurrent_copying_mark_workers_(concurrent_copying_mark_workers),
       low_memory_mode_(low_memory_mode),
       long_pause_log_threshold_(long_pause_log_threshold),
       long_gc_log_threshold_(long_gc_log_threshold),
@@ -376,10 +383,15 @@ Heap::Heap(size_t initial_size,
       target_utilization_(target_utilization),
       foreground_heap_growth_multiplier_(foreground_heap_growth_multiplier),
       stop_for_native_allocs_(stop_for_native_allocs),
+      rss_target_(rss_target),
+      last_rss_check_time_ns_(NanoTime()),
+      last_rss_check_bytes_allocated_(0u),
+      last_rss_compaction_time_ns_(0u),
       total_wait_time_(0),
       verify_object_mode_(kVerifyObjectModeDisabled),
       disable_moving_gc_count_(0),
       semi_space_collector_(nullptr),
+      mark_compact_collector_(nullptr),
       active_concurrent_copying_collector_(nullptr),
       young_concurrent_copying_collector_(nullptr),
       concurrent_copying_collector_(nullptr),
@@ -393,6 +405,7 @@ Heap::Heap(size_t initial_size,
       max_gc_requested_(0u),
       pending_collector_transition_(nullptr),
       pending_heap_trim_(nullptr),
+      pending_rss_compaction_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       use_generational_cc_(use_generational_cc),
       running_collection_is_blocking_(false),
@@ -407,6 +420,7 @@ Heap::Heap(size_t initial_size,
                                         kGcCountRateMaxBucketCount),
       alloc_tracking_enabled_(false),
       alloc_record_depth_(AllocRecordObjectMap::kDefaultAllocStackDepth),
+      class_histogram_enabled_(false),
       backtrace_lock_(nullptr),
       seen_backtrace_count_(0u),
       unique_backtrace_count_(0u),
@@ -417,10 +431,16 @@ Heap::Heap(size_t initial_size,
       boot_image_spaces_(),
       boot_images_start_address_(0u),
       boot_images_size_(0u),
-      pre_oome_gc_count_(0u) {
+      pre_oome_gc_count_(0u),
+      tlab_refills_(0u),
+      tlab_bytes_(0u),
+      tlab_waste_bytes_(0u) {
   if (VLOG_IS_ON(heap) || VLOG_IS_ON(startup)) {
     LOG(INFO) << "Heap() entering";
   }
+  if (foreground_collector_type_ == kCollectorTypeMC) {
+    CHECK(kMarkCompactSupport) << "Mark compact requires a runtime built with ART_USE_MARK_COMPACT";
+  }
   if (kUseReadBarrier) {
     CHECK_EQ(foreground_collector_type_, kCollectorTypeCC);
     CHECK_EQ(background_collector_type_, kCollectorTypeCCBackground);
@@ -451,9 +471,11 @@ Heap::Heap(size_t initial_size,
   if (foreground_collector_type_ == kCollectorTypeCC) {
     use_homogeneous_space_compaction_for_oom_ = false;
   }
+  // Mark compact compacts in place and must not reserve a second main space.
   bool support_homogeneous_space_compaction =
-      background_collector_type_ == gc::kCollectorTypeHomogeneousSpaceCompact ||
-      use_homogeneous_space_compaction_for_oom_;
+      (background_collector_type_ == gc::kCollectorTypeHomogeneousSpaceCompact ||
+       use_homogeneous_space_compaction_for_oom_) &&
+      foreground_collector_type_ != kCollectorTypeMC;
   // We may use the same space the main space for the non moving space if we don't need to compact
   // from the main space.
   // This is not the case if we support homogeneous compaction or have a moving background
@@ -618,8 +640,10 @@ Heap::Heap(size_t initial_size,
     MemMap region_space_mem_map =
         space::RegionSpace::CreateMemMap(kRegionSpaceName, capacity_ * 2, request_begin);
     CHECK(region_space_mem_map.IsValid()) << "No region space mem map";
-    region_space_ = space::RegionSpace::Create(
-        kRegionSpaceName, std::move(region_space_mem_map), use_generational_cc_);
+    region_space_ = space::RegionSpace::Create(kRegionSpaceName,
+                                               std::move(region_space_mem_map),
+                                               use_generational_cc_,
+                                               generational_cc_tenure_threshold);
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_)) {
     // Create bump pointer spaces.
@@ -629,10 +653,13 @@ Heap::Heap(size_t initial_size,
                                                                     std::move(main_mem_map_1));
     CHECK(bump_pointer_space_ != nullptr) << "Failed to create bump pointer space";
     AddSpace(bump_pointer_space_);
-    temp_space_ = space::BumpPointerSpace::CreateFromMemMap("Bump pointer space 2",
-                                                            std::move(main_mem_map_2));
-    CHECK(temp_space_ != nullptr) << "Failed to create bump pointer space";
-    AddSpace(temp_space_);
+    // The second semi space is only needed by the semi-space collector.
+    if (main_mem_map_2.IsValid()) {
+      temp_space_ = space::BumpPointerSpace::CreateFromMemMap("Bump pointer space 2",
+                                                              std::move(main_mem_map_2));
+      CHECK(temp_space_ != nullptr) << "Failed to create bump pointer space";
+      AddSpace(temp_space_);
+    }
     CHECK(separate_non_moving_space);
   } else {
     CreateMainMallocSpace(std::move(main_mem_map_1), initial_size, growth_limit_, capacity_);
@@ -661,6 +688,10 @@ Heap::Heap(size_t initial_size,
   if (large_object_space_type == space::LargeObjectSpaceType::kFreeList) {
     large_object_space_ = space::FreeListSpace::Create("free list large object space", capacity_);
     CHECK(large_object_space_ != nullptr) << "Failed to create large object space";
+  } else if (large_object_space_type == space::LargeObjectSpaceType::kSegregatedFreeList) {
+    large_object_space_ = space::SegregatedFreeListSpace::Create(
+        "segregated free list large object space", capacity_);
+    CHECK(large_object_space_ != nullptr) << "Failed to create large object space";
   } else if (large_object_space_type == space::LargeObjectSpaceType::kMap) {
     large_object_space_ = space::LargeObjectMapSpace::Create("mem map large object space");
     CHECK(large_object_space_ != nullptr) << "Failed to create large object space";
@@ -758,6 +789,10 @@ Heap::Heap(size_t initial_size,
       semi_space_collector_ = new collector::SemiSpace(this);
       garbage_collectors_.push_back(semi_space_collector_);
     }
+    if (kMarkCompactSupport && MayUseCollector(kCollectorTypeMC)) {
+      mark_compact_collector_ = new collector::MarkCompact(this);
+      garbage_collectors_.push_back(mark_compact_collector_);
+    }
     if (MayUseCollector(kCollectorTypeCC)) {
       concurrent_copying_collector_ = new collector::ConcurrentCopying(this,
                                                                        /*young_gen=*/false,
@@ -1084,7 +1119,12 @@ void Heap::UpdateProcessState(ProcessState old_process_state, ProcessState new_p
 }
 
 void Heap::CreateThreadPool() {
-  const size_t num_threads = std::max(parallel_gc_threads_, conc_gc_threads_);
+  // The GC-running thread is one of the concurrent copying mark workers.
+  const size_t num_threads = std::max({parallel_gc_threads_,
+                                       conc_gc_threads_,
+                                       concurrent_copying_mark_workers_ > 0u
+                                           ? concurrent_copying_mark_workers_ - 1u
+                                           : 0u});
   if (num_threads != 0) {
     thread_pool_.reset(new ThreadPool("Heap thread pool", num_threads));
   }
@@ -1271,6 +1311,16 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
     rosalloc_space_->DumpStats(os);
   }
 
+  const uint64_t tlab_refills = tlab_refills_.load(std::memory_order_relaxed);
+  if (tlab_refills != 0u) {
+    const uint64_t tlab_bytes = tlab_bytes_.load(std::memory_order_relaxed);
+    const uint64_t tlab_waste_bytes = tlab_waste_bytes_.load(std::memory_order_relaxed);
+    os << "Total TLAB refills: " << tlab_refills
+       << " mean size: " << PrettySize(tlab_bytes / tlab_refills)
+       << " wasted: " << PrettySize(tlab_waste_bytes)
+       << " (" << (tlab_bytes != 0u ? tlab_waste_bytes * 100 / tlab_bytes : 0u) << "%)\n";
+  }
+
   os << "Native bytes total: " << GetNativeBytes()
      << " registered: " << native_bytes_registered_.load(std::memory_order_relaxed) << "\n";
 
@@ -1299,6 +1349,9 @@ void Heap::ResetGcPerformanceInfo() {
   blocking_gc_count_ = 0;
   blocking_gc_time_ = 0;
   pre_oome_gc_count_.store(0, std::memory_order_relaxed);
+  tlab_refills_.store(0u, std::memory_order_relaxed);
+  tlab_bytes_.store(0u, std::memory_order_relaxed);
+  tlab_waste_bytes_.store(0u, std::memory_order_relaxed);
   gc_count_last_window_ = 0;
   blocking_gc_count_last_window_ = 0;
   last_update_time_gc_count_rate_histograms_ =  // Round down by the window duration.
@@ -1607,6 +1660,9 @@ void Heap::TrimSpaces(Thread* self) {
       }
     }
   }
+  if (large_object_space_ != nullptr) {
+    managed_reclaimed += large_object_space_->ReleaseFreePages();
+  }
   total_alloc_space_allocated = GetBytesAllocated();
   if (large_object_space_ != nullptr) {
     total_alloc_space_allocated -= large_object_space_->GetBytesAllocated();
@@ -2199,7 +2255,8 @@ void Heap::ChangeCollector(CollectorType collector_type) {
         }
         break;
       }
-      case kCollectorTypeSS: {
+      case kCollectorTypeSS:
+      case kCollectorTypeMC: {
         gc_plan_.push_back(collector::kGcTypeFull);
         if (use_tlab_) {
           ChangeAllocator(kAllocatorTypeTLAB);
@@ -2710,6 +2767,10 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
         semi_space_collector_->SetSwapSemiSpaces(true);
         collector = semi_space_collector_;
         break;
+      case kCollectorTypeMC:
+        mark_compact_collector_->SetSpace(bump_pointer_space_);
+        collector = mark_compact_collector_;
+        break;
       case kCollectorTypeCC:
         collector::ConcurrentCopying* active_cc_collector;
         if (use_generational_cc_) {
@@ -2728,7 +2789,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
       default:
         LOG(FATAL) << "Invalid collector type " << static_cast<size_t>(collector_type_);
     }
-    if (collector != active_concurrent_copying_collector_.load(std::memory_order_relaxed)) {
+    if (collector == semi_space_collector_) {
       temp_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
       if (kIsDebugBuild) {
         // Try to read each page of the memory map in case mprotect didn't work properly b/19894268.
@@ -2748,7 +2809,11 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
       << static_cast<size_t>(collector_type_) << " and gc_type=" << gc_type;
   collector->Run(gc_cause, clear_soft_references || runtime->IsZygote());
   IncrementFreedEver();
-  RequestTrim(self);
+  if (rss_target_ != 0u) {
+    RequestRssTargetAction(self);
+  } else {
+    RequestTrim(self);
+  }
   // Collect cleared references.
   SelfDeletingTask* clear = reference_processor_->CollectClearedReferences(self);
   // Grow the heap so that we know when to perform the next GC.
@@ -3562,6 +3627,9 @@ void Heap::DumpForSigQuit(std::ostream& os) {
   os << "Heap: " << GetPercentFree() << "% free, " << PrettySize(GetBytesAllocated()) << "/"
      << PrettySize(GetTotalMemory()) << "; " << GetObjectsAllocated() << " objects\n";
   DumpGcPerformanceInfo(os);
+  if (class_histogram_ != nullptr) {
+    class_histogram_->Dump(os, kClassHistogramDumpSize);
+  }
 }
 
 size_t Heap::GetPercentFree() {
@@ -4027,6 +4095,133 @@ void Heap::RequestTrim(Thread* self) {
   task_processor_->AddTask(self, added_task);
 }
 
+// Returns the resident set size of the process in bytes, or 0 if it is not available.
+static size_t GetProcessRss() {
+  std::string statm;
+  if (!android::base::ReadFileToString("/proc/self/statm", &statm)) {
+    return 0u;
+  }
+  size_t resident_pages;
+  if (sscanf(statm.c_str(), "%*zu %zu", &resident_pages) != 1) {
+    return 0u;
+  }
+  return resident_pages * kPageSize;
+}
+
+class Heap::RssCompactionTask : public HeapTask {
+ public:
+  explicit RssCompactionTask(uint64_t target_time) : HeapTask(target_time) {}
+
+  void Run(Thread* self) override {
+    gc::Heap* heap = Runtime::Current()->GetHeap();
+    heap->DoRssCompaction();
+    heap->ClearPendingRssCompaction(self);
+  }
+};
+
+void Heap::ClearPendingRssCompaction(Thread* self) {
+  MutexLock mu(self, *pending_task_lock_);
+  pending_rss_compaction_ = nullptr;
+}
+
+size_t Heap::GetCompactableFragmentedBytes() {
+  if (collector_type_ == kCollectorTypeCC) {
+    // Full CC evacuates the regions that are not full of live objects.
+    const size_t region_bytes =
+        region_space_->GetNumNonFreeRegions() * space::RegionSpace::kRegionSize;
+    return UnsignedDifference(region_bytes, region_space_->GetBytesAllocated());
+  }
+  if (main_space_ != nullptr && main_space_backup_ != nullptr && main_space_->IsMallocSpace()) {
+    // Homogeneous space compaction packs the main space into the backup space. Asking the
+    // allocator for the bytes allocated in the main space would need to suspend the mutators with
+    // RosAlloc, so count everything but large objects as allocated in the main space. This
+    // underestimates the fragmentation when the non-moving space is used.
+    uint64_t bytes_allocated = GetBytesAllocated();
+    if (large_object_space_ != nullptr) {
+      bytes_allocated -= large_object_space_->GetBytesAllocated();
+    }
+    return UnsignedDifference(main_space_->AsMallocSpace()->GetFootprint(), bytes_allocated);
+  }
+  // The mark-compact and semi-space collectors leave no holes in the bump pointer space.
+  return 0u;
+}
+
+void Heap::RequestRssTargetAction(Thread* self) {
+  DCHECK_NE(rss_target_, 0u);
+  const size_t rss = GetProcessRss();
+  if (rss == 0u) {
+    RequestTrim(self);
+    return;
+  }
+  // The allocation rate since the previous GC, in bytes per second.
+  const uint64_t now = NanoTime();
+  const uint64_t bytes_allocated_ever = GetBytesAllocatedEver();
+  const double allocation_rate =
+      static_cast<double>(bytes_allocated_ever - last_rss_check_bytes_allocated_) * MsToNs(1000) /
+      std::max<uint64_t>(now - last_rss_check_time_ns_, 1u);
+  last_rss_check_time_ns_ = now;
+  last_rss_check_bytes_allocated_ = bytes_allocated_ever;
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  // No collector moves large objects, so the holes between them are reported but cannot be
+  // compacted away. A trim releases the free pages that they keep resident.
+  const size_t los_fragmented_bytes =
+      large_object_space_ != nullptr ? large_object_space_->GetFragmentedBytes() : 0u;
+  metrics->LargeObjectSpaceFragmentedBytesAvg()->Add(los_fragmented_bytes);
+  if (rss <= rss_target_) {
+    // Trimming would only cost time.
+    metrics->RssTargetNoActionCount()->Add(1);
+    return;
+  }
+  const size_t excess = rss - rss_target_;
+  const size_t fragmented_bytes = GetCompactableFragmentedBytes();
+  // Compact when that gives back a good part of the excess, and the mutators would not allocate
+  // the same amount again before the next compaction is allowed, in which case the regular GCs
+  // keep up and a compaction only adds a full GC.
+  const bool compact =
+      fragmented_bytes >= excess / 4 &&
+      now - last_rss_compaction_time_ns_ >= kMinRssCompactionInterval &&
+      allocation_rate * NsToMs(kMinRssCompactionInterval) / 1000 < fragmented_bytes;
+  VLOG(heap) << "RSS " << PrettySize(rss) << " over target " << PrettySize(rss_target_)
+             << ", fragmented " << PrettySize(fragmented_bytes) << " (large objects "
+             << PrettySize(los_fragmented_bytes) << "), allocating "
+             << PrettySize(static_cast<uint64_t>(allocation_rate)) << "/s: "
+             << (compact ? "compacting" : "trimming");
+  if (!compact) {
+    metrics->RssTargetTrimCount()->Add(1);
+    RequestTrim(self);
+    return;
+  }
+  if (!CanAddHeapTask(self)) {
+    return;
+  }
+  metrics->RssTargetCompactionCount()->Add(1);
+  last_rss_compaction_time_ns_ = now;
+  RssCompactionTask* added_task = nullptr;
+  {
+    MutexLock mu(self, *pending_task_lock_);
+    if (pending_rss_compaction_ != nullptr) {
+      return;
+    }
+    added_task = new RssCompactionTask(now);
+    pending_rss_compaction_ = added_task;
+  }
+  task_processor_->AddTask(self, added_task);
+}
+
+void Heap::DoRssCompaction() {
+  if (collector_type_ == kCollectorTypeCC) {
+    // A full CC with this cause evacuates every region, and only has short pauses.
+    CollectGarbageInternal(collector::kGcTypeFull,
+                           kGcCauseRssTarget,
+                           /*clear_soft_references=*/false,
+                           GC_NUM_ANY);
+  } else if (!CareAboutPauseTimes()) {
+    PerformHomogeneousSpaceCompact();
+  } else {
+    VLOG(gc) << "RSS target compaction ignored due to jank perceptible process state";
+  }
+}
+
 void Heap::IncrementNumberOfBytesFreedRevoke(size_t freed_bytes_revoke) {
   size_t previous_num_bytes_freed_revoke =
       num_bytes_freed_revoke_.fetch_add(freed_bytes_revoke, std::memory_order_relaxed);
@@ -4038,6 +4233,7 @@ void Heap::IncrementNumberOfBytesFreedRevoke(size_t freed_bytes_revoke) {
 }
 
 void Heap::RevokeThreadLocalBuffers(Thread* thread) {
+  FlushClassHistogram(thread);
   if (rosalloc_space_ != nullptr) {
     size_t freed_bytes_revoke = rosalloc_space_->RevokeThreadLocalBuffers(thread);
     if (freed_bytes_revoke > 0U) {
@@ -4053,6 +4249,7 @@ void Heap::RevokeThreadLocalBuffers(Thread* thread) {
 }
 
 void Heap::RevokeRosAllocThreadLocalBuffers(Thread* thread) {
+  FlushClassHistogram(thread);
   if (rosalloc_space_ != nullptr) {
     size_t freed_bytes_revoke = rosalloc_space_->RevokeThreadLocalBuffers(thread);
     if (freed_bytes_revoke > 0U) {
@@ -4062,6 +4259,12 @@ void Heap::RevokeRosAllocThreadLocalBuffers(Thread* thread) {
 }
 
 void Heap::RevokeAllThreadLocalBuffers() {
+  if (class_histogram_ != nullptr) {
+    MutexLock mu(Thread::Current(), *Locks::thread_list_lock_);
+    for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
+      FlushClassHistogram(thread);
+    }
+  }
   if (rosalloc_space_ != nullptr) {
     size_t freed_bytes_revoke = rosalloc_space_->RevokeAllThreadLocalBuffers();
     if (freed_bytes_revoke > 0U) {
@@ -4308,6 +4511,52 @@ void Heap::BroadcastForNewAllocationRecords() const {
   }
 }
 
+void Heap::SetClassHistogramEnabled(bool enabled) {
+  if (Runtime::Current()->IsStarted()) {
+    // Suspend all the threads so that none of them updates its counts while they are reset.
+    ScopedSuspendAll ssa(__FUNCTION__);
+    UpdateClassHistogramEnabled(enabled);
+  } else {
+    UpdateClassHistogramEnabled(enabled);
+  }
+}
+
+void Heap::UpdateClassHistogramEnabled(bool enabled) {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, *Locks::alloc_tracker_lock_);
+  if (IsClassHistogramEnabled() == enabled) {
+    return;
+  }
+  if (enabled) {
+    if (class_histogram_ == nullptr) {
+      class_histogram_.reset(new ClassHistogram());
+    } else {
+      class_histogram_->Clear();
+      // Drop the counts the threads recorded since the histogram was last enabled and did not
+      // flush, otherwise the next GC would add them to the cleared histogram.
+      MutexLock mu2(self, *Locks::thread_list_lock_);
+      for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
+        if (thread->HasClassHistogram()) {
+          thread->GetClassHistogram()->Reset();
+        }
+      }
+    }
+    LOG(INFO) << "Enabling class histogram";
+  } else {
+    LOG(INFO) << "Disabling class histogram";
+  }
+  class_histogram_enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Heap::FlushClassHistogram(Thread* thread) {
+  // Threads only have a table after the histogram was created, see SetClassHistogramEnabled().
+  if (thread->HasClassHistogram()) {
+    Locks::mutator_lock_->AssertSharedHeld(Thread::Current());
+    DCHECK(class_histogram_ != nullptr);
+    class_histogram_->Flush(thread->GetClassHistogram());
+  }
+}
+
 // Perfetto Java Heap Profiler Support.
 
 // Perfetto initialization.
@@ -4383,6 +4632,41 @@ void Heap::AdjustSampleOffset(size_t adjustment) {
   GetHeapSampler().AdjustSampleOffset(adjustment);
 }
 
+size_t Heap::GetAdaptiveTlabSize(Thread* self, size_t default_tlab_size) {
+  if (!kUseAdaptiveTlabSize) {
+    return default_tlab_size;
+  }
+  const uint32_t gc_num = GetCurrentGcNum();
+  if (self->GetTlabGcNum() != gc_num) {
+    // A GC completed since the last refill. Size the TLABs after the bytes this thread got in
+    // TLABs since the GC before that, and average with the previous size to damp spikes.
+    const size_t previous_size =
+        self->GetAdaptiveTlabSize() != 0u ? self->GetAdaptiveTlabSize() : default_tlab_size;
+    const size_t target_size = self->GetTlabBytesSinceGc() / kTargetTlabRefillsPerGc;
+    const size_t new_size = std::clamp(RoundUp((previous_size + target_size) / 2, kPageSize),
+                                       kMinAdaptiveTlabSize,
+                                       kMaxAdaptiveTlabSize);
+    self->SetAdaptiveTlabSize(new_size);
+    self->ResetTlabBytesSinceGc(gc_num);
+  }
+  return self->GetAdaptiveTlabSize() != 0u ? self->GetAdaptiveTlabSize() : default_tlab_size;
+}
+
+size_t Heap::GetTlabSize(Thread* self, size_t default_tlab_size) {
+  const size_t tlab_size = GetAdaptiveTlabSize(self, default_tlab_size);
+  if (UNLIKELY(IsClassHistogramEnabled())) {
+    // Refill often enough for the samples of the class histogram to be representative.
+    return std::min(tlab_size, kClassHistogramMaxTlabSize);
+  }
+  return tlab_size;
+}
+
+void Heap::RecordTlabRefill(Thread* self, size_t bytes) {
+  self->AddTlabBytesSinceGc(bytes);
+  tlab_refills_.fetch_add(1u, std::memory_order_relaxed);
+  tlab_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
 void Heap::CheckGcStressMode(Thread* self, ObjPtr<mirror::Object>* obj) {
   DCHECK(gc_stress_mode_);
   auto* const runtime = Runtime::Current();
@@ -4479,7 +4763,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     // TLAB bytes.
     const size_t min_expand_size = alloc_size - self->TlabSize();
     size_t next_tlab_size = JHPCalculateNextTlabSize(self,
-                                                     kPartialTlabSize,
+                                                     GetTlabSize(self, kPartialTlabSize),
                                                      alloc_size,
                                                      &take_sample,
                                                      &bytes_until_sample);
@@ -4491,11 +4775,12 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     }
     *bytes_tl_bulk_allocated = expand_bytes;
     self->ExpandTlab(expand_bytes);
+    RecordTlabRefill(self, expand_bytes);
     DCHECK_LE(alloc_size, self->TlabSize());
   } else if (allocator_type == kAllocatorTypeTLAB) {
     DCHECK(bump_pointer_space_ != nullptr);
     size_t next_tlab_size = JHPCalculateNextTlabSize(self,
-                                                     kDefaultTLABSize,
+                                                     GetTlabSize(self, kDefaultTLABSize),
                                                      alloc_size,
                                                      &take_sample,
                                                      &bytes_until_sample);
@@ -4509,6 +4794,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
       return nullptr;
     }
     *bytes_tl_bulk_allocated = new_tlab_size;
+    RecordTlabRefill(self, new_tlab_size);
     if (CheckPerfettoJHPEnabled()) {
       VLOG(heap) << "JHP:kAllocatorTypeTLAB, New Tlab bytes allocated= " << new_tlab_size;
     }
@@ -4521,7 +4807,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                             space::RegionSpace::kRegionSize,
                                             grow))) {
         size_t def_pr_tlab_size = kUsePartialTlabs
-                                      ? kPartialTlabSize
+                                      ? GetTlabSize(self, kPartialTlabSize)
                                       : gc::space::RegionSpace::kRegionSize;
         size_t next_pr_tlab_size = JHPCalculateNextTlabSize(self,
                                                             def_pr_tlab_size,
@@ -4541,6 +4827,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
           JHPCheckNonTlabSampleAllocation(self, ret, alloc_size);
           return ret;
         }
+        RecordTlabRefill(self, new_tlab_size);
         // Fall-through to using the TLAB below.
       } else {
         // Check OOME for a non-tlab allocation.
@@ -68,6 +68,7 @@ namespace gc {
 
 class AllocationListener;
 class AllocRecordObjectMap;
+class ClassHistogram;
 class GcPauseListener;
 class HeapTask;
 class ReferenceProcessor;
@@ -87,6 +88,7 @@ class RememberedSet;
 namespace collector {
 class ConcurrentCopying;
 class GarbageCollector;
+class MarkCompact;
 class MarkSweep;
 class SemiSpace;
 }  // namespace collector
@@ -132,6 +134,12 @@ class Heap {
   // How much we grow the TLAB if we can do it.
   static constexpr size_t kPartialTlabSize = 16 * KB;
   static constexpr bool kUsePartialTlabs = true;
+  // If true, the size of the TLABs of a thread adapts to how much the thread allocated between the
+  // two previous GCs, so that a thread refills about kTargetTlabRefillsPerGc times per GC cycle.
+  static constexpr bool kUseAdaptiveTlabSize = true;
+  static constexpr size_t kTargetTlabRefillsPerGc = 32;
+  static constexpr size_t kMinAdaptiveTlabSize = 4 * KB;
+  static constexpr size_t kMaxAdaptiveTlabSize = 256 * KB;
 
   static constexpr size_t kDefaultStartingSize = kPageSize;
   static constexpr size_t kDefaultInitialSize = 2 * MB;
@@ -151,6 +159,9 @@ class Heap {
   static constexpr size_t kDefaultLargeObjectThreshold = kMinLargeObjectThreshold;
   // Whether or not parallel GC is enabled. If not, then we never create the thread pool.
   static constexpr bool kDefaultEnableParallelGC = false;
+  // Number of young collections an object has to survive before being promoted by generational
+  // CC. The default promotes survivors of the first young collection.
+  static constexpr size_t kDefaultGenerationalCCTenureThreshold = 1;
   static uint8_t* const kPreferredAllocSpaceBegin;
 
   // Whether or not we use the free list large object space. Only use it if USE_ART_LOW_4G_ALLOCATOR
@@ -183,6 +194,12 @@ class Heap {
   static constexpr uint64_t kHeapTrimWait = MsToNs(5000);
   // How long we wait after a transition request to perform a collector transition (nanoseconds).
   static constexpr uint64_t kCollectorTransitionWait = MsToNs(5000);
+  // Shortest interval between two compactions requested to meet the RSS target (nanoseconds).
+  static constexpr uint64_t kMinRssCompactionInterval = MsToNs(30000);
+  // The number of classes of the class histogram printed on SIGQUIT.
+  static constexpr size_t kClassHistogramDumpSize = 20;
+  // The largest TLAB while the class histogram is enabled, since it samples the TLAB refills.
+  static constexpr size_t kClassHistogramMaxTlabSize = 16 * KB;
   // Whether the transition-wait applies or not. Zero wait will stress the
   // transition code and collector, but increases jank probability.
   DECLARE_RUNTIME_DEBUG_FLAG(kStressCollectorTransition);
@@ -197,6 +214,7 @@ class Heap {
        double target_utilization,
        double foreground_heap_growth_multiplier,
        size_t stop_for_native_allocs,
+       size_t rss_target,
        size_t capacity,
        size_t non_moving_space_capacity,
        const std::vector<std::string>& boot_class_path,
@@ -213,6 +231,7 @@ class Heap {
        size_t large_object_threshold,
        size_t parallel_gc_threads,
        size_t conc_gc_threads,
+       size_t concurrent_copying_mark_workers,
        bool low_memory_mode,
        size_t long_pause_threshold,
        size_t long_gc_threshold,
@@ -229,6 +248,7 @@ class Heap {
        bool measure_gc_performance,
        bool use_homogeneous_space_compaction,
        bool use_generational_cc,
+       size_t generational_cc_tenure_threshold,
        uint64_t min_interval_homogeneous_space_compaction_by_oom,
        bool dump_region_info_before_gc,
        bool dump_region_info_after_gc);
@@ -641,6 +661,7 @@ class Heap {
   // Deflate monitors, ... and trim the spaces.
   void Trim(Thread* self) REQUIRES(!*gc_complete_lock_);
 
+  // Revoking the thread-local buffers also flushes the class histogram counts of the threads.
   void RevokeThreadLocalBuffers(Thread* thread);
   void RevokeRosAllocThreadLocalBuffers(Thread* thread);
   void RevokeAllThreadLocalBuffers();
@@ -772,6 +793,9 @@ class Heap {
   size_t GetConcGCThreadCount() const {
     return conc_gc_threads_;
   }
+  size_t GetConcurrentCopyingMarkWorkers() const {
+    return concurrent_copying_mark_workers_;
+  }
   accounting::ModUnionTable* FindModUnionTableFromSpace(space::Space* space);
   void AddModUnionTable(accounting::ModUnionTable* mod_union_table);
 
@@ -816,6 +840,12 @@ class Heap {
     return collector_type_;
   }
 
+  // Whether the mark-compact collector is in use. While it sweeps the system weaks, it returns
+  // post-compaction addresses which the objects have not been moved to yet.
+  bool IsUsingMarkCompact() const {
+    return kMarkCompactSupport && collector_type_ == kCollectorTypeMC;
+  }
+
   bool IsGcConcurrentAndMoving() const {
     if (IsGcConcurrent() && IsMovingGc(collector_type_)) {
       // Assume no transition when a concurrent moving collector is used.
@@ -892,6 +922,18 @@ class Heap {
   // Reduce the number of bytes to the next sample position by this adjustment.
   void AdjustSampleOffset(size_t adjustment);
 
+  // Returns the size of the next TLAB of the thread, given the default size of the allocator.
+  size_t GetAdaptiveTlabSize(Thread* self, size_t default_tlab_size);
+  // Same as above, but no larger than kClassHistogramMaxTlabSize when the class histogram is
+  // enabled.
+  size_t GetTlabSize(Thread* self, size_t default_tlab_size);
+  // Records that the thread got a new TLAB or expanded its TLAB by the given number of bytes.
+  void RecordTlabRefill(Thread* self, size_t bytes);
+  // Records the bytes of a retired TLAB which were counted as allocated but never used.
+  void RecordTlabWaste(size_t bytes) {
+    tlab_waste_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
   // Allocation tracking support
   // Callers to this function use double-checked locking to ensure safety on allocation_records_
   bool IsAllocTrackingEnabled() const {
@@ -938,6 +980,29 @@ class Heap {
   void BroadcastForNewAllocationRecords() const
       REQUIRES(!Locks::alloc_tracker_lock_);
 
+  // Per-class allocation and survival histogram support. Much cheaper than allocation tracking:
+  // the allocation entrypoints are not instrumented, and threads only count the allocations that
+  // refill their thread-local buffers, weighted by the refilled bytes, in a table keyed by class.
+  // The GC flushes the tables into the ClassHistogram when it revokes the thread-local buffers.
+  bool IsClassHistogramEnabled() const {
+    return class_histogram_enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Enabling the class histogram clears it, along with the counts the threads did not flush yet.
+  // The counts remain available after it is disabled.
+  void SetClassHistogramEnabled(bool enabled)
+      REQUIRES(!Locks::alloc_tracker_lock_, !Locks::thread_list_lock_);
+
+  // Returns null if the class histogram was never enabled. The histogram is never deleted once
+  // created.
+  ClassHistogram* GetClassHistogram() const {
+    return class_histogram_.get();
+  }
+
+  // Adds the class histogram counts of `thread`, which must be the current thread or suspended, to
+  // the class histogram. Must be called before the classes the thread counted may move.
+  void FlushClassHistogram(Thread* thread) NO_THREAD_SAFETY_ANALYSIS;
+
   void DisableGCForShutdown() REQUIRES(!*gc_complete_lock_);
 
   // Create a new alloc space and compact default alloc space to it.
@@ -973,9 +1038,15 @@ class Heap {
   class ConcurrentGCTask;
   class CollectorTransitionTask;
   class HeapTrimTask;
+  class RssCompactionTask;
   class TriggerPostForkCCGcTask;
   class ReduceTargetFootprintTask;
 
+  // Helper for SetClassHistogramEnabled(). The other threads must be suspended, or the runtime not
+  // started yet.
+  void UpdateClassHistogramEnabled(bool enabled)
+      REQUIRES(!Locks::alloc_tracker_lock_, !Locks::thread_list_lock_);
+
   // Compact source space to target space. Returns the collector used.
   collector::GarbageCollector* Compact(space::ContinuousMemMapAllocSpace* target_space,
                                        space::ContinuousMemMapAllocSpace* source_space,
@@ -1032,6 +1103,7 @@ class Heap {
     return
         collector_type == kCollectorTypeCC ||
         collector_type == kCollectorTypeSS ||
+        collector_type == kCollectorTypeMC ||
         collector_type == kCollectorTypeCCBackground ||
         collector_type == kCollectorTypeHomogeneousSpaceCompact;
   }
@@ -1218,6 +1290,18 @@ class Heap {
 
   void ClearPendingTrim(Thread* self) REQUIRES(!*pending_task_lock_);
   void ClearPendingCollectorTransition(Thread* self) REQUIRES(!*pending_task_lock_);
+  void ClearPendingRssCompaction(Thread* self) REQUIRES(!*pending_task_lock_);
+
+  // Called instead of RequestTrim at the end of a GC when there is an RSS target. Decides from the
+  // RSS of the process, the fragmentation of the compactable space and the allocation rate
+  // whether to request a compaction, a trim, or nothing.
+  void RequestRssTargetAction(Thread* self) REQUIRES(!*pending_task_lock_);
+  // Returns how many bytes a compaction would give back in the space that the current collector
+  // compacts, which is 0 if it does not compact.
+  size_t GetCompactableFragmentedBytes();
+  // Compacts the heap for the RSS target, run from a RssCompactionTask.
+  void DoRssCompaction()
+      REQUIRES(!*gc_complete_lock_, !*pending_task_lock_, !process_state_update_lock_);
 
   // What kind of concurrency behavior is the runtime after? Currently true for concurrent mark
   // sweep GC, false for other GC types.
@@ -1341,6 +1425,10 @@ class Heap {
   // How many GC threads we may use for unpaused parts of garbage collection.
   const size_t conc_gc_threads_;
 
+  // How many threads, including the GC-running thread, the concurrent copying collector may use
+  // to process its mark stack.
+  const size_t concurrent_copying_mark_workers_;
+
   // Boolean for if we are in low memory mode.
   const bool low_memory_mode_;
 
@@ -1577,6 +1665,13 @@ class Heap {
   // succession. (b/122099093) 1/4 to 1/3 of physical memory seems to be a good number.
   const size_t stop_for_native_allocs_;
 
+  // Resident set size that the process should stay under, 0 if there is none.
+  const size_t rss_target_;
+  // State of RequestRssTargetAction. Only used by the GC-running thread.
+  uint64_t last_rss_check_time_ns_;
+  uint64_t last_rss_check_bytes_allocated_;
+  uint64_t last_rss_compaction_time_ns_;
+
   // Total time which mutators are paused or waiting for GC to complete.
   uint64_t total_wait_time_;
 
@@ -1588,6 +1683,7 @@ class Heap {
 
   std::vector<collector::GarbageCollector*> garbage_collectors_;
   collector::SemiSpace* semi_space_collector_;
+  collector::MarkCompact* mark_compact_collector_;
   Atomic<collector::ConcurrentCopying*> active_concurrent_copying_collector_;
   collector::ConcurrentCopying* young_concurrent_copying_collector_;
   collector::ConcurrentCopying* concurrent_copying_collector_;
@@ -1631,6 +1727,7 @@ class Heap {
   // Active tasks which we can modify (change target time, desired collector type, etc..).
   CollectorTransitionTask* pending_collector_transition_ GUARDED_BY(pending_task_lock_);
   HeapTrimTask* pending_heap_trim_ GUARDED_BY(pending_task_lock_);
+  RssCompactionTask* pending_rss_compaction_ GUARDED_BY(pending_task_lock_);
 
   // Whether or not we use homogeneous space compaction to avoid OOM errors.
   bool use_homogeneous_space_compaction_for_oom_;
@@ -1669,6 +1766,10 @@ class Heap {
   std::unique_ptr<AllocRecordObjectMap> allocation_records_;
   size_t alloc_record_depth_;
 
+  // Class histogram support. class_histogram_ is created under the alloc_tracker_lock_.
+  Atomic<bool> class_histogram_enabled_;
+  std::unique_ptr<ClassHistogram> class_histogram_;
+
   // Perfetto Java Heap Profiler support.
   HeapSampler heap_sampler_;
 
@@ -1702,6 +1803,12 @@ class Heap {
   // The number of times we initiated a GC of last resort to try to avoid an OOME.
   Atomic<uint64_t> pre_oome_gc_count_;
 
+  // TLAB statistics: the number of TLAB refills and expansions, the bytes they handed out, and
+  // the bytes of retired TLABs which were never used.
+  Atomic<uint64_t> tlab_refills_;
+  Atomic<uint64_t> tlab_bytes_;
+  Atomic<uint64_t> tlab_waste_bytes_;
+
   // An installed allocation listener.
   Atomic<AllocationListener*> alloc_listener_;
   // An installed GC Pause listener.
@@ -1715,6 +1822,7 @@ class Heap {
   friend class collector::MarkSweep;
   friend class collector::SemiSpace;
   friend class GCCriticalSection;
+  friend class GenerationalCCHeapTest;  // For running young collections.
   friend class ReferenceQueue;
   friend class ScopedGCCriticalSection;
   friend class ScopedInterruptibleGCCriticalSection;
@@ -18,11 +18,14 @@
 #include "common_runtime_test.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/collector/concurrent_copying.h"
+#include "gc/space/region_space.h"
 #include "handle_scope-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-alloc-inl.h"
 #include "mirror/object_array-inl.h"
+#include "mirror/string-inl.h"
 #include "scoped_thread_state_change-inl.h"
 
 namespace art {
@@ -99,6 +102,259 @@ TEST_F(HeapTest, DumpGCPerformanceOnShutdown) {
   Runtime::Current()->SetDumpGCPerformanceOnShutdown(true);
 }
 
+TEST_F(HeapTest, AdaptiveTlabSize) {
+  if (!Heap::kUseAdaptiveTlabSize) {
+    printf("WARNING: TEST DISABLED WITHOUT ADAPTIVE TLAB SIZES\n");
+    return;
+  }
+  Heap* heap = Runtime::Current()->GetHeap();
+  Thread* self = Thread::Current();
+  // Makes the next call to GetAdaptiveTlabSize see a completed GC, after which the thread got
+  // `bytes` in TLABs.
+  auto complete_gc = [&](size_t bytes) {
+    self->ResetTlabBytesSinceGc(heap->GetCurrentGcNum() - 1u);
+    heap->RecordTlabRefill(self, bytes);
+  };
+  self->SetAdaptiveTlabSize(0u);
+  self->ResetTlabBytesSinceGc(heap->GetCurrentGcNum());
+  EXPECT_EQ(Heap::kPartialTlabSize, heap->GetAdaptiveTlabSize(self, Heap::kPartialTlabSize));
+
+  // A thread that allocates heavily gets the largest TLABs, which stay until the next GC.
+  complete_gc(Heap::kTargetTlabRefillsPerGc * MB);
+  EXPECT_EQ(Heap::kMaxAdaptiveTlabSize, heap->GetAdaptiveTlabSize(self, Heap::kPartialTlabSize));
+  heap->RecordTlabRefill(self, Heap::kMaxAdaptiveTlabSize);
+  EXPECT_EQ(Heap::kMaxAdaptiveTlabSize, heap->GetAdaptiveTlabSize(self, Heap::kPartialTlabSize));
+
+  // A thread that stops allocating shrinks its TLABs by half per GC, down to the smallest.
+  complete_gc(0u);
+  EXPECT_EQ(Heap::kMaxAdaptiveTlabSize / 2,
+            heap->GetAdaptiveTlabSize(self, Heap::kPartialTlabSize));
+  for (size_t i = 0; i < 8; ++i) {
+    complete_gc(0u);
+    heap->GetAdaptiveTlabSize(self, Heap::kPartialTlabSize);
+  }
+  EXPECT_EQ(RoundUp(Heap::kMinAdaptiveTlabSize, kPageSize),
+            heap->GetAdaptiveTlabSize(self, Heap::kPartialTlabSize));
+
+  // A steady allocation rate converges to kTargetTlabRefillsPerGc refills per GC.
+  for (size_t i = 0; i < 16; ++i) {
+    complete_gc(Heap::kTargetTlabRefillsPerGc * 64 * KB);
+    heap->GetAdaptiveTlabSize(self, Heap::kPartialTlabSize);
+  }
+  EXPECT_EQ(64 * KB, heap->GetAdaptiveTlabSize(self, Heap::kPartialTlabSize));
+}
+
+TEST_F(HeapTest, AdaptiveTlabSizeFollowsAllocations) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  if (!Heap::kUseAdaptiveTlabSize || heap->GetCurrentAllocator() != kAllocatorTypeRegionTLAB) {
+    printf("WARNING: TEST DISABLED WITHOUT ADAPTIVE REGION TLABS\n");
+    return;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::Class> array_class(
+      hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "[Ljava/lang/Object;")));
+  // Allocates about `bytes` in small arrays, which all come from TLABs.
+  auto allocate = [&](size_t bytes) REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (size_t allocated = 0; allocated < bytes;) {
+      ObjPtr<mirror::ObjectArray<mirror::Object>> array =
+          mirror::ObjectArray<mirror::Object>::Alloc(soa.Self(), array_class.Get(), 256);
+      ASSERT_TRUE(array != nullptr);
+      allocated += array->SizeOf();
+    }
+  };
+  soa.Self()->SetAdaptiveTlabSize(0u);
+  // Start counting from the next GC, then allocate enough for TLABs larger than the default.
+  {
+    ScopedThreadSuspension sts(soa.Self(), ThreadState::kNative);
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+  }
+  allocate(Heap::kPartialTlabSize);
+  allocate(4 * MB);
+  {
+    ScopedThreadSuspension sts(soa.Self(), ThreadState::kNative);
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+  }
+  // The first refill after the GC resizes the TLABs.
+  allocate(Heap::kPartialTlabSize);
+  EXPECT_GT(soa.Self()->GetAdaptiveTlabSize(), Heap::kPartialTlabSize);
+  EXPECT_LE(soa.Self()->GetAdaptiveTlabSize(), Heap::kMaxAdaptiveTlabSize);
+  EXPECT_EQ(heap->GetCurrentGcNum(), soa.Self()->GetTlabGcNum());
+
+  std::ostringstream oss;
+  heap->DumpGcPerformanceInfo(oss);
+  EXPECT_NE(std::string::npos, oss.str().find("Total TLAB refills: ")) << oss.str();
+}
+
+class ParallelMarkingHeapTest : public HeapTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    HeapTest::SetUpRuntimeOptions(options);
+    // Three heap thread pool threads, which mark along with the GC-running thread.
+    options->push_back(std::make_pair("-XX:ParallelGCThreads=3", nullptr));
+  }
+
+  static constexpr size_t kFanOut = 16;
+  static constexpr size_t kDepth = 2;
+
+  // Allocates a tree of object arrays with `depth` levels of kFanOut children under `root`, with
+  // strings as leaves.
+  void FillTree(Handle<mirror::Class> array_class,
+                Handle<mirror::ObjectArray<mirror::Object>> root,
+                size_t depth) REQUIRES_SHARED(Locks::mutator_lock_) {
+    Thread* self = Thread::Current();
+    for (size_t i = 0; i < kFanOut; ++i) {
+      if (depth == 1u) {
+        root->Set<false>(i, mirror::String::AllocFromModifiedUtf8(self, "leaf"));
+        continue;
+      }
+      StackHandleScope<1> hs(self);
+      Handle<mirror::ObjectArray<mirror::Object>> child(hs.NewHandle(
+          mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kFanOut)));
+      ASSERT_TRUE(child != nullptr);
+      root->Set<false>(i, child.Get());
+      FillTree(array_class, child, depth - 1u);
+    }
+  }
+
+  // Returns the number of leaves of the tree under `root` which are still intact.
+  size_t CountLeaves(ObjPtr<mirror::ObjectArray<mirror::Object>> root, size_t depth)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    size_t count = 0u;
+    for (size_t i = 0; i < kFanOut; ++i) {
+      ObjPtr<mirror::Object> child = root->Get(i);
+      if (depth == 1u) {
+        if (child != nullptr && child->IsString() &&
+            child->AsString()->ToModifiedUtf8() == "leaf") {
+          ++count;
+        }
+      } else if (child != nullptr && child->IsObjectArray()) {
+        count += CountLeaves(child->AsObjectArray<mirror::Object>(), depth - 1u);
+      }
+    }
+    return count;
+  }
+};
+
+TEST_F(ParallelMarkingHeapTest, ConcurrentCopyingMarksWithWorkers) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  if (heap->CurrentCollectorType() != kCollectorTypeCC) {
+    printf("WARNING: TEST DISABLED WITHOUT THE CONCURRENT COPYING COLLECTOR\n");
+    return;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<3> hs(soa.Self());
+  Handle<mirror::Class> array_class(
+      hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "[Ljava/lang/Object;")));
+  // Scanning the array of trees fills the GC mark stack enough to hand it to the mark workers,
+  // which then have more references on their stacks than they need to share some.
+  static constexpr size_t kNumTrees = 256;
+  Handle<mirror::ObjectArray<mirror::Object>> roots(hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(soa.Self(), array_class.Get(), kNumTrees)));
+  ASSERT_TRUE(roots != nullptr);
+  MutableHandle<mirror::ObjectArray<mirror::Object>> tree(
+      hs.NewHandle<mirror::ObjectArray<mirror::Object>>(nullptr));
+  for (size_t i = 0; i < kNumTrees; ++i) {
+    tree.Assign(mirror::ObjectArray<mirror::Object>::Alloc(soa.Self(), array_class.Get(), kFanOut));
+    ASSERT_TRUE(tree != nullptr);
+    roots->Set<false>(i, tree.Get());
+    FillTree(array_class, tree, kDepth);
+  }
+
+  {
+    ScopedThreadSuspension sts(soa.Self(), ThreadState::kNative);
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+  }
+
+  collector::ConcurrentCopying* collector = heap->ConcurrentCopyingCollector();
+  ASSERT_EQ(4u, collector->GetNumMarkWorkers());
+  EXPECT_GT(collector->GetParallelMarkCount(), 0u);
+  size_t num_workers_with_work = 0u;
+  for (size_t i = 0; i < collector->GetNumMarkWorkers(); ++i) {
+    if (collector->GetMarkWorkerObjectsProcessed(i) != 0u) {
+      ++num_workers_with_work;
+    }
+  }
+  EXPECT_GT(num_workers_with_work, 1u);
+  // Every object reached by a worker was copied and scanned exactly once.
+  size_t expected_leaves = 1u;
+  for (size_t i = 0; i < kDepth; ++i) {
+    expected_leaves *= kFanOut;
+  }
+  for (size_t i = 0; i < kNumTrees; ++i) {
+    ObjPtr<mirror::Object> root = roots->Get(i);
+    ASSERT_TRUE(root != nullptr && root->IsObjectArray());
+    EXPECT_EQ(expected_leaves, CountLeaves(root->AsObjectArray<mirror::Object>(), kDepth));
+  }
+}
+
+class GenerationalCCHeapTest : public HeapTest {
+ protected:
+  static constexpr size_t kTenureThreshold = 3;
+
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    HeapTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:GenerationalCCTenureThreshold=3", nullptr));
+  }
+
+  static void CollectGarbage(collector::GcType gc_type) {
+    ScopedThreadSuspension sts(Thread::Current(), ThreadState::kNative);
+    Heap* heap = Runtime::Current()->GetHeap();
+    ASSERT_EQ(gc_type,
+              heap->CollectGarbageInternal(gc_type,
+                                           kGcCauseExplicit,
+                                           /* clear_soft_references= */ false,
+                                           Heap::GC_NUM_ANY));
+  }
+};
+
+TEST_F(GenerationalCCHeapTest, TenuresSurvivorsAtThreshold) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  if (heap->CurrentCollectorType() != kCollectorTypeCC || !heap->GetUseGenerationalCC()) {
+    printf("WARNING: TEST DISABLED WITHOUT THE GENERATIONAL CONCURRENT COPYING COLLECTOR\n");
+    return;
+  }
+  space::RegionSpace* region_space = heap->GetRegionSpace();
+  ASSERT_EQ(kTenureThreshold, region_space->GetTenureThreshold());
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::String> object(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "survivor")));
+  ASSERT_TRUE(object != nullptr);
+  ASSERT_TRUE(region_space->HasAddress(object.Get()));
+  EXPECT_FALSE(region_space->IsInSurvivorRegion(object.Get()));
+
+  // Each young collection copies the object to a survivor region one age older, until it reaches
+  // the threshold and is copied to a tenured region.
+  for (size_t age = 1u; age < kTenureThreshold; ++age) {
+    CollectGarbage(collector::kGcTypeSticky);
+    EXPECT_TRUE(region_space->IsInSurvivorRegion(object.Get()));
+    EXPECT_EQ(age, region_space->GetRegionAge(object.Get()));
+    EXPECT_EQ("survivor", object->ToModifiedUtf8());
+  }
+  CollectGarbage(collector::kGcTypeSticky);
+  ASSERT_TRUE(region_space->HasAddress(object.Get()));
+  EXPECT_FALSE(region_space->IsInSurvivorRegion(object.Get()));
+  EXPECT_EQ(0u, region_space->GetRegionAge(object.Get()));
+  EXPECT_EQ("survivor", object->ToModifiedUtf8());
+
+  // Young collections leave tenured objects in place.
+  mirror::String* tenured_address = object.Get();
+  CollectGarbage(collector::kGcTypeSticky);
+  EXPECT_EQ(tenured_address, object.Get());
+
+  // A full collection tenures survivors of any age.
+  Handle<mirror::String> young_object(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "young")));
+  ASSERT_TRUE(young_object != nullptr);
+  CollectGarbage(collector::kGcTypeSticky);
+  EXPECT_TRUE(region_space->IsInSurvivorRegion(young_object.Get()));
+  CollectGarbage(collector::kGcTypeFull);
+  EXPECT_FALSE(region_space->IsInSurvivorRegion(young_object.Get()));
+  EXPECT_EQ("young", young_object->ToModifiedUtf8());
+  EXPECT_EQ("survivor", object->ToModifiedUtf8());
+}
+
 class ZygoteHeapTest : public CommonRuntimeTest {
   void SetUpRuntimeOptions(RuntimeOptions* options) override {
     CommonRuntimeTest::SetUpRuntimeOptions(options);
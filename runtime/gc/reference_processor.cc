@@ -16,6 +16,10 @@
 
 #include "reference_processor.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "art_field-inl.h"
 #include "base/mutex.h"
 #include "base/time_utils.h"
@@ -41,6 +45,10 @@ namespace gc {
 
 static constexpr bool kAsyncReferenceQueueAdd = false;
 
+// Number of references cleared by one heap thread pool task. Queues no longer than this are
+// cleared by the GC thread alone.
+static constexpr size_t kReferenceShardSize = 4 * KB;
+
 ReferenceProcessor::ReferenceProcessor()
     : collector_(nullptr),
       condition_("reference processor condition", *Locks::reference_processor_lock_) ,
@@ -230,8 +238,8 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   }
   // Clear all remaining soft and weak references with white referents.
   // This misses references only reachable through finalizers.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
+  ClearWhiteReferences(self, &soft_reference_queue_, timings);
+  ClearWhiteReferences(self, &weak_reference_queue_, timings);
   // Defer PhantomReference processing until we've finished marking through finalizers.
   {
     // TODO: Capture mark state of some system weaks here. If the referent was marked here,
@@ -291,7 +299,7 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
                                              /*report_cleared=*/ true);
 
   // Clear all phantom references with white referents. It's fine to do this just once here.
-  phantom_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
+  ClearWhiteReferences(self, &phantom_reference_queue_, timings);
 
   // At this point all reference queues other than the cleared references should be empty.
   DCHECK(soft_reference_queue_.IsEmpty());
@@ -312,6 +320,71 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   }
 }
 
+// Clears the white referents of one shard of a reference queue on a heap thread pool thread (or
+// on the GC-running thread, which also picks up tasks while waiting for the thread pool).
+class ClearWhiteReferencesTask : public SelfDeletingTask {
+ public:
+  ClearWhiteReferencesTask(ReferenceQueue* shard,
+                           ReferenceQueue* cleared_references,
+                           collector::GarbageCollector* collector)
+      : shard_(shard), cleared_references_(cleared_references), collector_(collector) {}
+
+  // No thread safety analysis since the GC-running thread holds the mutator lock on behalf of the
+  // workers while they run.
+  void Run(Thread* self ATTRIBUTE_UNUSED) override NO_THREAD_SAFETY_ANALYSIS {
+    shard_->ClearWhiteReferences(cleared_references_, collector_);
+  }
+
+ private:
+  ReferenceQueue* const shard_;
+  ReferenceQueue* const cleared_references_;
+  collector::GarbageCollector* const collector_;
+};
+
+void ReferenceProcessor::ClearWhiteReferences(Thread* self,
+                                              ReferenceQueue* queue,
+                                              TimingLogger* timings) {
+  ThreadPool* const thread_pool = Runtime::Current()->GetHeap()->GetThreadPool();
+  if (queue->IsEmpty() ||
+      thread_pool == nullptr ||
+      thread_pool->GetThreadCount() == 0u ||
+      collector_->IsTransactionActive()) {
+    queue->ClearWhiteReferences(&cleared_references_, collector_);
+    return;
+  }
+  // Split the queue into shards of kReferenceShardSize references. Each shard gets its own queue
+  // of cleared references so that the workers never contend on a lock, and those are spliced
+  // into cleared_references_ once all the workers are done. The locks of the shards are never
+  // taken.
+  std::vector<std::unique_ptr<ReferenceQueue>> shards;
+  std::vector<std::unique_ptr<ReferenceQueue>> cleared_shards;
+  while (!queue->IsEmpty()) {
+    shards.emplace_back(new ReferenceQueue(Locks::reference_queue_cleared_references_lock_));
+    queue->MoveToShard(shards.back().get(), kReferenceShardSize);
+  }
+  if (shards.size() == 1u) {
+    shards[0]->ClearWhiteReferences(&cleared_references_, collector_);
+    return;
+  }
+  TimingLogger::ScopedTiming t(concurrent_ ? "ParallelClearWhiteReferences"
+                                           : "(Paused)ParallelClearWhiteReferences", timings);
+  for (const std::unique_ptr<ReferenceQueue>& shard : shards) {
+    cleared_shards.emplace_back(
+        new ReferenceQueue(Locks::reference_queue_cleared_references_lock_));
+    thread_pool->AddTask(
+        self, new ClearWhiteReferencesTask(shard.get(), cleared_shards.back().get(), collector_));
+  }
+  const size_t num_workers = std::min(shards.size(), thread_pool->GetThreadCount() + 1);
+  thread_pool->SetMaxActiveWorkers(num_workers - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  thread_pool->StopWorkers(self);
+  for (size_t i = 0; i < shards.size(); ++i) {
+    DCHECK(shards[i]->IsEmpty());
+    cleared_references_.Splice(cleared_shards[i].get());
+  }
+}
+
 // Process the "referent" field in a java.lang.ref.Reference.  If the referent has not yet been
 // marked, put it on the appropriate list in the heap for later processing.
 void ReferenceProcessor::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
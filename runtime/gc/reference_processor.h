@@ -96,6 +96,10 @@ class ReferenceProcessor {
   // Called by ProcessReferences.
   void DisableSlowPath(Thread* self) REQUIRES(Locks::reference_processor_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
+  // Clears the references of `queue` with white referents into cleared_references_. Long queues are
+  // split into shards that are cleared in parallel by the heap thread pool.
+  void ClearWhiteReferences(Thread* self, ReferenceQueue* queue, TimingLogger* timings)
+      REQUIRES_SHARED(Locks::mutator_lock_);
   // Wait until reference processing is done.
   void WaitUntilDoneProcessingReferences(Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reference_processor.h"
+
+#include <set>
+
+#include "base/time_utils.h"
+#include "class_linker-inl.h"
+#include "common_runtime_test.h"
+#include "handle_scope-inl.h"
+#include "heap.h"
+#include "mirror/class-alloc-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-alloc-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/reference-inl.h"
+#include "mirror/string.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
+
+namespace art {
+namespace gc {
+
+class ReferenceProcessorTest : public CommonRuntimeTest {
+ public:
+  static constexpr size_t kMinNumReferences = 1 * KB;
+  static constexpr size_t kMaxNumReferences = 256 * KB;
+
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    // Give the heap a thread pool, so that the queues longer than a shard are cleared in parallel.
+    options->push_back(std::make_pair("-XX:ParallelGCThreads=3", nullptr));
+  }
+};
+
+// Collects the garbage with 1K to 256K live WeakReferences, half of which have a white referent
+// that the reference processor has to clear, and logs the time of the GC. Checks that exactly
+// the references with a white referent were cleared and enqueued on the cleared references.
+TEST_F(ReferenceProcessorTest, ClearsWeakReferences) {
+  Thread* self = Thread::Current();
+  ThreadPool* thread_pool = Runtime::Current()->GetHeap()->GetThreadPool();
+  ASSERT_TRUE(thread_pool != nullptr);
+  EXPECT_EQ(3u, thread_pool->GetThreadCount());
+  for (size_t num_refs = kMinNumReferences; num_refs <= kMaxNumReferences; num_refs *= 4) {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<4> hs(self);
+    Handle<mirror::Class> ref_class(
+        hs.NewHandle(class_linker_->FindSystemClass(self, "Ljava/lang/ref/WeakReference;")));
+    ASSERT_TRUE(ref_class != nullptr);
+    Handle<mirror::Class> array_class(
+        hs.NewHandle(class_linker_->FindSystemClass(self, "[Ljava/lang/Object;")));
+    ASSERT_TRUE(array_class != nullptr);
+    Handle<mirror::ObjectArray<mirror::Object>> refs(hs.NewHandle(
+        mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), num_refs)));
+    ASSERT_TRUE(refs != nullptr);
+    Handle<mirror::ObjectArray<mirror::Object>> referents(hs.NewHandle(
+        mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), num_refs / 2)));
+    ASSERT_TRUE(referents != nullptr);
+    for (size_t i = 0; i < num_refs; ++i) {
+      ObjPtr<mirror::Object> ref = ref_class->AllocObject(self);
+      ASSERT_TRUE(ref != nullptr);
+      refs->Set<false>(i, ref);
+      ObjPtr<mirror::String> referent = mirror::String::AllocFromModifiedUtf8(self, "referent");
+      ASSERT_TRUE(referent != nullptr);
+      refs->Get(i)->AsReference()->SetReferent<false>(referent);
+      if (i % 2 == 0) {
+        referents->Set<false>(i / 2, referent);
+      }
+    }
+    uint64_t duration;
+    {
+      ScopedThreadSuspension sts(self, ThreadState::kNative);
+      uint64_t start_time = NanoTime();
+      Runtime::Current()->GetHeap()->CollectGarbage(/*clear_soft_references=*/ false);
+      duration = NanoTime() - start_time;
+    }
+    LOG(INFO) << "GC with " << num_refs << " weak references: " << PrettyDuration(duration);
+    std::set<mirror::Reference*> cleared_refs;
+    for (size_t i = 0; i < num_refs; ++i) {
+      ObjPtr<mirror::Reference> ref = refs->Get(i)->AsReference();
+      if (i % 2 == 0) {
+        EXPECT_EQ(referents->Get(i / 2).Ptr(), ref->GetReferent());
+        EXPECT_TRUE(ref->IsUnprocessed());
+      } else {
+        EXPECT_TRUE(ref->GetReferent() == nullptr);
+        EXPECT_FALSE(ref->IsUnprocessed());
+        cleared_refs.insert(ref.Ptr());
+      }
+    }
+    // The cleared references, along with any other reference the GC cleared, form the single
+    // cycle of pendingNext links of the cleared references queue, even when cleared by shards.
+    ASSERT_FALSE(cleared_refs.empty());
+    mirror::Reference* const first = *cleared_refs.begin();
+    const size_t max_steps = 2u * num_refs + 1u * KB;
+    size_t num_found = 0u;
+    size_t num_steps = 0u;
+    mirror::Reference* ref = first;
+    do {
+      if (cleared_refs.count(ref) != 0u) {
+        ++num_found;
+      }
+      ref = ref->GetPendingNext<kWithoutReadBarrier>();
+      ASSERT_TRUE(ref != nullptr);
+      ASSERT_LT(++num_steps, max_steps) << "The cleared references do not form a cycle";
+    } while (ref != first);
+    EXPECT_EQ(cleared_refs.size(), num_found);
+  }
+}
+
+}  // namespace gc
+}  // namespace art
@@ -162,6 +162,41 @@ void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
   }
 }
 
+void ReferenceQueue::MoveToShard(ReferenceQueue* shard, size_t count) {
+  DCHECK(!IsEmpty());
+  DCHECK(shard->IsEmpty());
+  DCHECK_GT(count, 0u);
+  ObjPtr<mirror::Reference> head = list_->GetPendingNext<kWithoutReadBarrier>();
+  ObjPtr<mirror::Reference> last = head;
+  for (size_t i = 1; i < count && last != list_; ++i) {
+    last = last->GetPendingNext<kWithoutReadBarrier>();
+  }
+  if (last == list_) {
+    // Everything is moved.
+    shard->list_ = list_;
+    list_ = nullptr;
+    return;
+  }
+  // Unlink [head, last] and close it into a cycle of its own.
+  list_->SetPendingNext(last->GetPendingNext<kWithoutReadBarrier>());
+  last->SetPendingNext(head);
+  shard->list_ = last.Ptr();
+}
+
+void ReferenceQueue::Splice(ReferenceQueue* other) {
+  if (other->IsEmpty()) {
+    return;
+  }
+  if (!IsEmpty()) {
+    // Exchange the successors of the two tails to join the two cycles.
+    ObjPtr<mirror::Reference> head = list_->GetPendingNext<kWithoutReadBarrier>();
+    list_->SetPendingNext(other->list_->GetPendingNext<kWithoutReadBarrier>());
+    other->list_->SetPendingNext(head);
+  }
+  list_ = other->list_;
+  other->Clear();
+}
+
 FinalizerStats ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
                                                 collector::GarbageCollector* collector) {
   uint32_t num_refs(0), num_enqueued(0);
@@ -106,6 +106,13 @@ class ReferenceQueue {
                             bool report_cleared = false)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Moves up to `count` references from the head of this queue to the empty queue `shard`, so
+  // that a long queue can be split up between several GC threads. Not thread safe.
+  void MoveToShard(ReferenceQueue* shard, size_t count) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Moves all the references of `other` to this queue in constant time. Not thread safe.
+  void Splice(ReferenceQueue* other) REQUIRES_SHARED(Locks::mutator_lock_);
+
   void Dump(std::ostream& os) const REQUIRES_SHARED(Locks::mutator_lock_);
   size_t GetLength() const REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -62,6 +62,46 @@ TEST_F(ReferenceQueueTest, EnqueueDequeue) {
   ASSERT_EQ(refs, dequeued);
 }
 
+TEST_F(ReferenceQueueTest, MoveToShardAndSplice) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<6> hs(self);
+  Mutex lock("Reference queue lock");
+  ReferenceQueue queue(&lock);
+  ReferenceQueue shard1(&lock);
+  ReferenceQueue shard2(&lock);
+  auto ref_class = hs.NewHandle(
+      Runtime::Current()->GetClassLinker()->FindClass(self, "Ljava/lang/ref/WeakReference;",
+                                                      ScopedNullHandle<mirror::ClassLoader>()));
+  ASSERT_TRUE(ref_class != nullptr);
+  std::set<mirror::Reference*> refs;
+  for (size_t i = 0; i < 5; ++i) {
+    auto ref(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+    ASSERT_TRUE(ref != nullptr);
+    queue.EnqueueReference(ref.Get());
+    refs.insert(ref.Get());
+  }
+  queue.MoveToShard(&shard1, 2);
+  ASSERT_EQ(shard1.GetLength(), 2U);
+  ASSERT_EQ(queue.GetLength(), 3U);
+  // Asking for more references than there are moves the whole queue.
+  queue.MoveToShard(&shard2, 4);
+  ASSERT_EQ(shard2.GetLength(), 3U);
+  ASSERT_TRUE(queue.IsEmpty());
+
+  queue.Splice(&shard1);
+  ASSERT_TRUE(shard1.IsEmpty());
+  ASSERT_EQ(queue.GetLength(), 2U);
+  queue.Splice(&shard2);
+  ASSERT_TRUE(shard2.IsEmpty());
+  ASSERT_EQ(queue.GetLength(), 5U);
+  std::set<mirror::Reference*> dequeued;
+  while (!queue.IsEmpty()) {
+    dequeued.insert(queue.DequeuePendingReference().Ptr());
+  }
+  ASSERT_EQ(refs, dequeued);
+}
+
 TEST_F(ReferenceQueueTest, Dump) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
@@ -91,6 +91,33 @@ void BumpPointerSpace::Clear() {
   }
 }
 
+void BumpPointerSpace::ResetAfterCompaction(uint8_t* new_end, size_t num_objects) {
+  DCHECK_ALIGNED(new_end, kAlignment);
+  DCHECK_GE(new_end, Begin());
+  DCHECK_LE(new_end, End());
+  uint8_t* const old_end = End();
+  // Allocations expect zeroed memory. Clear the rest of the last page in use and release the pages
+  // after it back to the operating system.
+  uint8_t* const release_begin = std::min(AlignUp(new_end, kPageSize), old_end);
+  memset(new_end, 0, release_begin - new_end);
+  if (release_begin < old_end) {
+    if (!kMadviseZeroes) {
+      memset(release_begin, 0, old_end - release_begin);
+    }
+    CHECK_NE(madvise(release_begin, old_end - release_begin, MADV_DONTNEED), -1)
+        << "madvise failed";
+  }
+  SetEnd(new_end);
+  objects_allocated_.store(num_objects, std::memory_order_relaxed);
+  bytes_allocated_.store(new_end - Begin(), std::memory_order_relaxed);
+  {
+    MutexLock mu(Thread::Current(), block_lock_);
+    // The compacted objects form a single continuous main block.
+    num_blocks_ = 0;
+    main_block_size_ = new_end - Begin();
+  }
+}
+
 void BumpPointerSpace::Dump(std::ostream& os) const {
   os << GetName() << " "
       << reinterpret_cast<void*>(Begin()) << "-" << reinterpret_cast<void*>(End()) << " - "
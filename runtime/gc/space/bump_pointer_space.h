@@ -107,6 +107,10 @@ class BumpPointerSpace final : public ContinuousMemMapAllocSpace {
   // Reset the space to empty.
   void Clear() override REQUIRES(!block_lock_);
 
+  // Shrink the space to end at new_end once a compacting collector has slid the num_objects live
+  // objects down to the beginning of the space. Releases the pages past the new end.
+  void ResetAfterCompaction(uint8_t* new_end, size_t num_objects) REQUIRES(!block_lock_);
+
   void Dump(std::ostream& os) const override;
 
   size_t RevokeThreadLocalBuffers(Thread* thread) override REQUIRES(!block_lock_);
@@ -18,10 +18,13 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
 #include <memory>
 
 #include <android-base/logging.h>
 
+#include "base/bit_utils.h"
+#include "base/casts.h"
 #include "base/macros.h"
 #include "base/memory_tool.h"
 #include "base/mutex-inl.h"
@@ -581,6 +584,16 @@ void FreeListSpace::Dump(std::ostream& os) const {
   }
 }
 
+size_t FreeListSpace::GetFragmentedBytes() {
+  MutexLock mu(Thread::Current(), lock_);
+  size_t fragmented_bytes = 0u;
+  // Each free block is recorded in the allocation info that follows it.
+  for (const AllocationInfo* info : free_blocks_) {
+    fragmented_bytes += info->GetPrevFreeBytes();
+  }
+  return fragmented_bytes;
+}
+
 bool FreeListSpace::IsZygoteLargeObject(Thread* self ATTRIBUTE_UNUSED, mirror::Object* obj) const {
   const AllocationInfo* info = GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(obj));
   DCHECK(info != nullptr);
@@ -605,6 +618,289 @@ void FreeListSpace::SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mar
   }
 }
 
+// Gives pages back to the kernel, lazily if it supports MADV_FREE. The pages may still hold their
+// old contents afterwards.
+static void ReleasePagesLazily(void* begin, size_t size) {
+#ifdef MADV_FREE
+  if (madvise(begin, size, MADV_FREE) == 0) {
+    return;
+  }
+  // MADV_FREE needs Linux 4.5.
+#endif
+  madvise(begin, size, MADV_DONTNEED);
+}
+
+SegregatedFreeListSpace* SegregatedFreeListSpace::Create(const std::string& name, size_t size) {
+  CHECK_EQ(size % kAlignment, 0U);
+  std::string error_msg;
+  MemMap mem_map = MemMap::MapAnonymous(name.c_str(),
+                                        size,
+                                        PROT_READ | PROT_WRITE,
+                                        /*low_4gb=*/ true,
+                                        &error_msg);
+  CHECK(mem_map.IsValid()) << "Failed to allocate large object space mem map: " << error_msg;
+  return new SegregatedFreeListSpace(name, std::move(mem_map), mem_map.Begin(), mem_map.End());
+}
+
+SegregatedFreeListSpace::SegregatedFreeListSpace(const std::string& name,
+                                                 MemMap&& mem_map,
+                                                 uint8_t* begin,
+                                                 uint8_t* end)
+    : FreeListSpace(name, std::move(mem_map), begin, end),
+      non_empty_size_classes_(0u),
+      free_end_dirty_bytes_(0u),
+      free_end_resident_bytes_(0u),
+      unreleased_bytes_(0u) {
+  const size_t num_slots = (end - begin) / kAlignment;
+  CHECK_LT(num_slots, kNoSlot);
+  std::string error_msg;
+  free_list_links_map_ =
+      MemMap::MapAnonymous("large object segregated free list links",
+                           sizeof(FreeListLinks) * num_slots,
+                           PROT_READ | PROT_WRITE,
+                           /*low_4gb=*/ false,
+                           &error_msg);
+  CHECK(free_list_links_map_.IsValid()) << "Failed to allocate free list links map" << error_msg;
+  free_list_links_ = reinterpret_cast<FreeListLinks*>(free_list_links_map_.Begin());
+  std::fill_n(free_list_heads_, kNumSizeClasses, kNoSlot);
+}
+
+SegregatedFreeListSpace::~SegregatedFreeListSpace() {}
+
+size_t SegregatedFreeListSpace::SizeClassFor(size_t num_pages) {
+  DCHECK_GT(num_pages, 0u);
+  if (num_pages <= kNumExactSizeClasses) {
+    return num_pages - 1;
+  }
+  const size_t size_class = kNumExactSizeClasses + MostSignificantBit(num_pages) - 5;
+  DCHECK_LT(size_class, kNumSizeClasses);
+  return size_class;
+}
+
+void SegregatedFreeListSpace::AddFreeBlock(size_t slot, size_t num_pages, size_t resident_pages) {
+  DCHECK_LT(slot + num_pages, GetFreeEndSlot());
+  DCHECK_LE(resident_pages, num_pages);
+  AllocationInfo* info = &allocation_info_[slot];
+  info->SetPrevFreeBytes(0);
+  info->SetByteSize(num_pages * kAlignment, /*free=*/ true);
+  AllocationInfo* next_info = info->GetNextInfo();
+  DCHECK(!next_info->IsFree());
+  next_info->SetPrevFreeBytes(num_pages * kAlignment);
+  const size_t size_class = SizeClassFor(num_pages);
+  const uint32_t head = free_list_heads_[size_class];
+  free_list_links_[slot] =
+      FreeListLinks {kNoSlot, head, dchecked_integral_cast<uint32_t>(resident_pages)};
+  if (head != kNoSlot) {
+    free_list_links_[head].prev = dchecked_integral_cast<uint32_t>(slot);
+  }
+  free_list_heads_[size_class] = dchecked_integral_cast<uint32_t>(slot);
+  non_empty_size_classes_ |= UINT64_C(1) << size_class;
+}
+
+void SegregatedFreeListSpace::RemoveFreeBlock(size_t slot) {
+  AllocationInfo* info = &allocation_info_[slot];
+  DCHECK(info->IsFree());
+  info->GetNextInfo()->SetPrevFreeBytes(0);
+  const size_t size_class = SizeClassFor(info->AlignSize());
+  const FreeListLinks links = free_list_links_[slot];
+  if (links.prev != kNoSlot) {
+    free_list_links_[links.prev].next = links.next;
+  } else {
+    DCHECK_EQ(free_list_heads_[size_class], slot);
+    free_list_heads_[size_class] = links.next;
+    if (links.next == kNoSlot) {
+      non_empty_size_classes_ &= ~(UINT64_C(1) << size_class);
+    }
+  }
+  if (links.next != kNoSlot) {
+    free_list_links_[links.next].prev = links.prev;
+  }
+}
+
+size_t SegregatedFreeListSpace::FindFreeBlock(size_t num_pages) {
+  const size_t size_class = SizeClassFor(num_pages);
+  if (size_class >= kNumExactSizeClasses) {
+    // Blocks of a power of two class may be smaller than the request, take the first that fits.
+    for (uint32_t slot = free_list_heads_[size_class];
+         slot != kNoSlot;
+         slot = free_list_links_[slot].next) {
+      if (allocation_info_[slot].AlignSize() >= num_pages) {
+        return slot;
+      }
+    }
+  } else if (free_list_heads_[size_class] != kNoSlot) {
+    return free_list_heads_[size_class];
+  }
+  // Any block of a larger class fits, split one of the smallest.
+  const uint64_t larger_classes =
+      non_empty_size_classes_ & ~((UINT64_C(2) << size_class) - UINT64_C(1));
+  if (larger_classes == 0u) {
+    return kNoSlot;
+  }
+  return free_list_heads_[CTZ(larger_classes)];
+}
+
+mirror::Object* SegregatedFreeListSpace::Alloc(Thread* self,
+                                               size_t num_bytes,
+                                               size_t* bytes_allocated,
+                                               size_t* usable_size,
+                                               size_t* bytes_tl_bulk_allocated) {
+  const size_t allocation_size = RoundUp(num_bytes, kAlignment);
+  const size_t num_pages = allocation_size / kAlignment;
+  size_t slot;
+  size_t dirty_bytes;
+  {
+    MutexLock mu(self, lock_);
+    slot = FindFreeBlock(num_pages);
+    if (slot != kNoSlot) {
+      const size_t block_pages = allocation_info_[slot].AlignSize();
+      const size_t resident_pages = free_list_links_[slot].resident_pages;
+      RemoveFreeBlock(slot);
+      if (block_pages > num_pages) {
+        const size_t remaining_pages = block_pages - num_pages;
+        AddFreeBlock(slot + num_pages, remaining_pages, std::min(resident_pages, remaining_pages));
+      }
+      dirty_bytes = allocation_size;
+    } else if (LIKELY(free_end_ >= allocation_size)) {
+      // Fit our object at the start of the end free block.
+      slot = GetFreeEndSlot();
+      free_end_ -= allocation_size;
+      dirty_bytes = std::min(free_end_dirty_bytes_, allocation_size);
+      free_end_dirty_bytes_ -= dirty_bytes;
+      free_end_resident_bytes_ = std::min(free_end_resident_bytes_, free_end_dirty_bytes_);
+    } else {
+      return nullptr;
+    }
+    AllocationInfo* info = &allocation_info_[slot];
+    info->SetPrevFreeBytes(0);
+    info->SetByteSize(allocation_size, /*free=*/ false);
+    ++num_objects_allocated_;
+    ++total_objects_allocated_;
+    num_bytes_allocated_ += allocation_size;
+    total_bytes_allocated_ += allocation_size;
+    const size_t unreleased_bytes = unreleased_bytes_.load(std::memory_order_relaxed);
+    unreleased_bytes_.store(unreleased_bytes - std::min(unreleased_bytes, dirty_bytes),
+                            std::memory_order_relaxed);
+  }
+  DCHECK(bytes_allocated != nullptr);
+  *bytes_allocated = allocation_size;
+  if (usable_size != nullptr) {
+    *usable_size = allocation_size;
+  }
+  DCHECK(bytes_tl_bulk_allocated != nullptr);
+  *bytes_tl_bulk_allocated = allocation_size;
+  mirror::Object* obj = reinterpret_cast<mirror::Object*>(GetAllocationAddressForSlot(slot));
+  if (kIsDebugBuild) {
+    CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ | PROT_WRITE);
+  }
+  // Reused pages did not go through the kernel, zero them outside of the lock.
+  memset(obj, 0, dirty_bytes);
+  return obj;
+}
+
+size_t SegregatedFreeListSpace::Free(Thread* self, mirror::Object* obj) {
+  DCHECK(Contains(obj)) << reinterpret_cast<void*>(Begin()) << " " << obj << " "
+                        << reinterpret_cast<void*>(End());
+  DCHECK_ALIGNED(obj, kAlignment);
+  AllocationInfo* info = GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(obj));
+  DCHECK(!info->IsFree());
+  const size_t allocation_size = info->ByteSize();
+  DCHECK_GT(allocation_size, 0U);
+  // Keep the pages resident for reuse unless there are too many already. Release them before the
+  // block becomes free, since an Alloc may reuse and zero it as soon as the lock is released.
+  const bool release =
+      unreleased_bytes_.load(std::memory_order_relaxed) + allocation_size > kMaxUnreleasedBytes;
+  if (release) {
+    ReleasePagesLazily(obj, allocation_size);
+  }
+  if (kIsDebugBuild) {
+    // Can't disallow reads since we use them to find next chunks during coalescing.
+    CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ);
+  }
+
+  MutexLock mu(self, lock_);
+  if (!release) {
+    unreleased_bytes_.store(unreleased_bytes_.load(std::memory_order_relaxed) + allocation_size,
+                            std::memory_order_relaxed);
+  }
+  size_t slot = GetSlotIndexForAllocationInfo(info);
+  size_t num_pages = info->AlignSize();
+  size_t resident_pages = release ? 0u : num_pages;
+  const size_t prev_free_pages = info->GetPrevFree();
+  if (prev_free_pages != 0) {
+    // Coalesce with the previous free block.
+    slot -= prev_free_pages;
+    resident_pages += free_list_links_[slot].resident_pages;
+    RemoveFreeBlock(slot);
+    num_pages += prev_free_pages;
+  }
+  const size_t next_slot = slot + num_pages;
+  if (next_slot == GetFreeEndSlot()) {
+    free_end_ += num_pages * kAlignment;
+    free_end_dirty_bytes_ += num_pages * kAlignment;
+    free_end_resident_bytes_ += resident_pages * kAlignment;
+  } else {
+    AllocationInfo* next_info = &allocation_info_[next_slot];
+    if (next_info->IsFree()) {
+      // Coalesce with the next free block, which cannot be followed by the end free block.
+      const size_t next_free_pages = next_info->AlignSize();
+      resident_pages += free_list_links_[next_slot].resident_pages;
+      RemoveFreeBlock(next_slot);
+      num_pages += next_free_pages;
+    }
+    AddFreeBlock(slot, num_pages, resident_pages);
+  }
+  --num_objects_allocated_;
+  DCHECK_LE(allocation_size, num_bytes_allocated_);
+  num_bytes_allocated_ -= allocation_size;
+  return allocation_size;
+}
+
+void SegregatedFreeListSpace::ForEachMemMap(std::function<void(const MemMap&)> func) const {
+  FreeListSpace::ForEachMemMap(func);
+  func(free_list_links_map_);
+}
+
+size_t SegregatedFreeListSpace::ReleaseFreePages() {
+  MutexLock mu(Thread::Current(), lock_);
+  size_t released_bytes = 0u;
+  for (uint32_t head : free_list_heads_) {
+    for (uint32_t slot = head; slot != kNoSlot; slot = free_list_links_[slot].next) {
+      // Blocks released by Free or by a previous call have nothing left to give back.
+      FreeListLinks& links = free_list_links_[slot];
+      if (links.resident_pages != 0u) {
+        ReleasePagesLazily(reinterpret_cast<void*>(GetAllocationAddressForSlot(slot)),
+                           allocation_info_[slot].ByteSize());
+        released_bytes += links.resident_pages * kAlignment;
+        links.resident_pages = 0u;
+      }
+    }
+  }
+  // The end free block is handed out without zeroing, so it needs MADV_DONTNEED even for the pages
+  // already released lazily.
+  if (free_end_dirty_bytes_ != 0u) {
+    madvise(reinterpret_cast<void*>(GetAllocationAddressForSlot(GetFreeEndSlot())),
+            free_end_dirty_bytes_,
+            MADV_DONTNEED);
+    released_bytes += free_end_resident_bytes_;
+    free_end_dirty_bytes_ = 0u;
+    free_end_resident_bytes_ = 0u;
+  }
+  unreleased_bytes_.store(0u, std::memory_order_relaxed);
+  return released_bytes;
+}
+
+size_t SegregatedFreeListSpace::GetFragmentedBytes() {
+  MutexLock mu(Thread::Current(), lock_);
+  size_t fragmented_bytes = 0u;
+  for (uint32_t head : free_list_heads_) {
+    for (uint32_t slot = head; slot != kNoSlot; slot = free_list_links_[slot].next) {
+      fragmented_bytes += allocation_info_[slot].ByteSize();
+    }
+  }
+  return fragmented_bytes;
+}
+
 void LargeObjectSpace::SweepCallback(size_t num_ptrs, mirror::Object** ptrs, void* arg) {
   SweepCallbackContext* context = static_cast<SweepCallbackContext*>(arg);
   space::LargeObjectSpace* space = context->space->AsLargeObjectSpace();
@@ -24,6 +24,8 @@
 #include "space.h"
 #include "thread-current-inl.h"
 
+#include <atomic>
+#include <limits>
 #include <set>
 #include <vector>
 
@@ -37,6 +39,7 @@ enum class LargeObjectSpaceType {
   kDisabled,
   kMap,
   kFreeList,
+  kSegregatedFreeList,
 };
 
 // Abstraction implemented by all large object spaces.
@@ -116,6 +119,18 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   // End() from different allocations.
   virtual std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const = 0;
 
+  // Gives the pages of free memory that the space keeps resident back to the system. Returns the
+  // number of bytes released.
+  virtual size_t ReleaseFreePages() REQUIRES(!lock_) {
+    return 0u;
+  }
+
+  // Returns the bytes of the free blocks between large objects, which only allocations that fit in
+  // them can reuse. The free region at the end of the space is not counted.
+  virtual size_t GetFragmentedBytes() REQUIRES(!lock_) {
+    return 0u;
+  }
+
  protected:
   explicit LargeObjectSpace(const std::string& name, uint8_t* begin, uint8_t* end,
                             const char* lock_name);
@@ -183,11 +198,11 @@ class LargeObjectMapSpace : public LargeObjectSpace {
 };
 
 // A continuous large object space with a free-list to handle holes.
-class FreeListSpace final : public LargeObjectSpace {
+class FreeListSpace : public LargeObjectSpace {
  public:
   static constexpr size_t kAlignment = kPageSize;
 
-  virtual ~FreeListSpace();
+  ~FreeListSpace() override;
   static FreeListSpace* Create(const std::string& name, size_t capacity);
   size_t AllocationSize(mirror::Object* obj, size_t* usable_size) override
       REQUIRES(lock_);
@@ -199,6 +214,7 @@ class FreeListSpace final : public LargeObjectSpace {
   void Dump(std::ostream& os) const override REQUIRES(!lock_);
   void ForEachMemMap(std::function<void(const MemMap&)> func) const override REQUIRES(!lock_);
   std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const override REQUIRES(!lock_);
+  size_t GetFragmentedBytes() override REQUIRES(!lock_);
 
  protected:
   FreeListSpace(const std::string& name, MemMap&& mem_map, uint8_t* begin, uint8_t* end);
@@ -242,6 +258,72 @@ class FreeListSpace final : public LargeObjectSpace {
   FreeBlocks free_blocks_ GUARDED_BY(lock_);
 };
 
+// A FreeListSpace which finds free blocks in lists segregated by size instead of a single ordered
+// set, and which reuses freed pages in place. Freed blocks stay resident, and are zeroed when they
+// are reused, until kMaxUnreleasedBytes are pending; further blocks are released with MADV_FREE,
+// which lets the kernel reclaim them lazily. ReleaseFreePages releases the blocks which are still
+// resident.
+class SegregatedFreeListSpace final : public FreeListSpace {
+ public:
+  // Blocks of up to kNumExactSizeClasses pages have one free list per page count. Larger blocks
+  // have one free list per power of two of their page count, up to the 2^30 pages that
+  // AllocationInfo can represent.
+  static constexpr size_t kNumExactSizeClasses = 32;
+  static constexpr size_t kNumSizeClasses = kNumExactSizeClasses + 30 - 5;
+  static_assert(kNumExactSizeClasses == 1u << 5, "Size classes assume 32 exact classes");
+  static_assert(kNumSizeClasses <= 64, "Non-empty size classes are a 64-bit mask");
+  // Freed bytes kept resident for reuse.
+  static constexpr size_t kMaxUnreleasedBytes = 16 * MB;
+
+  static SegregatedFreeListSpace* Create(const std::string& name, size_t capacity);
+  ~SegregatedFreeListSpace() override;
+  mirror::Object* Alloc(Thread* self, size_t num_bytes, size_t* bytes_allocated,
+                        size_t* usable_size, size_t* bytes_tl_bulk_allocated)
+      override REQUIRES(!lock_);
+  size_t Free(Thread* self, mirror::Object* obj) override REQUIRES(!lock_);
+  void ForEachMemMap(std::function<void(const MemMap&)> func) const override REQUIRES(!lock_);
+  size_t ReleaseFreePages() override REQUIRES(!lock_);
+  size_t GetFragmentedBytes() override REQUIRES(!lock_);
+
+ private:
+  struct FreeListLinks {
+    uint32_t prev;
+    uint32_t next;
+    // Pages of the block which have not been released since they were freed. Which pages they are
+    // is not tracked, so after a split the remainder of the block is assumed to keep them.
+    uint32_t resident_pages;
+  };
+  static constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+
+  SegregatedFreeListSpace(const std::string& name, MemMap&& mem_map, uint8_t* begin, uint8_t* end);
+  static size_t SizeClassFor(size_t num_pages);
+  // Slot of the first page of the free region at the end of the space.
+  size_t GetFreeEndSlot() const REQUIRES(lock_) {
+    return (Size() - free_end_) / kAlignment;
+  }
+  // Marks the pages [slot, slot + num_pages) as a free block, of which resident_pages have not been
+  // released, and adds it to its free list. The block must be followed by an allocated block.
+  void AddFreeBlock(size_t slot, size_t num_pages, size_t resident_pages) REQUIRES(lock_);
+  void RemoveFreeBlock(size_t slot) REQUIRES(lock_);
+  // Returns the first slot of a free block of at least num_pages pages, or kNoSlot.
+  size_t FindFreeBlock(size_t num_pages) REQUIRES(lock_);
+
+  // Side table with the free list links of the first page of each free block, so that free pages
+  // are never touched.
+  MemMap free_list_links_map_;
+  FreeListLinks* free_list_links_;
+  uint32_t free_list_heads_[kNumSizeClasses] GUARDED_BY(lock_);
+  uint64_t non_empty_size_classes_ GUARDED_BY(lock_);
+  // Bytes at the start of the free region at the end of the space that may not be zero.
+  size_t free_end_dirty_bytes_ GUARDED_BY(lock_);
+  // Bytes of the free region at the end of the space that have not been released, at most
+  // free_end_dirty_bytes_.
+  size_t free_end_resident_bytes_ GUARDED_BY(lock_);
+  // Approximate number of freed bytes that are still resident. Only written with lock_ held, but
+  // read without it by Free.
+  std::atomic<size_t> unreleased_bytes_;
+};
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
@@ -16,6 +16,8 @@
 
 #include "large_object_space.h"
 
+#include <algorithm>
+
 #include "base/time_utils.h"
 #include "space_test.h"
 
@@ -30,20 +32,35 @@ class LargeObjectSpaceTest : public SpaceTest<CommonRuntimeTest> {
   static constexpr size_t kNumThreads = 10;
   static constexpr size_t kNumIterations = 1000;
   void RaceTest();
+
+  static constexpr size_t kMaxNumChurnThreads = 16;
+  static constexpr size_t kNumChurnAllocationsPerThread = 4 * KB;
+  // Churns the spaces with 1 to kMaxNumChurnThreads threads. The benchmark logs the allocation
+  // throughput, and only touches the last byte of each array instead of checking its contents.
+  void ChurnTest(bool benchmark);
+
+  void FragmentationTest();
+
+  static constexpr size_t kNumLargeObjectSpaceTypes = 3;
+  static LargeObjectSpace* CreateLargeObjectSpace(size_t los_type, size_t capacity) {
+    switch (los_type) {
+      case 0:
+        return space::LargeObjectMapSpace::Create("large object space");
+      case 1:
+        return space::FreeListSpace::Create("large object space", capacity);
+      default:
+        return space::SegregatedFreeListSpace::Create("large object space", capacity);
+    }
+  }
 };
 
 
 void LargeObjectSpaceTest::LargeObjectTest() {
   size_t rand_seed = 0;
   Thread* const self = Thread::Current();
-  for (size_t i = 0; i < 2; ++i) {
-    LargeObjectSpace* los = nullptr;
+  for (size_t i = 0; i < kNumLargeObjectSpaceTypes; ++i) {
     const size_t capacity = 128 * MB;
-    if (i == 0) {
-      los = space::LargeObjectMapSpace::Create("large object space");
-    } else {
-      los = space::FreeListSpace::Create("large object space", capacity);
-    }
+    LargeObjectSpace* los = CreateLargeObjectSpace(i, capacity);
 
     // Make sure the bitmap is not empty and actually covers at least how much we expect.
     CHECK_LT(static_cast<uintptr_t>(los->GetLiveBitmap()->HeapBegin()),
@@ -66,6 +83,9 @@ void LargeObjectSpaceTest::LargeObjectTest() {
         ASSERT_EQ(allocation_size, los->AllocationSize(obj, nullptr));
         ASSERT_GE(allocation_size, request_size);
         ASSERT_EQ(allocation_size, bytes_tl_bulk_allocated);
+        // Memory reused in place must have been zeroed.
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(obj);
+        ASSERT_TRUE(std::all_of(bytes, bytes + request_size, [](uint8_t b) { return b == 0; }));
         // Fill in our magic value.
         uint8_t magic = (request_size & 0xFF) | 1;
         memset(obj, magic, request_size);
@@ -152,13 +172,8 @@ class AllocRaceTask : public Task {
 };
 
 void LargeObjectSpaceTest::RaceTest() {
-  for (size_t los_type = 0; los_type < 2; ++los_type) {
-    LargeObjectSpace* los = nullptr;
-    if (los_type == 0) {
-      los = space::LargeObjectMapSpace::Create("large object space");
-    } else {
-      los = space::FreeListSpace::Create("large object space", 128 * MB);
-    }
+  for (size_t los_type = 0; los_type < kNumLargeObjectSpaceTypes; ++los_type) {
+    LargeObjectSpace* los = CreateLargeObjectSpace(los_type, 128 * MB);
 
     Thread* self = Thread::Current();
     ThreadPool thread_pool("Large object space test thread pool", kNumThreads);
@@ -174,6 +189,167 @@ void LargeObjectSpaceTest::RaceTest() {
   }
 }
 
+// Allocates and frees arrays of 12KB to 1MB, keeping a few of them alive, like code churning
+// through byte buffers and bitmaps. Unless benchmarking, each page of a live array is stamped with
+// a value unique to the allocation, which must still be there when the array is freed, and each
+// page of a new array must be zero.
+class ChurnTask : public Task {
+ public:
+  ChurnTask(size_t id, size_t num_allocations, LargeObjectSpace* los, bool benchmark)
+      : id_(id),
+        num_allocations_(num_allocations),
+        los_(los),
+        benchmark_(benchmark),
+        error_(nullptr) {}
+
+  void Run(Thread* self) override {
+    static constexpr size_t kNumLive = 8;
+    mirror::Object* live[kNumLive] = {};
+    size_t sizes[kNumLive] = {};
+    uint32_t stamps[kNumLive] = {};
+    size_t rand_seed = id_;
+    for (size_t i = 0; i < num_allocations_ && error_ == nullptr; ++i) {
+      size_t slot = i % kNumLive;
+      if (live[slot] != nullptr) {
+        if (!benchmark_ && !HasStamp(live[slot], sizes[slot], stamps[slot])) {
+          error_ = "live array overwritten";
+        }
+        los_->Free(self, live[slot]);
+      }
+      size_t size = 12 * KB + test_rand(&rand_seed) % (1 * MB - 12 * KB);
+      size_t alloc_size, bytes_tl_bulk_allocated;
+      live[slot] = los_->Alloc(self, size, &alloc_size, nullptr, &bytes_tl_bulk_allocated);
+      if (live[slot] == nullptr) {
+        error_ = "allocation failed";
+        break;
+      }
+      if (benchmark_) {
+        // Touch the object like an array initialization would.
+        reinterpret_cast<uint8_t*>(live[slot])[size - 1] = 1;
+        continue;
+      }
+      if (alloc_size < size || !HasStamp(live[slot], size, 0u)) {
+        error_ = "allocation too small or not zeroed";
+      }
+      sizes[slot] = size;
+      stamps[slot] = static_cast<uint32_t>(id_ * num_allocations_ + i + 1);
+      Stamp(live[slot], size, stamps[slot]);
+    }
+    for (size_t slot = 0; slot < kNumLive; ++slot) {
+      if (live[slot] != nullptr) {
+        if (!benchmark_ && error_ == nullptr && !HasStamp(live[slot], sizes[slot], stamps[slot])) {
+          error_ = "live array overwritten";
+        }
+        los_->Free(self, live[slot]);
+      }
+    }
+  }
+
+  void Finalize() override {
+    CHECK(error_ == nullptr) << "Task " << id_ << ": " << error_;
+    delete this;
+  }
+
+ private:
+  // The stamp goes at the start of each page and in the last word of the array.
+  static void Stamp(mirror::Object* obj, size_t size, uint32_t stamp) {
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(obj);
+    for (size_t offset = 0; offset < size; offset += kPageSize) {
+      memcpy(bytes + offset, &stamp, sizeof(stamp));
+    }
+    memcpy(bytes + size - sizeof(stamp), &stamp, sizeof(stamp));
+  }
+
+  static bool HasStamp(mirror::Object* obj, size_t size, uint32_t stamp) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(obj);
+    for (size_t offset = 0; offset < size; offset += kPageSize) {
+      if (memcmp(bytes + offset, &stamp, sizeof(stamp)) != 0) {
+        return false;
+      }
+    }
+    return memcmp(bytes + size - sizeof(stamp), &stamp, sizeof(stamp)) == 0;
+  }
+
+  const size_t id_;
+  const size_t num_allocations_;
+  LargeObjectSpace* const los_;
+  const bool benchmark_;
+  const char* error_;
+};
+
+void LargeObjectSpaceTest::ChurnTest(bool benchmark) {
+  Thread* self = Thread::Current();
+  for (size_t los_type = 0; los_type < kNumLargeObjectSpaceTypes; ++los_type) {
+    LargeObjectSpace* los = CreateLargeObjectSpace(los_type, 512 * MB);
+    for (size_t num_threads = 1; num_threads <= kMaxNumChurnThreads; num_threads *= 2) {
+      ThreadPool thread_pool("Large object space churn thread pool", num_threads);
+      for (size_t i = 0; i < num_threads; ++i) {
+        thread_pool.AddTask(self,
+                            new ChurnTask(i, kNumChurnAllocationsPerThread, los, benchmark));
+      }
+      uint64_t start_time = NanoTime();
+      thread_pool.StartWorkers(self);
+      thread_pool.Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+      uint64_t duration = NanoTime() - start_time;
+      if (benchmark) {
+        LOG(INFO) << "Large object space " << los_type << " churn with " << num_threads
+                  << " threads: "
+                  << num_threads * kNumChurnAllocationsPerThread * MsToNs(1000) /
+                         std::max<uint64_t>(duration, 1u)
+                  << " allocations/s (" << PrettyDuration(duration) << ")";
+      }
+      EXPECT_EQ(0U, los->GetBytesAllocated());
+      EXPECT_EQ(0U, los->GetObjectsAllocated());
+      los->ReleaseFreePages();
+      // Pages released by the previous call are not counted again.
+      EXPECT_EQ(0U, los->ReleaseFreePages());
+    }
+    delete los;
+  }
+}
+
+void LargeObjectSpaceTest::FragmentationTest() {
+  static constexpr size_t kNumObjects = 8;
+  static constexpr size_t kObjectSize = 4 * kPageSize;
+  Thread* self = Thread::Current();
+  for (size_t los_type = 0; los_type < kNumLargeObjectSpaceTypes; ++los_type) {
+    LargeObjectSpace* los = CreateLargeObjectSpace(los_type, 16 * MB);
+    // Objects of the map space have their own mappings, and leave no holes.
+    const size_t hole_size = los_type == 0 ? 0u : kObjectSize;
+    mirror::Object* objects[kNumObjects];
+    for (mirror::Object*& obj : objects) {
+      size_t alloc_size, bytes_tl_bulk_allocated;
+      obj = los->Alloc(self, kObjectSize, &alloc_size, nullptr, &bytes_tl_bulk_allocated);
+      ASSERT_TRUE(obj != nullptr);
+    }
+    EXPECT_EQ(0U, los->GetFragmentedBytes());
+
+    // Every other object leaves a hole.
+    for (size_t i = 0; i < kNumObjects; i += 2) {
+      los->Free(self, objects[i]);
+    }
+    EXPECT_EQ(4 * hole_size, los->GetFragmentedBytes());
+    // Holes coalesce.
+    los->Free(self, objects[1]);
+    EXPECT_EQ(5 * hole_size, los->GetFragmentedBytes());
+    // The free region at the end of the space is not a hole.
+    los->Free(self, objects[7]);
+    EXPECT_EQ(4 * hole_size, los->GetFragmentedBytes());
+    // An allocation that fits fills a hole.
+    size_t alloc_size, bytes_tl_bulk_allocated;
+    objects[4] = los->Alloc(self, kObjectSize, &alloc_size, nullptr, &bytes_tl_bulk_allocated);
+    ASSERT_TRUE(objects[4] != nullptr);
+    EXPECT_EQ(3 * hole_size, los->GetFragmentedBytes());
+
+    for (size_t i = 3; i < 6; ++i) {
+      los->Free(self, objects[i]);
+    }
+    EXPECT_EQ(0U, los->GetFragmentedBytes());
+    EXPECT_EQ(0U, los->GetBytesAllocated());
+    delete los;
+  }
+}
+
 TEST_F(LargeObjectSpaceTest, LargeObjectTest) {
   LargeObjectTest();
 }
@@ -182,6 +358,18 @@ TEST_F(LargeObjectSpaceTest, RaceTest) {
   RaceTest();
 }
 
+TEST_F(LargeObjectSpaceTest, ChurnTest) {
+  ChurnTest(/*benchmark=*/ false);
+}
+
+TEST_F(LargeObjectSpaceTest, ChurnBenchmark) {
+  ChurnTest(/*benchmark=*/ true);
+}
+
+TEST_F(LargeObjectSpaceTest, FragmentationTest) {
+  FragmentationTest();
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
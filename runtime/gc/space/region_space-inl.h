@@ -96,6 +96,49 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes,
   return nullptr;
 }
 
+inline mirror::Object* RegionSpace::AllocSurvivor(size_t age,
+                                                  size_t num_bytes,
+                                                  /* out */ size_t* bytes_allocated,
+                                                  /* out */ size_t* usable_size,
+                                                  /* out */ size_t* bytes_tl_bulk_allocated) {
+  DCHECK(use_generational_cc_);
+  DCHECK_ALIGNED(num_bytes, kAlignment);
+  DCHECK_LE(num_bytes, kRegionSize);
+  DCHECK_GT(age, 0u);
+  if (age >= tenure_threshold_) {
+    // The object has survived enough young collections: promote it.
+    return AllocNonvirtual</*kForEvac=*/ true>(num_bytes,
+                                               bytes_allocated,
+                                               usable_size,
+                                               bytes_tl_bulk_allocated);
+  }
+  mirror::Object* obj = survivor_regions_[age]->Alloc(num_bytes,
+                                                      bytes_allocated,
+                                                      usable_size,
+                                                      bytes_tl_bulk_allocated);
+  if (LIKELY(obj != nullptr)) {
+    return obj;
+  }
+  MutexLock mu(Thread::Current(), region_lock_);
+  // Retry with the current survivor region since another thread may have updated it.
+  obj = survivor_regions_[age]->Alloc(num_bytes, bytes_allocated, usable_size,
+                                      bytes_tl_bulk_allocated);
+  if (LIKELY(obj != nullptr)) {
+    return obj;
+  }
+  Region* r = AllocateRegion(/*for_evac=*/ true);
+  if (LIKELY(r != nullptr)) {
+    r->SetAge(age);
+    obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
+    CHECK(obj != nullptr);
+    // Do our allocation before setting the region, this makes sure no threads race ahead
+    // and fill in the region before we allocate the object. b/63153464
+    survivor_regions_[age] = r;
+    return obj;
+  }
+  return nullptr;
+}
+
 inline mirror::Object* RegionSpace::Region::Alloc(size_t num_bytes,
                                                   /* out */ size_t* bytes_allocated,
                                                   /* out */ size_t* usable_size,
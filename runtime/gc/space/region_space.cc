@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
 #include <deque>
 
 #include "bump_pointer_space-inl.h"
@@ -94,12 +95,17 @@ MemMap RegionSpace::CreateMemMap(const std::string& name,
   return mem_map;
 }
 
-RegionSpace* RegionSpace::Create(
-    const std::string& name, MemMap&& mem_map, bool use_generational_cc) {
-  return new RegionSpace(name, std::move(mem_map), use_generational_cc);
+RegionSpace* RegionSpace::Create(const std::string& name,
+                                 MemMap&& mem_map,
+                                 bool use_generational_cc,
+                                 size_t tenure_threshold) {
+  return new RegionSpace(name, std::move(mem_map), use_generational_cc, tenure_threshold);
 }
 
-RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc)
+RegionSpace::RegionSpace(const std::string& name,
+                         MemMap&& mem_map,
+                         bool use_generational_cc,
+                         size_t tenure_threshold)
     : ContinuousMemMapAllocSpace(name,
                                  std::move(mem_map),
                                  mem_map.Begin(),
@@ -108,6 +114,10 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
                                  kGcRetentionPolicyAlwaysCollect),
       region_lock_("Region lock", kRegionSpaceRegionLock),
       use_generational_cc_(use_generational_cc),
+      // Survivor regions are only used by young (sticky-bit) collections.
+      tenure_threshold_(use_generational_cc
+                            ? std::clamp<size_t>(tenure_threshold, 1u, kMaxTenureThreshold)
+                            : 1u),
       time_(1U),
       num_regions_(mem_map_.Size() / kRegionSize),
       madvise_time_(0U),
@@ -121,6 +131,7 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
   CHECK_ALIGNED(mem_map_.Size(), kRegionSize);
   CHECK_ALIGNED(mem_map_.Begin(), kRegionSize);
   DCHECK_GT(num_regions_, 0U);
+  std::fill_n(survivor_regions_, kMaxTenureThreshold, nullptr);
   regions_.reset(new Region[num_regions_]);
   uint8_t* region_addr = mem_map_.Begin();
   for (size_t i = 0; i < num_regions_; ++i, region_addr += kRegionSize) {
@@ -236,6 +247,14 @@ inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
     return true;
   }
   DCHECK(IsAllocated());
+  if (IsSurvivor()) {
+    // Survivor regions are part of the nursery: evacuate them so that their live objects
+    // either age further or get tenured. Ages are reset by full-heap collections (see
+    // RegionSpace::SetFromSpace).
+    DCHECK_EQ(evac_mode, kEvacModeNewlyAllocated);
+    DCHECK(!is_newly_allocated_);
+    return true;
+  }
   if (is_newly_allocated_) {
     // Invariant: newly allocated regions have an undefined live bytes count.
     DCHECK_EQ(live_bytes_, static_cast<size_t>(-1));
@@ -338,6 +357,12 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
     RegionType type = r->Type();
     if (!r->IsFree()) {
       DCHECK(r->IsInToSpace());
+      if (evac_mode != kEvacModeNewlyAllocated) {
+        // A full-heap collection tenures all survivors: it does not maintain the card marks
+        // of references from tenured objects to survivor regions that the next young
+        // collection would need to evacuate them.
+        r->ClearAge();
+      }
       if (LIKELY(num_expected_large_tails == 0U)) {
         DCHECK((state == RegionState::kRegionStateAllocated ||
                 state == RegionState::kRegionStateLarge) &&
@@ -345,6 +370,13 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
         bool should_evacuate = r->ShouldBeEvacuated(evac_mode);
         bool is_newly_allocated = r->IsNewlyAllocated();
         if (should_evacuate) {
+          if (r->IsSurvivor()) {
+            // Unlike newly allocated regions, survivor regions have the mark bits of their
+            // objects set (they were copied by the previous young collection). Clear them so
+            // that the card table scan of this collection does not visit from-space objects.
+            GetMarkBitmap()->ClearRange(reinterpret_cast<mirror::Object*>(r->Begin()),
+                                        reinterpret_cast<mirror::Object*>(r->End()));
+          }
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
         } else {
@@ -391,6 +423,7 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
   DCHECK_EQ(num_expected_large_tails, 0U);
   current_region_ = &full_region_;
   evac_region_ = &full_region_;
+  std::fill_n(survivor_regions_, kMaxTenureThreshold, &full_region_);
 }
 
 static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end) {
@@ -613,6 +646,7 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
   // Update non_free_region_index_limit_.
   SetNonFreeRegionLimit(new_non_free_region_index_limit);
   evac_region_ = nullptr;
+  std::fill_n(survivor_regions_, kMaxTenureThreshold, nullptr);
   num_non_free_regions_ += num_evac_regions_;
   num_evac_regions_ = 0;
 }
@@ -764,6 +798,7 @@ void RegionSpace::Clear() {
   DCHECK_EQ(num_non_free_regions_, 0u);
   current_region_ = &full_region_;
   evac_region_ = &full_region_;
+  std::fill_n(survivor_regions_, kMaxTenureThreshold, &full_region_);
 }
 
 void RegionSpace::Protect() {
@@ -942,6 +977,7 @@ void RegionSpace::Region::Dump(std::ostream& os) const {
      << " type=" << type_
      << " objects_allocated=" << objects_allocated_
      << " alloc_time=" << alloc_time_
+     << " age=" << static_cast<size_t>(age_)
      << " live_bytes=" << live_bytes_;
 
   if (live_bytes_ != static_cast<size_t>(-1)) {
@@ -1001,6 +1037,7 @@ void RegionSpace::Region::Clear(bool zero_and_release_pages) {
   type_ = RegionType::kRegionTypeNone;
   objects_allocated_.store(0, std::memory_order_relaxed);
   alloc_time_ = 0;
+  age_ = 0;
   live_bytes_ = static_cast<size_t>(-1);
   if (zero_and_release_pages) {
     ZeroAndProtectRegion(begin_, end_);
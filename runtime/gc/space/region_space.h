@@ -43,6 +43,10 @@ namespace space {
 // only enable it in debug mode.
 static constexpr bool kCyclicRegionAllocation = kIsDebugBuild;
 
+// The maximum number of young collections an object may have to survive before it is copied to
+// a tenured region (see RegionSpace::GetTenureThreshold).
+static constexpr size_t kMaxTenureThreshold = 8;
+
 // A space that consists of equal-sized regions.
 class RegionSpace final : public ContinuousMemMapAllocSpace {
  public:
@@ -62,7 +66,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // guaranteed to be granted, if it is required, the caller should call Begin on the returned
   // space to confirm the request was granted.
   static MemMap CreateMemMap(const std::string& name, size_t capacity, uint8_t* requested_begin);
-  static RegionSpace* Create(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  static RegionSpace* Create(const std::string& name,
+                             MemMap&& mem_map,
+                             bool use_generational_cc,
+                             size_t tenure_threshold);
 
   // Allocate `num_bytes`, returns null if the space is full.
   mirror::Object* Alloc(Thread* self,
@@ -93,6 +100,15 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
                              /* out */ size_t* bytes_tl_bulk_allocated) REQUIRES(!region_lock_);
   template<bool kForEvac>
   void FreeLarge(mirror::Object* large_obj, size_t bytes_allocated) REQUIRES(!region_lock_);
+  // Allocate `num_bytes` for an object surviving its `age`-th young collection. The object is
+  // copied to a survivor region of that age, or to a tenured evacuation region once `age`
+  // reaches the tenure threshold. Only used during young (sticky-bit) CC collections.
+  ALWAYS_INLINE mirror::Object* AllocSurvivor(size_t age,
+                                              size_t num_bytes,
+                                              /* out */ size_t* bytes_allocated,
+                                              /* out */ size_t* usable_size,
+                                              /* out */ size_t* bytes_tl_bulk_allocated)
+      REQUIRES(!region_lock_);
 
   // Return the storage space required by obj.
   size_t AllocationSize(mirror::Object* obj, size_t* usable_size) override
@@ -256,6 +272,34 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     return false;
   }
 
+  // Return whether `ref` is in a survivor region, i.e. a region holding objects that survived
+  // fewer young collections than the tenure threshold. Such regions are part of the nursery and
+  // are evacuated again by the next young collection.
+  bool IsInSurvivorRegion(mirror::Object* ref) {
+    if (HasAddress(ref)) {
+      Region* r = RefToRegionUnlocked(ref);
+      return r->IsSurvivor();
+    }
+    return false;
+  }
+
+  // If `ref` is in a survivor region, return the number of young collections survived by the
+  // objects of that region; otherwise, return 0.
+  size_t GetRegionAge(mirror::Object* ref) {
+    if (HasAddress(ref)) {
+      Region* r = RefToRegionUnlocked(ref);
+      return r->Age();
+    }
+    return 0u;
+  }
+
+  // Return the number of young collections an object has to survive before being promoted to a
+  // tenured region. With a threshold of 1 (the default), survivors of a young collection are
+  // promoted right away and no survivor region is ever allocated.
+  size_t GetTenureThreshold() const {
+    return tenure_threshold_;
+  }
+
   bool IsInUnevacFromSpace(mirror::Object* ref) {
     if (HasAddress(ref)) {
       Region* r = RefToRegionUnlocked(ref);
@@ -321,6 +365,12 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     reg->AddLiveBytes(alloc_size);
   }
 
+  // Same as AddLiveBytes, for callers racing with other threads on the same region.
+  void AtomicAddLiveBytes(mirror::Object* ref, size_t alloc_size) {
+    Region* reg = RefToRegionUnlocked(ref);
+    reg->AtomicAddLiveBytes(alloc_size);
+  }
+
   void AssertAllRegionLiveBytesZeroOrCleared() REQUIRES(!region_lock_) {
     if (kIsDebugBuild) {
       MutexLock mu(Thread::Current(), region_lock_);
@@ -385,7 +435,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   }
 
  private:
-  RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  RegionSpace(const std::string& name,
+              MemMap&& mem_map,
+              bool use_generational_cc,
+              size_t tenure_threshold);
 
   class Region {
    public:
@@ -398,6 +451,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
           end_(nullptr),
           objects_allocated_(0),
           alloc_time_(0),
+          age_(0),
           is_newly_allocated_(false),
           is_a_tlab_(false),
           state_(RegionState::kRegionStateAllocated),
@@ -412,6 +466,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       type_ = RegionType::kRegionTypeNone;
       objects_allocated_.store(0, std::memory_order_relaxed);
       alloc_time_ = 0;
+      age_ = 0;
       live_bytes_ = static_cast<size_t>(-1);
       is_newly_allocated_ = false;
       is_a_tlab_ = false;
@@ -503,6 +558,28 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       return is_a_tlab_;
     }
 
+    // Number of young collections survived by the objects of this survivor region; 0 for
+    // newly allocated and tenured regions.
+    size_t Age() const {
+      return age_;
+    }
+
+    void SetAge(size_t age) {
+      DCHECK(IsAllocated());
+      DCHECK(!IsNewlyAllocated());
+      DCHECK_LT(age, kMaxTenureThreshold);
+      age_ = static_cast<uint8_t>(age);
+    }
+
+    // Tenure all the objects of this region.
+    void ClearAge() {
+      age_ = 0;
+    }
+
+    bool IsSurvivor() const {
+      return age_ != 0;
+    }
+
     bool IsInFromSpace() const {
       return type_ == RegionType::kRegionTypeFromSpace;
     }
@@ -565,6 +642,15 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       DCHECK_LE(live_bytes_, BytesAllocated());
     }
 
+    void AtomicAddLiveBytes(size_t live_bytes) {
+      DCHECK(GetUseGenerationalCC() || IsInUnevacFromSpace());
+      DCHECK(!IsLargeTail());
+      DCHECK_NE(live_bytes_, static_cast<size_t>(-1));
+      // For large allocations, we always consider all bytes in the regions live.
+      reinterpret_cast<Atomic<size_t>*>(&live_bytes_)->fetch_add(
+          IsLarge() ? Top() - begin_ : live_bytes, std::memory_order_relaxed);
+    }
+
     bool AllAllocatedBytesAreLive() const {
       return LiveBytes() == static_cast<size_t>(Top() - Begin());
     }
@@ -632,6 +718,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     // are concurrent updates.
     Atomic<size_t> objects_allocated_;  // The number of objects allocated.
     uint32_t alloc_time_;               // The allocation time of the region.
+    uint8_t age_;                       // The survivor age of the region (see Region::Age).
     // Note that newly allocated and evacuated regions use -1 as
     // special value for `live_bytes_`.
     bool is_newly_allocated_;           // True if it's allocated after the last collection.
@@ -746,6 +833,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
 
   // Cached version of Heap::use_generational_cc_.
   const bool use_generational_cc_;
+  // Number of young collections an object has to survive before being tenured.
+  const size_t tenure_threshold_;
   uint32_t time_;                  // The time as the number of collections since the startup.
   size_t num_regions_;             // The number of regions in this space.
   uint64_t madvise_time_;          // The amount of time spent in madvise for purging pages.
@@ -775,6 +864,9 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
 
   Region* current_region_;         // The region currently used for allocation.
   Region* evac_region_;            // The region currently used for evacuation.
+  // The regions currently used for evacuating survivors of young collections, indexed by age.
+  // Only entries in [1, `tenure_threshold_`) are used.
+  Region* survivor_regions_[kMaxTenureThreshold];
   Region full_region_;             // The fake/sentinel region that looks full.
 
   // Index into the region array pointing to the starting region when
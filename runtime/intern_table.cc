@@ -20,6 +20,7 @@
 
 #include "dex/utf.h"
 #include "gc/collector/garbage_collector.h"
+#include "gc/heap.h"
 #include "gc/space/image_space.h"
 #include "gc/weak_root_state.h"
 #include "gc_root-inl.h"
@@ -398,6 +399,7 @@ void InternTable::Table::SweepWeaks(IsMarkedVisitor* visitor) {
 }
 
 void InternTable::Table::SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor) {
+  const bool using_mark_compact = Runtime::Current()->GetHeap()->IsUsingMarkCompact();
   for (auto it = set->begin(), end = set->end(); it != end;) {
     // This does not need a read barrier because this is called by GC.
     mirror::Object* object = it->Read<kWithoutReadBarrier>();
@@ -405,7 +407,11 @@ void InternTable::Table::SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
     if (new_object == nullptr) {
       it = set->erase(it);
     } else {
-      *it = GcRoot<mirror::String>(new_object->AsString());
+      // Mark compact returns the post-compaction address before the string has been moved
+      // there, so the string cannot be checked through it yet.
+      *it = GcRoot<mirror::String>(UNLIKELY(using_mark_compact)
+          ? ObjPtr<mirror::String>::DownCast(new_object)
+          : new_object->AsString());
       ++it;
     }
   }
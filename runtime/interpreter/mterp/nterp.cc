@@ -711,6 +711,13 @@ extern "C" jit::OsrData* NterpHotMethod(ArtMethod* method, uint16_t* dex_pc_ptr,
       if (osr_data != nullptr) {
         return osr_data;
       }
+      // The loop may be hot on its own, even if the method is not.
+      if (jit->MaybeEnqueueOsrCompilation(method, dex_pc, Thread::Current())) {
+        return jit->PrepareForOsr(method->GetInterfaceMethodIfProxy(kRuntimePointerSize),
+                                  dex_pc,
+                                  vregs,
+                                  /*is_hot_loop=*/ true);
+      }
     }
     jit->MaybeEnqueueCompilation(method, Thread::Current());
   }
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_range_index.h"
+
+#include "base/globals.h"
+#include "base/logging.h"
+
+namespace art {
+namespace jit {
+
+CodeRangeIndex::CodeRangeIndex()
+    : snapshot_(new Snapshot()),
+      number_of_retired_snapshots_(0u),
+      retired_memory_(0u) {}
+
+CodeRangeIndex::~CodeRangeIndex() {
+  FreeRetiredSnapshots(number_of_retired_snapshots_);
+  delete snapshot_.load(std::memory_order_relaxed);
+}
+
+void CodeRangeIndex::Publish(std::vector<CodeRange>&& ranges) {
+  if (kIsDebugBuild) {
+    for (size_t i = 0; i != ranges.size(); ++i) {
+      DCHECK_LT(ranges[i].begin, ranges[i].end);
+      DCHECK(i == 0u || ranges[i - 1u].end <= ranges[i].begin);
+    }
+  }
+  Snapshot* snapshot = new Snapshot();
+  snapshot->ranges = std::move(ranges);
+  const Snapshot* old_snapshot = snapshot_.exchange(snapshot, std::memory_order_acq_rel);
+  retired_snapshots_.emplace_back(number_of_retired_snapshots_, old_snapshot);
+  ++number_of_retired_snapshots_;
+  retired_memory_ += SizeOf(old_snapshot);
+}
+
+void CodeRangeIndex::FreeRetiredSnapshots(uint64_t number_of_retired_snapshots) {
+  DCHECK_LE(number_of_retired_snapshots, number_of_retired_snapshots_);
+  while (!retired_snapshots_.empty() &&
+         retired_snapshots_.front().first < number_of_retired_snapshots) {
+    const Snapshot* snapshot = retired_snapshots_.front().second;
+    retired_memory_ -= SizeOf(snapshot);
+    delete snapshot;
+    retired_snapshots_.pop_front();
+  }
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_CODE_RANGE_INDEX_H_
+#define ART_RUNTIME_JIT_CODE_RANGE_INDEX_H_
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace art {
+namespace jit {
+
+// A sorted index of the ranges of compiled code, which threads walking their stack can query
+// without taking a lock.
+//
+// Lookups read an immutable snapshot of the ranges. Writers publish a new snapshot and retire the
+// previous one, in the style of read-copy-update: a retired snapshot may still be read by lookups
+// which started before it was retired, so it is only freed once the caller knows that these
+// lookups have completed. Writers must be serialized by the caller.
+class CodeRangeIndex {
+ public:
+  struct CodeRange {
+    uintptr_t begin;   // First pc of the range.
+    uintptr_t end;     // First pc after the range.
+    const void* code;  // What a lookup of a pc in the range returns.
+  };
+
+  CodeRangeIndex();
+  ~CodeRangeIndex();
+
+  // Returns the code of the published range containing `pc`, or null if there is none.
+  const void* Lookup(uintptr_t pc) const {
+    const Snapshot* snapshot = snapshot_.load(std::memory_order_acquire);
+    auto it = std::upper_bound(snapshot->ranges.begin(),
+                               snapshot->ranges.end(),
+                               pc,
+                               [](uintptr_t value, const CodeRange& range) {
+                                 return value < range.begin;
+                               });
+    if (it == snapshot->ranges.begin()) {
+      return nullptr;
+    }
+    --it;
+    return (pc < it->end) ? it->code : nullptr;
+  }
+
+  // Replaces the published ranges with `ranges`, which must be sorted and must not overlap.
+  // The previously published snapshot is retired.
+  void Publish(std::vector<CodeRange>&& ranges);
+
+  // Returns the number of snapshots retired so far. Once all lookups running when this was called
+  // have completed, the caller can free these snapshots with `FreeRetiredSnapshots()`.
+  uint64_t GetNumberOfRetiredSnapshots() const {
+    return number_of_retired_snapshots_;
+  }
+
+  // Frees the first `number_of_retired_snapshots` snapshots retired, which lookups no longer read.
+  void FreeRetiredSnapshots(uint64_t number_of_retired_snapshots);
+
+  // Returns the number of published ranges.
+  size_t GetNumberOfRanges() const {
+    return snapshot_.load(std::memory_order_relaxed)->ranges.size();
+  }
+
+  // Returns the memory used by the snapshots which were retired but not freed yet.
+  size_t GetRetiredMemory() const {
+    return retired_memory_;
+  }
+
+ private:
+  struct Snapshot {
+    std::vector<CodeRange> ranges;
+  };
+
+  static size_t SizeOf(const Snapshot* snapshot) {
+    return sizeof(Snapshot) + snapshot->ranges.capacity() * sizeof(CodeRange);
+  }
+
+  std::atomic<const Snapshot*> snapshot_;
+
+  // The retired snapshots, with the number of snapshots retired before them.
+  std::deque<std::pair<uint64_t, const Snapshot*>> retired_snapshots_;
+  uint64_t number_of_retired_snapshots_;
+  size_t retired_memory_;
+
+  DISALLOW_COPY_AND_ASSIGN(CodeRangeIndex);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_CODE_RANGE_INDEX_H_
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_range_index.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace art {
+namespace jit {
+
+// The index never dereferences the code, any distinct pointer will do.
+static const void* FakeCode(uintptr_t begin) {
+  return reinterpret_cast<const void*>(begin);
+}
+
+static CodeRangeIndex::CodeRange MakeRange(uintptr_t begin, uintptr_t end) {
+  return {begin, end, FakeCode(begin)};
+}
+
+TEST(CodeRangeIndexTest, Lookup) {
+  CodeRangeIndex index;
+  EXPECT_EQ(0u, index.GetNumberOfRanges());
+  EXPECT_EQ(nullptr, index.Lookup(0x1000u));
+
+  index.Publish({MakeRange(0x1000u, 0x1100u),
+                 MakeRange(0x1100u, 0x1180u),
+                 MakeRange(0x2000u, 0x2010u)});
+  EXPECT_EQ(3u, index.GetNumberOfRanges());
+  EXPECT_EQ(nullptr, index.Lookup(0xfffu));
+  EXPECT_EQ(FakeCode(0x1000u), index.Lookup(0x1000u));
+  EXPECT_EQ(FakeCode(0x1000u), index.Lookup(0x10ffu));
+  EXPECT_EQ(FakeCode(0x1100u), index.Lookup(0x1100u));
+  EXPECT_EQ(nullptr, index.Lookup(0x1180u));
+  EXPECT_EQ(nullptr, index.Lookup(0x1fffu));
+  EXPECT_EQ(FakeCode(0x2000u), index.Lookup(0x200fu));
+  EXPECT_EQ(nullptr, index.Lookup(0x2010u));
+
+  // Publishing replaces all the ranges, and retires the previous ones.
+  EXPECT_EQ(1u, index.GetNumberOfRetiredSnapshots());
+  index.Publish({MakeRange(0x1100u, 0x1180u)});
+  EXPECT_EQ(2u, index.GetNumberOfRetiredSnapshots());
+  EXPECT_EQ(nullptr, index.Lookup(0x1000u));
+  EXPECT_EQ(FakeCode(0x1100u), index.Lookup(0x1100u));
+  EXPECT_EQ(nullptr, index.Lookup(0x2000u));
+
+  EXPECT_NE(0u, index.GetRetiredMemory());
+  index.FreeRetiredSnapshots(1u);
+  EXPECT_NE(0u, index.GetRetiredMemory());
+  index.FreeRetiredSnapshots(2u);
+  EXPECT_EQ(0u, index.GetRetiredMemory());
+  // Freeing does not change the number of snapshots retired so far.
+  EXPECT_EQ(2u, index.GetNumberOfRetiredSnapshots());
+  EXPECT_EQ(FakeCode(0x1100u), index.Lookup(0x1100u));
+}
+
+// A writer publishes the ranges with code being added and removed while readers look up pcs,
+// and frees the retired snapshots once all readers have completed a lookup since they were
+// retired, as the runtime does with a checkpoint.
+TEST(CodeRangeIndexTest, ConcurrentPublishAndLookup) {
+  static constexpr size_t kNumReaders = 4;
+  static constexpr size_t kNumRanges = 256;
+  static constexpr size_t kNumPublishes = 2000;
+  static constexpr size_t kPublishesBetweenFrees = 16;
+  static constexpr uintptr_t kRangeSize = 0x40u;
+  static constexpr uintptr_t kBase = 0x10000u;
+
+  // Even ranges are always published, odd ranges come and go, and the last quarter of each
+  // range is never part of it.
+  auto range_at = [](size_t i) {
+    uintptr_t begin = kBase + i * kRangeSize;
+    return MakeRange(begin, begin + kRangeSize * 3u / 4u);
+  };
+  auto ranges_for = [&](size_t iteration) {
+    std::vector<CodeRangeIndex::CodeRange> ranges;
+    for (size_t i = 0; i != kNumRanges; ++i) {
+      if (i % 2u == 0u || (i / 2u + iteration) % 3u == 0u) {
+        ranges.push_back(range_at(i));
+      }
+    }
+    return ranges;
+  };
+
+  CodeRangeIndex index;
+  index.Publish(ranges_for(0u));
+
+  std::atomic<bool> done(false);
+  std::atomic<size_t> failures(0u);
+  std::vector<std::atomic<uint64_t>> lookups(kNumReaders);
+  std::vector<std::thread> readers;
+  for (size_t r = 0; r != kNumReaders; ++r) {
+    lookups[r].store(0u);
+    readers.emplace_back([&, r]() {
+      uint64_t pc_seed = r;
+      while (!done.load(std::memory_order_relaxed)) {
+        pc_seed = pc_seed * 6364136223846793005u + 1442695040888963407u;
+        uintptr_t pc = kBase + (pc_seed >> 33) % (kNumRanges * kRangeSize);
+        size_t i = (pc - kBase) / kRangeSize;
+        CodeRangeIndex::CodeRange range = range_at(i);
+        const void* code = index.Lookup(pc);
+        bool ok;
+        if (pc >= range.end) {
+          ok = (code == nullptr);
+        } else if (i % 2u == 0u) {
+          ok = (code == range.code);
+        } else {
+          ok = (code == nullptr || code == range.code);
+        }
+        if (!ok) {
+          failures.fetch_add(1u);
+        }
+        lookups[r].fetch_add(1u, std::memory_order_release);
+      }
+    });
+  }
+
+  for (size_t iteration = 1u; iteration <= kNumPublishes; ++iteration) {
+    index.Publish(ranges_for(iteration));
+    if (iteration % kPublishesBetweenFrees == 0u) {
+      uint64_t number_of_retired_snapshots = index.GetNumberOfRetiredSnapshots();
+      std::vector<uint64_t> start(kNumReaders);
+      for (size_t r = 0; r != kNumReaders; ++r) {
+        start[r] = lookups[r].load(std::memory_order_acquire);
+      }
+      // A reader which completed a lookup since no longer reads the retired snapshots.
+      for (size_t r = 0; r != kNumReaders; ++r) {
+        while (lookups[r].load(std::memory_order_acquire) == start[r]) {
+          std::this_thread::yield();
+        }
+      }
+      index.FreeRetiredSnapshots(number_of_retired_snapshots);
+      EXPECT_EQ(0u, index.GetRetiredMemory());
+    }
+  }
+  done.store(true);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(0u, failures.load());
+  EXPECT_EQ(kNumPublishes + 1u, index.GetNumberOfRetiredSnapshots());
+  EXPECT_EQ(ranges_for(kNumPublishes).size(), index.GetNumberOfRanges());
+}
+
+}  // namespace jit
+}  // namespace art
@@ -78,6 +78,10 @@ static constexpr uint32_t kJitStressDefaultWarmupThreshold = kJitDefaultWarmupTh
 static constexpr uint32_t kJitSlowStressDefaultWarmupThreshold =
     kJitStressDefaultWarmupThreshold / 2;
 
+// Nterp charges a full warmup of the hotness counter to a loop each time the counter runs out on
+// one of its back edges, so a loop is only deemed hot on its own after several such warmups.
+static constexpr uint32_t kJitDefaultOsrThresholdWarmupRatio = 4;
+
 DEFINE_RUNTIME_DEBUG_FLAG(Jit, kSlowMode);
 
 // JIT compiler
@@ -103,6 +107,9 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
   jit_options->zygote_thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITZygotePoolThreadPthreadPriority);
+  jit_options->thread_pool_size_ =
+      std::max(1u, options.GetOrDefault(RuntimeArgumentMap::JITPoolThreads));
+  jit_options->cache_file_ = options.GetOrDefault(RuntimeArgumentMap::JITCacheFile);
 
   // Set default optimize threshold to aid with checking defaults.
   jit_options->optimize_threshold_ =
@@ -129,6 +136,16 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   }
   DCHECK_LE(jit_options->warmup_threshold_, kJitMaxThreshold);
 
+  if (options.Exists(RuntimeArgumentMap::JITOsrThreshold)) {
+    jit_options->osr_threshold_ = *options.Get(RuntimeArgumentMap::JITOsrThreshold);
+    if (jit_options->osr_threshold_ <= jit_options->warmup_threshold_) {
+      LOG(FATAL) << "OSR threshold must be above the warmup threshold.";
+    }
+  } else {
+    jit_options->osr_threshold_ =
+        jit_options->warmup_threshold_ * kJitDefaultOsrThresholdWarmupRatio;
+  }
+
   if (options.Exists(RuntimeArgumentMap::JITPriorityThreadWeight)) {
     jit_options->priority_thread_weight_ =
         *options.Get(RuntimeArgumentMap::JITPriorityThreadWeight);
@@ -162,6 +179,8 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
 
 void Jit::DumpInfo(std::ostream& os) {
   code_cache_->Dump(os);
+  os << "Total number of JIT recompilations after deoptimization: "
+     << recompilations_after_deoptimization_.load(std::memory_order_relaxed) << "\n";
   cumulative_timings_.Dump(os);
   MutexLock mu(Thread::Current(), lock_);
   memory_use_.PrintMemoryUse(os);
@@ -217,6 +236,7 @@ Jit* Jit::Create(JitCodeCache* code_cache, JitOptions* options) {
       << ", max_capacity=" << PrettySize(options->GetCodeCacheMaxCapacity())
       << ", warmup_threshold=" << options->GetWarmupThreshold()
       << ", optimize_threshold=" << options->GetOptimizeThreshold()
+      << ", osr_threshold=" << options->GetOsrThreshold()
       << ", profile_saver_options=" << options->GetProfileSaverOptions();
 
   // We want to know whether the compiler is compiling baseline, as this
@@ -228,6 +248,10 @@ Jit* Jit::Create(JitCodeCache* code_cache, JitOptions* options) {
     }
   }
 
+  if (!options->GetCacheFile().empty() && !Runtime::Current()->IsZygote()) {
+    jit->LoadCacheFile();
+  }
+
   // Notify native debugger about the classes already loaded before the creation of the jit.
   jit->DumpTypeInfoForLoadedTypes(Runtime::Current()->GetClassLinker());
   return jit.release();
@@ -350,7 +374,7 @@ void Jit::WaitForWorkersToBeCreated() {
 void Jit::DeleteThreadPool() {
   Thread* self = Thread::Current();
   if (thread_pool_ != nullptr) {
-    std::unique_ptr<ThreadPool> pool;
+    std::unique_ptr<JitThreadPool> pool;
     {
       ScopedSuspendAll ssa(__FUNCTION__);
       // Clear thread_pool_ field while the threads are suspended.
@@ -382,6 +406,71 @@ void Jit::StartProfileSaver(const std::string& profile_filename,
   }
 }
 
+void Jit::LoadCacheFile() {
+  const std::string& filename = options_->GetCacheFile();
+  cache_profile_ = std::make_unique<ProfileCompilationInfo>();
+  unix_file::FdFile file(filename.c_str(), O_RDONLY, /* check_usage= */ false);
+  // The file is missing on the first run. The next save creates it.
+  if (file.Fd() == -1) {
+    VLOG(jit) << "Not using the JIT cache file " << filename << ": " << strerror(errno);
+    return;
+  }
+  if (!cache_profile_->Load(file.Fd())) {
+    LOG(WARNING) << "Could not load the JIT cache file " << filename;
+    cache_profile_ = std::make_unique<ProfileCompilationInfo>();
+    return;
+  }
+  VLOG(jit) << "Loaded the JIT cache file " << filename << " with "
+            << cache_profile_->GetNumberOfMethods() << " methods";
+}
+
+void Jit::SaveCacheFile() {
+  if (cache_profile_ == nullptr) {
+    return;
+  }
+  const std::string& filename = options_->GetCacheFile();
+  Thread* self = Thread::Current();
+  ProfileCompilationInfo info;
+  size_t number_of_methods = 0u;
+  {
+    ScopedObjectAccess soa(self);
+    std::vector<std::pair<ArtMethod*, CompilationKind>> methods;
+    code_cache_->GetCompiledMethods(self, &methods);
+    for (const auto& [method, kind] : methods) {
+      // Optimized methods are hot. Baseline methods were executed but not hot yet, which we
+      // record as post startup.
+      ProfileCompilationInfo::MethodHotness::Flag flag = (kind == CompilationKind::kOptimized)
+          ? ProfileCompilationInfo::MethodHotness::kFlagHot
+          : ProfileCompilationInfo::MethodHotness::kFlagPostStartup;
+      if (info.AddMethod(ProfileMethodInfo(method->ToMethodReference()), flag)) {
+        ++number_of_methods;
+      }
+    }
+  }
+
+  // Write to a temporary file first, so that a process starting concurrently never sees a
+  // partially written file. The name is unique, as the file may be saved by several threads or
+  // processes at once.
+  std::string temp_filename = filename + ".XXXXXX";
+  unique_fd fd(mkstemp(temp_filename.data()));
+  if (fd.get() == -1) {
+    PLOG(WARNING) << "Could not create " << temp_filename;
+    return;
+  }
+  if (!info.Save(fd.get()) || fsync(fd.get()) != 0) {
+    PLOG(WARNING) << "Could not write the JIT cache file " << temp_filename;
+    unlink(temp_filename.c_str());
+    return;
+  }
+  fd.reset();
+  if (rename(temp_filename.c_str(), filename.c_str()) != 0) {
+    PLOG(WARNING) << "Could not rename " << temp_filename << " to " << filename;
+    unlink(temp_filename.c_str());
+    return;
+  }
+  VLOG(jit) << "Saved " << number_of_methods << " methods to " << filename;
+}
+
 void Jit::StopProfileSaver() {
   if (options_->GetSaveProfilingInfo() && ProfileSaver::IsStarted()) {
     ProfileSaver::Stop(options_->DumpJitInfoOnShutdown());
@@ -449,14 +538,17 @@ extern "C" void art_quick_osr_stub(void** stack,
                                    const char* shorty,
                                    Thread* self);
 
-OsrData* Jit::PrepareForOsr(ArtMethod* method, uint32_t dex_pc, uint32_t* vregs) {
+OsrData* Jit::PrepareForOsr(ArtMethod* method,
+                            uint32_t dex_pc,
+                            uint32_t* vregs,
+                            bool is_hot_loop) {
   if (!kEnableOnStackReplacement) {
     return nullptr;
   }
 
   // Cheap check if the method has been compiled already. That's an indicator that we should
-  // osr into it.
-  if (!GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+  // osr into it. The OSR code of a hot loop may be the only code of its method.
+  if (!is_hot_loop && !GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
     return nullptr;
   }
 
@@ -1031,6 +1123,54 @@ class JitProfileTask final : public Task {
   DISALLOW_COPY_AND_ASSIGN(JitProfileTask);
 };
 
+// A JIT task to compile the methods that the cache file recorded for some dex files.
+class JitCacheTask final : public Task {
+ public:
+  // A null `class_loader` is for the boot class path.
+  JitCacheTask(const std::vector<const DexFile*>& dex_files, jobject class_loader)
+      : dex_files_(dex_files), class_loader_(nullptr) {
+    if (class_loader == nullptr) {
+      return;
+    }
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+        soa.Decode<mirror::ClassLoader>(class_loader)));
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    for (const DexFile* dex_file : dex_files_) {
+      // Register the dex file so that we can guarantee it doesn't get deleted
+      // while reading it during the task.
+      class_linker->RegisterDexFile(*dex_file, h_loader.Get());
+    }
+    class_loader_ = soa.Vm()->AddGlobalRef(soa.Self(), h_loader.Get());
+  }
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<1> hs(self);
+    Handle<mirror::ClassLoader> loader = hs.NewHandle<mirror::ClassLoader>(
+        soa.Decode<mirror::ClassLoader>(class_loader_));
+    Runtime::Current()->GetJit()->CompileMethodsFromCacheFile(self, dex_files_, loader);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+  ~JitCacheTask() {
+    if (class_loader_ != nullptr) {
+      ScopedObjectAccess soa(Thread::Current());
+      soa.Vm()->DeleteGlobalRef(soa.Self(), class_loader_);
+    }
+  }
+
+ private:
+  std::vector<const DexFile*> dex_files_;
+  jobject class_loader_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitCacheTask);
+};
+
 static void CopyIfDifferent(void* s1, const void* s2, size_t n) {
   if (memcmp(s1, s2, n) != 0) {
     memcpy(s1, s2, n);
@@ -1172,7 +1312,7 @@ void Jit::CreateThreadPool() {
 
   // We need peers as we may report the JIT thread, e.g., in the debugger.
   constexpr bool kJitPoolNeedsPeers = true;
-  thread_pool_.reset(new ThreadPool("Jit thread pool", 1, kJitPoolNeedsPeers));
+  thread_pool_.reset(new JitThreadPool("Jit thread pool", GetThreadPoolSize(), kJitPoolNeedsPeers));
 
   Runtime* runtime = Runtime::Current();
   thread_pool_->SetPthreadPriority(
@@ -1181,6 +1321,14 @@ void Jit::CreateThreadPool() {
           : options_->GetThreadPoolPthreadPriority());
   Start();
 
+  if (cache_profile_ != nullptr && UseJitCompilation()) {
+    // The methods of the other dex files are compiled when the dex files are registered.
+    const std::vector<const DexFile*>& boot_class_path =
+        runtime->GetClassLinker()->GetBootClassPath();
+    thread_pool_->AddTask(Thread::Current(),
+                          new JitCacheTask(boot_class_path, /* class_loader= */ nullptr));
+  }
+
   if (runtime->IsZygote()) {
     // To speed up class lookups, generate a type lookup table for
     // dex files not backed by oat file.
@@ -1288,6 +1436,64 @@ void Jit::RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& de
       !runtime->IsJavaDebuggable()) {
     thread_pool_->AddTask(Thread::Current(), new JitProfileTask(dex_files, class_loader));
   }
+  if (cache_profile_ != nullptr && UseJitCompilation() && thread_pool_ != nullptr) {
+    std::vector<const DexFile*> dex_file_ptrs;
+    for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+      dex_file_ptrs.push_back(dex_file.get());
+    }
+    thread_pool_->AddTask(Thread::Current(), new JitCacheTask(dex_file_ptrs, class_loader));
+  }
+}
+
+uint32_t Jit::CompileMethodsFromCacheFile(Thread* self,
+                                          const std::vector<const DexFile*>& dex_files,
+                                          Handle<mirror::ClassLoader> class_loader) {
+  DCHECK(cache_profile_ != nullptr);
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  StackHandleScope<1> hs(self);
+  MutableHandle<mirror::DexCache> dex_cache = hs.NewHandle<mirror::DexCache>(nullptr);
+  uint32_t added_to_queue = 0u;
+  for (const DexFile* dex_file : dex_files) {
+    std::set<dex::TypeIndex> class_types;
+    std::set<uint16_t> hot_methods;
+    std::set<uint16_t> startup_methods;
+    std::set<uint16_t> baseline_methods;
+    if (!cache_profile_->GetClassesAndMethods(*dex_file,
+                                              &class_types,
+                                              &hot_methods,
+                                              &startup_methods,
+                                              &baseline_methods)) {
+      // The file has no methods of this dex file, or was written for another version of it.
+      continue;
+    }
+    dex_cache.Assign(class_linker->FindDexCache(self, *dex_file));
+    CHECK(dex_cache != nullptr) << "Could not find dex cache for " << dex_file->GetLocation();
+    auto add_compile_tasks = [&](const std::set<uint16_t>& methods, CompilationKind kind)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      for (uint16_t method_idx : methods) {
+        ArtMethod* method = class_linker->ResolveMethodWithoutInvokeType(
+            method_idx, dex_cache, class_loader);
+        if (method == nullptr) {
+          self->ClearException();
+          continue;
+        }
+        if (!method->IsCompilable() ||
+            !method->IsInvokable() ||
+            method->IsNative() ||
+            code_cache_->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+          continue;
+        }
+        // Static methods of classes which are not initialized yet are not compiled, see
+        // JitCodeCache::NotifyCompilationOf. They are compiled once they get hot.
+        AddCompileTask(self, method, kind);
+        ++added_to_queue;
+      }
+    };
+    add_compile_tasks(hot_methods, CompilationKind::kOptimized);
+    add_compile_tasks(baseline_methods, CompilationKind::kBaseline);
+  }
+  VLOG(jit) << "Queued " << added_to_queue << " compilations from the JIT cache file";
+  return added_to_queue;
 }
 
 bool Jit::CompileMethodFromProfile(Thread* self,
@@ -1475,14 +1681,20 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   // hotness threshold. If we're not only using the baseline compiler, enqueue a compilation
   // task that will compile optimize the method.
   if (!options_->UseBaselineCompiler()) {
-    thread_pool_->AddTask(
-        self,
-        new JitCompileTask(method,
-                           JitCompileTask::TaskKind::kCompile,
-                           CompilationKind::kOptimized));
+    AddCompileTask(self, method, CompilationKind::kOptimized);
   }
 }
 
+void Jit::AddCompileTask(Thread* self, ArtMethod* method, CompilationKind compilation_kind) {
+  thread_pool_->AddCompileTask(self, method, compilation_kind, [=]() {
+    return new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, compilation_kind);
+  });
+}
+
+size_t Jit::GetThreadPoolSize() const {
+  return Runtime::Current()->IsZygote() ? 1u : options_->GetThreadPoolSize();
+}
+
 class ScopedSetRuntimeThread {
  public:
   explicit ScopedSetRuntimeThread(Thread* self)
@@ -1665,7 +1877,7 @@ void Jit::PostZygoteFork() {
     NotifyZygoteCompilationDone();
     CHECK(code_cache_->GetZygoteMap()->IsCompilationNotified());
   }
-  thread_pool_->CreateThreads();
+  thread_pool_->CreateThreads(GetThreadPoolSize());
   thread_pool_->SetPthreadPriority(
       runtime->IsZygote()
           ? options_->GetZygoteThreadPoolPthreadPriority()
@@ -1745,9 +1957,7 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
     if (!method->IsNative() && !code_cache_->IsOsrCompiled(method)) {
       // If we already have compiled code for it, nterp may be stuck in a loop.
       // Compile OSR.
-      thread_pool_->AddTask(
-          self,
-          new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, CompilationKind::kOsr));
+      AddCompileTask(self, method, CompilationKind::kOsr);
     }
     return;
   }
@@ -1781,17 +1991,80 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
   }
 
   if (!method->IsNative() && GetCodeCache()->CanAllocateProfilingInfo()) {
-    thread_pool_->AddTask(
-        self,
-        new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, CompilationKind::kBaseline));
+    AddCompileTask(self, method, CompilationKind::kBaseline);
   } else {
-    thread_pool_->AddTask(
-        self,
-        new JitCompileTask(method,
-                           JitCompileTask::TaskKind::kCompile,
-                           CompilationKind::kOptimized));
+    AddCompileTask(self, method, CompilationKind::kOptimized);
   }
 }
 
+void Jit::NotifyDeoptimization(Thread* self,
+                               ArtMethod* method,
+                               const OatQuickMethodHeader* header,
+                               ArtMethod* site_method,
+                               uint32_t dex_pc,
+                               DeoptimizationKind kind) {
+  DCHECK_NE(kind, DeoptimizationKind::kDebugging);
+  bool is_baseline = CodeInfo::IsBaseline(header->GetOptimizedCodeInfoPtr());
+  bool is_entry_point = GetCodeCache()->InvalidateCompiledCodeFor(method, header);
+  uint32_t deoptimizations = GetCodeCache()->AddDeoptimization(method, site_method, dex_pc, kind);
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  metrics->JitDeoptimizationCount()->AddOne();
+  VLOG(jit) << method->PrettyMethod() << " deoptimized " << deoptimizations << " times, last "
+            << "because of " << GetDeoptimizationKindName(kind) << " at dex pc 0x" << std::hex
+            << dex_pc << std::dec << " of " << site_method->PrettyMethod();
+
+  // The method was hot enough to be optimized, and its next compilation will not make the
+  // speculation that failed: recompile it now rather than wait for it to get hot again.
+  // OSR code is only needed by the frame that used it, and baseline code does not speculate.
+  if (!is_entry_point ||
+      is_baseline ||
+      deoptimizations > kMaxRecompilationsAfterDeoptimization ||
+      thread_pool_ == nullptr ||
+      !UseJitCompilation() ||
+      JitAtFirstUse()) {
+    return;
+  }
+  AddCompileTask(self, method, CompilationKind::kOptimized);
+  ++recompilations_after_deoptimization_;
+  metrics->JitDeoptimizationRecompileCount()->AddOne();
+}
+
+bool Jit::MaybeEnqueueOsrCompilation(ArtMethod* method, uint32_t dex_pc, Thread* self) {
+  if (!kEnableOnStackReplacement ||
+      thread_pool_ == nullptr ||
+      JitAtFirstUse() ||
+      !UseJitCompilation() ||
+      IgnoreSamplesForMethod(method) ||
+      method->IsNative() ||
+      // Memory shared methods count their hotness per thread, and OSR code cannot be
+      // put in the shared region.
+      method->IsMemorySharedMethod() ||
+      GetCodeCache()->IsSharedRegion(*GetCodeCache()->GetCurrentRegion())) {
+    return false;
+  }
+
+  // The code cache does not keep JIT code that needs a class initialization check, including
+  // OSR code. Let the regular path request the visible initialization.
+  if (NeedsClinitCheckBeforeCall(method) &&
+      !method->GetDeclaringClass()->IsVisiblyInitialized()) {
+    return false;
+  }
+
+  // Charge the back edges that made the method counter run out to the loop they ended in.
+  // The counter also counts method entries and other loops, so this over-approximates the
+  // back edges of the loop. The OSR threshold is several warmups to make up for it.
+  uint32_t back_edges =
+      GetCodeCache()->AddBackEdges(self, method, dex_pc, options_->GetWarmupThreshold());
+  if (back_edges < options_->GetOsrThreshold()) {
+    return false;
+  }
+  if (!GetCodeCache()->IsOsrCompiled(method)) {
+    VLOG(jit) << "Loop at dex pc 0x" << std::hex << dex_pc << std::dec << " of "
+              << method->PrettyMethod() << " is hot after " << back_edges << " back edges";
+    AddCompileTask(self, method, CompilationKind::kOsr);
+  }
+  return true;
+}
+
 }  // namespace jit
 }  // namespace art
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include <atomic>
+
 #include <android-base/unique_fd.h>
 
 #include "base/histogram-inl.h"
@@ -25,10 +27,12 @@
 #include "base/runtime_debug.h"
 #include "base/timing_logger.h"
 #include "compilation_kind.h"
+#include "deoptimization_kind.h"
 #include "handle.h"
 #include "offsets.h"
 #include "interpreter/mterp/nterp.h"
 #include "jit/debugger_interface.h"
+#include "jit/jit_thread_pool.h"
 #include "jit/profile_saver_options.h"
 #include "obj_ptr.h"
 #include "thread_pool.h"
@@ -39,6 +43,8 @@ class ArtMethod;
 class ClassLinker;
 class DexFile;
 class OatDexFile;
+class OatQuickMethodHeader;
+class ProfileCompilationInfo;
 struct RuntimeArgumentMap;
 union JValue;
 
@@ -65,6 +71,8 @@ static constexpr int kJitPoolThreadPthreadDefaultPriority = 9;
 // 19 is the lowest background priority on device.
 // See android/os/Process.java.
 static constexpr int kJitZygotePoolThreadPthreadDefaultPriority = 19;
+// How many threads compile methods in an app. The zygote always uses a single thread.
+static constexpr unsigned int kJitPoolDefaultThreads = 1;
 
 class JitOptions {
  public:
@@ -78,6 +86,12 @@ class JitOptions {
     return warmup_threshold_;
   }
 
+  // The number of back edges of a single loop after which its method is OSR compiled, even if
+  // the method itself is not hot.
+  uint32_t GetOsrThreshold() const {
+    return osr_threshold_;
+  }
+
   uint16_t GetPriorityThreadWeight() const {
     return priority_thread_weight_;
   }
@@ -114,6 +128,15 @@ class JitOptions {
     return zygote_thread_pool_pthread_priority_;
   }
 
+  size_t GetThreadPoolSize() const {
+    return thread_pool_size_;
+  }
+
+  // The file recording the compiled methods across runs, or empty if there is none.
+  const std::string& GetCacheFile() const {
+    return cache_file_;
+  }
+
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -159,11 +182,14 @@ class JitOptions {
   size_t code_cache_max_capacity_;
   uint32_t optimize_threshold_;
   uint32_t warmup_threshold_;
+  uint32_t osr_threshold_;
   uint16_t priority_thread_weight_;
   uint16_t invoke_transition_weight_;
   bool dump_info_on_shutdown_;
   int thread_pool_pthread_priority_;
   int zygote_thread_pool_pthread_priority_;
+  size_t thread_pool_size_;
+  std::string cache_file_;
   ProfileSaverOptions profile_saver_options_;
 
   JitOptions()
@@ -174,11 +200,13 @@ class JitOptions {
         code_cache_max_capacity_(0),
         optimize_threshold_(0),
         warmup_threshold_(0),
+        osr_threshold_(0),
         priority_thread_weight_(0),
         invoke_transition_weight_(0),
         dump_info_on_shutdown_(false),
         thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority),
-        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority) {}
+        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority),
+        thread_pool_size_(kJitPoolDefaultThreads) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
@@ -232,6 +260,9 @@ class Jit {
   static constexpr size_t kDefaultInvokeTransitionWeightRatio = 500;
   // How frequently should the interpreter check to see if OSR compilation is ready.
   static constexpr int16_t kJitRecheckOSRThreshold = 101;  // Prime number to avoid patterns.
+  // How many times the compiled code of a method can deoptimize and be recompiled right away.
+  // Past that, the method needs to get hot again to be recompiled.
+  static constexpr uint32_t kMaxRecompilationsAfterDeoptimization = 4;
 
   DECLARE_RUNTIME_DEBUG_FLAG(kSlowMode);
 
@@ -331,6 +362,11 @@ class Jit {
                          const std::string& ref_profile_filename);
   void StopProfileSaver();
 
+  // Record the methods compiled in this run in the cache file of the JIT options, if any, for the
+  // next run to compile them at startup. Called periodically by the profile saver, on
+  // System.exit() and at shutdown.
+  void SaveCacheFile() REQUIRES(!Locks::mutator_lock_);
+
   void DumpForSigQuit(std::ostream& os) REQUIRES(!lock_);
 
   static void NewTypeLoadedIfUsingJit(mirror::Class* type)
@@ -347,8 +383,12 @@ class Jit {
   bool CanInvokeCompiledCode(ArtMethod* method);
 
   // Return the information required to do an OSR jump. Return null if the OSR
-  // cannot be done.
-  OsrData* PrepareForOsr(ArtMethod* method, uint32_t dex_pc, uint32_t* vregs)
+  // cannot be done. Unless `is_hot_loop`, only look for OSR code if the method has been
+  // compiled already.
+  OsrData* PrepareForOsr(ArtMethod* method,
+                         uint32_t dex_pc,
+                         uint32_t* vregs,
+                         bool is_hot_loop = false)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // If an OSR compiled version is available for `method`,
@@ -413,6 +453,13 @@ class Jit {
                                          Handle<mirror::ClassLoader> class_loader,
                                          bool add_to_queue);
 
+  // Queue the compilation of the methods of `dex_files` that the cache file recorded.
+  // Return the number of methods added to the queue.
+  uint32_t CompileMethodsFromCacheFile(Thread* self,
+                                       const std::vector<const DexFile*>& dex_files,
+                                       Handle<mirror::ClassLoader> class_loader)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Register the dex files to the JIT. This is to perform any compilation/optimization
   // at the point of loading the dex files.
   void RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
@@ -436,14 +483,46 @@ class Jit {
   // class path methods.
   void NotifyZygoteCompilationDone();
 
-  void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self);
+  void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   void MaybeEnqueueCompilation(ArtMethod* method, Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Called when compiled code of `method` deoptimizes because the `kind` speculation made at
+  // `dex_pc` of `site_method` failed. Invalidates the code and, unless the method deoptimizes
+  // too often, queues its recompilation without the failed speculation.
+  void NotifyDeoptimization(Thread* self,
+                            ArtMethod* method,
+                            const OatQuickMethodHeader* header,
+                            ArtMethod* site_method,
+                            uint32_t dex_pc,
+                            DeoptimizationKind kind)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Called by nterp when the hotness counter of `method` runs out on a back edge to the loop
+  // header at `dex_pc`. Records the back edges in the loop's counter and, once the loop alone is
+  // hot, queues an OSR compilation of `method` without waiting for baseline code. Returns
+  // whether the loop is hot, in which case its OSR code is queued or already there. Does not
+  // suspend.
+  bool MaybeEnqueueOsrCompilation(ArtMethod* method, uint32_t dex_pc, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
  private:
   Jit(JitCodeCache* code_cache, JitOptions* options);
 
+  // Read the cache file of the JIT options.
+  void LoadCacheFile();
+
+  // Queue the compilation of a hot method. Compilations which are already queued are not queued
+  // again, but move ahead in the queue.
+  void AddCompileTask(Thread* self, ArtMethod* method, CompilationKind compilation_kind)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // The number of threads of the thread pool. The zygote only compiles in the background and
+  // uses a single thread.
+  size_t GetThreadPoolSize() const;
+
   // Whether we should not add hotness counts for the given method.
   bool IgnoreSamplesForMethod(ArtMethod* method)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -471,9 +550,14 @@ class Jit {
   jit::JitCodeCache* const code_cache_;
   const JitOptions* const options_;
 
-  std::unique_ptr<ThreadPool> thread_pool_;
+  std::unique_ptr<JitThreadPool> thread_pool_;
   std::vector<std::unique_ptr<OatDexFile>> type_lookup_tables_;
 
+  // The methods compiled by the previous run, if the JIT options have a cache file. The file is
+  // a profile, with the optimized methods hot and the baseline ones post startup. Not used in
+  // the zygote, which would share the file with all the apps it forks.
+  std::unique_ptr<ProfileCompilationInfo> cache_profile_;
+
   Mutex boot_completed_lock_;
   bool boot_completed_ GUARDED_BY(boot_completed_lock_) = false;
   std::deque<Task*> tasks_after_boot_ GUARDED_BY(boot_completed_lock_);
@@ -507,6 +591,9 @@ class Jit {
   // between the zygote and apps.
   std::map<ArtMethod*, uint16_t> shared_method_counters_;
 
+  // Number of compilations queued right away after a deoptimization.
+  std::atomic<uint32_t> recompilations_after_deoptimization_ = 0u;
+
   DISALLOW_COPY_AND_ASSIGN(Jit);
 };
 
@@ -16,6 +16,8 @@
 
 #include "jit_code_cache.h"
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 #include <android-base/logging.h>
@@ -28,6 +30,7 @@
 #include "base/membarrier.h"
 #include "base/memfd.h"
 #include "base/mem_map.h"
+#include "base/memory_tool.h"
 #include "base/quasi_atomic.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
@@ -66,6 +69,10 @@ namespace jit {
 static constexpr size_t kCodeSizeLogThreshold = 50 * KB;
 static constexpr size_t kStackMapSizeLogThreshold = 50 * KB;
 
+// Compact the code after a collection when more than this percentage of the free code memory is
+// outside of the largest free block.
+static constexpr size_t kCompactionFragmentationThreshold = 50;
+
 class JitCodeCache::JniStubKey {
  public:
   explicit JniStubKey(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_)
@@ -264,6 +271,8 @@ JitCodeCache* JitCodeCache::Create(bool used_only_for_profile_data,
 JitCodeCache::JitCodeCache()
     : is_weak_access_enabled_(true),
       inline_cache_cond_("Jit inline cache condition variable", *Locks::jit_lock_),
+      number_of_unpublished_code_ranges_(0u),
+      freeing_retired_code_ranges_(false),
       zygote_map_(&shared_region_),
       lock_cond_("Jit code cache condition variable", *Locks::jit_lock_),
       collection_in_progress_(false),
@@ -273,6 +282,11 @@ JitCodeCache::JitCodeCache()
       number_of_optimized_compilations_(0),
       number_of_osr_compilations_(0),
       number_of_collections_(0),
+      number_of_compactions_(0),
+      force_compaction_for_testing_(false),
+      fragmentation_before_compaction_(0),
+      fragmentation_after_compaction_(0),
+      number_of_deoptimizations_(0),
       histogram_stack_map_memory_use_("Memory used for stack maps", 16),
       histogram_code_memory_use_("Memory used for compiled code", 16),
       histogram_profiling_info_memory_use_("Memory used for profiling info", 16) {
@@ -402,6 +416,14 @@ static const uint8_t* GetRootTable(const void* code_ptr, uint32_t* number_of_roo
 void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   for (const auto& entry : method_code_map_) {
+    auto copy_it = code_copies_.find(entry.first);
+    if (copy_it != code_copies_.end() &&
+        copy_it->second < entry.first &&
+        method_code_map_.find(copy_it->second) != method_code_map_.end()) {
+      // The roots are shared with the other copy of the code, and were swept with it. Sweeping
+      // them again could read through a moved object.
+      continue;
+    }
     uint32_t number_of_roots = 0;
     const uint8_t* root_table = GetRootTable(entry.first, &number_of_roots);
     uint8_t* roots_data = private_region_.IsInDataSpace(root_table)
@@ -422,7 +444,8 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
         // TODO: Do not use IsMarked for j.l.Class, and adjust once we move this method
         // out of the weak access/creation pause. b/32167580
         if (new_object != nullptr && new_object != object) {
-          DCHECK(new_object->IsString());
+          // Mark compact returns a post-compaction address the string has not been moved to yet.
+          DCHECK(Runtime::Current()->GetHeap()->IsUsingMarkCompact() || new_object->IsString());
           roots[i] = GcRoot<mirror::Object>(new_object);
         }
       } else {
@@ -440,6 +463,10 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
       InlineCache* cache = &info->cache_[i];
       for (size_t j = 0; j < InlineCache::kIndividualCacheSize; ++j) {
         Runtime::ProcessWeakClass(&cache->classes_[j], visitor, nullptr);
+        if (cache->classes_[j].IsNull()) {
+          // The entry may be reused by another class, drop the count of the unloaded one.
+          cache->counts_[j] = 0u;
+        }
       }
     }
   }
@@ -452,7 +479,12 @@ void JitCodeCache::FreeCodeAndData(const void* code_ptr) {
   }
   uintptr_t allocation = FromCodeToAllocation(code_ptr);
   const uint8_t* data = nullptr;
-  if (OatQuickMethodHeader::FromCodePointer(code_ptr)->IsOptimized()) {
+  auto copy_it = code_copies_.find(code_ptr);
+  if (copy_it != code_copies_.end()) {
+    // The other copy of the code still uses the data.
+    code_copies_.erase(copy_it->second);
+    code_copies_.erase(copy_it);
+  } else if (OatQuickMethodHeader::FromCodePointer(code_ptr)->IsOptimized()) {
     data = GetRootTable(code_ptr);
   }  // else this is a JNI stub without any data.
 
@@ -527,15 +559,20 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
           ++it;
         }
       }
+      bool removed_code = false;
       for (auto it = method_code_map_.begin(); it != method_code_map_.end();) {
         if (alloc.ContainsUnsafe(it->second)) {
           method_headers.insert(OatQuickMethodHeader::FromCodePointer(it->first));
           VLOG(jit) << "JIT removed " << it->second->PrettyMethod() << ": " << it->first;
           it = method_code_map_.erase(it);
+          removed_code = true;
         } else {
           ++it;
         }
       }
+      if (removed_code) {
+        PublishCodeRangesLocked();
+      }
     }
     for (auto it = osr_code_map_.begin(); it != osr_code_map_.end();) {
       if (alloc.ContainsUnsafe(it->first)) {
@@ -555,6 +592,20 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
         ++it;
       }
     }
+    for (auto it = deoptimization_counts_.begin(); it != deoptimization_counts_.end();) {
+      if (alloc.ContainsUnsafe(it->first)) {
+        it = deoptimization_counts_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (auto it = failed_speculations_.begin(); it != failed_speculations_.end();) {
+      if (alloc.ContainsUnsafe(it->first.first)) {
+        it = failed_speculations_.erase(it);
+      } else {
+        ++it;
+      }
+    }
     FreeAllMethodHeaders(method_headers);
   }
 }
@@ -595,18 +646,22 @@ void JitCodeCache::DisallowInlineCacheAccess() {
 
 void JitCodeCache::CopyInlineCacheInto(
     const InlineCache& ic,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/std::array<uint32_t, InlineCache::kIndividualCacheSize>* counts) {
   static_assert(arraysize(ic.classes_) == InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->NumberOfReferences(), InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->RemainingSlots(), InlineCache::kIndividualCacheSize);
   WaitUntilInlineCacheAccessible(Thread::Current());
   // Note that we don't need to lock `lock_` here, the compiler calling
   // this method has already ensured the inline cache will not be deleted.
-  for (const GcRoot<mirror::Class>& root : ic.classes_) {
-    mirror::Class* object = root.Read();
+  counts->fill(0u);
+  size_t index = 0u;
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    mirror::Class* object = ic.classes_[i].Read();
     if (object != nullptr) {
       DCHECK_NE(classes->RemainingSlots(), 0u);
       classes->NewHandle(object);
+      (*counts)[index++] = ic.counts_[i];
     }
   }
 }
@@ -739,9 +794,17 @@ bool JitCodeCache::Commit(Thread* self,
         zygote_map_.Put(code_ptr, method);
       } else {
         method_code_map_.Put(code_ptr, method);
+        ++number_of_unpublished_code_ranges_;
+        MaybePublishCodeRangesLocked();
       }
       if (compilation_kind == CompilationKind::kOsr) {
         osr_code_map_.Put(method, code_ptr);
+        // Let the interpreter find the OSR code at the next few back edges of the loop it
+        // is running, instead of after a full warmup of the hotness counter.
+        uint16_t counter = method->GetCounter();
+        if (counter > Jit::kJitRecheckOSRThreshold) {
+          method->UpdateCounter(counter - Jit::kJitRecheckOSRThreshold);
+        }
       } else if (NeedsClinitCheckBeforeCall(method) &&
                  !method->GetDeclaringClass()->IsVisiblyInitialized()) {
         // This situation currently only occurs in the jit-zygote mode.
@@ -839,6 +902,9 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
         ++it;
       }
     }
+    if (in_cache) {
+      PublishCodeRangesLocked();
+    }
 
     auto osr_it = osr_code_map_.find(method);
     if (osr_it != osr_code_map_.end()) {
@@ -1075,6 +1141,73 @@ void JitCodeCache::MarkCompiledCodeOnThreadStacks(Thread* self) {
   }
 }
 
+// Publish the code ranges once the code added since they were last published is an eighth of
+// them, so that copying them stays proportional to the number of commits.
+static constexpr size_t kMinUnpublishedCodeRanges = 16u;
+static constexpr size_t kUnpublishedCodeRangesRatio = 8u;
+
+// Memory of the retired code ranges above which we run a checkpoint to free them.
+static constexpr size_t kMaxRetiredCodeRangesMemory = 256 * KB;
+
+void JitCodeCache::PublishCodeRangesLocked() {
+  std::vector<CodeRangeIndex::CodeRange> ranges;
+  ranges.reserve(method_code_map_.size());
+  for (const auto& entry : method_code_map_) {
+    const void* code_ptr = entry.first;
+    // Match OatQuickMethodHeader::Contains().
+    uintptr_t begin = reinterpret_cast<uintptr_t>(HWASanUntag(code_ptr));
+    if (kRuntimeISA == InstructionSet::kArm) {
+      // On Thumb-2, the pc is offset by one.
+      ++begin;
+    }
+    uintptr_t end = begin + OatQuickMethodHeader::FromCodePointer(code_ptr)->GetCodeSize() + 1u;
+    ranges.push_back({begin, end, code_ptr});
+  }
+  // The map is sorted by tagged pointers, which may not be in the order of the addresses.
+  std::sort(ranges.begin(),
+            ranges.end(),
+            [](const CodeRangeIndex::CodeRange& lhs, const CodeRangeIndex::CodeRange& rhs) {
+              return lhs.begin < rhs.begin;
+            });
+  code_ranges_.Publish(std::move(ranges));
+  number_of_unpublished_code_ranges_ = 0u;
+}
+
+void JitCodeCache::MaybePublishCodeRangesLocked() {
+  size_t threshold = std::max(kMinUnpublishedCodeRanges,
+                              code_ranges_.GetNumberOfRanges() / kUnpublishedCodeRangesRatio);
+  if (number_of_unpublished_code_ranges_ >= threshold) {
+    PublishCodeRangesLocked();
+  }
+}
+
+void JitCodeCache::MaybeFreeRetiredCodeRanges(Thread* self) {
+  uint64_t number_of_retired_code_ranges;
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
+    if (freeing_retired_code_ranges_ ||
+        code_ranges_.GetRetiredMemory() < kMaxRetiredCodeRangesMemory) {
+      return;
+    }
+    freeing_retired_code_ranges_ = true;
+    number_of_retired_code_ranges = code_ranges_.GetNumberOfRetiredSnapshots();
+  }
+
+  // Lookups of code ranges do not span a suspend point, so once all threads have passed one, no
+  // thread reads the code ranges which were retired before it. Only one empty checkpoint can run
+  // at a time, exclude the GC which also runs them.
+  {
+    gc::ScopedInterruptibleGCCriticalSection sigcs(self,
+                                                   gc::kGcCauseRunEmptyCheckpoint,
+                                                   gc::kCollectorTypeCriticalSection);
+    Runtime::Current()->GetThreadList()->RunEmptyCheckpoint();
+  }
+
+  MutexLock mu(self, *Locks::jit_lock_);
+  code_ranges_.FreeRetiredSnapshots(number_of_retired_code_ranges);
+  freeing_retired_code_ranges_ = false;
+}
+
 bool JitCodeCache::IsAtMaxCapacity() const {
   return private_region_.GetCurrentCapacity() == private_region_.GetMaxCapacity();
 }
@@ -1205,6 +1338,7 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
         it = jni_stubs_map_.erase(it);
       }
     }
+    bool removed_code = false;
     for (auto it = method_code_map_.begin(); it != method_code_map_.end();) {
       const void* code_ptr = it->first;
       uintptr_t allocation = FromCodeToAllocation(code_ptr);
@@ -1215,12 +1349,121 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
         method_headers.insert(header);
         VLOG(jit) << "JIT removed " << it->second->PrettyMethod() << ": " << it->first;
         it = method_code_map_.erase(it);
+        removed_code = true;
       }
     }
+    if (removed_code) {
+      PublishCodeRangesLocked();
+    }
     FreeAllMethodHeaders(method_headers);
   }
 }
 
+bool JitCodeCache::CompactCodeLocked() {
+  ScopedTrace trace(__FUNCTION__);
+  // The native debug info of the code has the address of the code, so that code cannot move.
+  std::set<const void*> code_with_debug_info;
+  ForEachNativeDebugSymbol([&](const void* addr, size_t, const char*) {
+    code_with_debug_info.insert(
+        AlignDown(addr, GetInstructionSetInstructionAlignment(kRuntimeISA)));  // Thumb-bit.
+  });
+
+  struct CodeToMove {
+    const void* code_ptr;
+    ArtMethod* method;
+    uint32_t hotness;
+  };
+  std::vector<CodeToMove> code_to_move;
+  for (const auto& [code_ptr, method] : method_code_map_) {
+    if (IsInZygoteExecSpace(code_ptr) ||
+        code_copies_.find(code_ptr) != code_copies_.end() ||
+        ContainsElement(code_with_debug_info, code_ptr)) {
+      continue;
+    }
+    const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+    // Only move the code that threads enter through the entry point of the method, other code
+    // is about to be freed. The CHA dependencies of code with a should-deoptimize flag refer to
+    // its method header, leave that code in place.
+    if (method_header->GetEntryPoint() != method->GetEntryPointFromQuickCompiledCode() ||
+        method_header->HasShouldDeoptimizeFlag()) {
+      continue;
+    }
+    // Optimized code is hotter than any baseline code, and baseline code is as hot as the number
+    // of times its hotness counter was decremented since it was last reset.
+    uint32_t hotness = std::numeric_limits<uint32_t>::max();
+    if (CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr())) {
+      auto info_it = profiling_infos_.find(method);
+      hotness = (info_it != profiling_infos_.end())
+          ? ProfilingInfo::GetOptimizeThreshold() - info_it->second->GetBaselineHotnessCount()
+          : 0u;
+    }
+    code_to_move.push_back({code_ptr, method, hotness});
+  }
+  // Allocate the hottest code first, so that it gets the lowest free blocks.
+  std::stable_sort(code_to_move.begin(),
+                   code_to_move.end(),
+                   [](const CodeToMove& lhs, const CodeToMove& rhs) {
+                     return lhs.hotness > rhs.hotness;
+                   });
+
+  size_t header_size = OatQuickMethodHeader::InstructionAlignedSize();
+  std::vector<std::pair<CodeToMove, const uint8_t*>> allocations;
+  {
+    ScopedCodeCacheWrite scc(private_region_);
+    for (const CodeToMove& code : code_to_move) {
+      const OatQuickMethodHeader* method_header =
+          OatQuickMethodHeader::FromCodePointer(code.code_ptr);
+      const uint8_t* allocation =
+          private_region_.AllocateCode(header_size + method_header->GetCodeSize());
+      if (allocation == nullptr) {
+        break;
+      }
+      if (reinterpret_cast<uintptr_t>(allocation) > FromCodeToAllocation(code.code_ptr)) {
+        // There is no free block below the code to move it to.
+        private_region_.FreeCode(allocation);
+        continue;
+      }
+      allocations.emplace_back(code, allocation);
+    }
+  }
+
+  bool moved_code = false;
+  for (const auto& [code, allocation] : allocations) {
+    const OatQuickMethodHeader* method_header =
+        OatQuickMethodHeader::FromCodePointer(code.code_ptr);
+    size_t code_size = method_header->GetCodeSize();
+    // The code only refers to its roots and literals through absolute addresses or addresses
+    // relative to the code itself, so a copy of the code can keep using the same data.
+    const uint8_t* code_ptr = private_region_.CommitCode(
+        ArrayRef<const uint8_t>(allocation, header_size + code_size),
+        ArrayRef<const uint8_t>(reinterpret_cast<const uint8_t*>(code.code_ptr), code_size),
+        method_header->GetOptimizedCodeInfoPtr(),
+        /* has_should_deoptimize_flag= */ false);
+    if (code_ptr == nullptr) {
+      ScopedCodeCacheWrite scc(private_region_);
+      private_region_.FreeCode(allocation);
+      continue;
+    }
+    method_code_map_.Put(code_ptr, code.method);
+    ++number_of_unpublished_code_ranges_;
+    code_copies_.Put(code_ptr, code.code_ptr);
+    code_copies_.Put(code.code_ptr, code_ptr);
+    if (code.method->GetEntryPointFromQuickCompiledCode() == method_header->GetEntryPoint()) {
+      // Only the threads which are running the old code when we next mark the thread stacks keep
+      // it alive. If the entry point changed in the meantime, the copy is freed instead.
+      GetLiveBitmap()->AtomicTestAndSet(FromCodeToAllocation(code_ptr));
+      GetLiveBitmap()->Clear(FromCodeToAllocation(code.code_ptr));
+      Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
+          code.method, OatQuickMethodHeader::FromCodePointer(code_ptr)->GetEntryPoint());
+    }
+    moved_code = true;
+    VLOG(jit) << "JIT moved " << code.method->PrettyMethod() << ": " << code.code_ptr
+              << " -> " << reinterpret_cast<const void*>(code_ptr);
+  }
+  MaybePublishCodeRangesLocked();
+  return moved_code;
+}
+
 bool JitCodeCache::GetGarbageCollectCode() {
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   return garbage_collect_code_;
@@ -1291,6 +1534,33 @@ ProfilingInfo* JitCodeCache::GetProfilingInfo(ArtMethod* method, Thread* self) {
   return it->second;
 }
 
+ProfilingInfo* JitCodeCache::GetProfilingInfoForTesting(ArtMethod* method, Thread* self) {
+  MutexLock mu(self, *Locks::jit_lock_);
+  DCHECK(!garbage_collect_code_);
+  auto it = profiling_infos_.find(method);
+  return (it == profiling_infos_.end()) ? nullptr : it->second;
+}
+
+uint32_t JitCodeCache::AddBackEdges(Thread* self,
+                                    ArtMethod* method,
+                                    uint32_t loop_header_dex_pc,
+                                    uint32_t count) {
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
+    auto it = profiling_infos_.find(method);
+    if (it != profiling_infos_.end()) {
+      return it->second->AddBackEdges(loop_header_dex_pc, count);
+    }
+  }
+  if (!CanAllocateProfilingInfo()) {
+    return 0u;
+  }
+  // The interpreter calls this with thread suspension disallowed, do not collect the cache to
+  // make room. The method will get another chance with its next back edges.
+  ProfilingInfo* info = ProfilingInfo::Create(self, method, /* retry_allocation= */ false);
+  return (info == nullptr) ? 0u : info->AddBackEdges(loop_header_dex_pc, count);
+}
+
 void JitCodeCache::ResetHotnessCounter(ArtMethod* method, Thread* self) {
   MutexLock mu(self, *Locks::jit_lock_);
   auto it = profiling_infos_.find(method);
@@ -1301,8 +1571,10 @@ void JitCodeCache::ResetHotnessCounter(ArtMethod* method, Thread* self) {
 
 void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
   ScopedTrace trace(__FUNCTION__);
+  uint64_t number_of_retired_code_ranges;
   {
     MutexLock mu(self, *Locks::jit_lock_);
+    number_of_retired_code_ranges = code_ranges_.GetNumberOfRetiredSnapshots();
 
     // Update to interpreter the methods that have baseline entrypoints and whose baseline
     // hotness count hasn't changed.
@@ -1365,11 +1637,42 @@ void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
   // Run a checkpoint on all threads to mark the JIT compiled code they are running.
   MarkCompiledCodeOnThreadStacks(self);
 
+  // Lookups of code ranges do not span a checkpoint, so no thread reads the code ranges which
+  // were retired before it anymore.
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
+    code_ranges_.FreeRetiredSnapshots(number_of_retired_code_ranges);
+  }
+
   // At this point, mutator threads are still running, and entrypoints of methods can
   // change. We do know they cannot change to a code cache entry that is not marked,
   // therefore we can safely remove those entries.
   RemoveUnmarkedCode(self);
 
+  // Collections leave holes between the live code, which the allocation of larger methods cannot
+  // use. Move the live code out of the holes to merge the free memory into larger blocks.
+  bool compacted = false;
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
+    size_t fragmentation = private_region_.GetCodeFragmentation();
+    if (fragmentation > kCompactionFragmentationThreshold || force_compaction_for_testing_) {
+      fragmentation_before_compaction_ = fragmentation;
+      compacted = CompactCodeLocked();
+    }
+  }
+  if (compacted) {
+    // The copied code is no longer an entry point, but threads may still be running it. Mark it
+    // on thread stacks again, and free the copies that are not running.
+    MarkCompiledCodeOnThreadStacks(self);
+    RemoveUnmarkedCode(self);
+    MutexLock mu(self, *Locks::jit_lock_);
+    number_of_compactions_++;
+    fragmentation_after_compaction_ = private_region_.GetCodeFragmentation();
+    VLOG(jit) << "JIT code cache compaction: fragmentation "
+              << fragmentation_before_compaction_ << "% -> "
+              << fragmentation_after_compaction_ << "%";
+  }
+
   if (collect_profiling_info) {
     // TODO: Collect unused profiling infos.
   }
@@ -1390,6 +1693,24 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
     CHECK(method != nullptr);
   }
 
+  if (method == nullptr || LIKELY(!method->IsNative())) {
+    // Stack walks look up most frames in the code ranges without taking the lock. The code
+    // committed since the code ranges were last published is found in the maps below.
+    const void* code_ptr = code_ranges_.Lookup(pc);
+    if (code_ptr != nullptr) {
+      if (kIsDebugBuild && method != nullptr) {
+        MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+        auto it = method_code_map_.find(code_ptr);
+        DCHECK(it != method_code_map_.end()) << code_ptr;
+        DCHECK_EQ(it->second, method)
+            << ArtMethod::PrettyMethod(method) << " "
+            << ArtMethod::PrettyMethod(it->second) << " "
+            << std::hex << pc;
+      }
+      return OatQuickMethodHeader::FromCodePointer(code_ptr);
+    }
+  }
+
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   OatQuickMethodHeader* method_header = nullptr;
   ArtMethod* found_method = nullptr;  // Only for DCHECK(), not for JNI stubs.
@@ -1455,25 +1776,30 @@ OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
 
 ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
                                               ArtMethod* method,
-                                              const std::vector<uint32_t>& entries) {
+                                              const std::vector<uint32_t>& entries,
+                                              const std::vector<uint32_t>& loop_headers,
+                                              const std::vector<uint32_t>& branches,
+                                              bool retry_allocation) {
   DCHECK(CanAllocateProfilingInfo());
   ProfilingInfo* info = nullptr;
   {
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, entries);
+    info = AddProfilingInfoInternal(self, method, entries, loop_headers, branches);
   }
 
-  if (info == nullptr) {
+  if (info == nullptr && retry_allocation) {
     GarbageCollectCache(self);
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, entries);
+    info = AddProfilingInfoInternal(self, method, entries, loop_headers, branches);
   }
   return info;
 }
 
 ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNUSED,
                                                       ArtMethod* method,
-                                                      const std::vector<uint32_t>& entries) {
+                                                      const std::vector<uint32_t>& entries,
+                                                      const std::vector<uint32_t>& loop_headers,
+                                                      const std::vector<uint32_t>& branches) {
   // Check whether some other thread has concurrently created it.
   auto it = profiling_infos_.find(method);
   if (it != profiling_infos_.end()) {
@@ -1481,7 +1807,7 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNU
   }
 
   size_t profile_info_size = RoundUp(
-      sizeof(ProfilingInfo) + sizeof(InlineCache) * entries.size(),
+      ProfilingInfo::ComputeSize(entries.size(), loop_headers.size(), branches.size()),
       sizeof(void*));
 
   const uint8_t* data = private_region_.AllocateData(profile_info_size);
@@ -1489,7 +1815,8 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNU
     return nullptr;
   }
   uint8_t* writable_data = private_region_.GetWritableDataAddress(data);
-  ProfilingInfo* info = new (writable_data) ProfilingInfo(method, entries);
+  ProfilingInfo* info =
+      new (writable_data) ProfilingInfo(method, entries, loop_headers, branches);
 
   profiling_infos_.Put(method, info);
   histogram_profiling_info_memory_use_.AddValue(profile_info_size);
@@ -1502,6 +1829,22 @@ void* JitCodeCache::MoreCore(const void* mspace, intptr_t increment) {
       : private_region_.MoreCore(mspace, increment);
 }
 
+void JitCodeCache::GetCompiledMethods(
+    Thread* self, std::vector<std::pair<ArtMethod*, CompilationKind>>* methods) {
+  MutexLock mu(self, *Locks::jit_lock_);
+  for (const auto& [code_ptr, method] : method_code_map_) {
+    const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+    // OSR code and discarded code are not entry points.
+    if (method_header->GetEntryPoint() != method->GetEntryPointFromQuickCompiledCode()) {
+      continue;
+    }
+    CompilationKind kind = CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr())
+        ? CompilationKind::kBaseline
+        : CompilationKind::kOptimized;
+    methods->emplace_back(method, kind);
+  }
+}
+
 void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_locations,
                                       std::vector<ProfileMethodInfo>& methods) {
   Thread* self = Thread::Current();
@@ -1519,6 +1862,17 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
     }
     std::vector<ProfileMethodInfo::ProfileInlineCache> inline_caches;
 
+    // The branch counts are only a ratio, so save them even if they are still being counted.
+    std::vector<ProfileMethodInfo::ProfileBranchCache> branch_caches;
+    BranchCache* branch_cache_begin = info->GetBranchCaches();
+    for (size_t i = 0; i < info->number_of_branch_caches_; ++i) {
+      const BranchCache& cache = branch_cache_begin[i];
+      if (cache.GetFalseCount() != 0u || cache.GetTrueCount() != 0u) {
+        branch_caches.emplace_back(/*ProfileMethodInfo::ProfileBranchCache*/
+            cache.GetDexPc(), cache.GetFalseCount(), cache.GetTrueCount());
+      }
+    }
+
     // If the method is still baseline compiled, don't save the inline caches.
     // They might be incomplete and cause unnecessary deoptimizations.
     // If the inline cache is empty the compiler will generate a regular invoke virtual/interface.
@@ -1527,12 +1881,13 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
         CodeInfo::IsBaseline(
             OatQuickMethodHeader::FromEntryPoint(entry_point)->GetOptimizedCodeInfoPtr())) {
       methods.emplace_back(/*ProfileMethodInfo*/
-          MethodReference(dex_file, method->GetDexMethodIndex()), inline_caches);
+          MethodReference(dex_file, method->GetDexMethodIndex()), inline_caches, branch_caches);
       continue;
     }
 
     for (size_t i = 0; i < info->number_of_inline_caches_; ++i) {
       std::vector<TypeReference> profile_classes;
+      std::vector<uint32_t> profile_counts;
       const InlineCache& cache = info->cache_[i];
       ArtMethod* caller = info->GetMethod();
       bool is_missing_types = false;
@@ -1575,17 +1930,22 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
           // Only consider classes from the same apk (including multidex).
           profile_classes.emplace_back(/*ProfileMethodInfo::ProfileClassReference*/
               class_dex_file, type_index);
+          profile_counts.push_back(cache.counts_[k]);
         } else {
           is_missing_types = true;
         }
       }
       if (!profile_classes.empty()) {
         inline_caches.emplace_back(/*ProfileMethodInfo::ProfileInlineCache*/
-            cache.dex_pc_, is_missing_types, profile_classes);
+            cache.dex_pc_,
+            is_missing_types,
+            profile_classes,
+            /* megamorphic= */ false,
+            profile_counts);
       }
     }
     methods.emplace_back(/*ProfileMethodInfo*/
-        MethodReference(dex_file, method->GetDexMethodIndex()), inline_caches);
+        MethodReference(dex_file, method->GetDexMethodIndex()), inline_caches, branch_caches);
   }
 }
 
@@ -1719,19 +2079,22 @@ void JitCodeCache::DoneCompiling(ArtMethod* method,
                                  Thread* self,
                                  CompilationKind compilation_kind) {
   DCHECK_EQ(Thread::Current(), self);
-  MutexLock mu(self, *Locks::jit_lock_);
-  if (UNLIKELY(method->IsNative())) {
-    auto it = jni_stubs_map_.find(JniStubKey(method));
-    DCHECK(it != jni_stubs_map_.end());
-    JniStubData* data = &it->second;
-    DCHECK(ContainsElement(data->GetMethods(), method));
-    if (UNLIKELY(!data->IsCompiled())) {
-      // Failed to compile; the JNI compiler never fails, but the cache may be full.
-      jni_stubs_map_.erase(it);  // Remove the entry added in NotifyCompilationOf().
-    }  // else Commit() updated entrypoints of all methods in the JniStubData.
-  } else {
-    RemoveMethodBeingCompiled(method, compilation_kind);
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
+    if (UNLIKELY(method->IsNative())) {
+      auto it = jni_stubs_map_.find(JniStubKey(method));
+      DCHECK(it != jni_stubs_map_.end());
+      JniStubData* data = &it->second;
+      DCHECK(ContainsElement(data->GetMethods(), method));
+      if (UNLIKELY(!data->IsCompiled())) {
+        // Failed to compile; the JNI compiler never fails, but the cache may be full.
+        jni_stubs_map_.erase(it);  // Remove the entry added in NotifyCompilationOf().
+      }  // else Commit() updated entrypoints of all methods in the JniStubData.
+    } else {
+      RemoveMethodBeingCompiled(method, compilation_kind);
+    }
   }
+  MaybeFreeRetiredCodeRanges(self);
 }
 
 void JitCodeCache::InvalidateAllCompiledCode() {
@@ -1752,25 +2115,37 @@ void JitCodeCache::InvalidateAllCompiledCode() {
   osr_code_map_.clear();
 }
 
-void JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
+bool JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
                                              const OatQuickMethodHeader* header) {
   DCHECK(!method->IsNative());
   const void* method_entrypoint = method->GetEntryPointFromQuickCompiledCode();
+  bool is_entry_point = (method_entrypoint == header->GetEntryPoint());
+  if (!is_entry_point) {
+    MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+    // A compaction may have moved the entry point of the method to a copy of the code, while
+    // a thread kept running the old copy.
+    auto copy_it = code_copies_.find(header->GetCode());
+    if (copy_it != code_copies_.end()) {
+      is_entry_point = (method_entrypoint ==
+                        OatQuickMethodHeader::FromCodePointer(copy_it->second)->GetEntryPoint());
+    }
+    if (!is_entry_point) {
+      auto it = osr_code_map_.find(method);
+      if (it != osr_code_map_.end() &&
+          OatQuickMethodHeader::FromCodePointer(it->second) == header) {
+        // Remove the OSR method, to avoid using it again.
+        osr_code_map_.erase(it);
+      }
+    }
+  }
 
   // Clear the method counter if we are running jitted code since we might want to jit this again in
   // the future.
-  if (method_entrypoint == header->GetEntryPoint()) {
+  if (is_entry_point) {
     // The entrypoint is the one to invalidate, so we just update it to the interpreter entry point
     // and clear the counter to get the method Jitted again.
     Runtime::Current()->GetInstrumentation()->InitializeMethodsCode(method, /*aot_code=*/ nullptr);
     ClearMethodCounter(method, /*was_warm=*/ true);
-  } else {
-    MutexLock mu(Thread::Current(), *Locks::jit_lock_);
-    auto it = osr_code_map_.find(method);
-    if (it != osr_code_map_.end() && OatQuickMethodHeader::FromCodePointer(it->second) == header) {
-      // Remove the OSR method, to avoid using it again.
-      osr_code_map_.erase(it);
-    }
   }
 
   // In case the method was pre-compiled, clear that information so we
@@ -1778,6 +2153,69 @@ void JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
   if (method->IsPreCompiled()) {
     method->ClearPreCompiled();
   }
+  return is_entry_point;
+}
+
+bool JitCodeCache::CollectAndCompactForTesting(Thread* self) {
+  size_t number_of_compactions;
+  bool garbage_collect_code;
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
+    number_of_compactions = number_of_compactions_;
+    garbage_collect_code = garbage_collect_code_;
+    garbage_collect_code_ = true;
+    force_compaction_for_testing_ = true;
+  }
+  GarbageCollectCache(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  garbage_collect_code_ = garbage_collect_code;
+  force_compaction_for_testing_ = false;
+  return number_of_compactions_ != number_of_compactions;
+}
+
+// Bounds check elimination speculates on the ranges of a whole loop or block, which
+// we do not track, so it is disabled for the whole compiled method.
+static bool IsMethodWideSpeculation(DeoptimizationKind kind) {
+  switch (kind) {
+    case DeoptimizationKind::kLoopBoundsBCE:
+    case DeoptimizationKind::kLoopNullBCE:
+    case DeoptimizationKind::kBlockBCE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static_assert(static_cast<uint32_t>(DeoptimizationKind::kLast) < 32u,
+              "Failed speculations have a bit per deoptimization kind");
+
+uint32_t JitCodeCache::AddDeoptimization(ArtMethod* method,
+                                         ArtMethod* site_method,
+                                         uint32_t dex_pc,
+                                         DeoptimizationKind kind) {
+  MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+  ++number_of_deoptimizations_;
+  std::pair<ArtMethod*, uint32_t> site = IsMethodWideSpeculation(kind)
+      ? std::make_pair(method, dex::kDexNoIndex)
+      : std::make_pair(site_method, dex_pc);
+  failed_speculations_.GetOrCreate(site, []() { return 0u; }) |=
+      (1u << static_cast<uint32_t>(kind));
+  return ++deoptimization_counts_.GetOrCreate(method, []() { return 0u; });
+}
+
+bool JitCodeCache::HasFailedSpeculation(ArtMethod* method,
+                                        uint32_t dex_pc,
+                                        DeoptimizationKind kind) {
+  MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+  if (failed_speculations_.empty()) {
+    return false;
+  }
+  if (IsMethodWideSpeculation(kind)) {
+    dex_pc = dex::kDexNoIndex;
+  }
+  auto it = failed_speculations_.find(std::make_pair(method, dex_pc));
+  return (it != failed_speculations_.end()) &&
+         ((it->second & (1u << static_cast<uint32_t>(kind))) != 0u);
 }
 
 void JitCodeCache::Dump(std::ostream& os) {
@@ -1800,11 +2238,22 @@ void JitCodeCache::Dump(std::ostream& os) {
      << "Current JIT capacity: " << PrettySize(GetCurrentRegion()->GetCurrentCapacity()) << "\n"
      << "Current number of JIT JNI stub entries: " << jni_stubs_map_.size() << "\n"
      << "Current number of JIT code cache entries: " << method_code_map_.size() << "\n"
+     << "Current number of JIT code ranges looked up without lock: "
+        << code_ranges_.GetNumberOfRanges() << "\n"
      << "Total number of JIT baseline compilations: " << number_of_baseline_compilations_ << "\n"
      << "Total number of JIT optimized compilations: " << number_of_optimized_compilations_ << "\n"
      << "Total number of JIT compilations for on stack replacement: "
         << number_of_osr_compilations_ << "\n"
-     << "Total number of JIT code cache collections: " << number_of_collections_ << std::endl;
+     << "Total number of JIT code cache collections: " << number_of_collections_ << "\n"
+     << "Total number of JIT code cache compactions: " << number_of_compactions_ << "\n"
+     << "Current JIT code cache fragmentation: "
+        << GetCurrentRegion()->GetCodeFragmentation() << "%\n"
+     << "JIT code cache fragmentation before / after the last compaction: "
+        << fragmentation_before_compaction_ << "% / "
+        << fragmentation_after_compaction_ << "%\n"
+     << "Total number of JIT deoptimizations: " << number_of_deoptimizations_ << "\n"
+     << "Current number of deoptimized JIT methods: " << deoptimization_counts_.size() << "\n"
+     << "Current number of failed JIT speculations: " << failed_speculations_.size() << std::endl;
   histogram_stack_map_memory_use_.PrintMemoryUse(os);
   histogram_code_memory_use_.PrintMemoryUse(os);
   histogram_profiling_info_memory_use_.PrintMemoryUse(os);
@@ -1839,6 +2288,10 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
   number_of_optimized_compilations_ = 0;
   number_of_osr_compilations_ = 0;
   number_of_collections_ = 0;
+  number_of_compactions_ = 0;
+  fragmentation_before_compaction_ = 0;
+  fragmentation_after_compaction_ = 0;
+  number_of_deoptimizations_ = 0;
   histogram_stack_map_memory_use_.Reset();
   histogram_code_memory_use_.Reset();
   histogram_profiling_info_memory_use_.Reset();
@@ -17,11 +17,13 @@
 #ifndef ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 #define ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 
+#include <array>
 #include <iosfwd>
 #include <memory>
 #include <set>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "base/arena_containers.h"
@@ -32,7 +34,9 @@
 #include "base/mem_map.h"
 #include "base/mutex.h"
 #include "base/safe_map.h"
+#include "code_range_index.h"
 #include "compilation_kind.h"
+#include "deoptimization_kind.h"
 #include "jit_memory_region.h"
 #include "profiling_info.h"
 
@@ -307,15 +311,21 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Copy the classes of the inline cache `ic` into `classes`, and their counts at the same index
+  // into `counts`.
   void CopyInlineCacheInto(const InlineCache& ic,
-                           /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+                           /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+                           /*out*/std::array<uint32_t, InlineCache::kIndividualCacheSize>* counts)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Create a 'ProfileInfo' for 'method'.
   ProfilingInfo* AddProfilingInfo(Thread* self,
                                   ArtMethod* method,
-                                  const std::vector<uint32_t>& entries)
+                                  const std::vector<uint32_t>& entries,
+                                  const std::vector<uint32_t>& loop_headers,
+                                  const std::vector<uint32_t>& branches,
+                                  bool retry_allocation)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -331,14 +341,44 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Adds to `methods` the methods whose entry point is compiled code of the private region, with
+  // the kind of that code.
+  void GetCompiledMethods(Thread* self,
+                          std::vector<std::pair<ArtMethod*, CompilationKind>>* methods)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void InvalidateAllCompiledCode()
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void InvalidateCompiledCodeFor(ArtMethod* method, const OatQuickMethodHeader* code)
+  // Stop using `code` for `method`. Returns whether `code`, or its copy after a compaction, was
+  // the entry point of `method`.
+  bool InvalidateCompiledCodeFor(ArtMethod* method, const OatQuickMethodHeader* code)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Collect the code cache and compact it, whatever its fragmentation and even if code
+  // collection is disabled. Returns whether some code was moved.
+  bool CollectAndCompactForTesting(Thread* self)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Record that the compiled code of `method` deoptimized because the `kind` speculation made at
+  // `dex_pc` of `site_method` failed, so that the next compilations do not make it again. Returns
+  // the number of times the compiled code of `method` deoptimized.
+  uint32_t AddDeoptimization(ArtMethod* method,
+                             ArtMethod* site_method,
+                             uint32_t dex_pc,
+                             DeoptimizationKind kind)
+      REQUIRES(!Locks::jit_lock_);
+
+  // Whether compiled code deoptimized because of a `kind` speculation made at `dex_pc` of
+  // `method`. Bounds check elimination speculates for a whole compiled method, its `dex_pc`
+  // is ignored.
+  bool HasFailedSpeculation(ArtMethod* method, uint32_t dex_pc, DeoptimizationKind kind)
+      REQUIRES(!Locks::jit_lock_);
+
   void Dump(std::ostream& os) REQUIRES(!Locks::jit_lock_);
 
   bool IsOsrCompiled(ArtMethod* method) REQUIRES(!Locks::jit_lock_);
@@ -401,14 +441,32 @@ class JitCodeCache {
   }
 
   ProfilingInfo* GetProfilingInfo(ArtMethod* method, Thread* self);
+
+  // Return the ProfilingInfo of `method`, or null if it has none. Unlike GetProfilingInfo(),
+  // `method` does not need to be compiling. Code collection must be disabled, so that the
+  // ProfilingInfo is not freed while the caller reads it.
+  ProfilingInfo* GetProfilingInfoForTesting(ArtMethod* method, Thread* self)
+      REQUIRES(!Locks::jit_lock_);
   void ResetHotnessCounter(ArtMethod* method, Thread* self);
 
+  // Add `count` back edges to the loop of `method` whose header is at `loop_header_dex_pc`,
+  // creating the ProfilingInfo of `method` if needed. Returns the number of back edges recorded
+  // for the loop, or 0 if they could not be recorded. Does not suspend the calling thread.
+  uint32_t AddBackEdges(Thread* self,
+                        ArtMethod* method,
+                        uint32_t loop_header_dex_pc,
+                        uint32_t count)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
  private:
   JitCodeCache();
 
   ProfilingInfo* AddProfilingInfoInternal(Thread* self,
                                           ArtMethod* method,
-                                          const std::vector<uint32_t>& entries)
+                                          const std::vector<uint32_t>& entries,
+                                          const std::vector<uint32_t>& loop_headers,
+                                          const std::vector<uint32_t>& branches)
       REQUIRES(Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -439,7 +497,8 @@ class JitCodeCache {
   void VisitAllMethods(const std::function<void(const void*, ArtMethod*)>& cb)
       REQUIRES(Locks::jit_lock_);
 
-  // Free code and data allocations for `code_ptr`.
+  // Free code and data allocations for `code_ptr`. The data of code which was relocated by a
+  // compaction is only freed with the last copy of the code.
   void FreeCodeAndData(const void* code_ptr)
       REQUIRES(Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -479,6 +538,28 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Copy the compiled code which is the entry point of its method into free memory below it,
+  // hottest code first, and make the copies the entry points. The copied code is left in the
+  // cache, to be freed once no thread runs it. Returns whether any code was copied.
+  bool CompactCodeLocked()
+      REQUIRES(Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Publish the ranges of the code in `method_code_map_` for the lookups which do not take the
+  // lock. This must be called after removing code from `method_code_map_` and before releasing
+  // the lock, so that the memory of the code cannot be reused while the index refers to it.
+  void PublishCodeRangesLocked() REQUIRES(Locks::jit_lock_);
+
+  // Publish the code ranges if enough code was added since they were last published. Until then,
+  // lookups of the added code take the lock.
+  void MaybePublishCodeRangesLocked() REQUIRES(Locks::jit_lock_);
+
+  // Free the snapshots of code ranges which were retired, once they use enough memory to be worth
+  // running a checkpoint to know that no thread reads them anymore.
+  void MaybeFreeRetiredCodeRanges(Thread* self)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   CodeCacheBitmap* GetLiveBitmap() const {
     return live_bitmap_.get();
   }
@@ -534,6 +615,16 @@ class JitCodeCache {
   // Holds compiled code associated to the ArtMethod.
   SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(Locks::jit_lock_);
 
+  // The ranges of the code in `method_code_map_`, which LookupMethodHeader() reads without taking
+  // the lock. Updates are guarded by the lock.
+  CodeRangeIndex code_ranges_;
+
+  // Number of entries added to `method_code_map_` since `code_ranges_` was last published.
+  size_t number_of_unpublished_code_ranges_ GUARDED_BY(Locks::jit_lock_);
+
+  // Whether a thread is running a checkpoint to free the retired snapshots of `code_ranges_`.
+  bool freeing_retired_code_ranges_ GUARDED_BY(Locks::jit_lock_);
+
   // Holds compiled code associated to the ArtMethod. Used when pre-jitting
   // methods whose entrypoints have the resolution stub.
   SafeMap<ArtMethod*, const void*> saved_compiled_methods_map_ GUARDED_BY(Locks::jit_lock_);
@@ -541,9 +632,21 @@ class JitCodeCache {
   // Holds osr compiled code associated to the ArtMethod.
   SafeMap<ArtMethod*, const void*> osr_code_map_ GUARDED_BY(Locks::jit_lock_);
 
+  // Maps code relocated by a compaction to its other copy, in both directions. The two copies
+  // share their roots and stack maps.
+  SafeMap<const void*, const void*> code_copies_ GUARDED_BY(Locks::jit_lock_);
+
   // ProfilingInfo objects we have allocated.
   SafeMap<ArtMethod*, ProfilingInfo*> profiling_infos_ GUARDED_BY(Locks::jit_lock_);
 
+  // Number of times the compiled code of methods deoptimized.
+  SafeMap<ArtMethod*, uint32_t> deoptimization_counts_ GUARDED_BY(Locks::jit_lock_);
+
+  // Speculations which made compiled code deoptimize, by method and dex pc of the speculation.
+  // The value has a bit for each DeoptimizationKind.
+  SafeMap<std::pair<ArtMethod*, uint32_t>, uint32_t> failed_speculations_
+      GUARDED_BY(Locks::jit_lock_);
+
   // Methods we are currently compiling, one set for each kind of compilation.
   std::set<ArtMethod*> current_optimized_compilations_ GUARDED_BY(Locks::jit_lock_);
   std::set<ArtMethod*> current_osr_compilations_ GUARDED_BY(Locks::jit_lock_);
@@ -584,6 +687,19 @@ class JitCodeCache {
   // Number of code cache collections done throughout the lifetime of the JIT.
   size_t number_of_collections_ GUARDED_BY(Locks::jit_lock_);
 
+  // Number of code cache collections which compacted the code.
+  size_t number_of_compactions_ GUARDED_BY(Locks::jit_lock_);
+
+  // Whether the next collection compacts the code whatever its fragmentation.
+  bool force_compaction_for_testing_ GUARDED_BY(Locks::jit_lock_);
+
+  // Fragmentation of the free code memory, in percent, before and after the last compaction.
+  size_t fragmentation_before_compaction_ GUARDED_BY(Locks::jit_lock_);
+  size_t fragmentation_after_compaction_ GUARDED_BY(Locks::jit_lock_);
+
+  // Number of deoptimizations of compiled code made by the compiled code itself.
+  size_t number_of_deoptimizations_ GUARDED_BY(Locks::jit_lock_);
+
   // Histograms for keeping track of stack map size statistics.
   Histogram<uint64_t> histogram_stack_map_memory_use_ GUARDED_BY(Locks::jit_lock_);
 
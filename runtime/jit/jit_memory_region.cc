@@ -16,6 +16,8 @@
 
 #include "jit_memory_region.h"
 
+#include <algorithm>
+
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -483,6 +485,31 @@ void JitMemoryRegion::FreeCode(const uint8_t* code) {
   mspace_free(exec_mspace_, const_cast<uint8_t*>(code));
 }
 
+size_t JitMemoryRegion::GetCodeFragmentation() const {
+  if (exec_mspace_ == nullptr) {
+    return 0u;
+  }
+  struct FreeMemory {
+    size_t total = 0u;
+    size_t largest_block = 0u;
+  } free_memory;
+  mspace_inspect_all(exec_mspace_,
+                     [](void* start, void* end, size_t used_bytes, void* arg) {
+                       if (used_bytes == 0u) {
+                         FreeMemory* memory = reinterpret_cast<FreeMemory*>(arg);
+                         size_t size = reinterpret_cast<uintptr_t>(end) -
+                             reinterpret_cast<uintptr_t>(start);
+                         memory->total += size;
+                         memory->largest_block = std::max(memory->largest_block, size);
+                       }
+                     },
+                     &free_memory);
+  if (free_memory.total == 0u) {
+    return 0u;
+  }
+  return (free_memory.total - free_memory.largest_block) * 100u / free_memory.total;
+}
+
 const uint8_t* JitMemoryRegion::AllocateData(size_t data_size) {
   void* result = mspace_malloc(data_mspace_, data_size);
   if (UNLIKELY(result == nullptr)) {
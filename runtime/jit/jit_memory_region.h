@@ -172,6 +172,9 @@ class JitMemoryRegion {
     return exec_end_;
   }
 
+  // Returns how much of the free code memory is outside of the largest free block, in percent.
+  size_t GetCodeFragmentation() const REQUIRES(Locks::jit_lock_);
+
   size_t GetUsedMemoryForData() const REQUIRES(Locks::jit_lock_) {
     return used_memory_for_data_;
   }
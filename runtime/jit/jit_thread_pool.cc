@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_thread_pool.h"
+
+#include "base/logging.h"
+#include "base/metrics/metrics.h"
+#include "base/time_utils.h"
+#include "runtime.h"
+
+namespace art {
+namespace jit {
+
+JitThreadPool::JitThreadPool(const char* name, size_t num_threads, bool create_peers)
+    : ThreadPool(name, num_threads, create_peers), sequence_(0u) {}
+
+JitThreadPool::~JitThreadPool() {
+  // The workers call the queue operations of this class, stop them before the queue goes away.
+  DeleteThreads();
+  RemoveAllTasks(Thread::Current());
+}
+
+void JitThreadPool::CreateThreads(size_t num_threads) {
+  {
+    MutexLock mu(Thread::Current(), task_queue_lock_);
+    CHECK_EQ(GetThreadCount(), 0u);
+    max_active_workers_ = num_threads;
+  }
+  CreateThreads();
+}
+
+uint32_t JitThreadPool::GetRank(CompilationKind kind) {
+  switch (kind) {
+    // The method is stuck in a loop in nterp even though it has compiled code.
+    case CompilationKind::kOsr: return 3u;
+    // The method runs in nterp, baseline code gives most of the speedup for a fraction of the
+    // compile time.
+    case CompilationKind::kBaseline: return 2u;
+    case CompilationKind::kOptimized: return 1u;
+  }
+}
+
+bool JitThreadPool::AddCompileTask(Thread* self,
+                                   ArtMethod* method,
+                                   CompilationKind kind,
+                                   const std::function<Task*()>& create_task) {
+  DCHECK(method != nullptr);
+  {
+    MutexLock mu(self, task_queue_lock_);
+    if (BumpQueuedCompileTaskLocked(method, kind)) {
+      return false;
+    }
+  }
+  // Creating a compilation task takes locks that rank above the task queue lock.
+  Task* task = create_task();
+  {
+    MutexLock mu(self, task_queue_lock_);
+    if (!BumpQueuedCompileTaskLocked(method, kind)) {
+      metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+      metrics->JitCompileQueueDepthAvg()->Add(queue_.size());
+      InsertLocked(QueuedTask{task, method, kind, GetRank(kind), 1u, sequence_++, NanoTime()});
+      if (started_ && waiting_count_ != 0) {
+        task_queue_condition_.Signal(self);
+      }
+      return true;
+    }
+  }
+  // Another thread queued the same compilation in the meantime.
+  task->Finalize();
+  return false;
+}
+
+bool JitThreadPool::BumpQueuedCompileTaskLocked(ArtMethod* method, CompilationKind kind) {
+  auto it = compile_tasks_.find(std::make_pair(method, kind));
+  if (it == compile_tasks_.end()) {
+    return false;
+  }
+  // The requests count is part of the key of the queue, re-insert the task to update it.
+  Queue::node_type node = queue_.extract(it->second);
+  ++node.value().requests;
+  it->second = queue_.insert(std::move(node)).position;
+  return true;
+}
+
+void JitThreadPool::InsertLocked(const QueuedTask& queued_task) {
+  auto [it, inserted] = queue_.insert(queued_task);
+  DCHECK(inserted);
+  if (queued_task.method != nullptr) {
+    compile_tasks_.emplace(std::make_pair(queued_task.method, queued_task.kind), it);
+  }
+}
+
+void JitThreadPool::PushTaskLocked(Task* task) {
+  InsertLocked(QueuedTask{task,
+                          /* method= */ nullptr,
+                          CompilationKind::kOptimized,
+                          /* rank= */ 0u,
+                          /* requests= */ 0u,
+                          sequence_++,
+                          NanoTime()});
+}
+
+Task* JitThreadPool::PopTaskLocked() {
+  DCHECK(!queue_.empty());
+  Queue::node_type node = queue_.extract(queue_.begin());
+  const QueuedTask& queued_task = node.value();
+  if (queued_task.method != nullptr) {
+    compile_tasks_.erase(std::make_pair(queued_task.method, queued_task.kind));
+    uint64_t time_in_queue_ns = NanoTime() - queued_task.queue_time_ns;
+    metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+    metrics->JitCompileQueueTimeAvg()->Add(NsToUs(time_in_queue_ns));
+    metrics->JitCompileQueueTime()->Add(NsToMs(time_in_queue_ns));
+  }
+  return queued_task.task;
+}
+
+size_t JitThreadPool::GetTaskCountLocked() const {
+  return queue_.size();
+}
+
+void JitThreadPool::ClearTasksLocked() {
+  queue_.clear();
+  compile_tasks_.clear();
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_THREAD_POOL_H_
+#define ART_RUNTIME_JIT_JIT_THREAD_POOL_H_
+
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+
+#include "base/macros.h"
+#include "compilation_kind.h"
+#include "thread_pool.h"
+
+namespace art {
+
+class ArtMethod;
+
+namespace jit {
+
+// The thread pool of the JIT. Instead of running its tasks in FIFO order, it runs the compilation
+// tasks by priority: first by compilation kind, so that a method reaching its baseline threshold
+// can overtake the optimized compilation of a method which already has baseline code, and then by
+// hotness, measured as the number of times the compilation was requested while it was queued.
+// Other tasks, such as the compilation of the methods of a profile, run in FIFO order after the
+// compilation tasks.
+class JitThreadPool final : public ThreadPool {
+ public:
+  JitThreadPool(const char* name, size_t num_threads, bool create_peers);
+  ~JitThreadPool();
+
+  using ThreadPool::CreateThreads;
+
+  // Create `num_threads` threads, which replaces the number of threads the pool was created with.
+  // The pool must not have threads.
+  void CreateThreads(size_t num_threads) REQUIRES(!task_queue_lock_);
+
+  // Queues the `kind` compilation of `method`, using `create_task` to create the task. If that
+  // compilation is already queued, only increases its priority and returns false.
+  // `create_task` is called without holding the task queue lock.
+  bool AddCompileTask(Thread* self,
+                      ArtMethod* method,
+                      CompilationKind kind,
+                      const std::function<Task*()>& create_task) REQUIRES(!task_queue_lock_);
+
+ protected:
+  void PushTaskLocked(Task* task) override REQUIRES(task_queue_lock_);
+  Task* PopTaskLocked() override REQUIRES(task_queue_lock_);
+  size_t GetTaskCountLocked() const override REQUIRES(task_queue_lock_);
+  void ClearTasksLocked() override REQUIRES(task_queue_lock_);
+
+ private:
+  struct QueuedTask {
+    Task* task;
+    // The method compiled by the task, or null if the task is not a compilation task.
+    ArtMethod* method;
+    CompilationKind kind;
+    // Higher ranks run first.
+    uint32_t rank;
+    // How many times the compilation was requested while the task was queued.
+    uint32_t requests;
+    // Orders the tasks of equal priority by the time they were queued.
+    uint64_t sequence;
+    uint64_t queue_time_ns;
+  };
+
+  struct CompareByPriority {
+    bool operator()(const QueuedTask& lhs, const QueuedTask& rhs) const {
+      if (lhs.rank != rhs.rank) {
+        return lhs.rank > rhs.rank;
+      }
+      if (lhs.requests != rhs.requests) {
+        return lhs.requests > rhs.requests;
+      }
+      return lhs.sequence < rhs.sequence;
+    }
+  };
+
+  using Queue = std::set<QueuedTask, CompareByPriority>;
+
+  static uint32_t GetRank(CompilationKind kind);
+
+  // Increases the priority of the queued `kind` compilation of `method`. Returns false if there is
+  // no such task.
+  bool BumpQueuedCompileTaskLocked(ArtMethod* method, CompilationKind kind)
+      REQUIRES(task_queue_lock_);
+
+  void InsertLocked(const QueuedTask& queued_task) REQUIRES(task_queue_lock_);
+
+  Queue queue_ GUARDED_BY(task_queue_lock_);
+  // The queued compilation tasks, to find them when their compilation is requested again.
+  std::map<std::pair<ArtMethod*, CompilationKind>, Queue::iterator> compile_tasks_
+      GUARDED_BY(task_queue_lock_);
+  uint64_t sequence_ GUARDED_BY(task_queue_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(JitThreadPool);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_THREAD_POOL_H_
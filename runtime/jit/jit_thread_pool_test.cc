@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_thread_pool.h"
+
+#include <vector>
+
+#include "base/atomic.h"
+#include "common_runtime_test.h"
+#include "runtime.h"
+
+namespace art {
+namespace jit {
+
+class JitThreadPoolTest : public CommonRuntimeTest {
+ public:
+  // The pool never dereferences the methods, any distinct pointer will do.
+  static ArtMethod* FakeMethod(uintptr_t id) {
+    return reinterpret_cast<ArtMethod*>(id * kObjectAlignment);
+  }
+
+  // Queues a compilation task which records `id` when it runs.
+  bool AddCompileTask(Thread* self,
+                      JitThreadPool* pool,
+                      uintptr_t id,
+                      CompilationKind kind) {
+    return pool->AddCompileTask(self, FakeMethod(id), kind, [this, id]() {
+      return new FunctionTask([this, id](Thread*) { order_.push_back(id); });
+    });
+  }
+
+  // Written by the single worker of the pool, read after waiting for it.
+  std::vector<uintptr_t> order_;
+};
+
+TEST_F(JitThreadPoolTest, RunsByPriority) {
+  Thread* self = Thread::Current();
+  JitThreadPool pool("Jit thread pool test", /* num_threads= */ 1, /* create_peers= */ false);
+  pool.AddTask(self, new FunctionTask([this](Thread*) { order_.push_back(0u); }));
+  EXPECT_TRUE(AddCompileTask(self, &pool, 1u, CompilationKind::kOptimized));
+  EXPECT_TRUE(AddCompileTask(self, &pool, 2u, CompilationKind::kOptimized));
+  EXPECT_TRUE(AddCompileTask(self, &pool, 3u, CompilationKind::kBaseline));
+  EXPECT_TRUE(AddCompileTask(self, &pool, 4u, CompilationKind::kOsr));
+  EXPECT_TRUE(AddCompileTask(self, &pool, 5u, CompilationKind::kBaseline));
+  // Requesting a queued compilation again does not queue it twice, but makes it hotter.
+  EXPECT_FALSE(AddCompileTask(self, &pool, 2u, CompilationKind::kOptimized));
+  EXPECT_FALSE(AddCompileTask(self, &pool, 5u, CompilationKind::kBaseline));
+  // A different kind of compilation of the same method is a different task.
+  EXPECT_TRUE(AddCompileTask(self, &pool, 1u, CompilationKind::kBaseline));
+  EXPECT_EQ(7u, pool.GetTaskCount(self));
+
+  pool.StartWorkers(self);
+  pool.Wait(self, /* do_work= */ false, /* may_hold_locks= */ false);
+  EXPECT_EQ(0u, pool.GetTaskCount(self));
+  // OSR first, then baseline and optimized compilations by hotness and then in FIFO order, and
+  // last the other tasks.
+  std::vector<uintptr_t> expected = {4u, 5u, 3u, 1u, 2u, 1u, 0u};
+  EXPECT_EQ(expected, order_);
+
+  // Once a compilation has run, it can be queued again.
+  EXPECT_TRUE(AddCompileTask(self, &pool, 2u, CompilationKind::kOptimized));
+  pool.Wait(self, /* do_work= */ false, /* may_hold_locks= */ false);
+  EXPECT_EQ(2u, order_.back());
+}
+
+TEST_F(JitThreadPoolTest, RemoveAllTasks) {
+  Thread* self = Thread::Current();
+  JitThreadPool pool("Jit thread pool test", /* num_threads= */ 1, /* create_peers= */ false);
+  Task* removed_task = nullptr;
+  EXPECT_TRUE(pool.AddCompileTask(self, FakeMethod(1u), CompilationKind::kBaseline, [&]() {
+    removed_task = new FunctionTask([](Thread*) {});
+    return removed_task;
+  }));
+  // The workers are not started, so the tasks are dropped without being finalized.
+  pool.RemoveAllTasks(self);
+  EXPECT_EQ(0u, pool.GetTaskCount(self));
+  delete removed_task;
+  // The removed compilation is no longer considered queued.
+  EXPECT_TRUE(AddCompileTask(self, &pool, 1u, CompilationKind::kBaseline));
+  EXPECT_EQ(1u, pool.GetTaskCount(self));
+  pool.StartWorkers(self);
+  pool.Wait(self, /* do_work= */ false, /* may_hold_locks= */ false);
+  EXPECT_EQ(std::vector<uintptr_t>({1u}), order_);
+}
+
+TEST_F(JitThreadPoolTest, MultipleThreads) {
+  static constexpr size_t kNumThreads = 4;
+  static constexpr uintptr_t kNumTasks = 64;
+  Thread* self = Thread::Current();
+  JitThreadPool pool("Jit thread pool test", kNumThreads, /* create_peers= */ false);
+  EXPECT_EQ(kNumThreads, pool.GetThreadCount());
+  Atomic<size_t> count(0u);
+  for (uintptr_t i = 1; i <= kNumTasks; ++i) {
+    pool.AddCompileTask(self, FakeMethod(i), CompilationKind::kBaseline, [&count]() {
+      return new FunctionTask([&count](Thread*) { count.fetch_add(1u); });
+    });
+  }
+  pool.StartWorkers(self);
+  pool.Wait(self, /* do_work= */ false, /* may_hold_locks= */ false);
+  EXPECT_EQ(kNumTasks, count.load());
+
+  // The thread count can change when the threads are recreated, as after a zygote fork.
+  pool.DeleteThreads();
+  pool.CreateThreads(/* num_threads= */ 2);
+  EXPECT_EQ(2u, pool.GetThreadCount());
+}
+
+}  // namespace jit
+}  // namespace art
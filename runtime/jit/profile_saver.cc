@@ -221,6 +221,13 @@ void ProfileSaver::Run() {
     // Reset the flag, so we can continue on the normal schedule.
     force_early_first_save = false;
 
+    // Apps are usually killed rather than shut down, record the methods compiled so far for the
+    // next run on the same schedule as the profile.
+    jit::Jit* jit = Runtime::Current()->GetJit();
+    if (jit != nullptr) {
+      jit->SaveCacheFile();
+    }
+
     // Update the notification counter based on result. Note that there might be contention on this
     // but we don't care about to be 100% precise.
     if (!profile_saved_to_disk) {
@@ -16,6 +16,9 @@
 
 #include "profiling_info.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "art_method-inl.h"
 #include "dex/dex_instruction.h"
 #include "jit/jit.h"
@@ -25,27 +28,47 @@
 
 namespace art {
 
-ProfilingInfo::ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries)
+ProfilingInfo::ProfilingInfo(ArtMethod* method,
+                             const std::vector<uint32_t>& entries,
+                             const std::vector<uint32_t>& loop_headers,
+                             const std::vector<uint32_t>& branches)
       : baseline_hotness_count_(GetOptimizeThreshold()),
         method_(method),
         number_of_inline_caches_(entries.size()),
+        number_of_back_edge_counters_(loop_headers.size()),
+        number_of_branch_caches_(branches.size()),
         current_inline_uses_(0) {
   memset(&cache_, 0, number_of_inline_caches_ * sizeof(InlineCache));
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
     cache_[i].dex_pc_ = entries[i];
   }
+  DCHECK(std::is_sorted(loop_headers.begin(), loop_headers.end()));
+  BackEdgeCounter* counters = GetBackEdgeCounters();
+  for (size_t i = 0; i < number_of_back_edge_counters_; ++i) {
+    counters[i].dex_pc_ = loop_headers[i];
+    counters[i].count_ = 0u;
+  }
+  DCHECK(std::is_sorted(branches.begin(), branches.end()));
+  BranchCache* branch_caches = GetBranchCaches();
+  for (size_t i = 0; i < number_of_branch_caches_; ++i) {
+    branch_caches[i].dex_pc_ = branches[i];
+    branch_caches[i].false_ = 0u;
+    branch_caches[i].true_ = 0u;
+  }
 }
 
 uint16_t ProfilingInfo::GetOptimizeThreshold() {
   return Runtime::Current()->GetJITOptions()->GetOptimizeThreshold();
 }
 
-ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method) {
+ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocation) {
   // Walk over the dex instructions of the method and keep track of
   // instructions we are interested in profiling.
   DCHECK(!method->IsNative());
 
   std::vector<uint32_t> entries;
+  std::vector<uint32_t> loop_headers;
+  std::vector<uint32_t> branches;
   for (const DexInstructionPcPair& inst : method->DexInstructions()) {
     switch (inst->Opcode()) {
       case Instruction::INVOKE_VIRTUAL:
@@ -56,16 +79,28 @@ ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method) {
         break;
 
       default:
+        if (inst->IsBranch()) {
+          // Back edges are the branches nterp counts in the hotness of the method.
+          if (inst->GetTargetOffset() <= 0) {
+            loop_headers.push_back(inst.DexPc() + inst->GetTargetOffset());
+          }
+          if (!inst->IsUnconditional()) {
+            branches.push_back(inst.DexPc());
+          }
+        }
         break;
     }
   }
+  std::sort(loop_headers.begin(), loop_headers.end());
+  loop_headers.erase(std::unique(loop_headers.begin(), loop_headers.end()), loop_headers.end());
 
   // We always create a `ProfilingInfo` object, even if there is no instruction we are
   // interested in. The JIT code cache internally uses it.
 
   // Allocate the `ProfilingInfo` object int the JIT's data space.
   jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
-  return code_cache->AddProfilingInfo(self, method, entries);
+  return code_cache->AddProfilingInfo(
+      self, method, entries, loop_headers, branches, retry_allocation);
 }
 
 InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
@@ -80,13 +115,47 @@ InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
   UNREACHABLE();
 }
 
+BranchCache* ProfilingInfo::GetBranchCache(uint32_t dex_pc) {
+  // The caches are sorted by dex pc.
+  BranchCache* begin = GetBranchCaches();
+  BranchCache* end = begin + number_of_branch_caches_;
+  BranchCache* it = std::lower_bound(
+      begin, end, dex_pc, [](const BranchCache& lhs, uint32_t rhs) {
+        return lhs.dex_pc_ < rhs;
+      });
+  return (it != end && it->dex_pc_ == dex_pc) ? it : nullptr;
+}
+
+BackEdgeCounter* ProfilingInfo::FindBackEdgeCounter(uint32_t dex_pc) {
+  // The counters are sorted by dex pc.
+  BackEdgeCounter* begin = GetBackEdgeCounters();
+  BackEdgeCounter* end = begin + number_of_back_edge_counters_;
+  BackEdgeCounter* it = std::lower_bound(
+      begin, end, dex_pc, [](const BackEdgeCounter& lhs, uint32_t rhs) {
+        return lhs.dex_pc_ < rhs;
+      });
+  return (it != end && it->dex_pc_ == dex_pc) ? it : nullptr;
+}
+
+uint32_t ProfilingInfo::AddBackEdges(uint32_t dex_pc, uint32_t count) {
+  BackEdgeCounter* counter = FindBackEdgeCounter(dex_pc);
+  if (counter == nullptr) {
+    return 0u;
+  }
+  // Saturate rather than wrap around, a hot loop must stay hot.
+  counter->count_ = std::min<uint64_t>(static_cast<uint64_t>(counter->count_) + count,
+                                       std::numeric_limits<uint32_t>::max());
+  return counter->count_;
+}
+
 void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   InlineCache* cache = GetInlineCache(dex_pc);
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
     mirror::Class* existing = cache->classes_[i].Read<kWithoutReadBarrier>();
     mirror::Class* marked = ReadBarrier::IsMarked(existing);
     if (marked == cls) {
-      // Receiver type is already in the cache, nothing else to do.
+      // Receiver type is already in the cache, just count it.
+      ++cache->counts_[i];
       return;
     } else if (marked == nullptr) {
       // Cache entry is empty, try to put `cls` in it.
@@ -101,13 +170,16 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
         // entry in case the entry contains `cls`.
         --i;
       } else {
-        // We successfully set `cls`, just return.
+        // We successfully set `cls`, count it and return.
+        ++cache->counts_[i];
         return;
       }
     }
   }
   // Unsuccessfull - cache is full, making it megamorphic. We do not DCHECK it though,
-  // as the garbage collector might clear the entries concurrently.
+  // as the garbage collector might clear the entries concurrently. Count the receiver in the
+  // last entry, like art_quick_update_inline_cache.
+  ++cache->counts_[InlineCache::kIndividualCacheSize - 1];
 }
 
 ScopedProfilingInfoUse::ScopedProfilingInfoUse(jit::Jit* jit, ArtMethod* method, Thread* self)
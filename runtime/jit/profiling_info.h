@@ -50,9 +50,17 @@ class InlineCache {
     return MemberOffset(OFFSETOF_MEMBER(InlineCache, classes_));
   }
 
+  static constexpr MemberOffset CountsOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(InlineCache, counts_));
+  }
+
  private:
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  // How many times the receiver was the class of the same index. The counts are updated without
+  // synchronization, so they are approximate. Once the cache is megamorphic, the last count also
+  // includes the receivers of all the classes that did not fit in the cache.
+  uint32_t counts_[kIndividualCacheSize];
 
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
@@ -60,16 +68,79 @@ class InlineCache {
   DISALLOW_COPY_AND_ASSIGN(InlineCache);
 };
 
+// Structure to count the back edges taken to a loop header, by the interpreter.
+class BackEdgeCounter {
+ private:
+  // Dex pc of the loop header, the target of the back edges.
+  uint32_t dex_pc_;
+  // The count is updated without synchronization, so it is approximate.
+  uint32_t count_;
+
+  friend class ProfilingInfo;
+
+  DISALLOW_COPY_AND_ASSIGN(BackEdgeCounter);
+};
+
+// Structure to count the outcomes of a conditional branch, by baseline compiled code.
+class BranchCache {
+ public:
+  // Baseline code indexes the counts with the value of the condition, so the count of the
+  // branch not taken must come first. This is hard coded in the code generators.
+  static constexpr MemberOffset FalseOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(BranchCache, false_));
+  }
+
+  static constexpr MemberOffset TrueOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(BranchCache, true_));
+  }
+
+  uint32_t GetDexPc() const {
+    return dex_pc_;
+  }
+
+  uint16_t GetFalseCount() const {
+    return false_;
+  }
+
+  uint16_t GetTrueCount() const {
+    return true_;
+  }
+
+ private:
+  // Dex pc of the conditional branch.
+  uint32_t dex_pc_;
+  // How many times the branch was not taken, and taken. The counts saturate, and are updated
+  // without synchronization, so they are approximate.
+  uint16_t false_;
+  uint16_t true_;
+
+  friend class ProfilingInfo;
+
+  DISALLOW_COPY_AND_ASSIGN(BranchCache);
+};
+
 /**
  * Profiling info for a method, created and filled by the interpreter once the
  * method is warm, and used by the compiler to drive optimizations.
  */
 class ProfilingInfo {
  public:
-  // Create a ProfilingInfo for 'method'.
-  static ProfilingInfo* Create(Thread* self, ArtMethod* method)
+  // Create a ProfilingInfo for 'method'. If `retry_allocation` is false, fail instead of
+  // collecting the JIT code cache to make room, so that the caller is not suspended.
+  static ProfilingInfo* Create(Thread* self, ArtMethod* method, bool retry_allocation = true)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // The size of a ProfilingInfo with the given number of inline caches, loop headers and
+  // conditional branches.
+  static size_t ComputeSize(size_t number_of_inline_caches,
+                            size_t number_of_loop_headers,
+                            size_t number_of_branches) {
+    return sizeof(ProfilingInfo) +
+        sizeof(InlineCache) * number_of_inline_caches +
+        sizeof(BackEdgeCounter) * number_of_loop_headers +
+        sizeof(BranchCache) * number_of_branches;
+  }
+
   // Add information from an executed INVOKE instruction to the profile.
   void AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls)
       // Method should not be interruptible, as it manipulates the ProfilingInfo
@@ -83,6 +154,14 @@ class ProfilingInfo {
 
   InlineCache* GetInlineCache(uint32_t dex_pc);
 
+  // Returns the branch cache of the conditional branch at `dex_pc`, or null if there is no
+  // conditional branch at `dex_pc`.
+  BranchCache* GetBranchCache(uint32_t dex_pc);
+
+  // Add `count` back edges to the loop whose header is at `dex_pc`, and return the number of
+  // back edges recorded for that loop. Returns 0 if `dex_pc` is not the target of a back edge.
+  uint32_t AddBackEdges(uint32_t dex_pc, uint32_t count);
+
   // Increments the number of times this method is currently being inlined.
   // Returns whether it was successful, that is it could increment without
   // overflowing.
@@ -120,7 +199,20 @@ class ProfilingInfo {
   }
 
  private:
-  ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries);
+  ProfilingInfo(ArtMethod* method,
+                const std::vector<uint32_t>& entries,
+                const std::vector<uint32_t>& loop_headers,
+                const std::vector<uint32_t>& branches);
+
+  BackEdgeCounter* GetBackEdgeCounters() {
+    return reinterpret_cast<BackEdgeCounter*>(&cache_[number_of_inline_caches_]);
+  }
+
+  BranchCache* GetBranchCaches() {
+    return reinterpret_cast<BranchCache*>(GetBackEdgeCounters() + number_of_back_edge_counters_);
+  }
+
+  BackEdgeCounter* FindBackEdgeCounter(uint32_t dex_pc);
 
   static uint16_t GetOptimizeThreshold();
 
@@ -137,11 +229,19 @@ class ProfilingInfo {
   // Number of instructions we are profiling in the ArtMethod.
   const uint32_t number_of_inline_caches_;
 
+  // Number of loop headers we count back edges for.
+  const uint32_t number_of_back_edge_counters_;
+
+  // Number of conditional branches we count the outcomes of.
+  const uint32_t number_of_branch_caches_;
+
   // When the compiler inlines the method associated to this ProfilingInfo,
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
-  // Dynamically allocated array of size `number_of_inline_caches_`.
+  // Dynamically allocated array of size `number_of_inline_caches_`, followed by an array
+  // of `number_of_back_edge_counters_` BackEdgeCounters sorted by dex pc, and an array of
+  // `number_of_branch_caches_` BranchCaches sorted by dex pc.
   InlineCache cache_[0];
 
   friend class jit::JitCodeCache;
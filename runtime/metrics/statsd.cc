@@ -106,6 +106,25 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
     case DatumId::kFullGcTracingThroughputAvg:
       return std::make_optional(
           statsd::ART_DATUM_REPORTED__KIND__ART_DATUM_GC_FULL_HEAP_TRACING_THROUGHPUT_AVG_MB_PER_SEC);
+    case DatumId::kRssTargetCompactionCount:
+      return std::make_optional(
+          statsd::ART_DATUM_REPORTED__KIND__ART_DATUM_GC_RSS_TARGET_COMPACTION_COUNT);
+    case DatumId::kRssTargetTrimCount:
+      return std::make_optional(
+          statsd::ART_DATUM_REPORTED__KIND__ART_DATUM_GC_RSS_TARGET_TRIM_COUNT);
+    case DatumId::kRssTargetNoActionCount:
+      return std::make_optional(
+          statsd::ART_DATUM_REPORTED__KIND__ART_DATUM_GC_RSS_TARGET_NO_ACTION_COUNT);
+    case DatumId::kLargeObjectSpaceFragmentedBytesAvg:
+      return std::make_optional(
+          statsd::ART_DATUM_REPORTED__KIND__ART_DATUM_GC_LARGE_OBJECT_SPACE_FRAGMENTED_BYTES_AVG);
+    case DatumId::kJitCompileQueueDepthAvg:
+    case DatumId::kJitCompileQueueTimeAvg:
+    case DatumId::kJitCompileQueueTime:
+    case DatumId::kJitDeoptimizationCount:
+    case DatumId::kJitDeoptimizationRecompileCount:
+      // Not reported until there are atoms.proto entries for them.
+      return std::nullopt;
   }
 }
 
@@ -201,12 +201,27 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:StopForNativeAllocs=_")
           .WithType<MemoryKiB>()
           .IntoKey(M::StopForNativeAllocs)
+      .Define("-XX:RssTarget=_")
+          .WithType<MemoryKiB>()
+          .WithHelp("Resident set size that the heap tries to keep the process under by compacting "
+                    "or trimming after GCs. 0 (the default) keeps the usual trimming policy.")
+          .IntoKey(M::RssTarget)
       .Define("-XX:ParallelGCThreads=_")
           .WithType<unsigned int>()
           .IntoKey(M::ParallelGCThreads)
       .Define("-XX:ConcGCThreads=_")
           .WithType<unsigned int>()
           .IntoKey(M::ConcGCThreads)
+      .Define("-XX:ConcurrentCopyingMarkWorkers=_")
+          .WithType<unsigned int>()
+          .WithHelp("Number of threads processing the concurrent copying mark stack, including "
+                    "the GC thread. 1 disables parallel marking. Defaults to the parallel GC "
+                    "threads plus the GC thread.")
+          .IntoKey(M::ConcurrentCopyingMarkWorkers)
+      .Define("-XX:GenerationalCCTenureThreshold=_")
+          .WithType<unsigned int>()
+          .WithHelp("Number of young GCs an object survives before generational CC promotes it.")
+          .IntoKey(M::GenerationalCCTenureThreshold)
       .Define("-XX:FinalizerTimeoutMs=_")
           .WithType<unsigned int>()
           .IntoKey(M::FinalizerTimeoutMs)
@@ -221,6 +236,8 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::LongGCLogThreshold)
       .Define("-XX:DumpGCPerformanceOnShutdown")
           .IntoKey(M::DumpGCPerformanceOnShutdown)
+      .Define("-XX:ClassHistogram")
+          .IntoKey(M::ClassHistogram)
       .Define("-XX:DumpRegionInfoBeforeGC")
           .IntoKey(M::DumpRegionInfoBeforeGC)
       .Define("-XX:DumpRegionInfoAfterGC")
@@ -274,6 +291,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitwarmupthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITWarmupThreshold)
+      .Define("-Xjitosrthreshold:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITOsrThreshold)
       .Define("-Xjitprithreadweight:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITPriorityThreadWeight)
@@ -283,9 +303,15 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitpthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITPoolThreadPthreadPriority)
+      .Define("-Xjitthreads:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITPoolThreads)
       .Define("-Xjitzygotepthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITZygotePoolThreadPthreadPriority)
+      .Define("-Xjitcachefile:_")
+          .WithType<std::string>()
+          .IntoKey(M::JITCacheFile)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
@@ -323,9 +349,10 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::ImageDex2Oat)
       .Define("-XX:LargeObjectSpace=_")
           .WithType<gc::space::LargeObjectSpaceType>()
-          .WithValueMap({{"disabled", gc::space::LargeObjectSpaceType::kDisabled},
-                         {"freelist", gc::space::LargeObjectSpaceType::kFreeList},
-                         {"map",      gc::space::LargeObjectSpaceType::kMap}})
+          .WithValueMap({{"disabled",   gc::space::LargeObjectSpaceType::kDisabled},
+                         {"freelist",   gc::space::LargeObjectSpaceType::kFreeList},
+                         {"segregated", gc::space::LargeObjectSpaceType::kSegregatedFreeList},
+                         {"map",        gc::space::LargeObjectSpaceType::kMap}})
           .IntoKey(M::LargeObjectSpace)
       .Define("-XX:LargeObjectThreshold=_")
           .WithType<Memory<1>>()
@@ -474,7 +501,7 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           "-Xverifyopt:_", "-Xcheckdexsum", "-Xincludeselectedop", "-Xjitop:_",
           "-Xincludeselectedmethod",
           "-Xjitblocking", "-Xjitmethod:_", "-Xjitclass:_", "-Xjitoffset:_",
-          "-Xjitosrthreshold:_", "-Xjitconfig:_", "-Xjitcheckcg", "-Xjitverbose", "-Xjitprofile",
+          "-Xjitconfig:_", "-Xjitcheckcg", "-Xjitverbose", "-Xjitprofile",
           "-Xjitdisableopt", "-Xjitsuspendpoll", "-XX:mainThreadStackSize=_"})
       .IgnoreUnrecognized(ignore_unrecognized)
       .OrderCategories({"standard", "extended", "Dalvik", "ART"});
@@ -674,6 +701,8 @@ bool ParsedOptions::DoParse(const RuntimeOptions& options,
   // Default to number of processors minus one since the main GC thread also does work.
   args.SetIfMissing(M::ParallelGCThreads, gc::Heap::kDefaultEnableParallelGC ?
       static_cast<unsigned int>(sysconf(_SC_NPROCESSORS_CONF) - 1u) : 0u);
+  // Process the concurrent copying mark stack with the parallel GC threads too, like MarkSweep.
+  args.SetIfMissing(M::ConcurrentCopyingMarkWorkers, *args.Get(M::ParallelGCThreads) + 1u);
 
   // -verbose:
   {
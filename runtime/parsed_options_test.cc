@@ -20,6 +20,7 @@
 
 #include "arch/instruction_set.h"
 #include "base/common_art_test.h"
+#include "jit/jit.h"
 
 namespace art {
 
@@ -183,4 +184,28 @@ TEST_F(ParsedOptionsTest, ParsedOptionsInstructionSet) {
   }
 }
 
+TEST_F(ParsedOptionsTest, ParsedOptionsJitOsrThreshold) {
+  {
+    // Nterp charges a full warmup to a loop each time the hotness counter runs out, so a single
+    // warmup must not make a loop hot enough to OSR compile its method.
+    RuntimeOptions options;
+    RuntimeArgumentMap map;
+    ASSERT_TRUE(ParsedOptions::Parse(options, false, &map));
+    std::unique_ptr<jit::JitOptions> jit_options(
+        jit::JitOptions::CreateFromRuntimeArguments(map));
+    EXPECT_GT(jit_options->GetOsrThreshold(), jit_options->GetWarmupThreshold());
+  }
+  {
+    RuntimeOptions options;
+    options.push_back(std::make_pair("-Xjitwarmupthreshold:1000", nullptr));
+    options.push_back(std::make_pair("-Xjitosrthreshold:5000", nullptr));
+    RuntimeArgumentMap map;
+    ASSERT_TRUE(ParsedOptions::Parse(options, false, &map));
+    std::unique_ptr<jit::JitOptions> jit_options(
+        jit::JitOptions::CreateFromRuntimeArguments(map));
+    EXPECT_EQ(1000u, jit_options->GetWarmupThreshold());
+    EXPECT_EQ(5000u, jit_options->GetOsrThreshold());
+  }
+}
+
 }  // namespace art
@@ -313,6 +313,8 @@ class DeoptimizeStackVisitor final : public StackVisitor {
         single_frame_done_(false),
         single_frame_deopt_method_(nullptr),
         single_frame_deopt_quick_method_header_(nullptr),
+        single_frame_deopt_site_method_(nullptr),
+        single_frame_deopt_site_dex_pc_(dex::kDexNoIndex),
         callee_method_(nullptr) {
   }
 
@@ -324,6 +326,15 @@ class DeoptimizeStackVisitor final : public StackVisitor {
     return single_frame_deopt_quick_method_header_;
   }
 
+  // The method and dex pc of the innermost frame, where compiled code deoptimized.
+  ArtMethod* GetSingleFrameDeoptSiteMethod() const {
+    return single_frame_deopt_site_method_;
+  }
+
+  uint32_t GetSingleFrameDeoptSiteDexPc() const {
+    return single_frame_deopt_site_dex_pc_;
+  }
+
   void FinishStackWalk() REQUIRES_SHARED(Locks::mutator_lock_) {
     // This is the upcall, or the next full frame in single-frame deopt, or the
     // code isn't deoptimizeable. We remember the frame and last pc so that we
@@ -402,6 +413,8 @@ class DeoptimizeStackVisitor final : public StackVisitor {
       if (prev_shadow_frame_ != nullptr) {
         prev_shadow_frame_->SetLink(new_frame);
       } else {
+        single_frame_deopt_site_method_ = method;
+        single_frame_deopt_site_dex_pc_ = GetDexPc();
         // Will be popped after the long jump after DeoptimizeStack(),
         // right before interpreter::EnterInterpreterFromDeoptimize().
         stacked_shadow_frame_pushed_ = true;
@@ -548,6 +561,8 @@ class DeoptimizeStackVisitor final : public StackVisitor {
   bool single_frame_done_;
   ArtMethod* single_frame_deopt_method_;
   const OatQuickMethodHeader* single_frame_deopt_quick_method_header_;
+  ArtMethod* single_frame_deopt_site_method_;
+  uint32_t single_frame_deopt_site_dex_pc_;
   ArtMethod* callee_method_;
 
   DISALLOW_COPY_AND_ASSIGN(DeoptimizeStackVisitor);
@@ -603,8 +618,13 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
   // can be reused when debugging support (like breakpoints) are no longer
   // needed fot this method.
   if (Runtime::Current()->UseJitCompilation() && (kind != DeoptimizationKind::kDebugging)) {
-    Runtime::Current()->GetJit()->GetCodeCache()->InvalidateCompiledCodeFor(
-        deopt_method, visitor.GetSingleFrameDeoptQuickMethodHeader());
+    Runtime::Current()->GetJit()->NotifyDeoptimization(
+        self_,
+        deopt_method,
+        visitor.GetSingleFrameDeoptQuickMethodHeader(),
+        visitor.GetSingleFrameDeoptSiteMethod(),
+        visitor.GetSingleFrameDeoptSiteDexPc(),
+        kind);
   } else {
     Runtime::Current()->GetInstrumentation()->InitializeMethodsCode(
         deopt_method, /*aot_code=*/ nullptr);
@@ -398,6 +398,8 @@ Runtime::~Runtime() {
     // The saver will try to dump the profiles before being sopped and that
     // requires holding the mutator lock.
     jit_->StopProfileSaver();
+    // Record the compiled methods for the next run while the code cache is still intact.
+    jit_->SaveCacheFile();
     // Delete thread pool before the thread list since we don't want to wait forever on the
     // JIT compiler threads. Also this should be run before marking the runtime
     // as shutting down as some tasks may require mutator access.
@@ -767,6 +769,11 @@ void Runtime::PostZygoteFork() {
 }
 
 void Runtime::CallExitHook(jint status) {
+  // System.exit() does not shut the runtime down, record the compiled methods for the next run
+  // now.
+  if (jit_ != nullptr) {
+    jit_->SaveCacheFile();
+  }
   if (exit_ != nullptr) {
     ScopedThreadStateChange tsc(Thread::Current(), ThreadState::kNative);
     exit_(status);
@@ -1606,6 +1613,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        runtime_options.GetOrDefault(Opt::HeapTargetUtilization),
                        foreground_heap_growth_multiplier,
                        runtime_options.GetOrDefault(Opt::StopForNativeAllocs),
+                       runtime_options.GetOrDefault(Opt::RssTarget),
                        runtime_options.GetOrDefault(Opt::MemoryMaximumSize),
                        runtime_options.GetOrDefault(Opt::NonMovingSpaceCapacity),
                        GetBootClassPath(),
@@ -1624,6 +1632,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        runtime_options.GetOrDefault(Opt::LargeObjectThreshold),
                        runtime_options.GetOrDefault(Opt::ParallelGCThreads),
                        runtime_options.GetOrDefault(Opt::ConcGCThreads),
+                       runtime_options.GetOrDefault(Opt::ConcurrentCopyingMarkWorkers),
                        runtime_options.Exists(Opt::LowMemoryMode),
                        runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
                        runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
@@ -1640,6 +1649,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        xgc_option.measure_,
                        runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
                        use_generational_cc,
+                       runtime_options.GetOrDefault(Opt::GenerationalCCTenureThreshold),
                        runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
                        runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
                        runtime_options.Exists(Opt::DumpRegionInfoAfterGC));
@@ -1880,6 +1890,10 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   verifier::ClassVerifier::Init(class_linker_);
 
+  if (runtime_options.Exists(Opt::ClassHistogram)) {
+    heap_->SetClassHistogramEnabled(true);
+  }
+
   if (runtime_options.Exists(Opt::MethodTrace)) {
     trace_config_.reset(new TraceConfig());
     trace_config_->trace_file = runtime_options.ReleaseOrDefault(Opt::MethodTraceFile);
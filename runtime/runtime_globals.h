@@ -37,7 +37,12 @@ static constexpr size_t kLargeObjectAlignment = kPageSize;
 
 // Garbage collector constants.
 static constexpr bool kMovingCollector = true;
+// Mark compact updates references before moving objects, which requires classes to never move.
+#ifdef ART_USE_MARK_COMPACT
+static constexpr bool kMarkCompactSupport = true && kMovingCollector;
+#else
 static constexpr bool kMarkCompactSupport = false && kMovingCollector;
+#endif
 // True if we allow moving classes.
 static constexpr bool kMovingClasses = !kMarkCompactSupport;
 // When using the Concurrent Copying (CC) collector, if
@@ -69,6 +69,7 @@
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/allocator/rosalloc.h"
+#include "gc/class_histogram.h"
 #include "gc/heap.h"
 #include "gc/space/space-inl.h"
 #include "gc_root.h"
@@ -2426,6 +2427,9 @@ Thread::Thread(bool daemon)
   std::fill(tlsPtr_.rosalloc_runs,
             tlsPtr_.rosalloc_runs + kNumRosAllocThreadLocalSizeBracketsInThread,
             gc::allocator::RosAlloc::GetDedicatedFullRun());
+  std::fill(rosalloc_magazines_,
+            rosalloc_magazines_ + kNumRosAllocMagazineSizeBracketsInThread,
+            nullptr);
   tlsPtr_.checkpoint_function = nullptr;
   for (uint32_t i = 0; i < kMaxSuspendBarriers; ++i) {
     tlsPtr_.active_suspend_barriers[i] = nullptr;
@@ -4392,6 +4396,13 @@ void Thread::SetStackEndForStackOverflow() {
   }
 }
 
+gc::ThreadLocalClassHistogram* Thread::GetClassHistogram() {
+  if (class_histogram_ == nullptr) {
+    class_histogram_.reset(new gc::ThreadLocalClassHistogram());
+  }
+  return class_histogram_.get();
+}
+
 void Thread::SetTlab(uint8_t* start, uint8_t* end, uint8_t* limit) {
   DCHECK_LE(start, end);
   DCHECK_LE(end, limit);
@@ -4404,6 +4415,8 @@ void Thread::SetTlab(uint8_t* start, uint8_t* end, uint8_t* limit) {
 
 void Thread::ResetTlab() {
   gc::Heap* const heap = Runtime::Current()->GetHeap();
+  // The unused end of the TLAB was counted as allocated when the TLAB was handed out.
+  heap->RecordTlabWaste(tlsPtr_.thread_local_end - tlsPtr_.thread_local_pos);
   if (heap->GetHeapSampler().IsEnabled()) {
     // Note: We always ResetTlab before SetTlab, therefore we can do the sample
     // offset adjustment here.
@@ -59,6 +59,7 @@ template<class T> class AtomicStack;
 namespace collector {
 class SemiSpace;
 }  // namespace collector
+class ThreadLocalClassHistogram;
 }  // namespace gc
 
 namespace instrumentation {
@@ -188,6 +189,9 @@ enum class WeakRefAccessState : int32_t {
 // This should match RosAlloc::kNumThreadLocalSizeBrackets.
 static constexpr size_t kNumRosAllocThreadLocalSizeBracketsInThread = 16;
 
+// This should match RosAlloc::kNumMagazineSizeBrackets.
+static constexpr size_t kNumRosAllocMagazineSizeBracketsInThread = 26;
+
 static constexpr size_t kSharedMethodHotnessThreshold = 0xffff;
 
 // Thread's stack layout for implicit stack overflow checks:
@@ -1206,6 +1210,34 @@ class Thread {
     DCHECK_LE(tlsPtr_.thread_local_end, tlsPtr_.thread_local_limit);
   }
 
+  // Adaptive TLAB sizing state, see Heap::GetAdaptiveTlabSize(). Only used by the thread itself.
+  size_t GetAdaptiveTlabSize() const {
+    return adaptive_tlab_size_;
+  }
+  void SetAdaptiveTlabSize(size_t size) {
+    adaptive_tlab_size_ = size;
+  }
+  size_t GetTlabBytesSinceGc() const {
+    return tlab_bytes_since_gc_;
+  }
+  void AddTlabBytesSinceGc(size_t bytes) {
+    tlab_bytes_since_gc_ += bytes;
+  }
+  uint32_t GetTlabGcNum() const {
+    return tlab_gc_num_;
+  }
+  void ResetTlabBytesSinceGc(uint32_t gc_num) {
+    tlab_bytes_since_gc_ = 0u;
+    tlab_gc_num_ = gc_num;
+  }
+
+  // The class histogram counts of this thread since the heap last flushed them, see
+  // Heap::IsClassHistogramEnabled(). Created on first use.
+  gc::ThreadLocalClassHistogram* GetClassHistogram();
+  bool HasClassHistogram() const {
+    return class_histogram_ != nullptr;
+  }
+
   // Doesn't check that there is room.
   mirror::Object* AllocTlab(size_t bytes);
   void SetTlab(uint8_t* start, uint8_t* end, uint8_t* limit);
@@ -1265,6 +1297,14 @@ class Thread {
     tlsPtr_.rosalloc_runs[index] = run;
   }
 
+  void* GetRosAllocMagazine(size_t index) const {
+    return rosalloc_magazines_[index];
+  }
+
+  void SetRosAllocMagazine(size_t index, void* slots) {
+    rosalloc_magazines_[index] = slots;
+  }
+
   bool ProtectStack(bool fatal_on_error = true);
   bool UnprotectStack();
 
@@ -2054,6 +2094,19 @@ class Thread {
   // Pointer to the monitor lock we're currently waiting on or null if not waiting.
   Monitor* wait_monitor_ GUARDED_BY(wait_mutex_);
 
+  // The heads of the lists of free slots cached for the RosAlloc size brackets which do not use
+  // thread-local runs.
+  void* rosalloc_magazines_[kNumRosAllocMagazineSizeBracketsInThread];
+
+  // The size of the TLABs of this thread, or 0 to use the default size of the allocator.
+  size_t adaptive_tlab_size_ = 0u;
+  // The TLAB bytes this thread got since the GC number tlab_gc_num_ completed.
+  size_t tlab_bytes_since_gc_ = 0u;
+  uint32_t tlab_gc_num_ = 0u;
+
+  // Per-class allocation and survival counts, see GetClassHistogram().
+  std::unique_ptr<gc::ThreadLocalClassHistogram> class_histogram_;
+
   // Debug disable read barrier count, only is checked for debug builds and only in the runtime.
   uint8_t debug_disallow_read_barrier_ = 0;
 
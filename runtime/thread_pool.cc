@@ -141,7 +141,7 @@ void* ThreadPoolWorker::Callback(void* arg) {
 
 void ThreadPool::AddTask(Thread* self, Task* task) {
   MutexLock mu(self, task_queue_lock_);
-  tasks_.push_back(task);
+  PushTaskLocked(task);
   // If we have any waiters, signal one.
   if (started_ && waiting_count_ != 0) {
     task_queue_condition_.Signal(self);
@@ -156,7 +156,7 @@ void ThreadPool::RemoveAllTasks(Thread* self) {
     task->Finalize();
   }
   MutexLock mu(self, task_queue_lock_);
-  tasks_.clear();
+  ClearTasksLocked();
 }
 
 ThreadPool::ThreadPool(const char* name,
@@ -285,13 +285,29 @@ Task* ThreadPool::TryGetTask(Thread* self) {
 
 Task* ThreadPool::TryGetTaskLocked() {
   if (HasOutstandingTasks()) {
-    Task* task = tasks_.front();
-    tasks_.pop_front();
-    return task;
+    return PopTaskLocked();
   }
   return nullptr;
 }
 
+void ThreadPool::PushTaskLocked(Task* task) {
+  tasks_.push_back(task);
+}
+
+Task* ThreadPool::PopTaskLocked() {
+  Task* task = tasks_.front();
+  tasks_.pop_front();
+  return task;
+}
+
+size_t ThreadPool::GetTaskCountLocked() const {
+  return tasks_.size();
+}
+
+void ThreadPool::ClearTasksLocked() {
+  tasks_.clear();
+}
+
 void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
   if (do_work) {
     CHECK(!create_peers_);
@@ -314,7 +330,7 @@ void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
 
 size_t ThreadPool::GetTaskCount(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
-  return tasks_.size();
+  return GetTaskCountLocked();
 }
 
 void ThreadPool::SetPthreadPriority(int priority) {
@@ -187,9 +187,16 @@ class ThreadPool {
   }
 
   bool HasOutstandingTasks() const REQUIRES(task_queue_lock_) {
-    return started_ && !tasks_.empty();
+    return started_ && GetTaskCountLocked() != 0;
   }
 
+  // Operations on the task queue. The default queue runs the tasks in FIFO order, pools that
+  // order their tasks differently override all of them.
+  virtual void PushTaskLocked(Task* task) REQUIRES(task_queue_lock_);
+  virtual Task* PopTaskLocked() REQUIRES(task_queue_lock_);
+  virtual size_t GetTaskCountLocked() const REQUIRES(task_queue_lock_);
+  virtual void ClearTasksLocked() REQUIRES(task_queue_lock_);
+
   const std::string name_;
   Mutex task_queue_lock_;
   ConditionVariable task_queue_condition_ GUARDED_BY(task_queue_lock_);
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Test on loop unswitching and on loops which need several runtime alias tests to vectorize.
+//
+public class Main {
+
+  /// CHECK-START: void Main.unswitchAddSub(int[], int, boolean) loop_optimization (before)
+  /// CHECK-DAG: <<Par:z\d+>> ParameterValue                       loop:none
+  /// CHECK-DAG:              If [<<Par>>]                         loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:              Add                                  loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:              Sub                                  loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-START: void Main.unswitchAddSub(int[], int, boolean) loop_optimization (after)
+  /// CHECK-DAG: <<Par:z\d+>> ParameterValue                       loop:none
+  /// CHECK-DAG:              If [<<Par>>]                         loop:none
+  //
+  /// CHECK-START: void Main.unswitchAddSub(int[], int, boolean) loop_optimization (after)
+  /// CHECK-NOT:              If [{{z\d+}}]                        loop:{{B\d+}}
+  //
+  /// CHECK-START-ARM64: void Main.unswitchAddSub(int[], int, boolean) loop_optimization (after)
+  /// CHECK-DAG:              VecAdd                               loop:<<Loop1:B\d+>> outer_loop:none
+  /// CHECK-DAG:              VecSub                               loop:<<Loop2:B\d+>> outer_loop:none
+  private static void unswitchAddSub(int[] a, int x, boolean add) {
+    for (int i = 0; i < a.length; i++) {
+      if (add) {
+        a[i] += x;
+      } else {
+        a[i] -= x;
+      }
+    }
+  }
+
+  /// CHECK-START: int Main.unswitchReduction(int[], boolean) loop_optimization (before)
+  /// CHECK-DAG: <<Par:z\d+>> ParameterValue                       loop:none
+  /// CHECK-DAG:              If [<<Par>>]                         loop:<<Loop:B\d+>> outer_loop:none
+  //
+  /// CHECK-START: int Main.unswitchReduction(int[], boolean) loop_optimization (after)
+  /// CHECK-DAG: <<Par:z\d+>> ParameterValue                       loop:none
+  /// CHECK-DAG:              If [<<Par>>]                         loop:none
+  private static int unswitchReduction(int[] a, boolean square) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      int x = a[i];
+      if (square) {
+        sum += x * x;
+      } else {
+        sum += x;
+      }
+    }
+    return sum;
+  }
+
+  // The condition depends on the induction variable, so the loop must not be unswitched.
+  //
+  /// CHECK-START: void Main.noUnswitchVariant(int[], int) loop_optimization (after)
+  /// CHECK-DAG:              If                                   loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:              Add                                  loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:              Sub                                  loop:<<Loop>>      outer_loop:none
+  private static void noUnswitchVariant(int[] a, int x) {
+    for (int i = 0; i < a.length; i++) {
+      if (i < x) {
+        a[i] += x;
+      } else {
+        a[i] -= x;
+      }
+    }
+  }
+
+  // The `continue` also reaches the block where the arms of the invariant `if` meet, so the
+  // loop is not unswitched.
+  //
+  /// CHECK-START: void Main.noUnswitchContinue(int[], int[], boolean) loop_optimization (after)
+  /// CHECK-DAG: <<Par:z\d+>> ParameterValue                       loop:none
+  /// CHECK-DAG:              If [<<Par>>]                         loop:{{B\d+}} outer_loop:none
+  private static void noUnswitchContinue(int[] a, int[] x, boolean one) {
+    for (int i = 0; i < a.length; i++) {
+      if (a[i] == 0) {
+        continue;
+      }
+      if (one) {
+        x[i] = 1;
+      } else {
+        x[i] = 2;
+      }
+    }
+  }
+
+  // Vectorizing this loop needs a runtime test for each pair of arrays which are written and
+  // read at different offsets.
+  //
+  /// CHECK-START-ARM64: void Main.twoCopies(int[], int[], int[], int[], int) loop_optimization (after)
+  /// CHECK-DAG:              VecLoad                              loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:              VecStore                             loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:              VecLoad                              loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:              VecStore                             loop:<<Loop>>      outer_loop:none
+  private static void twoCopies(int[] a, int[] b, int[] c, int[] d, int n) {
+    for (int i = 0; i < n; i++) {
+      a[i] = b[i + 1];
+      c[i] = d[i + 1];
+    }
+  }
+
+  public static void main(String[] args) {
+    int[] a = new int[100];
+    for (int i = 0; i < a.length; i++) {
+      a[i] = i;
+    }
+
+    unswitchAddSub(a, 3, true);
+    for (int i = 0; i < a.length; i++) {
+      expectEquals(i + 3, a[i]);
+    }
+    unswitchAddSub(a, 5, false);
+    for (int i = 0; i < a.length; i++) {
+      expectEquals(i - 2, a[i]);
+    }
+
+    for (int i = 0; i < a.length; i++) {
+      a[i] = i;
+    }
+    expectEquals(4950, unswitchReduction(a, false));
+    expectEquals(328350, unswitchReduction(a, true));
+
+    noUnswitchVariant(a, 50);
+    for (int i = 0; i < a.length; i++) {
+      expectEquals(i < 50 ? i + 50 : i - 50, a[i]);
+    }
+
+    int[] x = new int[100];
+    noUnswitchContinue(a, x, true);
+    for (int i = 0; i < x.length; i++) {
+      expectEquals(a[i] == 0 ? 0 : 1, x[i]);
+    }
+    noUnswitchContinue(a, x, false);
+    for (int i = 0; i < x.length; i++) {
+      expectEquals(a[i] == 0 ? 0 : 2, x[i]);
+    }
+
+    int[] b = new int[101];
+    int[] c = new int[100];
+    int[] d = new int[101];
+    for (int i = 0; i < b.length; i++) {
+      b[i] = i;
+      d[i] = -i;
+    }
+    twoCopies(a, b, c, d, 100);
+    for (int i = 0; i < a.length; i++) {
+      expectEquals(i + 1, a[i]);
+      expectEquals(-i - 1, c[i]);
+    }
+
+    // Aliased arrays must give the same result as the scalar loop.
+    for (int i = 0; i < b.length; i++) {
+      b[i] = i;
+    }
+    twoCopies(b, b, c, d, 100);
+    for (int i = 0; i < 100; i++) {
+      expectEquals(i + 1, b[i]);
+    }
+    expectEquals(100, b[100]);
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (hasJit()) {
+      testDeoptimizeMovedCode();
+    }
+    System.out.println("passed");
+  }
+
+  private static void testDeoptimizeMovedCode() {
+    int[] a = new int[10];
+    for (int i = 0; i < a.length; i++) {
+      a[i] = i;
+    }
+    // The baseline code of $noinline$filler is freed once the method is optimized, which leaves
+    // a free block below the code of $noinline$sum for the compaction to move it to.
+    ensureJitBaselineCompiled(Main.class, "$noinline$filler");
+    ensureJitCompiled(Main.class, "$noinline$sum");
+    ensureJitCompiled(Main.class, "$noinline$filler");
+    expectEquals(45, $noinline$sum(a, a.length, /*compact=*/ false));
+
+    // Compact the code cache while $noinline$sum runs, then deoptimize it from the old copy of
+    // its code.
+    try {
+      $noinline$sum(a, a.length + 1, /*compact=*/ true);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+
+    // The deoptimization must have stopped the method from using the new copy, which makes the
+    // same failing speculation.
+    int deoptimizations = numberOfDeoptimizations();
+    try {
+      $noinline$sum(a, a.length + 1, /*compact=*/ false);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    expectEquals(deoptimizations, numberOfDeoptimizations());
+  }
+
+  // Bounds check elimination hoists the bounds checks of the loop into a deoptimization test
+  // of `n` against the length of `a`.
+  private static int $noinline$sum(int[] a, int n, boolean compact) {
+    if (compact) {
+      compactJitCodeCache();
+    }
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  private static int $noinline$filler(int[] a, int x) {
+    int result = 0;
+    for (int i = 0; i < a.length; i++) {
+      switch (a[i] % 8) {
+        case 0: result += x * a[i]; break;
+        case 1: result -= x / (a[i] | 1); break;
+        case 2: result ^= x << (a[i] & 31); break;
+        case 3: result |= x >>> (a[i] & 31); break;
+        case 4: result += Integer.bitCount(x + a[i]); break;
+        case 5: result -= Long.numberOfTrailingZeros((long) x * a[i]); break;
+        case 6: result += (int) Math.sqrt(x + a[i]); break;
+        default: result = result * 31 + a[i]; break;
+      }
+    }
+    return result;
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native boolean compactJitCodeCache();
+  private static native int numberOfDeoptimizations();
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (hasJit()) {
+      if (args[1].equals("save")) {
+        // Recorded in the cache file when the runtime shuts down.
+        ensureJitCompiled(Main.class, "$noinline$compiled");
+      } else {
+        // Compiled from the cache file at startup, without ever being called in this run.
+        while (!hasJitCompiledEntrypoint(Main.class, "$noinline$compiled")) {
+          Thread.sleep(10);
+        }
+      }
+    }
+    System.out.println("passed");
+  }
+
+  // An instance method, as the static methods of a class are not compiled before the class is
+  // initialized.
+  public int $noinline$compiled(int x) {
+    return x * 31 + 7;
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native boolean hasJitCompiledEntrypoint(Class<?> cls, String methodName);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+import java.util.Arrays;
+
+public class Main {
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (hasJit()) {
+      Class<?> cls = Class.forName("BranchProfile");
+      testPolarity(cls);
+      testSaturation(cls);
+    }
+    System.out.println("passed");
+  }
+
+  // The not taken count comes first, and the taken count second.
+  private static void testPolarity(Class<?> cls) throws Exception {
+    Method isPositive = cls.getMethod("$noinline$isPositive", int.class);
+    ensureJitBaselineCompiled(cls, "$noinline$isPositive");
+    for (int i = 0; i < 1000; ++i) {
+      isPositive.invoke(null, (i % 10 < 3) ? i + 1 : -i);
+    }
+    int[] counts = getBranchCounts(cls, "$noinline$isPositive");
+    if (counts != null) {
+      expectEquals(new int[] { 700, 300 }, counts);
+    }
+  }
+
+  // The counts stop at 0xffff rather than wrap around.
+  private static void testSaturation(Class<?> cls) throws Exception {
+    Method countPositive = cls.getMethod("$noinline$countPositive", int[].class);
+    ensureJitBaselineCompiled(cls, "$noinline$countPositive");
+    int[] values = new int[70000];
+    Arrays.fill(values, 1);
+    // One call, so that the whole loop runs in the baseline code.
+    expectEquals(values.length, (Integer) countPositive.invoke(null, values));
+    int[] counts = getBranchCounts(cls, "$noinline$countPositive");
+    if (counts != null) {
+      expectEquals(new int[] { 0xffff, 1, 0xffff, 0 }, counts);
+    }
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(int[] expected, int[] result) {
+    if (!Arrays.equals(expected, result)) {
+      throw new Error("Expected: " + Arrays.toString(expected) + ", found: " +
+          Arrays.toString(result));
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native int[] getBranchCounts(Class<?> cls, String methodName);
+}
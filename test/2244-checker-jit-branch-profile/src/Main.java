@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (hasJit()) {
+      testBiasedSelect();
+      testUnpredictableSelect();
+      testNeverExecutedCall();
+      testExecutedCall();
+    }
+    System.out.println("passed");
+  }
+
+  // Run the baseline code of the method, which profiles its branches, then compile it
+  // optimized with the profile.
+  private static void testBiasedSelect() {
+    ensureJitBaselineCompiled(Main.class, "$noinline$biasedSelect");
+    for (int i = 0; i < kIterations; ++i) {
+      expectEquals(i + 2, $noinline$biasedSelect(i + 1));
+    }
+    ensureJitCompiled(Main.class, "$noinline$biasedSelect");
+    expectEquals(-2, $noinline$biasedSelect(-1));
+  }
+
+  private static void testUnpredictableSelect() {
+    ensureJitBaselineCompiled(Main.class, "$noinline$unpredictableSelect");
+    for (int i = 0; i < kIterations; ++i) {
+      $noinline$unpredictableSelect(i);
+    }
+    ensureJitCompiled(Main.class, "$noinline$unpredictableSelect");
+    expectEquals(21, $noinline$unpredictableSelect(0));
+    expectEquals(-44, $noinline$unpredictableSelect(1));
+  }
+
+  private static void testNeverExecutedCall() {
+    ensureJitBaselineCompiled(Main.class, "$noinline$neverExecutedCall");
+    for (int i = 0; i < kIterations; ++i) {
+      expectEquals(i, $noinline$neverExecutedCall(i));
+    }
+    ensureJitCompiled(Main.class, "$noinline$neverExecutedCall");
+    expectEquals(medium(kUnusedValue), $noinline$neverExecutedCall(kUnusedValue));
+  }
+
+  private static void testExecutedCall() {
+    ensureJitBaselineCompiled(Main.class, "$noinline$executedCall");
+    for (int i = 0; i < kIterations; ++i) {
+      expectEquals(medium(i), $noinline$executedCall(i));
+    }
+    ensureJitCompiled(Main.class, "$noinline$executedCall");
+    expectEquals(kUnusedValue, $noinline$executedCall(kUnusedValue));
+  }
+
+  // The profile shows the branch always goes the same way, so it is kept.
+
+  /// CHECK-START: int Main.$noinline$biasedSelect(int) select_generator (before)
+  /// CHECK:     If true_count:{{\d+}} false_count:{{\d+}}
+
+  /// CHECK-START: int Main.$noinline$biasedSelect(int) select_generator (after)
+  /// CHECK-NOT: Select
+  private static int $noinline$biasedSelect(int x) {
+    return (x > 0) ? x + 1 : x - 1;
+  }
+
+  // The profile shows each branch is taken half of the time, so both sides are computed even
+  // though they have more than one instruction.
+
+  /// CHECK-START: int Main.$noinline$unpredictableSelect(int) select_generator (after)
+  /// CHECK:     Select
+  private static int $noinline$unpredictableSelect(int x) {
+    return ((x & 1) == 0) ? (x + 3) * 7 : (x - 5) * 11;
+  }
+
+  // The profile shows the call is never executed, so a method larger than the call is not
+  // inlined there.
+
+  /// CHECK-START: int Main.$noinline$neverExecutedCall(int) inliner (after)
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.medium
+  private static int $noinline$neverExecutedCall(int x) {
+    if (x == kUnusedValue) {
+      return medium(x);
+    }
+    return x;
+  }
+
+  // The same call on the path which the profile shows is always executed is inlined. This also
+  // checks the branch counts are not swapped.
+
+  /// CHECK-START: int Main.$noinline$executedCall(int) inliner (after)
+  /// CHECK-NOT: InvokeStaticOrDirect method_name:Main.medium
+  private static int $noinline$executedCall(int x) {
+    if (x != kUnusedValue) {
+      return medium(x);
+    }
+    return x;
+  }
+
+  private static int medium(int x) {
+    return ((x * 7 + 3) ^ (x >>> 5)) - x / 9;
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  // Enough runs for the profiles to be used, not enough for the baseline code to trigger an
+  // optimized compilation by itself.
+  private static final int kIterations = 1000;
+  private static final int kUnusedValue = 123456;
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+}
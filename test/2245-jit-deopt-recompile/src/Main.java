@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+abstract class Base {
+  abstract int get();
+}
+
+class A extends Base {
+  int get() { return 1; }
+}
+
+class B extends Base {
+  int get() { return 2; }
+}
+
+class C extends Base {
+  int get() { return 3; }
+}
+
+public class Main {
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (hasJit()) {
+      testBoundsCheckElimination();
+      testInlineCache();
+    }
+    System.out.println("passed");
+  }
+
+  private static void testBoundsCheckElimination() {
+    int[] a = new int[10];
+    for (int i = 0; i < a.length; i++) {
+      a[i] = i;
+    }
+    ensureJitCompiled(Main.class, "$noinline$sum");
+    expectEquals(45, $noinline$sum(a, a.length));
+
+    // The hoisted bounds check fails and the method deoptimizes.
+    int deoptimizations = numberOfDeoptimizations();
+    try {
+      $noinline$sum(a, a.length + 1);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    expectEquals(deoptimizations + 1, numberOfDeoptimizations());
+
+    // The recompiled code keeps the bounds checks in the loop and throws without deoptimizing.
+    ensureJitCompiled(Main.class, "$noinline$sum");
+    try {
+      $noinline$sum(a, a.length + 1);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    expectEquals(deoptimizations + 1, numberOfDeoptimizations());
+    expectTrue(hasJitCompiledEntrypoint(Main.class, "$noinline$sum"));
+  }
+
+  private static void testInlineCache() {
+    // Only let the inline cache of the call site see `A`, so that the optimized code inlines
+    // `A.get()` behind a type guard.
+    ensureJitBaselineCompiled(Main.class, "$noinline$get");
+    Base a = new A();
+    for (int i = 0; i < 100; i++) {
+      expectEquals(1, $noinline$get(a));
+    }
+    ensureJitCompiled(Main.class, "$noinline$get");
+    expectEquals(1, $noinline$get(a));
+
+    // The type guard fails and the method deoptimizes.
+    int deoptimizations = numberOfDeoptimizations();
+    expectEquals(2, $noinline$get(new B()));
+    expectEquals(deoptimizations + 1, numberOfDeoptimizations());
+
+    // The recompiled code keeps the virtual call for receivers the inline cache did not see.
+    ensureJitCompiled(Main.class, "$noinline$get");
+    expectEquals(3, $noinline$get(new C()));
+    expectEquals(deoptimizations + 1, numberOfDeoptimizations());
+    expectTrue(hasJitCompiledEntrypoint(Main.class, "$noinline$get"));
+  }
+
+  // Bounds check elimination hoists the bounds checks of the loop into a deoptimization test
+  // of `n` against the length of `a`.
+  private static int $noinline$sum(int[] a, int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  private static int $noinline$get(Base b) {
+    return b.get();
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectTrue(boolean value) {
+    if (!value) {
+      throw new Error("Expected true");
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native boolean hasJitCompiledEntrypoint(Class<?> cls, String methodName);
+  private static native int numberOfDeoptimizations();
+}
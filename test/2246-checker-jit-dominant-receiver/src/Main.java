@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+abstract class Super {
+  abstract int getValue();
+}
+
+class SubA extends Super {
+  int getValue() { return 42; }
+}
+
+class SubB extends Super {
+  int getValue() { return 38; }
+}
+
+class SubC extends Super {
+  int getValue() { return 24; }
+}
+
+class SubD extends Super {
+  int getValue() { return 10; }
+}
+
+class SubE extends Super {
+  int getValue() { return -4; }
+}
+
+class SubF extends Super {
+  int getValue() { return 7; }
+}
+
+public class Main {
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (hasJit()) {
+      testDominantReceiver();
+      testBalancedReceivers();
+      testDominantMegamorphicReceiver();
+    }
+    System.out.println("passed");
+  }
+
+  // Run the baseline code of the method, which counts the receiver types of the call, then
+  // compile it optimized with the inline cache.
+  private static void testDominantReceiver() {
+    ensureJitBaselineCompiled(Main.class, "$noinline$dominantReceiver");
+    Super a = new SubA();
+    Super b = new SubB();
+    for (int i = 0; i < kIterations; ++i) {
+      expectEquals(42, $noinline$dominantReceiver(a));
+      if (i % 20 == 0) {
+        expectEquals(38, $noinline$dominantReceiver(b));
+      }
+    }
+    ensureJitCompiled(Main.class, "$noinline$dominantReceiver");
+    expectEquals(42, $noinline$dominantReceiver(a));
+    expectEquals(38, $noinline$dominantReceiver(b));
+    expectEquals(24, $noinline$dominantReceiver(new SubC()));
+  }
+
+  private static void testBalancedReceivers() {
+    ensureJitBaselineCompiled(Main.class, "$noinline$balancedReceivers");
+    Super a = new SubA();
+    Super b = new SubB();
+    for (int i = 0; i < kIterations; ++i) {
+      expectEquals(42, $noinline$balancedReceivers(a));
+      expectEquals(38, $noinline$balancedReceivers(b));
+    }
+    ensureJitCompiled(Main.class, "$noinline$balancedReceivers");
+    expectEquals(42, $noinline$balancedReceivers(a));
+    expectEquals(38, $noinline$balancedReceivers(b));
+  }
+
+  private static void testDominantMegamorphicReceiver() {
+    ensureJitBaselineCompiled(Main.class, "$noinline$dominantMegamorphicReceiver");
+    Super a = new SubA();
+    Super[] others = { new SubB(), new SubC(), new SubD(), new SubE(), new SubF() };
+    for (int i = 0; i < kIterations; ++i) {
+      expectEquals(42, $noinline$dominantMegamorphicReceiver(a));
+      if (i % 100 == 0) {
+        for (Super other : others) {
+          expectEquals(other.getValue(), $noinline$dominantMegamorphicReceiver(other));
+        }
+      }
+    }
+    ensureJitCompiled(Main.class, "$noinline$dominantMegamorphicReceiver");
+    expectEquals(42, $noinline$dominantMegamorphicReceiver(a));
+    for (Super other : others) {
+      expectEquals(other.getValue(), $noinline$dominantMegamorphicReceiver(other));
+    }
+  }
+
+  // SubA is 95% of the receivers: only SubA is inlined and the virtual call is kept for the
+  // other types, without deoptimizing.
+
+  /// CHECK-START: int Main.$noinline$dominantReceiver(Super) inliner (after)
+  /// CHECK-DAG:  <<SubARet:i\d+>>      IntConstant 42
+  /// CHECK-DAG:  <<Obj:l\d+>>          NullCheck
+  /// CHECK-DAG:  <<ObjClass:l\d+>>     InstanceFieldGet [<<Obj>>] field_name:java.lang.Object.shadow$_klass_
+  /// CHECK-DAG:  <<InlineClass:l\d+>>  LoadClass class_name:SubA
+  /// CHECK-DAG:  <<Test:z\d+>>         NotEqual [<<InlineClass>>,<<ObjClass>>]
+  /// CHECK-DAG:                        If [<<Test>>]
+  /// CHECK-DAG:  <<DefaultRet:i\d+>>   InvokeVirtual [<<Obj>>] method_name:Super.getValue
+  /// CHECK-DAG:  <<Ret:i\d+>>          Phi [<<SubARet>>,<<DefaultRet>>]
+  /// CHECK-DAG:                        Return [<<Ret>>]
+
+  /// CHECK-START: int Main.$noinline$dominantReceiver(Super) inliner (after)
+  /// CHECK-NOT:                        LoadClass class_name:SubB
+
+  /// CHECK-START: int Main.$noinline$dominantReceiver(Super) inliner (after)
+  /// CHECK-NOT:                        Deoptimize
+  private static int $noinline$dominantReceiver(Super s) {
+    return s.getValue();
+  }
+
+  // No receiver type dominates: both are inlined, as without counts.
+
+  /// CHECK-START: int Main.$noinline$balancedReceivers(Super) inliner (after)
+  /// CHECK-DAG:                        LoadClass class_name:SubA
+  /// CHECK-DAG:                        LoadClass class_name:SubB
+  /// CHECK-DAG:                        Deoptimize
+  private static int $noinline$balancedReceivers(Super s) {
+    return s.getValue();
+  }
+
+  // Six receiver types do not fit in the inline cache, but SubA is still 95% of the receivers
+  // and is inlined.
+
+  /// CHECK-START: int Main.$noinline$dominantMegamorphicReceiver(Super) inliner (after)
+  /// CHECK-DAG:  <<Obj:l\d+>>          NullCheck
+  /// CHECK-DAG:  <<ObjClass:l\d+>>     InstanceFieldGet [<<Obj>>] field_name:java.lang.Object.shadow$_klass_
+  /// CHECK-DAG:  <<InlineClass:l\d+>>  LoadClass class_name:SubA
+  /// CHECK-DAG:  <<Test:z\d+>>         NotEqual [<<InlineClass>>,<<ObjClass>>]
+  /// CHECK-DAG:                        InvokeVirtual [<<Obj>>] method_name:Super.getValue
+
+  /// CHECK-START: int Main.$noinline$dominantMegamorphicReceiver(Super) inliner (after)
+  /// CHECK-NOT:                        Deoptimize
+  private static int $noinline$dominantMegamorphicReceiver(Super s) {
+    return s.getValue();
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  // Enough runs for the inline caches to be counted, not enough for the baseline code to
+  // trigger an optimized compilation by itself.
+  private static final int kIterations = 1000;
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+}
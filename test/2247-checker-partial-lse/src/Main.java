@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Point {
+  int x;
+}
+
+public class Main {
+  static Point sEscaped;
+
+  public static void main(String[] args) {
+    expectEquals(0, $noinline$materializeOnEscape(5, true));
+    expectTrue(sEscaped != null);
+    expectEquals(105, sEscaped.x);
+    sEscaped = null;
+    expectEquals(5, $noinline$materializeOnEscape(5, false));
+    expectTrue(sEscaped == null);
+
+    expectEquals(107, $noinline$predicatedGet(7, true));
+    expectEquals(3, $noinline$predicatedGet(7, false));
+    System.out.println("passed");
+  }
+
+  // The allocation only escapes on one branch: it is materialized there, with its store, and
+  // the store and the read on the other branch are removed.
+
+  /// CHECK-START: int Main.$noinline$materializeOnEscape(int, boolean) load_store_elimination (before)
+  /// CHECK:                            NewInstance
+  /// CHECK:                            InstanceFieldSet
+  /// CHECK:                            If
+  /// CHECK:                            InvokeStaticOrDirect method_name:Main.$noinline$escape
+  /// CHECK:                            InstanceFieldGet
+
+  /// CHECK-START: int Main.$noinline$materializeOnEscape(int, boolean) load_store_elimination (after)
+  /// CHECK-DAG:  <<Arg:i\d+>>          ParameterValue
+  /// CHECK-DAG:                        If
+  /// CHECK-DAG:  <<New:l\d+>>          NewInstance
+  /// CHECK-DAG:                        InstanceFieldSet [<<New>>,<<Arg>>]
+  /// CHECK-DAG:                        InvokeStaticOrDirect method_name:Main.$noinline$escape
+  /// CHECK-DAG:                        Return [<<Arg>>]
+
+  /// CHECK-START: int Main.$noinline$materializeOnEscape(int, boolean) load_store_elimination (after)
+  /// CHECK:                            If
+  /// CHECK:                            NewInstance
+
+  /// CHECK-START: int Main.$noinline$materializeOnEscape(int, boolean) load_store_elimination (after)
+  /// CHECK:                            InstanceFieldSet
+  /// CHECK-NOT:                        InstanceFieldSet
+
+  /// CHECK-START: int Main.$noinline$materializeOnEscape(int, boolean) load_store_elimination (after)
+  /// CHECK-NOT:                        InstanceFieldGet
+  private static int $noinline$materializeOnEscape(int value, boolean escape) {
+    Point p = new Point();
+    p.x = value;
+    if (escape) {
+      $noinline$escape(p);
+      return 0;
+    }
+    return p.x;
+  }
+
+  // The read after the merge sees the escaped object on one predecessor and a known value on
+  // the other: it becomes a predicated read, which only loads when the object was materialized.
+
+  /// CHECK-START: int Main.$noinline$predicatedGet(int, boolean) load_store_elimination (before)
+  /// CHECK-NOT:                        PredicatedInstanceFieldGet
+
+  /// CHECK-START: int Main.$noinline$predicatedGet(int, boolean) load_store_elimination (after)
+  /// CHECK-DAG:  <<Null:l\d+>>         NullConstant
+  /// CHECK-DAG:  <<New:l\d+>>          NewInstance
+  /// CHECK-DAG:  <<Obj:l\d+>>          Phi [<<New>>,<<Null>>]
+  /// CHECK-DAG:  <<Get:i\d+>>          PredicatedInstanceFieldGet [<<Obj>>,{{i\d+}}] field_name:Point.x
+  /// CHECK-DAG:                        Return [<<Get>>]
+
+  /// CHECK-START: int Main.$noinline$predicatedGet(int, boolean) load_store_elimination (after)
+  /// CHECK-NOT:                        InstanceFieldGet
+  private static int $noinline$predicatedGet(int value, boolean escape) {
+    Point p = new Point();
+    p.x = value;
+    if (escape) {
+      $noinline$escape(p);
+    } else {
+      p.x = 3;
+    }
+    return p.x;
+  }
+
+  private static void $noinline$escape(Point p) {
+    sEscaped = p;
+    p.x += 100;
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectTrue(boolean value) {
+    if (!value) {
+      throw new Error("Expected true");
+    }
+  }
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static Integer sBoxed;
+
+  public static void main(String[] args) {
+    expectEquals(42, $noinline$unboxValueOf(42));
+    expectEquals(-1000000, $noinline$unboxValueOf(-1000000));
+
+    expectEquals(7, $noinline$unboxEscapingValueOf(7));
+    expectEquals(7, sBoxed.intValue());
+    expectEquals(100000, $noinline$unboxEscapingValueOf(100000));
+    expectEquals(100000, sBoxed.intValue());
+
+    expectEquals(3, $noinline$unboxParameter(Integer.valueOf(3)));
+    try {
+      $noinline$unboxParameter(null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+
+    expectEquals(1L << 40, $noinline$unboxLongValueOf(1L << 40));
+    System.out.println("passed");
+  }
+
+  // The read of `Integer.value` from the result of `Integer.valueOf` is the argument of
+  // `valueOf`. The box is then unused and removed.
+
+  /// CHECK-START: int Main.$noinline$unboxValueOf(int) instruction_simplifier$after_inlining (before)
+  /// CHECK-DAG:     <<Arg:i\d+>>    ParameterValue
+  /// CHECK-DAG:     <<Box:l\d+>>    InvokeStaticOrDirect [<<Arg>>{{(,[ij]\d+)?}}] method_name:java.lang.Integer.valueOf intrinsic:IntegerValueOf
+  /// CHECK-DAG:     <<Get:i\d+>>    InstanceFieldGet [<<Box>>] field_name:java.lang.Integer.value
+  /// CHECK-DAG:                     Return [<<Get>>]
+
+  /// CHECK-START: int Main.$noinline$unboxValueOf(int) instruction_simplifier$after_inlining (after)
+  /// CHECK-DAG:     <<Arg:i\d+>>    ParameterValue
+  /// CHECK-DAG:                     Return [<<Arg>>]
+
+  /// CHECK-START: int Main.$noinline$unboxValueOf(int) instruction_simplifier$after_inlining (after)
+  /// CHECK-NOT:                     InstanceFieldGet
+
+  /// CHECK-START: int Main.$noinline$unboxValueOf(int) instruction_simplifier$after_inlining (after)
+  /// CHECK-NOT:                     NullCheck
+
+  /// CHECK-START: int Main.$noinline$unboxValueOf(int) dead_code_elimination$after_inlining (after)
+  /// CHECK-NOT:                     InvokeStaticOrDirect
+  private static int $noinline$unboxValueOf(int value) {
+    Integer boxed = Integer.valueOf(value);
+    return boxed.intValue();
+  }
+
+  // The box escapes and is kept, but the read is still folded.
+
+  /// CHECK-START: int Main.$noinline$unboxEscapingValueOf(int) instruction_simplifier$after_inlining (after)
+  /// CHECK-DAG:     <<Arg:i\d+>>    ParameterValue
+  /// CHECK-DAG:     <<Box:l\d+>>    InvokeStaticOrDirect [<<Arg>>{{(,[ij]\d+)?}}] method_name:java.lang.Integer.valueOf intrinsic:IntegerValueOf
+  /// CHECK-DAG:                     StaticFieldSet [{{l\d+}},<<Box>>] field_name:Main.sBoxed
+  /// CHECK-DAG:                     Return [<<Arg>>]
+
+  /// CHECK-START: int Main.$noinline$unboxEscapingValueOf(int) instruction_simplifier$after_inlining (after)
+  /// CHECK-NOT:                     InstanceFieldGet
+  private static int $noinline$unboxEscapingValueOf(int value) {
+    Integer boxed = Integer.valueOf(value);
+    sBoxed = boxed;
+    return boxed.intValue();
+  }
+
+  // The box does not come from `Integer.valueOf`: the read and its null check stay.
+
+  /// CHECK-START: int Main.$noinline$unboxParameter(java.lang.Integer) instruction_simplifier$after_inlining (after)
+  /// CHECK-DAG:     <<Param:l\d+>>  ParameterValue
+  /// CHECK-DAG:     <<Check:l\d+>>  NullCheck [<<Param>>]
+  /// CHECK-DAG:     <<Get:i\d+>>    InstanceFieldGet [<<Check>>] field_name:java.lang.Integer.value
+  /// CHECK-DAG:                     Return [<<Get>>]
+  private static int $noinline$unboxParameter(Integer boxed) {
+    return boxed.intValue();
+  }
+
+  // Only `Integer.valueOf` is folded.
+
+  /// CHECK-START: long Main.$noinline$unboxLongValueOf(long) instruction_simplifier$after_inlining (after)
+  /// CHECK-DAG:     <<Get:j\d+>>    InstanceFieldGet field_name:java.lang.Long.value
+  /// CHECK-DAG:                     Return [<<Get>>]
+  private static long $noinline$unboxLongValueOf(long value) {
+    Long boxed = Long.valueOf(value);
+    return boxed.longValue();
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -55,6 +55,27 @@ public class Main {
   /// CHECK:    <<res1:i\d+>>         Add [<<res0>>,<<ArrayGet1>>]
   /// CHECK:                          Add [<<res1>>,<<ArrayGet2>>]
 
+  /// CHECK-START-X86_64: int Main.arrayAccess() scheduler (before)
+  /// CHECK:    <<Const1:i\d+>>       IntConstant 1
+  /// CHECK:    <<Array:l\d+>>        NewArray
+  /// CHECK:    <<res0:i\d+>>         Phi
+  /// CHECK:    <<i0:i\d+>>           Phi
+  /// CHECK:    <<ArrayGet1:i\d+>>    ArrayGet [<<Array>>,<<i0>>]
+  /// CHECK:    <<res1:i\d+>>         Add [<<res0>>,<<ArrayGet1>>]
+  /// CHECK:    <<i1:i\d+>>           Add [<<i0>>,<<Const1>>]
+  /// CHECK:    <<ArrayGet2:i\d+>>    ArrayGet [<<Array>>,<<i1>>]
+  /// CHECK:                          Add [<<res1>>,<<ArrayGet2>>]
+
+  /// CHECK-START-X86_64: int Main.arrayAccess() scheduler (after)
+  /// CHECK:    <<Const1:i\d+>>       IntConstant 1
+  /// CHECK:    <<Array:l\d+>>        NewArray
+  /// CHECK:    <<res0:i\d+>>         Phi
+  /// CHECK:    <<i0:i\d+>>           Phi
+  /// CHECK:    <<ArrayGet1:i\d+>>    ArrayGet [<<Array>>,<<i0>>]
+  /// CHECK:    <<i1:i\d+>>           Add [<<i0>>,<<Const1>>]
+  /// CHECK:    <<ArrayGet2:i\d+>>    ArrayGet [<<Array>>,<<i1>>]
+  /// CHECK:    <<res1:i\d+>>         Add [<<res0>>,<<ArrayGet1>>]
+  /// CHECK:                          Add [<<res1>>,<<ArrayGet2>>]
   public static int arrayAccess() {
     int res = 0;
     int [] array = new int[10];
@@ -140,6 +161,44 @@ public class Main {
   /// CHECK:                           ArraySet
   /// CHECK:                           ArraySet
   /// CHECK:                           ArraySet
+
+  /// CHECK-START-X86_64: void Main.arrayAccessVariable(int) scheduler (before)
+  /// CHECK:     <<Param:i\d+>>        ParameterValue
+  /// CHECK-DAG: <<Const1:i\d+>>       IntConstant 1
+  /// CHECK-DAG: <<Const2:i\d+>>       IntConstant 2
+  /// CHECK-DAG: <<Const3:i\d+>>       IntConstant -1
+  /// CHECK:     <<Array:l\d+>>        NewArray
+  /// CHECK:     <<Add1:i\d+>>         Add [<<Param>>,<<Const1>>]
+  /// CHECK:     <<Add2:i\d+>>         Add [<<Param>>,<<Const2>>]
+  /// CHECK:     <<Add3:i\d+>>         Add [<<Param>>,<<Const3>>]
+  /// CHECK:     <<ArrayGet1:i\d+>>    ArrayGet [<<Array>>,<<Add1>>]
+  /// CHECK:     <<AddArray1:i\d+>>    Add [<<ArrayGet1>>,<<Const1>>]
+  /// CHECK:     <<ArraySet1:v\d+>>    ArraySet [<<Array>>,<<Add1>>,<<AddArray1>>]
+  /// CHECK:     <<ArrayGet2:i\d+>>    ArrayGet [<<Array>>,<<Add2>>]
+  /// CHECK:     <<AddArray2:i\d+>>    Add [<<ArrayGet2>>,<<Const1>>]
+  /// CHECK:     <<ArraySet2:v\d+>>    ArraySet [<<Array>>,<<Add2>>,<<AddArray2>>]
+  /// CHECK:     <<ArrayGet3:i\d+>>    ArrayGet [<<Array>>,<<Add3>>]
+  /// CHECK:     <<AddArray3:i\d+>>    Add [<<ArrayGet3>>,<<Const1>>]
+  /// CHECK:     <<ArraySet3:v\d+>>    ArraySet [<<Array>>,<<Add3>>,<<AddArray3>>]
+
+  /// CHECK-START-X86_64: void Main.arrayAccessVariable(int) scheduler (after)
+  /// CHECK:     <<Param:i\d+>>        ParameterValue
+  /// CHECK-DAG: <<Const1:i\d+>>       IntConstant 1
+  /// CHECK-DAG: <<Const2:i\d+>>       IntConstant 2
+  /// CHECK-DAG: <<Const3:i\d+>>       IntConstant -1
+  /// CHECK:     <<Array:l\d+>>        NewArray
+  /// CHECK:     <<Add1:i\d+>>         Add [<<Param>>,<<Const1>>]
+  /// CHECK:     <<Add2:i\d+>>         Add [<<Param>>,<<Const2>>]
+  /// CHECK:     <<Add3:i\d+>>         Add [<<Param>>,<<Const3>>]
+  /// CHECK:                           ArrayGet [<<Array>>,{{i\d+}}]
+  /// CHECK:                           ArrayGet [<<Array>>,{{i\d+}}]
+  /// CHECK:                           ArrayGet [<<Array>>,{{i\d+}}]
+  /// CHECK:                           Add
+  /// CHECK:                           Add
+  /// CHECK:                           Add
+  /// CHECK:                           ArraySet
+  /// CHECK:                           ArraySet
+  /// CHECK:                           ArraySet
   public static void arrayAccessVariable(int i) {
     int [] array = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
     for (int j = 0; j < 100; j++) {
@@ -208,6 +267,36 @@ public class Main {
   /// CHECK:      <<ArrayGet2:i\d+>>    ArrayGet [<<Array>>,<<Sub2>>]
   /// CHECK:      <<AddArray2:i\d+>>    Add [<<ArrayGet2>>,<<Const3>>]
   /// CHECK:      <<ArraySet2:v\d+>>    ArraySet [<<Array>>,<<Sub2>>,<<AddArray2>>]
+
+  /// CHECK-START-X86_64: void Main.arrayAccessSub(int) scheduler (before)
+  /// CHECK:      <<Param:i\d+>>        ParameterValue
+  /// CHECK-DAG:  <<Const1:i\d+>>       IntConstant -1
+  /// CHECK-DAG:  <<Const2:i\d+>>       IntConstant 9
+  /// CHECK-DAG:  <<Const3:i\d+>>       IntConstant 1
+  /// CHECK:      <<Array:l\d+>>        NewArray
+  /// CHECK:      <<Add1:i\d+>>         Add [<<Param>>,<<Const1>>]
+  /// CHECK:      <<Sub2:i\d+>>         Sub [<<Const2>>,<<Param>>]
+  /// CHECK:      <<ArrayGet1:i\d+>>    ArrayGet [<<Array>>,<<Add1>>]
+  /// CHECK:      <<AddArray1:i\d+>>    Add [<<ArrayGet1>>,<<Const3>>]
+  /// CHECK:      <<ArraySet1:v\d+>>    ArraySet [<<Array>>,<<Add1>>,<<AddArray1>>]
+  /// CHECK:      <<ArrayGet2:i\d+>>    ArrayGet [<<Array>>,<<Sub2>>]
+  /// CHECK:      <<AddArray2:i\d+>>    Add [<<ArrayGet2>>,<<Const3>>]
+  /// CHECK:      <<ArraySet2:v\d+>>    ArraySet [<<Array>>,<<Sub2>>,<<AddArray2>>]
+
+  /// CHECK-START-X86_64: void Main.arrayAccessSub(int) scheduler (after)
+  /// CHECK:      <<Param:i\d+>>        ParameterValue
+  /// CHECK-DAG:  <<Const1:i\d+>>       IntConstant -1
+  /// CHECK-DAG:  <<Const2:i\d+>>       IntConstant 9
+  /// CHECK-DAG:  <<Const3:i\d+>>       IntConstant 1
+  /// CHECK:      <<Array:l\d+>>        NewArray
+  /// CHECK:      <<Add1:i\d+>>         Add [<<Param>>,<<Const1>>]
+  /// CHECK:      <<Sub2:i\d+>>         Sub [<<Const2>>,<<Param>>]
+  /// CHECK:      <<ArrayGet1:i\d+>>    ArrayGet [<<Array>>,<<Add1>>]
+  /// CHECK:      <<AddArray1:i\d+>>    Add [<<ArrayGet1>>,<<Const3>>]
+  /// CHECK:      <<ArraySet1:v\d+>>    ArraySet [<<Array>>,<<Add1>>,<<AddArray1>>]
+  /// CHECK:      <<ArrayGet2:i\d+>>    ArrayGet [<<Array>>,<<Sub2>>]
+  /// CHECK:      <<AddArray2:i\d+>>    Add [<<ArrayGet2>>,<<Const3>>]
+  /// CHECK:      <<ArraySet2:v\d+>>    ArraySet [<<Array>>,<<Sub2>>,<<AddArray2>>]
   public static void arrayAccessSub(int i) {
     int [] array = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
     for (int j = 0; j < 100; j++) {
@@ -268,6 +357,30 @@ public class Main {
   /// CHECK:     <<AddArray2:i\d+>>    Add
   /// CHECK:     <<ArraySet1:v\d+>>    ArraySet
   /// CHECK:     <<ArraySet2:v\d+>>    ArraySet
+
+  /// CHECK-START-X86_64: void Main.arrayAccessLoopVariable() scheduler (before)
+  /// CHECK-DAG: <<Const0:i\d+>>       IntConstant 0
+  /// CHECK-DAG: <<Const1:i\d+>>       IntConstant 1
+  /// CHECK:     <<Phi:i\d+>>          Phi
+  /// CHECK:     <<ArrayGet1:i\d+>>    ArrayGet
+  /// CHECK:     <<AddArray1:i\d+>>    Add
+  /// CHECK:     <<ArraySet1:v\d+>>    ArraySet
+  /// CHECK:     <<AddVar:i\d+>>       Add
+  /// CHECK:     <<ArrayGet2:i\d+>>    ArrayGet
+  /// CHECK:     <<AddArray2:i\d+>>    Add
+  /// CHECK:     <<ArraySet2:v\d+>>    ArraySet
+
+  /// CHECK-START-X86_64: void Main.arrayAccessLoopVariable() scheduler (after)
+  /// CHECK-DAG: <<Const0:i\d+>>       IntConstant 0
+  /// CHECK-DAG: <<Const1:i\d+>>       IntConstant 1
+  /// CHECK:     <<Phi:i\d+>>          Phi
+  /// CHECK:     <<AddVar:i\d+>>       Add
+  /// CHECK:     <<ArrayGet1:i\d+>>    ArrayGet
+  /// CHECK:     <<ArrayGet2:i\d+>>    ArrayGet
+  /// CHECK:     <<AddArray1:i\d+>>    Add
+  /// CHECK:     <<AddArray2:i\d+>>    Add
+  /// CHECK:     <<ArraySet1:v\d+>>    ArraySet
+  /// CHECK:     <<ArraySet2:v\d+>>    ArraySet
   public static void arrayAccessLoopVariable() {
     int [] array = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
     for (int j = 0; j < 9; j++) {
@@ -309,6 +422,34 @@ public class Main {
   /// CHECK:                           Add                                      loop:<<Loop>>      outer_loop:none
   /// CHECK:     <<ArraySet2:v\d+>>    ArraySet [<<Addr1>>,{{i\d+}},{{i\d+}}]   loop:<<Loop>>      outer_loop:none
   /// CHECK:                           Add                                      loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START-X86_64: void Main.CrossOverLoop(int[], int[]) scheduler (before)
+  /// CHECK:     <<ParamA:l\d+>>       ParameterValue                           loop:none
+  /// CHECK:     <<ParamB:l\d+>>       ParameterValue                           loop:none
+  /// CHECK:     <<NullB:l\d+>>        NullCheck [<<ParamB>>]                   loop:none
+  /// CHECK:     <<NullA:l\d+>>        NullCheck [<<ParamA>>]                   loop:none
+  /// CHECK:                           Phi                                      loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK:     <<ArrayGet1:i\d+>>    ArrayGet [<<NullB>>,{{i\d+}}]            loop:<<Loop>>      outer_loop:none
+  /// CHECK:                           Add [<<ArrayGet1>>,{{i\d+}}]             loop:<<Loop>>      outer_loop:none
+  /// CHECK:     <<ArraySet1:v\d+>>    ArraySet [<<NullA>>,{{i\d+}},{{i\d+}}]  loop:<<Loop>>      outer_loop:none
+  /// CHECK:     <<ArrayGet2:i\d+>>    ArrayGet [<<NullB>>,{{i\d+}}]            loop:<<Loop>>      outer_loop:none
+  /// CHECK:                           Add                                      loop:<<Loop>>      outer_loop:none
+  /// CHECK:     <<ArraySet2:v\d+>>    ArraySet [<<NullA>>,{{i\d+}},{{i\d+}}]  loop:<<Loop>>      outer_loop:none
+  /// CHECK:                           Add                                      loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START-X86_64: void Main.CrossOverLoop(int[], int[]) scheduler (after)
+  /// CHECK:     <<ParamA:l\d+>>       ParameterValue                           loop:none
+  /// CHECK:     <<ParamB:l\d+>>       ParameterValue                           loop:none
+  /// CHECK:     <<NullB:l\d+>>        NullCheck [<<ParamB>>]                   loop:none
+  /// CHECK:     <<NullA:l\d+>>        NullCheck [<<ParamA>>]                   loop:none
+  /// CHECK:                           Phi                                      loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK:     <<ArrayGet1:i\d+>>    ArrayGet [<<NullB>>,{{i\d+}}]            loop:<<Loop>>      outer_loop:none
+  /// CHECK:                           Add [<<ArrayGet1>>,{{i\d+}}]             loop:<<Loop>>      outer_loop:none
+  /// CHECK:     <<ArraySet1:v\d+>>    ArraySet [<<NullA>>,{{i\d+}},{{i\d+}}]  loop:<<Loop>>      outer_loop:none
+  /// CHECK:     <<ArrayGet2:i\d+>>    ArrayGet [<<NullB>>,{{i\d+}}]            loop:<<Loop>>      outer_loop:none
+  /// CHECK:                           Add                                      loop:<<Loop>>      outer_loop:none
+  /// CHECK:     <<ArraySet2:v\d+>>    ArraySet [<<NullA>>,{{i\d+}},{{i\d+}}]  loop:<<Loop>>      outer_loop:none
+  /// CHECK:                           Add                                      loop:<<Loop>>      outer_loop:none
   private static void CrossOverLoop(int a[], int b[]) {
     b[20] = 99;
     for (int i = 0; i < a.length; i++) {
@@ -325,7 +466,7 @@ public class Main {
   // After using LSA to analyze the original references, the scheduler should be able
   // to find out that 'a' and 'b' may alias, hence unable to schedule these ArraGet/Set.
 
-  /// CHECK-START-ARM64: void Main.CrossOverLoop2(java.lang.Object, java.lang.Object) scheduler (before)
+  /// CHECK-START-{ARM64,X86_64}: void Main.CrossOverLoop2(java.lang.Object, java.lang.Object) scheduler (before)
   /// CHECK:  Phi        loop:<<Loop:B\d+>> outer_loop:none
   /// CHECK:  ArrayGet   loop:<<Loop>>      outer_loop:none
   /// CHECK:  Add        loop:<<Loop>>      outer_loop:none
@@ -334,7 +475,7 @@ public class Main {
   /// CHECK:  Add        loop:<<Loop>>      outer_loop:none
   /// CHECK:  ArraySet   loop:<<Loop>>      outer_loop:none
 
-  /// CHECK-START-ARM64: void Main.CrossOverLoop2(java.lang.Object, java.lang.Object) scheduler (after)
+  /// CHECK-START-{ARM64,X86_64}: void Main.CrossOverLoop2(java.lang.Object, java.lang.Object) scheduler (after)
   /// CHECK:  Phi        loop:<<Loop:B\d+>> outer_loop:none
   /// CHECK:  ArrayGet   loop:<<Loop>>      outer_loop:none
   /// CHECK:  Add        loop:<<Loop>>      outer_loop:none
@@ -380,6 +521,7 @@ public class Main {
   /// CHECK-DAG:        StaticFieldSet
 
   /// CHECK-START-ARM64: void Main.accessFields() scheduler (before)
+  /// CHECK-START-X86_64: void Main.accessFields() scheduler (before)
   /// CHECK:            InstanceFieldGet
   /// CHECK:            Add
   /// CHECK:            InstanceFieldSet
@@ -394,6 +536,7 @@ public class Main {
   /// CHECK:            StaticFieldSet
 
   /// CHECK-START-ARM64: void Main.accessFields() scheduler (after)
+  /// CHECK-START-X86_64: void Main.accessFields() scheduler (after)
   /// CHECK-DAG:        InstanceFieldGet
   /// CHECK-DAG:        InstanceFieldGet
   /// CHECK-DAG:        StaticFieldGet
@@ -419,6 +562,7 @@ public class Main {
 
   /// CHECK-START-ARM: void Main.accessFieldsVolatile() scheduler (before)
   /// CHECK-START-ARM64: void Main.accessFieldsVolatile() scheduler (before)
+  /// CHECK-START-X86_64: void Main.accessFieldsVolatile() scheduler (before)
   /// CHECK:            InstanceFieldGet
   /// CHECK:            Add
   /// CHECK:            InstanceFieldSet
@@ -434,6 +578,7 @@ public class Main {
 
   /// CHECK-START-ARM: void Main.accessFieldsVolatile() scheduler (after)
   /// CHECK-START-ARM64: void Main.accessFieldsVolatile() scheduler (after)
+  /// CHECK-START-X86_64: void Main.accessFieldsVolatile() scheduler (after)
   /// CHECK:            InstanceFieldGet
   /// CHECK:            Add
   /// CHECK:            InstanceFieldSet
@@ -459,6 +604,7 @@ public class Main {
 
   /// CHECK-START-ARM: void Main.accessFieldsUnresolved() scheduler (before)
   /// CHECK-START-ARM64: void Main.accessFieldsUnresolved() scheduler (before)
+  /// CHECK-START-X86_64: void Main.accessFieldsUnresolved() scheduler (before)
   /// CHECK:            InstanceFieldGet
   /// CHECK:            Add
   /// CHECK:            InstanceFieldSet
@@ -474,6 +620,7 @@ public class Main {
 
   /// CHECK-START-ARM: void Main.accessFieldsUnresolved() scheduler (after)
   /// CHECK-START-ARM64: void Main.accessFieldsUnresolved() scheduler (after)
+  /// CHECK-START-X86_64: void Main.accessFieldsUnresolved() scheduler (after)
   /// CHECK:            InstanceFieldGet
   /// CHECK:            Add
   /// CHECK:            InstanceFieldSet
@@ -587,14 +734,14 @@ public class Main {
   // Check that instructions having cross iteration dependencies are not
   // reordered.
   //
-  /// CHECK-START-{ARM,ARM64}: void Main.testCrossItersDependencies() scheduler (before)
+  /// CHECK-START-{ARM,ARM64,X86_64}: void Main.testCrossItersDependencies() scheduler (before)
   /// CHECK:     <<ID1:i\d+>>  Phi [{{i\d+}},<<ID3:i\d+>>]
   /// CHECK:     <<ID2:i\d+>>  Phi [{{i\d+}},<<ID4:i\d+>>]
   //
   /// CHECK:     <<ID3>>  Sub [<<ID1>>,<<ID2>>]
   /// CHECK:     <<ID4>>  Add [<<ID2>>,{{i\d+}}]
 
-  /// CHECK-START-{ARM,ARM64}: void Main.testCrossItersDependencies() scheduler (after)
+  /// CHECK-START-{ARM,ARM64,X86_64}: void Main.testCrossItersDependencies() scheduler (after)
   /// CHECK:     <<ID1:i\d+>>  Phi [{{i\d+}},<<ID3:i\d+>>]
   /// CHECK:     <<ID2:i\d+>>  Phi [{{i\d+}},<<ID4:i\d+>>]
   //
@@ -647,6 +794,20 @@ public class Main {
   /// CHECK:     Select
   /// CHECK:     ArraySet
   /// CHECK:     Add
+
+  /// CHECK-START-X86_64: void Main.testNoSelfDependantSchedNode(int) scheduler (before)
+  /// CHECK:          ArrayGet
+  /// CHECK:          LessThanOrEqual
+  /// CHECK-NEXT:     Select
+  /// CHECK:          ArraySet
+  /// CHECK:          Add
+
+  /// CHECK-START-X86_64: void Main.testNoSelfDependantSchedNode(int) scheduler (after)
+  /// CHECK:          ArrayGet
+  /// CHECK:          LessThanOrEqual
+  /// CHECK-NEXT:     Select
+  /// CHECK:          ArraySet
+  /// CHECK:          Add
   //
   // Parameter n is to prevent unrolling of the main loop.
   private static void testNoSelfDependantSchedNode(int n) {
@@ -681,6 +842,18 @@ public class Main {
   /// CHECK-NEXT:     Add
   /// CHECK-NEXT:     ArrayGet
   /// CHECK-NEXT:     ArrayGet
+
+  /// CHECK-START-X86_64: void Main.testNonPreventingSchedulingCrossItersDeps(int) scheduler (before)
+  /// CHECK:          <<I:i\d+>>  Phi
+  /// CHECK:                      ArrayGet
+  /// CHECK-NEXT:                 Add [<<I>>,{{i\d+}}]
+  /// CHECK-NEXT:                 ArrayGet
+
+  /// CHECK-START-X86_64: void Main.testNonPreventingSchedulingCrossItersDeps(int) scheduler (after)
+  /// CHECK:          <<I:i\d+>>  Phi
+  /// CHECK:                      Add [<<I>>,{{i\d+}}]
+  /// CHECK-NEXT:                 ArrayGet
+  /// CHECK-NEXT:                 ArrayGet
   //
   // Parameter n is to prevent unrolling of the main loop.
   private static void testNonPreventingSchedulingCrossItersDeps(int n) {
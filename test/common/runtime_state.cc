@@ -374,6 +374,52 @@ extern "C" JNIEXPORT int JNICALL Java_Main_numberOfDeoptimizations(JNIEnv*, jcla
   return Runtime::Current()->GetNumberOfDeoptimizations();
 }
 
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_compactJitCodeCache(JNIEnv*, jclass) {
+  jit::Jit* jit = GetJitIfEnabled();
+  if (jit == nullptr) {
+    return false;
+  }
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  return jit->GetCodeCache()->CollectAndCompactForTesting(self);
+}
+
+// Returns the counts of the conditional branches of the method, in dex pc order, as pairs of
+// not taken and taken counts. Returns null if the method has no ProfilingInfo.
+extern "C" JNIEXPORT jintArray JNICALL Java_Main_getBranchCounts(JNIEnv* env,
+                                                                 jclass,
+                                                                 jclass cls,
+                                                                 jstring method_name) {
+  jit::Jit* jit = GetJitIfEnabled();
+  if (jit == nullptr) {
+    return nullptr;
+  }
+  std::vector<jint> counts;
+  {
+    Thread* self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    ScopedUtfChars chars(env, method_name);
+    ArtMethod* method = GetMethod(soa, cls, chars);
+    ProfilingInfo* info = jit->GetCodeCache()->GetProfilingInfoForTesting(method, self);
+    if (info == nullptr) {
+      return nullptr;
+    }
+    for (const DexInstructionPcPair& inst : method->DexInstructions()) {
+      if (inst->IsBranch() && !inst->IsUnconditional()) {
+        BranchCache* cache = info->GetBranchCache(inst.DexPc());
+        CHECK(cache != nullptr);
+        counts.push_back(cache->GetFalseCount());
+        counts.push_back(cache->GetTrueCount());
+      }
+    }
+  }
+  jintArray result = env->NewIntArray(counts.size());
+  if (result != nullptr) {
+    env->SetIntArrayRegion(result, 0, counts.size(), counts.data());
+  }
+  return result;
+}
+
 extern "C" JNIEXPORT void JNICALL Java_Main_fetchProfiles(JNIEnv*, jclass) {
   jit::Jit* jit = GetJitIfEnabled();
   if (jit == nullptr) {